@@ -0,0 +1,115 @@
+/**
+ * @file host_test.h
+ * @brief Minimal check macros and helpers shared by the host tests
+ *
+ * A failed CHECK prints the location and counts the failure; the test
+ * keeps running so one run reports every broken case. main() returns
+ * host_test_result().
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CHECKS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static int host_test_failures = 0;
+static int host_test_checks = 0;
+
+#define CHECK(cond) \
+  do \
+  { \
+    host_test_checks++; \
+    if (!(cond)) \
+    { \
+      host_test_failures++; \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+    } \
+  } while (0)
+
+#define CHECK_EQ_INT(actual, expected) \
+  do \
+  { \
+    long long a_ = (long long)(actual); \
+    long long e_ = (long long)(expected); \
+    host_test_checks++; \
+    if (a_ != e_) \
+    { \
+      host_test_failures++; \
+      fprintf(stderr, "%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, a_, e_); \
+    } \
+  } while (0)
+
+/**
+ * @brief Print the summary line
+ * @return Process exit code
+ */
+static inline int host_test_result(const char *name)
+{
+  printf("%s: %d checks, %d failed\n", name, host_test_checks, host_test_failures);
+  return host_test_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Monotonic time in nanoseconds
+ */
+static inline uint64_t host_test_now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Read a whole file
+ * @param path File to read
+ * @param len Receives the size
+ * @return malloc'd contents (NUL-terminated for convenience), or NULL
+ */
+static inline char *host_test_read_file(const char *path, size_t *len)
+{
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return NULL;
+
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  rewind(f);
+
+  char *data = size >= 0 ? malloc((size_t)size + 1) : NULL;
+  if (data && fread(data, 1, (size_t)size, f) != (size_t)size)
+  {
+    free(data);
+    data = NULL;
+  }
+  fclose(f);
+
+  if (data)
+  {
+    data[size] = '\0';
+    *len = (size_t)size;
+  }
+  return data;
+}
+
+/**
+ * @brief Small deterministic PRNG (xorshift32) so runs are reproducible
+ */
+static inline uint32_t host_test_rand(uint32_t *state)
+{
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *state = x;
+}
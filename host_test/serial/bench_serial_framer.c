@@ -0,0 +1,278 @@
+/**
+ * @file bench_serial_framer.c
+ * @brief Replay recorded serial byte streams through the line framer
+ *
+ * Usage: bench_serial_framer <capture> [...]
+ *
+ * Captures are raw bytes as they came off the UART (a .jsonl payload file
+ * is one). They are concatenated, repeated to STREAM_TARGET bytes and fed
+ * to the framer in fixed chunk sizes, from single bytes up to a full driver
+ * read. A second stream interleaves the same lines with binary frames.
+ *
+ * Reported per chunk size: throughput, records/s, and the latency of one
+ * UART read (commit plus popping every record it completed), average,
+ * 99th percentile and worst case. The worst case includes host scheduler
+ * preemption, so p99 is the figure to compare. The byte-at-a-time copy
+ * loop the serial task used before the framer is run on the text stream
+ * for comparison.
+ */
+
+#include "host_test.h"
+#include "serial_line_framer.h"
+#include "telemetry_frame.h"
+
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define RING_SIZE 4096           ///< As in serial_data_handler.c
+#define MAX_LINE 1023            ///< JSON_BUFFER_SIZE - 1
+#define STREAM_TARGET (8u << 20) ///< Bytes replayed per stream
+#define LATENCY_BUCKETS 4096     ///< Histogram buckets of LATENCY_BUCKET_NS
+#define LATENCY_BUCKET_NS 25
+
+static const size_t chunk_sizes[] = {1, 16, 120, 512, 2048};
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct
+{
+  uint8_t *data;
+  size_t len;
+} stream_t;
+
+typedef struct
+{
+  uint64_t total_ns;
+  uint64_t max_ns;
+  uint64_t reads;
+  uint64_t records;
+  uint32_t histogram[LATENCY_BUCKETS];
+} result_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STREAMS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void stream_put(stream_t *s, const void *data, size_t len)
+{
+  memcpy(s->data + s->len, data, len);
+  s->len += len;
+}
+
+/**
+ * @brief Repeat the captures up to STREAM_TARGET, optionally adding a binary
+ *        frame after every line
+ */
+static void build_stream(stream_t *s, const uint8_t *capture, size_t capture_len, bool frames)
+{
+  s->data = malloc(STREAM_TARGET + capture_len + TELEMETRY_FRAME_WIRE_MAX * (capture_len + 1));
+  s->len = 0;
+
+  metric_frame_t metrics;
+  metric_frame_init(&metrics);
+  uint8_t seq = 0;
+
+  while (s->len < STREAM_TARGET)
+  {
+    for (const uint8_t *p = capture; p < capture + capture_len && s->len < STREAM_TARGET;)
+    {
+      const uint8_t *nl = memchr(p, '\n', (size_t)(capture + capture_len - p));
+      size_t n = nl ? (size_t)(nl - p) + 1 : (size_t)(capture + capture_len - p);
+      stream_put(s, p, n);
+      p += n;
+
+      if (frames)
+      {
+        uint8_t wire[TELEMETRY_FRAME_WIRE_MAX];
+        metrics.values[METRIC_CPU_USAGE] = (float)(seq % 100);
+        metrics.timestamp++;
+        stream_put(s, wire, telemetry_frame_encode(&metrics, seq++, wire, sizeof(wire)));
+      }
+    }
+  }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// REPLAY
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static volatile uint32_t sink; ///< Keeps the record reads from being optimized out
+
+static void record_latency(result_t *r, uint64_t ns)
+{
+  size_t bucket = ns / LATENCY_BUCKET_NS;
+  r->histogram[bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS - 1]++;
+  r->total_ns += ns;
+  r->reads++;
+  if (ns > r->max_ns)
+    r->max_ns = ns;
+}
+
+static uint64_t percentile_ns(const result_t *r, double fraction)
+{
+  uint64_t target = (uint64_t)((double)r->reads * fraction);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < LATENCY_BUCKETS; i++)
+  {
+    seen += r->histogram[i];
+    if (seen > target)
+      return (uint64_t)(i + 1) * LATENCY_BUCKET_NS;
+  }
+  return r->max_ns;
+}
+
+static void replay_framer(const stream_t *s, size_t chunk, result_t *r)
+{
+  serial_line_framer_t framer;
+  if (serial_line_framer_init(&framer, RING_SIZE, MAX_LINE) != ESP_OK)
+  {
+    fprintf(stderr, "framer init failed\n");
+    exit(EXIT_FAILURE);
+  }
+  memset(r, 0, sizeof(*r));
+
+  for (size_t pos = 0; pos < s->len;)
+  {
+    uint8_t *dst;
+    size_t n = serial_line_framer_write_ptr(&framer, &dst);
+    if (n > chunk)
+      n = chunk;
+    if (n > s->len - pos)
+      n = s->len - pos;
+
+    uint64_t start = host_test_now_ns();
+    memcpy(dst, s->data + pos, n); // Stands in for uart_read_bytes()
+    serial_line_framer_commit(&framer, n);
+
+    const char *data;
+    size_t len;
+    serial_record_type_t type;
+    while (serial_line_framer_next(&framer, &data, &len, &type))
+    {
+      sink += (uint8_t)data[0] + (uint32_t)len;
+      r->records++;
+    }
+    record_latency(r, host_test_now_ns() - start);
+    pos += n;
+  }
+
+  serial_line_framer_deinit(&framer);
+}
+
+/**
+ * @brief The previous receive path: copy printable bytes one at a time
+ */
+static void replay_bytewise(const stream_t *s, size_t chunk, result_t *r)
+{
+  static char line[MAX_LINE + 1];
+  static uint8_t read_buffer[2048];
+  size_t line_pos = 0;
+  memset(r, 0, sizeof(*r));
+
+  for (size_t pos = 0; pos < s->len;)
+  {
+    size_t n = chunk < sizeof(read_buffer) ? chunk : sizeof(read_buffer);
+    if (n > s->len - pos)
+      n = s->len - pos;
+
+    uint64_t start = host_test_now_ns();
+    memcpy(read_buffer, s->data + pos, n);
+    for (size_t i = 0; i < n; i++)
+    {
+      uint8_t byte = read_buffer[i];
+      if (byte == '\n' || byte == '\r')
+      {
+        if (line_pos > 0)
+        {
+          line[line_pos] = '\0';
+          sink += (uint8_t)line[0] + (uint32_t)line_pos;
+          r->records++;
+          line_pos = 0;
+        }
+      }
+      else if (byte >= 32 && byte <= 126)
+      {
+        if (line_pos < MAX_LINE)
+          line[line_pos++] = (char)byte;
+        else
+          line_pos = 0;
+      }
+    }
+    record_latency(r, host_test_now_ns() - start);
+    pos += n;
+  }
+}
+
+static void report(const char *name, size_t chunk, const stream_t *s, const result_t *r)
+{
+  double seconds = (double)r->total_ns / 1e9;
+  printf("  %-9s %5zu B  %8.1f MB/s %10.0f rec/s   read avg %7.0f ns  p99 %7llu ns  max %8llu ns\n", name,
+         chunk, (double)s->len / seconds / 1e6, (double)r->records / seconds,
+         (double)r->total_ns / (double)r->reads, (unsigned long long)percentile_ns(r, 0.99),
+         (unsigned long long)r->max_ns);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MAIN
+// ═══════════════════════════════════════════════════════════════════════════════
+
+int main(int argc, char **argv)
+{
+  if (argc < 2)
+  {
+    fprintf(stderr, "usage: %s <capture> [...]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  // Concatenate the captures
+  uint8_t *capture = NULL;
+  size_t capture_len = 0;
+  for (int i = 1; i < argc; i++)
+  {
+    size_t len;
+    char *data = host_test_read_file(argv[i], &len);
+    if (!data)
+    {
+      fprintf(stderr, "%s: cannot read\n", argv[i]);
+      return EXIT_FAILURE;
+    }
+    capture = realloc(capture, capture_len + len);
+    memcpy(capture + capture_len, data, len);
+    capture_len += len;
+    free(data);
+  }
+
+  metric_registry_init();
+
+  stream_t text;
+  stream_t mixed;
+  build_stream(&text, capture, capture_len, false);
+  build_stream(&mixed, capture, capture_len, true);
+  free(capture);
+
+  result_t r;
+  printf("text stream: %zu bytes\n", text.len);
+  for (size_t i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++)
+  {
+    replay_framer(&text, chunk_sizes[i], &r);
+    report("framer", chunk_sizes[i], &text, &r);
+    replay_bytewise(&text, chunk_sizes[i], &r);
+    report("bytewise", chunk_sizes[i], &text, &r);
+  }
+
+  printf("mixed stream (a binary frame after every line): %zu bytes\n", mixed.len);
+  for (size_t i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++)
+  {
+    replay_framer(&mixed, chunk_sizes[i], &r);
+    report("framer", chunk_sizes[i], &mixed, &r);
+  }
+
+  free(text.data);
+  free(mixed.data);
+  return EXIT_SUCCESS;
+}
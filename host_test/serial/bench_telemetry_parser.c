@@ -0,0 +1,300 @@
+/**
+ * @file bench_telemetry_parser.c
+ * @brief Throughput of the telemetry parser on recorded payloads
+ *
+ * Usage: bench_telemetry_parser <payloads.jsonl> [...]
+ *
+ * Each file is parsed line by line, repeatedly, for about half a second.
+ * With HAVE_CJSON the same lines also go through the cJSON code the serial
+ * handler used before the tokenizer (tree build, fixed-field extraction,
+ * delete), with the allocator hooked to count heap calls per line.
+ *
+ * Host numbers only rank the two paths; absolute speed on the ESP32-S3 is
+ * several times lower.
+ */
+
+#include "host_test.h"
+#include "telemetry_parser.h"
+
+#include <string.h>
+
+#ifdef HAVE_CJSON
+#include <cJSON.h>
+#include <time.h>
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define BENCH_MIN_NS 500000000ULL ///< Minimum measured time per path and file
+#define BENCH_MAX_LINES 4096
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct
+{
+  const char *text;
+  size_t len;
+} line_t;
+
+typedef bool (*parse_fn_t)(const line_t *line);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PARSERS UNDER TEST
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static metric_frame_t frame;
+
+static bool parse_tokenizer(const line_t *line)
+{
+  return telemetry_parse_json(line->text, line->len, &frame);
+}
+
+#ifdef HAVE_CJSON
+
+/**
+ * @brief The fixed schema the cJSON path filled (baseline system_data_t)
+ */
+typedef struct
+{
+  struct
+  {
+    uint8_t usage;
+    uint8_t temp;
+    uint16_t fan;
+    char name[64];
+  } cpu;
+  struct
+  {
+    uint8_t usage;
+    uint8_t temp;
+    char name[64];
+    uint32_t mem_used;
+    uint32_t mem_total;
+  } gpu;
+  struct
+  {
+    uint8_t usage;
+    float used;
+    float total;
+    float avail;
+  } mem;
+  uint64_t timestamp;
+} baseline_data_t;
+
+static baseline_data_t baseline;
+static size_t alloc_calls;
+static size_t alloc_bytes;
+
+static void *counting_malloc(size_t size)
+{
+  alloc_calls++;
+  alloc_bytes += size;
+  return malloc(size);
+}
+
+static void copy_name(char *dst, size_t size, const cJSON *item)
+{
+  if (cJSON_IsString(item))
+  {
+    strncpy(dst, cJSON_GetStringValue(item), size - 1);
+    dst[size - 1] = '\0';
+  }
+}
+
+/**
+ * @brief The cJSON extraction the serial handler ran before the tokenizer
+ */
+static bool parse_cjson(const line_t *line)
+{
+  cJSON *json = cJSON_ParseWithLength(line->text, line->len);
+  if (json == NULL)
+    return false;
+
+  baseline_data_t *data = &baseline;
+  cJSON *ts = cJSON_GetObjectItem(json, "ts");
+  data->timestamp = cJSON_IsNumber(ts) ? (uint64_t)cJSON_GetNumberValue(ts) : (uint64_t)time(NULL) * 1000;
+
+  cJSON *cpu = cJSON_GetObjectItem(json, "cpu");
+  if (cJSON_IsObject(cpu))
+  {
+    cJSON *item;
+    if (cJSON_IsNumber(item = cJSON_GetObjectItem(cpu, "usage")))
+      data->cpu.usage = (uint8_t)cJSON_GetNumberValue(item);
+    if (cJSON_IsNumber(item = cJSON_GetObjectItem(cpu, "temp")))
+      data->cpu.temp = (uint8_t)cJSON_GetNumberValue(item);
+    if (cJSON_IsNumber(item = cJSON_GetObjectItem(cpu, "fan")))
+      data->cpu.fan = (uint16_t)cJSON_GetNumberValue(item);
+    copy_name(data->cpu.name, sizeof(data->cpu.name), cJSON_GetObjectItem(cpu, "name"));
+  }
+
+  cJSON *gpu = cJSON_GetObjectItem(json, "gpu");
+  if (cJSON_IsObject(gpu))
+  {
+    cJSON *item;
+    if (cJSON_IsNumber(item = cJSON_GetObjectItem(gpu, "usage")))
+      data->gpu.usage = (uint8_t)cJSON_GetNumberValue(item);
+    if (cJSON_IsNumber(item = cJSON_GetObjectItem(gpu, "temp")))
+      data->gpu.temp = (uint8_t)cJSON_GetNumberValue(item);
+    copy_name(data->gpu.name, sizeof(data->gpu.name), cJSON_GetObjectItem(gpu, "name"));
+    if (cJSON_IsNumber(item = cJSON_GetObjectItem(gpu, "mem_used")))
+      data->gpu.mem_used = (uint32_t)cJSON_GetNumberValue(item);
+    if (cJSON_IsNumber(item = cJSON_GetObjectItem(gpu, "mem_total")))
+      data->gpu.mem_total = (uint32_t)cJSON_GetNumberValue(item);
+  }
+
+  cJSON *mem = cJSON_GetObjectItem(json, "mem");
+  if (cJSON_IsObject(mem))
+  {
+    cJSON *item;
+    if (cJSON_IsNumber(item = cJSON_GetObjectItem(mem, "usage")))
+      data->mem.usage = (uint8_t)cJSON_GetNumberValue(item);
+    if (cJSON_IsNumber(item = cJSON_GetObjectItem(mem, "used")))
+      data->mem.used = (float)cJSON_GetNumberValue(item);
+    if (cJSON_IsNumber(item = cJSON_GetObjectItem(mem, "total")))
+      data->mem.total = (float)cJSON_GetNumberValue(item);
+    if (cJSON_IsNumber(item = cJSON_GetObjectItem(mem, "avail")))
+      data->mem.avail = (float)cJSON_GetNumberValue(item);
+  }
+
+  cJSON_Delete(json);
+  return true;
+}
+
+#endif // HAVE_CJSON
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// BENCHMARK
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static size_t split_lines(char *data, size_t len, line_t *lines, size_t max)
+{
+  size_t count = 0;
+  for (char *p = data; p < data + len && count < max;)
+  {
+    char *nl = memchr(p, '\n', (size_t)(data + len - p));
+    size_t n = nl ? (size_t)(nl - p) : (size_t)(data + len - p);
+    if (n > 0)
+      lines[count++] = (line_t){p, n};
+    p += n + 1;
+  }
+  return count;
+}
+
+/**
+ * @brief Parse every line until BENCH_MIN_NS has passed
+ * @return Nanoseconds per line, or 0 if a line was rejected
+ */
+static double run(parse_fn_t parse, const line_t *lines, size_t count, size_t *passes)
+{
+  // Warm-up pass, also registers every path before timing
+  for (size_t i = 0; i < count; i++)
+  {
+    if (!parse(&lines[i]))
+      return 0;
+  }
+
+  uint64_t start = host_test_now_ns();
+  uint64_t elapsed;
+  *passes = 0;
+  do
+  {
+    for (size_t i = 0; i < count; i++)
+      parse(&lines[i]);
+    (*passes)++;
+    elapsed = host_test_now_ns() - start;
+  } while (elapsed < BENCH_MIN_NS);
+
+  return (double)elapsed / (double)(*passes * count);
+}
+
+static void report(const char *name, double ns_per_line, double bytes_per_line)
+{
+  printf("  %-10s %9.0f ns/line %10.0f lines/s %8.1f MB/s", name, ns_per_line, 1e9 / ns_per_line,
+         bytes_per_line / ns_per_line * 1e3);
+}
+
+static int bench_file(const char *path)
+{
+  static line_t lines[BENCH_MAX_LINES];
+  size_t len;
+  char *data = host_test_read_file(path, &len);
+  if (!data)
+  {
+    fprintf(stderr, "%s: cannot read\n", path);
+    return EXIT_FAILURE;
+  }
+
+  size_t count = split_lines(data, len, lines, BENCH_MAX_LINES);
+  size_t bytes = 0;
+  for (size_t i = 0; i < count; i++)
+    bytes += lines[i].len;
+  double bytes_per_line = count ? (double)bytes / (double)count : 0;
+
+  printf("%s: %zu lines, %.0f bytes/line\n", path, count, bytes_per_line);
+
+  size_t passes;
+  double ns = run(parse_tokenizer, lines, count, &passes);
+  if (ns == 0)
+  {
+    fprintf(stderr, "%s: tokenizer rejected a line\n", path);
+    free(data);
+    return EXIT_FAILURE;
+  }
+  report("tokenizer", ns, bytes_per_line);
+  printf("   0 heap calls/line\n");
+
+#ifdef HAVE_CJSON
+  ns = run(parse_cjson, lines, count, &passes);
+  if (ns == 0)
+  {
+    fprintf(stderr, "%s: cJSON rejected a line\n", path);
+    free(data);
+    return EXIT_FAILURE;
+  }
+  alloc_calls = 0;
+  alloc_bytes = 0;
+  for (size_t i = 0; i < count; i++)
+    parse_cjson(&lines[i]);
+  report("cJSON", ns, bytes_per_line);
+  printf("  %3.0f heap calls/line (%.0f bytes)\n", (double)alloc_calls / (double)count,
+         (double)alloc_bytes / (double)count);
+#endif
+
+  free(data);
+  return EXIT_SUCCESS;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MAIN
+// ═══════════════════════════════════════════════════════════════════════════════
+
+int main(int argc, char **argv)
+{
+  if (argc < 2)
+  {
+    fprintf(stderr, "usage: %s <payloads.jsonl> [...]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  metric_registry_init();
+  metric_frame_init(&frame);
+
+#ifdef HAVE_CJSON
+  cJSON_Hooks hooks = {.malloc_fn = counting_malloc, .free_fn = free};
+  cJSON_InitHooks(&hooks);
+#else
+  printf("(built without cJSON: tokenizer only)\n");
+#endif
+
+  int result = EXIT_SUCCESS;
+  for (int i = 1; i < argc; i++)
+  {
+    if (bench_file(argv[i]) != EXIT_SUCCESS)
+      result = EXIT_FAILURE;
+  }
+  return result;
+}
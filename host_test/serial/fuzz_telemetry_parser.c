@@ -0,0 +1,40 @@
+/**
+ * @file fuzz_telemetry_parser.c
+ * @brief libFuzzer entry point for the telemetry parser
+ *
+ * Checks the same invariants as the mutation pass in test_telemetry_parser:
+ * a rejected input leaves the frame and the registry untouched.
+ */
+
+#include "telemetry_parser.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+  static metric_frame_t frame;
+  static metric_frame_t before;
+  static bool initialized = false;
+
+  if (!initialized)
+  {
+    metric_registry_init();
+    metric_frame_init(&frame);
+    initialized = true;
+  }
+
+  memcpy(&before, &frame, sizeof(frame));
+  uint16_t count = metric_registry_count();
+
+  if (telemetry_parse_json((const char *)data, size, &frame))
+  {
+    if (frame.count != metric_registry_count())
+      abort();
+  }
+  else if (memcmp(&before, &frame, sizeof(frame)) != 0 || metric_registry_count() != count)
+  {
+    abort();
+  }
+  return 0;
+}
@@ -0,0 +1,335 @@
+/**
+ * @file test_async_log.c
+ * @brief Host tests for the asynchronous log backend's record encoding
+ *
+ * Builds async_log.c into the test, so the hook and the drain formatter
+ * are reached without a running drain task. Records go through
+ * async_log_vprintf() into the stand-in ring and come back out through
+ * format_deferred(); the text must equal vsnprintf() on the same
+ * arguments. Formats are spelled as ESP-IDF 5.5 log v1 builds them:
+ * LOG_COLOR_x "x (%lu) %s: " format LOG_RESET_COLOR "\n".
+ */
+
+#include "host_test.h"
+
+#include "async_log.c"
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define COLOR_E "\033[0;31m"
+#define COLOR_W "\033[0;33m"
+#define COLOR_I "\033[0;32m"
+#define RESET "\033[0m"
+
+#define LOG_E(format) COLOR_E "E (%lu) %s: " format RESET "\n"
+#define LOG_W(format) COLOR_W "W (%lu) %s: " format RESET "\n"
+#define LOG_I(format) COLOR_I "I (%lu) %s: " format RESET "\n"
+#define LOG_D(format) "D (%lu) %s: " format "\n"
+
+/** "Flash" strings: formats and tags, which the hook stores as pointers */
+static const char TAG_SERIAL[] = "serial";
+static const char TAG_NOISY[] = "noisy";
+static const char FLASH_NAME[] = "GT911";
+
+static const char FMT_PLAIN[] = LOG_I("Started");
+static const char FMT_INTS[] = LOG_I("%d %i %u %x %X %o %5d|%-5d|%05d %+d");
+static const char FMT_LONGS[] = LOG_W("%ld %lu %lld %llu %llx %zu %hd %hhu");
+static const char FMT_FLOATS[] = LOG_D("%f %.2f %8.3e %g %-10.1f|");
+static const char FMT_STARS[] = LOG_I("[%*d] [%-*s] [%.*s] [%*.*f]");
+static const char FMT_STRINGS[] = LOG_E("%s and %s, %10s|%-10s|%.3s");
+static const char FMT_MISC[] = LOG_I("%c%c 100%% %p");
+static const char FMT_UNSUPPORTED[] = LOG_I("%jd");
+static const char FMT_NOISY[] = LOG_I("sample %d");
+static const char FMT_NOISY_E[] = LOG_E("failed %d");
+static const char FMT_NOISY_W[] = LOG_W("slow %d");
+static const char FMT_NOISY_D[] = LOG_D("detail %d");
+
+static const char *const flash_strings[] = {
+    TAG_SERIAL, TAG_NOISY, FLASH_NAME, FMT_PLAIN, FMT_INTS, FMT_LONGS, FMT_FLOATS, FMT_STARS, FMT_STRINGS,
+    FMT_MISC, FMT_UNSUPPORTED, FMT_NOISY, FMT_NOISY_E, FMT_NOISY_W, FMT_NOISY_D,
+};
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PLATFORM STAND-INS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static int64_t clock_us = 1000000;
+
+int64_t esp_timer_get_time(void)
+{
+  return clock_us;
+}
+
+bool esp_ptr_in_drom(const void *p)
+{
+  for (size_t i = 0; i < sizeof(flash_strings) / sizeof(flash_strings[0]); i++)
+  {
+    if (p == flash_strings[i])
+      return true;
+  }
+  return false;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct
+{
+  bool stored;          ///< A record reached the ring
+  bool deferred;        ///< ...as format plus arguments
+  uint16_t suppressed;  ///< Its header's rate-limit count
+  char text[ASYNC_LOG_LINE_MAX];
+  char expected[ASYNC_LOG_LINE_MAX];
+} logged_t;
+
+static void reset_backend(void)
+{
+  if (!log_ring)
+    log_ring = xRingbufferCreateWithCaps(CONFIG_ASYNC_LOG_RING_SIZE, RINGBUF_TYPE_NOSPLIT, MALLOC_CAP_SPIRAM);
+  memset(tag_buckets, 0, sizeof(tag_buckets));
+  atomic_store(&stat_deferred, 0);
+  atomic_store(&stat_text, 0);
+  atomic_store(&stat_rate_limited, 0);
+  atomic_store(&stat_dropped, 0);
+}
+
+/**
+ * @brief Pop the oldest record and format it the way the drain task does
+ */
+static bool drain_one(logged_t *out)
+{
+  size_t size;
+  uint8_t *item = xRingbufferReceive(log_ring, &size, 0);
+  if (!item)
+    return false;
+
+  record_header_t header;
+  memcpy(&header, item, sizeof(header));
+  out->stored = true;
+  out->deferred = header.fmt != NULL;
+  out->suppressed = header.suppressed;
+  if (header.fmt)
+    format_deferred(header.fmt, item + sizeof(header), out->text, sizeof(out->text));
+  else
+    snprintf(out->text, sizeof(out->text), "%s", (const char *)item + sizeof(header));
+  vRingbufferReturnItem(log_ring, item);
+  return true;
+}
+
+static void log_only(const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  async_log_vprintf(fmt, args);
+  va_end(args);
+}
+
+/**
+ * @brief Log through the hook and capture both the stored and the reference text
+ */
+static logged_t log_record(const char *fmt, ...)
+{
+  logged_t out = {0};
+  va_list args;
+
+  va_start(args, fmt);
+  async_log_vprintf(fmt, args);
+  va_end(args);
+
+  va_start(args, fmt);
+  vsnprintf(out.expected, sizeof(out.expected), fmt, args);
+  va_end(args);
+
+  drain_one(&out);
+  return out;
+}
+
+static void check_round_trip(const logged_t *r, bool deferred)
+{
+  CHECK(r->stored);
+  CHECK(r->deferred == deferred);
+  if (strcmp(r->text, r->expected) != 0)
+  {
+    host_test_failures++;
+    fprintf(stderr, "round trip mismatch:\n  got      \"%s\"\n  expected \"%s\"\n", r->text, r->expected);
+  }
+  host_test_checks++;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// TESTS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void test_format_level(void)
+{
+  CHECK_EQ_INT(format_level(LOG_E("x")), 'E');
+  CHECK_EQ_INT(format_level(LOG_W("x")), 'W');
+  CHECK_EQ_INT(format_level(LOG_I("x")), 'I');
+  CHECK_EQ_INT(format_level(LOG_D("x")), 'D');
+  CHECK_EQ_INT(format_level("V (%lu) %s: x\n"), 'V');
+  CHECK_EQ_INT(format_level("\033[1;31mE (%s) %s: x\n"), 'E'); // Bold color, system time
+  CHECK_EQ_INT(format_level("Error: %d\n"), 0);
+  CHECK_EQ_INT(format_level("E"), 0);
+  CHECK_EQ_INT(format_level("\033[0;31"), 0);
+  CHECK_EQ_INT(format_level(""), 0);
+}
+
+static void test_round_trip(void)
+{
+  reset_backend();
+  char ram_str[] = "copied";
+  char long_str[300];
+  memset(long_str, 'x', sizeof(long_str) - 1);
+  long_str[sizeof(long_str) - 1] = '\0';
+  unsigned long ts = 123456;
+
+  logged_t r = log_record(FMT_PLAIN, ts, TAG_SERIAL);
+  check_round_trip(&r, true);
+
+  r = log_record(FMT_INTS, ts, TAG_SERIAL, -42, 7, 4000000000u, 0xBEEFu, 0xCAFEu, 8u, 12, -3, 42, 5);
+  check_round_trip(&r, true);
+
+  r = log_record(FMT_LONGS, ts, TAG_SERIAL, -1234567L, 9876543UL, -1234567890123LL, 18446744073709551615ULL,
+                 0x123456789ABCULL, (size_t)4096, (short)-7, (unsigned char)200);
+  check_round_trip(&r, true);
+
+  r = log_record(FMT_FLOATS, ts, TAG_SERIAL, 3.14159, -2.5, 12345.678, 1e-7, 0.25);
+  check_round_trip(&r, true);
+
+  r = log_record(FMT_STARS, ts, TAG_SERIAL, 6, 42, -8, "ab", 3, "truncated", 9, 2, 3.14159);
+  check_round_trip(&r, true);
+
+  r = log_record(FMT_STRINGS, ts, TAG_SERIAL, FLASH_NAME, ram_str, ram_str, FLASH_NAME, ram_str);
+  check_round_trip(&r, true);
+
+  r = log_record(FMT_STRINGS, ts, TAG_SERIAL, (const char *)NULL, "", ram_str, ram_str, FLASH_NAME);
+  check_round_trip(&r, true);
+
+  r = log_record(FMT_MISC, ts, TAG_SERIAL, 'o', 'k', (void *)&r);
+  check_round_trip(&r, true);
+
+  // Copied strings are cut at ASYNC_LOG_STR_MAX
+  r = log_record(FMT_STRINGS, ts, TAG_SERIAL, long_str, "", "", "", "");
+  CHECK(r.stored && r.deferred);
+  CHECK_EQ_INT(strspn(r.text + strlen(COLOR_E "E (123456) serial: "), "x"), ASYNC_LOG_STR_MAX);
+
+  CHECK_EQ_INT(atomic_load(&stat_deferred), 9);
+  CHECK_EQ_INT(atomic_load(&stat_text), 0);
+}
+
+static void test_text_path(void)
+{
+  reset_backend();
+  unsigned long ts = 99;
+
+  // A format outside flash is formatted at once
+  char ram_fmt[] = LOG_I("value %d from %s");
+  logged_t r = log_record(ram_fmt, ts, TAG_SERIAL, 17, "ram");
+  check_round_trip(&r, false);
+
+  // So is one with a conversion the encoder does not handle
+  r = log_record(FMT_UNSUPPORTED, ts, TAG_SERIAL, (intmax_t)-5);
+  check_round_trip(&r, false);
+
+  // And one with more copied strings than a record holds
+  char s[] = "s";
+  char many_fmt_ram[] = LOG_I("%s%s%s%s%s%s%s%s%s");
+  r = log_record(many_fmt_ram, ts, TAG_SERIAL, s, s, s, s, s, s, s, s, s);
+  check_round_trip(&r, false);
+
+  CHECK_EQ_INT(atomic_load(&stat_text), 3);
+}
+
+static void test_rate_limit(void)
+{
+  reset_backend();
+  unsigned long ts = 1;
+  logged_t r;
+
+  // The burst passes, then info records of the tag are limited
+  int admitted = 0;
+  for (int i = 0; i < CONFIG_ASYNC_LOG_TAG_BURST + 10; i++)
+  {
+    r = log_record(FMT_NOISY, ts, TAG_NOISY, i);
+    admitted += r.stored;
+  }
+  CHECK_EQ_INT(admitted, CONFIG_ASYNC_LOG_TAG_BURST);
+  CHECK_EQ_INT(atomic_load(&stat_rate_limited), 10);
+
+  r = log_record(FMT_NOISY_D, ts, TAG_NOISY, 0);
+  CHECK(!r.stored);
+
+  // Errors and warnings of the exhausted tag always pass
+  for (int i = 0; i < 5; i++)
+  {
+    r = log_record(FMT_NOISY_E, ts, TAG_NOISY, i);
+    check_round_trip(&r, true);
+    r = log_record(FMT_NOISY_W, ts, TAG_NOISY, i);
+    check_round_trip(&r, true);
+  }
+  CHECK_EQ_INT(atomic_load(&stat_rate_limited), 11);
+
+  // Other tags have their own bucket
+  r = log_record(FMT_PLAIN, ts, TAG_SERIAL);
+  CHECK(r.stored);
+
+  // Refill: one record per 1000 / rate ms; the next one reports what was cut
+  clock_us += 1000000 / CONFIG_ASYNC_LOG_TAG_RATE;
+  r = log_record(FMT_NOISY, ts, TAG_NOISY, 1);
+  CHECK(r.stored);
+  CHECK_EQ_INT(r.suppressed, 11);
+  r = log_record(FMT_NOISY, ts, TAG_NOISY, 2);
+  CHECK(!r.stored);
+}
+
+static void test_ring_full(void)
+{
+  reset_backend();
+  unsigned long ts = 1;
+  char big[ASYNC_LOG_STR_MAX];
+  memset(big, 'y', sizeof(big) - 1);
+  big[sizeof(big) - 1] = '\0';
+
+  // Records are not drained, so copied strings fill the ring; E records
+  // skip the rate limit, so only the ring decides what is kept
+  const int attempts = CONFIG_ASYNC_LOG_RING_SIZE / 64;
+  for (int i = 0; i < attempts; i++)
+    log_only(FMT_STRINGS, ts, TAG_SERIAL, big, "", "", "", "");
+
+  int dropped = (int)atomic_load(&stat_dropped);
+  CHECK(dropped > 0);
+  CHECK_EQ_INT(atomic_load(&stat_deferred) + (uint32_t)dropped, attempts);
+
+  // What was kept is intact
+  char expected[ASYNC_LOG_LINE_MAX];
+  snprintf(expected, sizeof(expected), FMT_STRINGS, ts, TAG_SERIAL, big, "", "", "", "");
+  int kept = 0;
+  logged_t r;
+  while (drain_one(&r))
+  {
+    kept++;
+    CHECK(r.deferred && strcmp(r.text, expected) == 0);
+  }
+  CHECK_EQ_INT(kept, attempts - dropped);
+
+  // Once drained there is room again
+  r = log_record(FMT_PLAIN, ts, TAG_SERIAL);
+  check_round_trip(&r, true);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MAIN
+// ═══════════════════════════════════════════════════════════════════════════════
+
+int main(void)
+{
+  test_format_level();
+  test_round_trip();
+  test_text_path();
+  test_rate_limit();
+  test_ring_full();
+  return host_test_result("async_log");
+}
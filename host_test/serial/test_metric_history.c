@@ -0,0 +1,122 @@
+/**
+ * @file test_metric_history.c
+ * @brief Host tests for the metric history store fed by parsed records
+ *
+ * Records go through the same path as on the device: telemetry_parse_json()
+ * or telemetry_frame_decode() into one persistent frame, then
+ * metric_history_record(). A metric the record did not carry keeps its
+ * value in the frame but must not add a sample to its history.
+ */
+
+#include "host_test.h"
+#include "metric_history.h"
+#include "telemetry_frame.h"
+#include "telemetry_parser.h"
+
+#include <math.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PLATFORM STAND-INS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+int64_t esp_timer_get_time(void)
+{
+  return 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static metric_frame_t frame;
+
+static void record_json(const char *json, uint32_t now_s)
+{
+  CHECK(telemetry_parse_json(json, strlen(json), &frame));
+  metric_history_record(&frame, now_s);
+}
+
+static void record_binary(const metric_frame_t *values, uint32_t now_s)
+{
+  uint8_t wire[TELEMETRY_FRAME_WIRE_MAX];
+  size_t n = telemetry_frame_encode(values, 0, wire, sizeof(wire));
+  CHECK_EQ_INT(telemetry_frame_decode(wire + 1, n - 2, &frame, NULL), ESP_OK);
+  metric_history_record(&frame, now_s);
+}
+
+static metric_id_t lookup(const char *path)
+{
+  size_t len = strlen(path);
+  return metric_registry_lookup(path, len, metric_hash_extend(METRIC_HASH_INIT, path, len));
+}
+
+static bool same(float a, float b)
+{
+  return (isnan(a) && isnan(b)) || fabsf(a - b) < 1e-4f;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// TESTS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void test_only_updated_metrics_recorded(void)
+{
+  metric_frame_init(&frame);
+  record_json("{\"ts\":1,\"cpu\":{\"usage\":10},\"gpu\":{\"temp\":50},\"disk\":{\"0\":{\"used\":5}}}", 100);
+  record_json("{\"ts\":2,\"cpu\":{\"usage\":20},\"gpu\":{\"temp\":60}}", 101);
+  record_json("{\"ts\":3,\"cpu\":{\"usage\":30}}", 102);
+
+  metric_frame_t values;
+  metric_frame_init(&values);
+  values.values[METRIC_CPU_USAGE] = 40;
+  values.values[METRIC_GPU_TEMP] = 70;
+  record_binary(&values, 103);
+
+  // gpu.temp keeps 60 in the frame during second 102, but has no sample there
+  static const float gpu_1s[] = {50, 60, NAN, 70};
+  static const float cpu_1s[] = {10, 20, 30, 40};
+  metric_history_point_t points[8];
+  CHECK_EQ_INT(metric_history_query(METRIC_GPU_TEMP, METRIC_HISTORY_1S, 100, 103, points, 8), 4);
+  for (int i = 0; i < 4; i++)
+  {
+    CHECK_EQ_INT(points[i].time, 100 + i);
+    CHECK(same(points[i].avg, gpu_1s[i]));
+  }
+  CHECK_EQ_INT(metric_history_query(METRIC_CPU_USAGE, METRIC_HISTORY_1S, 100, 103, points, 8), 4);
+  for (int i = 0; i < 4; i++)
+  {
+    CHECK(same(points[i].avg, cpu_1s[i]));
+  }
+
+  // Coarser buckets average real samples only: (50 + 60 + 70) / 3, not with a repeated 60
+  CHECK_EQ_INT(metric_history_latest(METRIC_GPU_TEMP, METRIC_HISTORY_10S, points, 1), 1);
+  CHECK(same(points[0].avg, 60) && same(points[0].min, 50) && same(points[0].max, 70));
+  CHECK_EQ_INT(metric_history_latest(METRIC_CPU_USAGE, METRIC_HISTORY_10S, points, 1), 1);
+  CHECK(same(points[0].avg, 25));
+
+  // Binary frames carry built-in numbers only; the JSON-only disk metric had one sample
+  metric_id_t disk = lookup("disk.0.used");
+  CHECK(disk != METRIC_ID_INVALID);
+  CHECK(same(frame.values[disk], 5));
+  CHECK_EQ_INT(metric_history_query(disk, METRIC_HISTORY_1S, 100, 103, points, 8), 1);
+  CHECK(same(points[0].avg, 5));
+
+  // A binary frame carries every built-in number, including the ones its sender left at 0
+  CHECK_EQ_INT(metric_history_latest(METRIC_MEM_USAGE, METRIC_HISTORY_1S, points, 8), 1);
+  CHECK_EQ_INT(points[0].time, 103);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MAIN
+// ═══════════════════════════════════════════════════════════════════════════════
+
+int main(void)
+{
+  CHECK(metric_registry_init() == ESP_OK);
+  CHECK(metric_history_init() == ESP_OK);
+
+  test_only_updated_metrics_recorded();
+
+  return host_test_result("metric_history");
+}
@@ -0,0 +1,468 @@
+/**
+ * @file test_telemetry_frame.c
+ * @brief Host tests for the binary telemetry frame and mixed serial streams
+ *
+ * Usage: test_telemetry_frame [payloads.jsonl]
+ *
+ * Covers the encode/decode round trip, single-bit corruption, the version
+ * check order, COBS edge cases (zero runs, 254-byte blocks) and JSON lines
+ * interleaved with binary frames going through serial_line_framer in
+ * random UART-sized chunks.
+ */
+
+#include "host_test.h"
+#include "serial_line_framer.h"
+#include "telemetry_frame.h"
+
+#include <math.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define RING_SIZE 1024
+#define MAX_LINE 500
+#define STREAM_RECORDS 2000
+#define STREAM_SEEDS 8
+#define MAX_CHUNK 64
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void sample_metrics(metric_frame_t *m, unsigned i)
+{
+  metric_frame_init(m);
+  m->timestamp = 1755165600000ULL + i * 1000ULL;
+  m->values[METRIC_CPU_USAGE] = (float)(i % 101);
+  m->values[METRIC_CPU_TEMP] = (float)(30 + i % 60);
+  m->values[METRIC_CPU_FAN] = (float)(i * 37 % 3000);
+  m->values[METRIC_GPU_USAGE] = (float)(i * 7 % 101);
+  m->values[METRIC_GPU_TEMP] = (float)(25 + i % 70);
+  m->values[METRIC_GPU_MEM_USED] = (float)(i * 131 % 24564);
+  m->values[METRIC_GPU_MEM_TOTAL] = 24564;
+  m->values[METRIC_MEM_USAGE] = (float)(i % 100);
+  m->values[METRIC_MEM_USED] = (float)(i % 6315) / 100.0f;
+  m->values[METRIC_MEM_TOTAL] = 63.15f;
+  m->values[METRIC_MEM_AVAIL] = 63.15f - (float)(i % 6315) / 100.0f;
+}
+
+static bool same_builtins(const metric_frame_t *a, const metric_frame_t *b)
+{
+  if (a->timestamp != b->timestamp)
+    return false;
+  for (int id = 0; id < METRIC_BUILTIN_COUNT; id++)
+  {
+    if (id == METRIC_CPU_NAME || id == METRIC_GPU_NAME)
+      continue;
+    // Memory sizes travel in hundredths of a GB
+    if (fabsf(a->values[id] - b->values[id]) > 0.006f)
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Decode a wire frame built by telemetry_frame_encode
+ */
+static esp_err_t decode_wire(const uint8_t *wire, size_t wire_len, metric_frame_t *m, uint8_t *seq)
+{
+  return telemetry_frame_decode(wire + 1, wire_len - 2, m, seq);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FRAME CODEC
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void test_round_trip(void)
+{
+  uint8_t wire[TELEMETRY_FRAME_WIRE_MAX];
+
+  for (unsigned i = 0; i < 5000; i++)
+  {
+    metric_frame_t in;
+    metric_frame_t out;
+    uint8_t seq = 0;
+    sample_metrics(&in, i);
+    metric_frame_init(&out);
+
+    size_t n = telemetry_frame_encode(&in, (uint8_t)i, wire, sizeof(wire));
+    CHECK(n > 2 && n <= TELEMETRY_FRAME_WIRE_MAX);
+    CHECK(wire[0] == 0 && wire[n - 1] == 0);
+    CHECK(memchr(wire + 1, 0, n - 2) == NULL);
+    CHECK_EQ_INT(decode_wire(wire, n, &out, &seq), ESP_OK);
+    CHECK_EQ_INT(seq, (uint8_t)i);
+    CHECK(same_builtins(&in, &out));
+  }
+
+  // The frame carries every built-in number and nothing else
+  metric_frame_t out;
+  metric_frame_init(&out);
+  metric_frame_mark_updated(&out, METRIC_BUILTIN_COUNT);
+  CHECK_EQ_INT(decode_wire(wire, telemetry_frame_encode(&out, 0, wire, sizeof(wire)), &out, NULL), ESP_OK);
+  for (metric_id_t id = 0; id <= METRIC_BUILTIN_COUNT; id++)
+  {
+    bool numeric = id < METRIC_BUILTIN_COUNT && id != METRIC_CPU_NAME && id != METRIC_GPU_NAME;
+    CHECK(metric_frame_is_updated(&out, id) == numeric);
+  }
+
+  CHECK_EQ_INT(telemetry_frame_encode(NULL, 0, wire, TELEMETRY_FRAME_WIRE_MAX - 1), 0);
+}
+
+static void test_saturation(void)
+{
+  uint8_t wire[TELEMETRY_FRAME_WIRE_MAX];
+  metric_frame_t in;
+  metric_frame_t out;
+
+  metric_frame_init(&in);
+  in.values[METRIC_CPU_USAGE] = -5;
+  in.values[METRIC_CPU_TEMP] = 300;
+  in.values[METRIC_CPU_FAN] = 70000;
+  in.values[METRIC_MEM_TOTAL] = 1000; // 100000 hundredths > UINT16_MAX
+  // Everything else is NAN and goes out as 0
+
+  size_t n = telemetry_frame_encode(&in, 0, wire, sizeof(wire));
+  metric_frame_init(&out);
+  CHECK_EQ_INT(decode_wire(wire, n, &out, NULL), ESP_OK);
+  CHECK(out.values[METRIC_CPU_USAGE] == 0);
+  CHECK(out.values[METRIC_CPU_TEMP] == 255);
+  CHECK(out.values[METRIC_CPU_FAN] == 65535);
+  CHECK(out.values[METRIC_MEM_TOTAL] == 655.35f);
+  CHECK(out.values[METRIC_GPU_TEMP] == 0);
+}
+
+static void test_corruption(void)
+{
+  uint8_t wire[TELEMETRY_FRAME_WIRE_MAX];
+  uint8_t raw[TELEMETRY_FRAME_SIZE];
+  uint8_t rec[TELEMETRY_COBS_MAX(TELEMETRY_FRAME_SIZE)];
+  metric_frame_t in;
+  sample_metrics(&in, 1234);
+
+  size_t n = telemetry_frame_encode(&in, 7, wire, sizeof(wire));
+  CHECK_EQ_INT(telemetry_frame_cobs_decode(wire + 1, n - 2, raw, sizeof(raw)), TELEMETRY_FRAME_SIZE);
+
+  // Every single-bit error is caught; the version byte is checked first
+  for (size_t byte = 0; byte < TELEMETRY_FRAME_SIZE; byte++)
+  {
+    for (int bit = 0; bit < 8; bit++)
+    {
+      metric_frame_t out;
+      metric_frame_init(&out);
+      metric_frame_t untouched = out;
+
+      raw[byte] ^= (uint8_t)(1 << bit);
+      size_t len = telemetry_frame_cobs_encode(raw, sizeof(raw), rec, sizeof(rec));
+      esp_err_t ret = telemetry_frame_decode(rec, len, &out, NULL);
+      raw[byte] ^= (uint8_t)(1 << bit);
+
+      CHECK_EQ_INT(ret, byte == 0 ? ESP_ERR_NOT_SUPPORTED : ESP_ERR_INVALID_CRC);
+      CHECK(memcmp(&out, &untouched, sizeof(out)) == 0);
+    }
+  }
+}
+
+static void test_version_and_size(void)
+{
+  uint8_t raw[64] = {0};
+  uint8_t rec[TELEMETRY_COBS_MAX(sizeof(raw))];
+  metric_frame_t out;
+  metric_frame_init(&out);
+
+  // A future version with a different length is unsupported, not corrupt
+  raw[0] = TELEMETRY_FRAME_VERSION + 1;
+  for (size_t len = 1; len <= sizeof(raw); len++)
+  {
+    size_t n = telemetry_frame_cobs_encode(raw, len, rec, sizeof(rec));
+    CHECK_EQ_INT(telemetry_frame_decode(rec, n, &out, NULL), ESP_ERR_NOT_SUPPORTED);
+  }
+
+  // Version 1 must be exactly TELEMETRY_FRAME_SIZE bytes
+  raw[0] = TELEMETRY_FRAME_VERSION;
+  size_t n = telemetry_frame_cobs_encode(raw, TELEMETRY_FRAME_SIZE - 1, rec, sizeof(rec));
+  CHECK_EQ_INT(telemetry_frame_decode(rec, n, &out, NULL), ESP_ERR_INVALID_SIZE);
+  n = telemetry_frame_cobs_encode(raw, TELEMETRY_FRAME_SIZE + 1, rec, sizeof(rec));
+  CHECK_EQ_INT(telemetry_frame_decode(rec, n, &out, NULL), ESP_ERR_INVALID_SIZE);
+
+  // Malformed COBS
+  static const uint8_t overrun[] = {0x05, 0x01, 0x02};
+  static const uint8_t zero_code[] = {0x02, 0x01, 0x00, 0x01};
+  CHECK_EQ_INT(telemetry_frame_decode(overrun, sizeof(overrun), &out, NULL), ESP_ERR_INVALID_SIZE);
+  CHECK_EQ_INT(telemetry_frame_decode(zero_code, sizeof(zero_code), &out, NULL), ESP_ERR_INVALID_SIZE);
+  CHECK_EQ_INT(telemetry_frame_decode(rec, 0, &out, NULL), ESP_ERR_INVALID_SIZE);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// COBS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void cobs_round_trip(const uint8_t *in, size_t len)
+{
+  static uint8_t enc[2048];
+  static uint8_t dec[2048];
+
+  size_t n = telemetry_frame_cobs_encode(in, len, enc, sizeof(enc));
+  CHECK(n > 0 && n <= TELEMETRY_COBS_MAX(len));
+  CHECK(memchr(enc, 0, n) == NULL);
+  CHECK_EQ_INT(telemetry_frame_cobs_decode(enc, n, dec, sizeof(dec)), len);
+  CHECK(memcmp(in, dec, len) == 0);
+
+  // Too small on either side fails instead of truncating
+  CHECK_EQ_INT(telemetry_frame_cobs_encode(in, len, enc, TELEMETRY_COBS_MAX(len) - 1), 0);
+  if (len > 0)
+    CHECK_EQ_INT(telemetry_frame_cobs_decode(enc, n, dec, len - 1), 0);
+}
+
+static void test_cobs(void)
+{
+  static uint8_t buf[1200];
+  static const size_t lengths[] = {1, 2, 253, 254, 255, 256, 507, 508, 509, 1016, 1200};
+  uint32_t rng = 0x9E3779B9;
+
+  // Runs of zeros, including all-zero buffers
+  memset(buf, 0, sizeof(buf));
+  for (size_t len = 1; len <= 600; len++)
+    cobs_round_trip(buf, len);
+
+  // Non-zero runs around the 254-byte block limit
+  memset(buf, 0xA5, sizeof(buf));
+  for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    cobs_round_trip(buf, lengths[i]);
+
+  // A zero right at, before and after a block boundary
+  for (size_t pos = 250; pos < 260; pos++)
+  {
+    memset(buf, 0x5A, 600);
+    buf[pos] = 0;
+    cobs_round_trip(buf, 600);
+  }
+
+  // Exactly 254 non-zero bytes is one full block and a trailing empty block
+  uint8_t enc[TELEMETRY_COBS_MAX(254)];
+  memset(buf, 0x11, 254);
+  CHECK_EQ_INT(telemetry_frame_cobs_encode(buf, 254, enc, sizeof(enc)), 256);
+  CHECK(enc[0] == 0xFF && enc[255] == 0x01);
+
+  // Random buffers with varying zero density
+  for (int round = 0; round < 2000; round++)
+  {
+    size_t len = 1 + host_test_rand(&rng) % sizeof(buf);
+    uint32_t density = host_test_rand(&rng) % 4;
+    for (size_t i = 0; i < len; i++)
+    {
+      uint32_t r = host_test_rand(&rng);
+      buf[i] = (r >> 8) % 8 < density ? 0 : (uint8_t)r;
+    }
+    cobs_round_trip(buf, len);
+  }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MIXED STREAMS THROUGH THE FRAMER
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct
+{
+  serial_record_type_t type;
+  size_t offset; ///< Text: payload offset in the stream. Binary: sequence number
+  size_t len;    ///< Text payload length
+} expected_t;
+
+typedef struct
+{
+  uint8_t *data;
+  size_t len;
+  size_t cap;
+  expected_t *expected;
+  size_t count;
+} stream_t;
+
+static void stream_put(stream_t *s, const void *data, size_t len)
+{
+  if (s->len + len > s->cap)
+  {
+    s->cap = (s->len + len) * 2;
+    s->data = realloc(s->data, s->cap);
+  }
+  memcpy(s->data + s->len, data, len);
+  s->len += len;
+}
+
+static void stream_text(stream_t *s, const char *line, size_t len, bool crlf, bool stray_zero)
+{
+  if (stray_zero)
+    stream_put(s, "", 1); // A lone opening delimiter: the framer resyncs on '{'
+  s->expected[s->count++] = (expected_t){SERIAL_RECORD_TEXT, s->len, len};
+  stream_put(s, line, len);
+  stream_put(s, crlf ? "\r\n" : "\n", crlf ? 2 : 1);
+}
+
+static void stream_frame(stream_t *s, unsigned i)
+{
+  uint8_t wire[TELEMETRY_FRAME_WIRE_MAX];
+  metric_frame_t m;
+  sample_metrics(&m, i);
+  size_t n = telemetry_frame_encode(&m, (uint8_t)i, wire, sizeof(wire));
+  s->expected[s->count++] = (expected_t){SERIAL_RECORD_BINARY, i, 0};
+  stream_put(s, wire, n);
+}
+
+static void build_stream(stream_t *s, char **lines, size_t *line_lens, size_t line_count, uint32_t *rng)
+{
+  s->expected = calloc(STREAM_RECORDS, sizeof(*s->expected));
+  for (unsigned i = 0; i < STREAM_RECORDS; i++)
+  {
+    if (host_test_rand(rng) % 2)
+    {
+      size_t k = host_test_rand(rng) % line_count;
+      bool crlf = host_test_rand(rng) % 4 == 0;
+      // Only a JSON line can follow a stray delimiter: other text stays binary
+      bool stray_zero = lines[k][0] == '{' && host_test_rand(rng) % 16 == 0;
+      stream_text(s, lines[k], line_lens[k], crlf, stray_zero);
+    }
+    else
+    {
+      stream_frame(s, i);
+    }
+  }
+}
+
+static void check_record(const stream_t *s, size_t index, const char *data, size_t len,
+                         serial_record_type_t type)
+{
+  if (index >= s->count)
+  {
+    CHECK(index < s->count);
+    return;
+  }
+
+  const expected_t *e = &s->expected[index];
+  CHECK_EQ_INT(type, e->type);
+  if (type != e->type)
+    return;
+
+  if (type == SERIAL_RECORD_TEXT)
+  {
+    CHECK_EQ_INT(len, e->len);
+    CHECK(len == e->len && memcmp(data, s->data + e->offset, len) == 0);
+    return;
+  }
+
+  metric_frame_t expected;
+  metric_frame_t out;
+  uint8_t seq = 0;
+  sample_metrics(&expected, (unsigned)e->offset);
+  metric_frame_init(&out);
+  CHECK_EQ_INT(telemetry_frame_decode((const uint8_t *)data, len, &out, &seq), ESP_OK);
+  CHECK_EQ_INT(seq, (uint8_t)e->offset);
+  CHECK(same_builtins(&expected, &out));
+}
+
+/**
+ * @brief Feed the stream in random chunks, checking every record in order
+ */
+static void replay_stream(const stream_t *s, uint32_t *rng)
+{
+  serial_line_framer_t framer;
+  CHECK_EQ_INT(serial_line_framer_init(&framer, RING_SIZE, MAX_LINE), ESP_OK);
+
+  size_t pos = 0;
+  size_t index = 0;
+  while (pos < s->len)
+  {
+    uint8_t *dst;
+    size_t space = serial_line_framer_write_ptr(&framer, &dst);
+    CHECK(space > 0);
+    if (space == 0)
+      break;
+
+    size_t chunk = 1 + host_test_rand(rng) % MAX_CHUNK;
+    if (chunk > space)
+      chunk = space;
+    if (chunk > s->len - pos)
+      chunk = s->len - pos;
+    memcpy(dst, s->data + pos, chunk);
+    serial_line_framer_commit(&framer, chunk);
+    pos += chunk;
+
+    const char *data;
+    size_t len;
+    serial_record_type_t type;
+    while (serial_line_framer_next(&framer, &data, &len, &type))
+    {
+      check_record(s, index++, data, len, type);
+    }
+  }
+
+  CHECK_EQ_INT(index, s->count);
+  CHECK_EQ_INT(framer.overflow, 0);
+  serial_line_framer_deinit(&framer);
+}
+
+static void test_mixed_stream(const char *path)
+{
+  static const char *const builtin[] = {
+      "{\"cpu\":{\"usage\":1}}",
+      "{\"ts\":1755165600000,\"gpu\":{\"usage\":83,\"temp\":33,\"name\":\"RTX\"}}",
+      "LOG level W",
+      "{}",
+  };
+  char *lines[256];
+  size_t lens[256];
+  size_t count = 0;
+  char *file = NULL;
+
+  if (path)
+  {
+    size_t file_len;
+    file = host_test_read_file(path, &file_len);
+    CHECK(file != NULL);
+    for (char *p = file; file && p < file + file_len && count < 252;)
+    {
+      char *nl = memchr(p, '\n', (size_t)(file + file_len - p));
+      size_t n = nl ? (size_t)(nl - p) : (size_t)(file + file_len - p);
+      if (n > 0 && n <= MAX_LINE)
+      {
+        lines[count] = p;
+        lens[count++] = n;
+      }
+      p += n + 1;
+    }
+  }
+  for (size_t i = 0; i < sizeof(builtin) / sizeof(builtin[0]); i++)
+  {
+    lines[count] = (char *)builtin[i];
+    lens[count++] = strlen(builtin[i]);
+  }
+
+  uint32_t rng = 0xC0B5F00D;
+  for (int seed = 0; seed < STREAM_SEEDS; seed++)
+  {
+    stream_t s = {0};
+    build_stream(&s, lines, lens, count, &rng);
+    replay_stream(&s, &rng);
+    free(s.data);
+    free(s.expected);
+  }
+  free(file);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MAIN
+// ═══════════════════════════════════════════════════════════════════════════════
+
+int main(int argc, char **argv)
+{
+  CHECK(metric_registry_init() == ESP_OK);
+
+  test_round_trip();
+  test_saturation();
+  test_corruption();
+  test_version_and_size();
+  test_cobs();
+  test_mixed_stream(argc > 1 ? argv[1] : NULL);
+
+  return host_test_result("telemetry_frame");
+}
@@ -0,0 +1,513 @@
+/**
+ * @file test_telemetry_parser.c
+ * @brief Host tests for the telemetry JSON parser
+ *
+ * Usage: test_telemetry_parser <corpus dir> [recorded .jsonl ...]
+ *
+ * Besides the unit cases, every corpus file is parsed (valid_* must be
+ * accepted, invalid_* rejected) and then mutated a few thousand times with a
+ * fixed seed. The mutated inputs only check the parser's invariants: no
+ * crash or out-of-bounds access (build with HOST_TEST_SANITIZE), the frame
+ * untouched on failure, and no registry slot spent on a rejected line.
+ */
+
+#include "host_test.h"
+#include "telemetry_parser.h"
+
+#include <dirent.h>
+#include <math.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define MUTATIONS_PER_SEED 3000
+#define MAX_MUTATION_OPS 4
+#define MAX_INPUT_LEN 8192
+
+/** Candidate keys searched for an FNV-1a collision */
+#define COLLISION_CANDIDATES 400000
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static metric_frame_t frame;
+
+static bool parse(const char *json)
+{
+  return telemetry_parse_json(json, strlen(json), &frame);
+}
+
+static metric_id_t lookup(const char *path)
+{
+  size_t len = strlen(path);
+  return metric_registry_lookup(path, len, metric_hash_extend(METRIC_HASH_INIT, path, len));
+}
+
+static float value_of(const char *path)
+{
+  metric_id_t id = lookup(path);
+  return id == METRIC_ID_INVALID ? NAN : frame.values[id];
+}
+
+static bool has_prefix(const char *s, const char *prefix)
+{
+  return strncmp(s, prefix, strlen(prefix)) == 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// UNIT CASES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void test_builtin_fields(void)
+{
+  metric_frame_init(&frame);
+  CHECK(parse("{\"ts\":1755165600000,\"cpu\":{\"usage\":32.8,\"temp\":47,\"fan\":1408,\"name\":\"Ryzen\"},"
+              "\"gpu\":{\"usage\":83,\"temp\":33,\"name\":\"RTX\",\"mem_used\":3273,\"mem_total\":24564},"
+              "\"mem\":{\"usage\":88,\"used\":16.33,\"total\":63.15,\"avail\":46.82}}"));
+
+  CHECK_EQ_INT(frame.timestamp, 1755165600000ULL);
+  CHECK(fabsf(frame.values[METRIC_CPU_USAGE] - 32.8f) < 1e-4f);
+  CHECK_EQ_INT(frame.values[METRIC_CPU_TEMP], 47);
+  CHECK_EQ_INT(frame.values[METRIC_CPU_FAN], 1408);
+  CHECK(strcmp(metric_frame_string(&frame, METRIC_CPU_NAME), "Ryzen") == 0);
+  CHECK_EQ_INT(frame.values[METRIC_GPU_USAGE], 83);
+  CHECK(strcmp(metric_frame_string(&frame, METRIC_GPU_NAME), "RTX") == 0);
+  CHECK_EQ_INT(frame.values[METRIC_GPU_MEM_TOTAL], 24564);
+  CHECK(fabsf(frame.values[METRIC_MEM_AVAIL] - 46.82f) < 1e-4f);
+  CHECK_EQ_INT(frame.count, metric_registry_count());
+}
+
+static void test_missing_values_keep_previous(void)
+{
+  float temp = frame.values[METRIC_CPU_TEMP];
+
+  CHECK(parse("{\"cpu\":{\"usage\":5}}"));
+  CHECK_EQ_INT(frame.values[METRIC_CPU_USAGE], 5);
+  CHECK(frame.values[METRIC_CPU_TEMP] == temp);
+  CHECK(strcmp(metric_frame_string(&frame, METRIC_CPU_NAME), "Ryzen") == 0);
+  // No "ts": stamped with the local clock instead
+  CHECK(frame.timestamp != 1755165600000ULL && frame.timestamp > 0);
+}
+
+static void test_updated_marks(void)
+{
+  // Only what the line carries is marked; null, wrong-typed and missing
+  // values keep their previous value unmarked
+  CHECK(parse("{\"cpu\":{\"usage\":7,\"temp\":null,\"name\":\"Ryzen\",\"fan\":\"fast\"},\"gpu\":{\"name\":1}}"));
+  for (metric_id_t id = 0; id < METRIC_BUILTIN_COUNT; id++)
+  {
+    CHECK(metric_frame_is_updated(&frame, id) == (id == METRIC_CPU_USAGE || id == METRIC_CPU_NAME));
+  }
+
+  // New paths are marked by the registering pass
+  CHECK(parse("{\"upd\":{\"new\":3},\"mem\":{\"usage\":40}}"));
+  CHECK(metric_frame_is_updated(&frame, lookup("upd.new")));
+  CHECK(metric_frame_is_updated(&frame, METRIC_MEM_USAGE));
+  CHECK(!metric_frame_is_updated(&frame, METRIC_CPU_USAGE));
+  CHECK(!metric_frame_is_updated(&frame, METRIC_ID_INVALID));
+
+  CHECK(parse("{}"));
+  for (metric_id_t id = 0; id < METRIC_MAX; id++)
+  {
+    CHECK(!metric_frame_is_updated(&frame, id));
+  }
+}
+
+static void test_rejected_line_leaves_frame(void)
+{
+  static const char *const lines[] = {
+      "{\"cpu\":{\"usage\":99,\"temp\":",
+      "{\"cpu\":{\"usage\":99}}{\"cpu\":{\"usage\":98}}",
+      "{\"cpu\":{\"usage\":99},\"new.path\":1,}",
+  };
+  metric_frame_t before = frame;
+  uint16_t count = metric_registry_count();
+
+  for (size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); i++)
+  {
+    CHECK(!parse(lines[i]));
+    CHECK(memcmp(&before, &frame, sizeof(frame)) == 0);
+  }
+  CHECK_EQ_INT(metric_registry_count(), count);
+}
+
+static void test_surrounding_bytes(void)
+{
+  static const char with_nul[] = "{\"cpu\":{\"usage\":1}}";
+
+  CHECK(parse(" \t{\"cpu\":{\"usage\":1}}\r\n "));
+  CHECK(!parse("{\"cpu\":{\"usage\":1}}x"));
+  CHECK(!parse("{\"cpu\":{\"usage\":1}},"));
+  CHECK(!parse("{\"cpu\":{\"usage\":1}}}"));
+  // A terminator counted into the length is not whitespace
+  CHECK(!telemetry_parse_json(with_nul, sizeof(with_nul), &frame));
+}
+
+static void test_strings(void)
+{
+  char json[128];
+
+  // 30 ASCII bytes, then a 2-byte sequence that does not fit in 31
+  snprintf(json, sizeof(json), "{\"cpu\":{\"name\":\"%s\xC3\xA9tail\"}}", "012345678901234567890123456789");
+  CHECK(parse(json));
+  CHECK(strcmp(metric_frame_string(&frame, METRIC_CPU_NAME), "012345678901234567890123456789") == 0);
+
+  // Every escape, including \u in the 1-, 2- and 3-byte UTF-8 ranges
+  snprintf(json, sizeof(json), "{\"cpu\":{\"name\":\"q\\\" b\\\\ s\\/ \\b\\f\\n\\r\\t %cu00e9%cu2122%cu0041\"}}",
+           '\\', '\\', '\\');
+  CHECK(parse(json));
+  CHECK(strcmp(metric_frame_string(&frame, METRIC_CPU_NAME),
+               "q\" b\\ s/ \b\f\n\r\t \xC3\xA9\xE2\x84\xA2"
+               "A") == 0);
+
+  // A number where a string metric lives is ignored, not converted
+  CHECK(parse("{\"cpu\":{\"name\":42,\"usage\":\"high\"}}"));
+  CHECK(strcmp(metric_frame_string(&frame, METRIC_CPU_NAME), "q\" b\\ s/ \b\f\n\r\t \xC3\xA9\xE2\x84\xA2"
+                                                             "A") == 0);
+}
+
+static void test_numbers(void)
+{
+  CHECK(parse("{\"n\":{\"a\":-0,\"b\":0.5,\"c\":1e3,\"d\":1E-3,\"e\":-1.5e+2,\"f\":12345678901234567890,"
+              "\"g\":1e400,\"t\":true,\"u\":false,\"v\":null}}"));
+  CHECK(value_of("n.a") == 0 && signbit(value_of("n.a")));
+  CHECK(value_of("n.b") == 0.5f);
+  CHECK(value_of("n.c") == 1000);
+  CHECK(fabsf(value_of("n.d") - 0.001f) < 1e-9f);
+  CHECK(value_of("n.e") == -150);
+  CHECK(fabsf(value_of("n.f") / 1.2345678901234567e19f - 1) < 1e-6f);
+  CHECK(isinf(value_of("n.g")));
+  CHECK(value_of("n.t") == 1);
+  CHECK(value_of("n.u") == 0);
+  CHECK(lookup("n.v") == METRIC_ID_INVALID);
+}
+
+static void test_dynamic_paths(void)
+{
+  CHECK(parse("{\"cpu\":{\"cores\":[10,20,30.5]},\"gpu\":[{\"temp\":40},{\"temp\":50,\"name\":\"iGPU\"}],"
+              "\"disk\":[{\"load\":7}],\"net\":{\"eth0\":{\"rx_kbps\":1.5}},\"on_battery\":true}"));
+
+  CHECK(value_of("cpu.cores.2") == 30.5f);
+  CHECK(value_of("gpu.1.temp") == 50);
+  CHECK(value_of("disk.0.load") == 7);
+  CHECK(value_of("net.eth0.rx_kbps") == 1.5f);
+  CHECK(value_of("on_battery") == 1);
+  CHECK(strcmp(metric_frame_string(&frame, lookup("gpu.1.name")), "iGPU") == 0);
+
+  const metric_desc_t *desc = metric_registry_get(lookup("gpu.1.temp"));
+  CHECK(desc != NULL && desc->unit == METRIC_UNIT_CELSIUS);
+  desc = metric_registry_get(lookup("disk.0.load"));
+  CHECK(desc != NULL && desc->unit == METRIC_UNIT_PERCENT);
+
+  // Paths that do not fit METRIC_PATH_LEN are accepted but never registered
+  uint16_t count = metric_registry_count();
+  CHECK(parse("{\"a_very_long_section_name\":{\"and_an_even_longer_leaf_name\":1}}"));
+  CHECK_EQ_INT(metric_registry_count(), count);
+}
+
+/**
+ * @brief Once the string slots are used up, only string paths stop registering
+ */
+static void test_string_slots_full(void)
+{
+  char json[64];
+  char path[32];
+  for (int i = 0; metric_registry_can_register(METRIC_TYPE_STRING) && i < METRIC_STRING_SLOTS; i++)
+  {
+    snprintf(json, sizeof(json), "{\"slot\":{\"s%d\":\"x\"}}", i);
+    snprintf(path, sizeof(path), "slot.s%d", i);
+    CHECK(parse(json));
+    CHECK(lookup(path) != METRIC_ID_INVALID);
+  }
+  CHECK(!metric_registry_can_register(METRIC_TYPE_STRING));
+  CHECK(metric_registry_can_register(METRIC_TYPE_NUMBER));
+
+  // A new string path is accepted and dropped
+  uint16_t count = metric_registry_count();
+  CHECK(parse("{\"slot\":{\"late\":\"x\"}}"));
+  CHECK_EQ_INT(metric_registry_count(), count);
+  CHECK(lookup("slot.late") == METRIC_ID_INVALID);
+
+  // Next to it, a new number still registers
+  CHECK(parse("{\"slot\":{\"later\":\"x\",\"n\":5}}"));
+  CHECK_EQ_INT(metric_registry_count(), count + 1);
+  CHECK(value_of("slot.n") == 5);
+  CHECK(lookup("slot.later") == METRIC_ID_INVALID);
+}
+
+typedef struct
+{
+  uint32_t hash;
+  uint32_t n;
+} candidate_t;
+
+static int compare_candidates(const void *a, const void *b)
+{
+  const candidate_t *x = a;
+  const candidate_t *y = b;
+  if (x->hash != y->hash)
+    return x->hash < y->hash ? -1 : 1;
+  return x->n < y->n ? -1 : x->n > y->n;
+}
+
+/**
+ * @brief Two top-level keys with the same FNV-1a hash stay two metrics
+ */
+static void test_hash_collision(void)
+{
+  candidate_t *candidates = malloc(COLLISION_CANDIDATES * sizeof(*candidates));
+  char a[16];
+  char b[16];
+  bool found = false;
+
+  for (uint32_t n = 0; n < COLLISION_CANDIDATES; n++)
+  {
+    int len = snprintf(a, sizeof(a), "k%u", n);
+    candidates[n] = (candidate_t){metric_hash_extend(METRIC_HASH_INIT, a, (size_t)len), n};
+  }
+  qsort(candidates, COLLISION_CANDIDATES, sizeof(*candidates), compare_candidates);
+  for (uint32_t i = 1; i < COLLISION_CANDIDATES && !found; i++)
+  {
+    if (candidates[i].hash == candidates[i - 1].hash)
+    {
+      snprintf(a, sizeof(a), "k%u", candidates[i - 1].n);
+      snprintf(b, sizeof(b), "k%u", candidates[i].n);
+      found = true;
+    }
+  }
+  free(candidates);
+
+  CHECK(found);
+  if (!found)
+    return;
+
+  char json[64];
+  snprintf(json, sizeof(json), "{\"%s\":1,\"%s\":2}", a, b);
+  CHECK(parse(json));
+  CHECK(lookup(a) != METRIC_ID_INVALID && lookup(b) != METRIC_ID_INVALID);
+  CHECK(lookup(a) != lookup(b));
+  CHECK(value_of(a) == 1);
+  CHECK(value_of(b) == 2);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CORPUS AND RECORDED PAYLOADS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct
+{
+  char *data;
+  size_t len;
+  bool valid;
+} seed_t;
+
+static seed_t seeds[128];
+static size_t seed_count = 0;
+
+static void load_corpus(const char *dir)
+{
+  DIR *d = opendir(dir);
+  CHECK(d != NULL);
+  if (!d)
+    return;
+
+  struct dirent *entry;
+  while ((entry = readdir(d)) != NULL && seed_count < sizeof(seeds) / sizeof(seeds[0]))
+  {
+    bool valid = has_prefix(entry->d_name, "valid_");
+    if (!valid && !has_prefix(entry->d_name, "invalid_"))
+      continue;
+
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+    seed_t *seed = &seeds[seed_count];
+    seed->data = host_test_read_file(path, &seed->len);
+    seed->valid = valid;
+    CHECK(seed->data != NULL);
+    if (!seed->data)
+      continue;
+
+    uint16_t count = metric_registry_count();
+    bool ok = telemetry_parse_json(seed->data, seed->len, &frame);
+    if (ok != valid)
+    {
+      fprintf(stderr, "%s: %s\n", entry->d_name, ok ? "accepted" : "rejected");
+    }
+    CHECK(ok == valid);
+    if (!valid)
+      CHECK_EQ_INT(metric_registry_count(), count);
+    seed_count++;
+  }
+  closedir(d);
+
+  CHECK(seed_count > 0);
+  printf("corpus: %zu seeds\n", seed_count);
+}
+
+static void test_recorded(const char *path)
+{
+  size_t len;
+  char *data = host_test_read_file(path, &len);
+  CHECK(data != NULL);
+  if (!data)
+    return;
+
+  unsigned lines = 0;
+  unsigned rejected = 0;
+  for (char *line = data; line < data + len;)
+  {
+    char *nl = memchr(line, '\n', (size_t)(data + len - line));
+    size_t line_len = nl ? (size_t)(nl - line) : (size_t)(data + len - line);
+    if (line_len > 0)
+    {
+      lines++;
+      if (!telemetry_parse_json(line, line_len, &frame))
+        rejected++;
+    }
+    line += line_len + 1;
+  }
+  free(data);
+
+  printf("%s: %u lines\n", path, lines);
+  CHECK(lines > 0);
+  CHECK_EQ_INT(rejected, 0);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MUTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static size_t mutate(uint32_t *rng, char *buf, size_t len)
+{
+  static const char interesting[] = "{}[]\":,\\-+.eE0 \t\nu";
+  int ops = 1 + (int)(host_test_rand(rng) % MAX_MUTATION_OPS);
+
+  for (int i = 0; i < ops; i++)
+  {
+    size_t pos = len ? host_test_rand(rng) % len : 0;
+    switch (host_test_rand(rng) % 6)
+    {
+    case 0: // random byte
+      if (len)
+        buf[pos] = (char)host_test_rand(rng);
+      break;
+    case 1: // JSON punctuation
+      if (len)
+        buf[pos] = interesting[host_test_rand(rng) % (sizeof(interesting) - 1)];
+      break;
+    case 2: // delete
+      if (len)
+      {
+        memmove(buf + pos, buf + pos + 1, len - pos - 1);
+        len--;
+      }
+      break;
+    case 3: // insert
+      if (len < MAX_INPUT_LEN)
+      {
+        memmove(buf + pos + 1, buf + pos, len - pos);
+        buf[pos] = interesting[host_test_rand(rng) % (sizeof(interesting) - 1)];
+        len++;
+      }
+      break;
+    case 4: // truncate
+      len = pos;
+      break;
+    default: // duplicate a slice
+    {
+      size_t n = 1 + host_test_rand(rng) % 16;
+      if (pos + n <= len && len + n <= MAX_INPUT_LEN)
+      {
+        memmove(buf + pos + n, buf + pos, len - pos);
+        len += n;
+      }
+      break;
+    }
+    }
+  }
+  return len;
+}
+
+static void test_mutations(void)
+{
+  static char buf[MAX_INPUT_LEN];
+  uint32_t rng = 0x2545F491;
+  unsigned accepted = 0;
+  unsigned total = 0;
+
+  for (size_t s = 0; s < seed_count; s++)
+  {
+    if (!seeds[s].data || seeds[s].len > MAX_INPUT_LEN)
+      continue;
+
+    for (int m = 0; m < MUTATIONS_PER_SEED; m++)
+    {
+      memcpy(buf, seeds[s].data, seeds[s].len);
+      size_t len = mutate(&rng, buf, seeds[s].len);
+
+      metric_frame_t before = frame;
+      uint16_t count = metric_registry_count();
+      bool ok = telemetry_parse_json(buf, len, &frame);
+
+      total++;
+      if (ok)
+      {
+        accepted++;
+        CHECK(frame.count == metric_registry_count());
+      }
+      else
+      {
+        CHECK(memcmp(&before, &frame, sizeof(frame)) == 0);
+        CHECK(metric_registry_count() == count);
+      }
+      CHECK(metric_registry_count() <= METRIC_MAX);
+    }
+  }
+  printf("mutations: %u inputs, %u accepted\n", total, accepted);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MAIN
+// ═══════════════════════════════════════════════════════════════════════════════
+
+int main(int argc, char **argv)
+{
+  if (argc < 2)
+  {
+    fprintf(stderr, "usage: %s <corpus dir> [recorded.jsonl ...]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  CHECK(metric_registry_init() == ESP_OK);
+
+  test_builtin_fields();
+  test_missing_values_keep_previous();
+  test_updated_marks();
+  test_rejected_line_leaves_frame();
+  test_surrounding_bytes();
+  test_strings();
+  test_numbers();
+  test_dynamic_paths();
+  test_hash_collision();
+
+  for (int i = 2; i < argc; i++)
+  {
+    test_recorded(argv[i]);
+  }
+
+  // Uses up the string slots, so after everything that needs them
+  test_string_slots_full();
+
+  // Last: the mutations fill the registry with junk paths
+  load_corpus(argv[1]);
+  test_mutations();
+
+  for (size_t s = 0; s < seed_count; s++)
+  {
+    free(seeds[s].data);
+  }
+  return host_test_result("telemetry_parser");
+}
@@ -0,0 +1,220 @@
+/**
+ * @file bench_ha_gzip.c
+ * @brief Bytes on the wire and decode time of gzip-compressed /api/states
+ *
+ * Usage: bench_ha_gzip [dump.json ...]
+ *
+ * Without arguments, synthetic dumps of 100 KB, 500 KB and 2 MB are
+ * generated (see states_dump.h); they repeat more than real dumps, so their
+ * compression ratio is optimistic. Each dump is gzip-compressed at the zlib
+ * default level and reported with:
+ * - raw and compressed size, and the number of 1436-byte TCP segments each
+ *   needs;
+ * - time to parse the plain body, to inflate the compressed one, and to
+ *   inflate it straight into the parser as ha_api does, all fed in
+ *   1436-byte chunks.
+ *
+ * Inflating here runs on zlib (see stubs/rom/miniz.h), not the ROM tinfl,
+ * so only the sizes carry over to the device as they are; the times rank
+ * the paths.
+ */
+
+#include "host_test.h"
+#include "ha_gzip.h"
+#include "ha_states_parser.h"
+#include "states_dump.h"
+
+#include <string.h>
+#include <zlib.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define BENCH_MIN_NS 500000000ULL ///< Minimum measured time per path and dump
+#define SEGMENT 1436              ///< TCP payload per segment, and the chunk size fed
+#define GZIP_LEVEL Z_DEFAULT_COMPRESSION
+
+static const size_t generated_sizes[] = {100 * 1000, 500 * 1000, 2000 * 1000};
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PATHS UNDER TEST
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct
+{
+  const uint8_t *plain;
+  size_t plain_len;
+  const uint8_t *gz;
+  size_t gz_len;
+} dump_ref_t;
+
+typedef bool (*decode_fn_t)(const dump_ref_t *dump);
+
+static ha_gzip_t *gzip;
+static ha_states_parser_t parser;
+static ha_entity_state_t states[STATES_DUMP_WANTED];
+static volatile size_t sink_bytes; ///< Keeps the no-op sink from being optimized out
+
+static void discard_sink(void *ctx, const char *data, size_t len)
+{
+  (void)ctx;
+  (void)data;
+  sink_bytes += len;
+}
+
+static void parser_sink(void *ctx, const char *data, size_t len)
+{
+  ha_states_parser_feed(ctx, data, len);
+}
+
+static bool parse_plain(const dump_ref_t *dump)
+{
+  ha_states_parser_init(&parser, states_dump_wanted, STATES_DUMP_WANTED, states);
+  for (size_t pos = 0; pos < dump->plain_len; pos += SEGMENT)
+  {
+    size_t n = dump->plain_len - pos < SEGMENT ? dump->plain_len - pos : SEGMENT;
+    ha_states_parser_feed(&parser, (const char *)dump->plain + pos, n);
+  }
+  return !parser.error;
+}
+
+static bool inflate_to(const dump_ref_t *dump, ha_gzip_sink_t sink, void *ctx)
+{
+  ha_gzip_reset(gzip, sink, ctx);
+  for (size_t pos = 0; pos < dump->gz_len; pos += SEGMENT)
+  {
+    size_t n = dump->gz_len - pos < SEGMENT ? dump->gz_len - pos : SEGMENT;
+    if (ha_gzip_feed(gzip, dump->gz + pos, n) != ESP_OK)
+      return false;
+  }
+  return ha_gzip_finish(gzip) == ESP_OK;
+}
+
+static bool inflate_only(const dump_ref_t *dump)
+{
+  return inflate_to(dump, discard_sink, NULL);
+}
+
+static bool inflate_and_parse(const dump_ref_t *dump)
+{
+  ha_states_parser_init(&parser, states_dump_wanted, STATES_DUMP_WANTED, states);
+  return inflate_to(dump, parser_sink, &parser) && !parser.error;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// BENCHMARK
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @return Nanoseconds per decode, or 0 if the dump was rejected
+ */
+static double run(decode_fn_t decode, const dump_ref_t *dump)
+{
+  if (!decode(dump))
+    return 0;
+
+  uint64_t start = host_test_now_ns();
+  uint64_t elapsed;
+  size_t passes = 0;
+  do
+  {
+    decode(dump);
+    passes++;
+    elapsed = host_test_now_ns() - start;
+  } while (elapsed < BENCH_MIN_NS);
+
+  return (double)elapsed / (double)passes;
+}
+
+static int bench_dump(const char *name, const uint8_t *plain, size_t len)
+{
+  uLongf gz_cap = compressBound((uLong)len) + 64;
+  uint8_t *gz = malloc(gz_cap);
+  z_stream z = {0};
+  deflateInit2(&z, GZIP_LEVEL, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+  z.next_in = (Bytef *)plain;
+  z.avail_in = (uInt)len;
+  z.next_out = gz;
+  z.avail_out = (uInt)gz_cap;
+  deflate(&z, Z_FINISH);
+  size_t gz_len = gz_cap - z.avail_out;
+  deflateEnd(&z);
+
+  dump_ref_t dump = {plain, len, gz, gz_len};
+  printf("%s\n", name);
+  printf("  on the wire  plain %8zu bytes %5zu segments   gzip %7zu bytes %4zu segments   %.1f%%\n", len,
+         (len + SEGMENT - 1) / SEGMENT, gz_len, (gz_len + SEGMENT - 1) / SEGMENT, 100.0 * (double)gz_len / (double)len);
+
+  static const struct
+  {
+    const char *name;
+    decode_fn_t fn;
+  } paths[] = {
+      {"parse plain", parse_plain},
+      {"inflate", inflate_only},
+      {"inflate+parse", inflate_and_parse},
+  };
+
+  int result = EXIT_SUCCESS;
+  for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++)
+  {
+    double ns = run(paths[i].fn, &dump);
+    if (ns == 0)
+    {
+      fprintf(stderr, "%s: %s failed\n", name, paths[i].name);
+      result = EXIT_FAILURE;
+      continue;
+    }
+    printf("  %-13s %8.2f ms %8.1f MB/s of plain JSON\n", paths[i].name, ns / 1e6, (double)len / ns * 1e3);
+  }
+
+  free(gz);
+  return result;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MAIN
+// ═══════════════════════════════════════════════════════════════════════════════
+
+int main(int argc, char **argv)
+{
+  gzip = ha_gzip_create();
+  if (!gzip)
+    return EXIT_FAILURE;
+
+  int result = EXIT_SUCCESS;
+  if (argc > 1)
+  {
+    for (int i = 1; i < argc; i++)
+    {
+      size_t len;
+      char *text = host_test_read_file(argv[i], &len);
+      if (!text)
+      {
+        fprintf(stderr, "%s: cannot read\n", argv[i]);
+        result = EXIT_FAILURE;
+        continue;
+      }
+      if (bench_dump(argv[i], (const uint8_t *)text, len) != EXIT_SUCCESS)
+        result = EXIT_FAILURE;
+      free(text);
+    }
+  }
+  else
+  {
+    for (size_t s = 0; s < sizeof(generated_sizes) / sizeof(generated_sizes[0]); s++)
+    {
+      states_dump_t dump;
+      char name[64];
+      states_dump_generate(&dump, generated_sizes[s], 0x51A7E + (uint32_t)s, false);
+      snprintf(name, sizeof(name), "generated, %u entities", (unsigned)dump.entities);
+      if (bench_dump(name, (const uint8_t *)dump.text, dump.len) != EXIT_SUCCESS)
+        result = EXIT_FAILURE;
+      free(dump.text);
+    }
+  }
+
+  ha_gzip_destroy(gzip);
+  return result;
+}
@@ -0,0 +1,242 @@
+/**
+ * @file bench_ha_states_parser.c
+ * @brief Throughput of the streaming /api/states parser on large dumps
+ *
+ * Usage: bench_ha_states_parser [dump.json ...]
+ *
+ * Without arguments, synthetic dumps of 100 KB, 500 KB and 2 MB are
+ * generated (see states_dump.h). A recorded dump (curl -H "Authorization:
+ * Bearer ..." http://ha:8123/api/states > dump.json) can be given instead;
+ * the wanted IDs are then the three switches the dashboard syncs, which a
+ * real dump may not contain, but the whole body is scanned either way.
+ *
+ * Each dump is fed in 1436-byte chunks (one TCP segment) and in 64-byte
+ * chunks. With HAVE_CJSON the same dump also goes through what the old
+ * code would have needed to reach every entity: the whole body in one
+ * buffer, cJSON_Parse, a scan of the array, cJSON_Delete. Its peak heap use
+ * is reported next to the parser's fixed state size.
+ *
+ * Host numbers only rank the two paths; the ESP32-S3 is several times
+ * slower, and there the network sets the pace.
+ */
+
+#include "host_test.h"
+#include "ha_states_parser.h"
+#include "states_dump.h"
+
+#include <string.h>
+
+#ifdef HAVE_CJSON
+#include <cJSON.h>
+#include <stddef.h>
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define BENCH_MIN_NS 500000000ULL ///< Minimum measured time per path and dump
+
+static const size_t generated_sizes[] = {100 * 1000, 500 * 1000, 2000 * 1000};
+static const size_t chunk_sizes[] = {1436, 64};
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PATHS UNDER TEST
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct
+{
+  const char *text;
+  size_t len;
+  size_t chunk;
+} dump_ref_t;
+
+typedef int (*parse_fn_t)(const dump_ref_t *dump);
+
+static ha_entity_state_t states[STATES_DUMP_WANTED];
+
+/**
+ * @return Wanted entities found, or -1 if the dump was rejected
+ */
+static int parse_streaming(const dump_ref_t *dump)
+{
+  ha_states_parser_t parser;
+  ha_states_parser_init(&parser, states_dump_wanted, STATES_DUMP_WANTED, states);
+  for (size_t pos = 0; pos < dump->len; pos += dump->chunk)
+  {
+    size_t n = dump->len - pos < dump->chunk ? dump->len - pos : dump->chunk;
+    if (!ha_states_parser_feed(&parser, dump->text + pos, n))
+      return -1;
+  }
+  return ha_states_parser_found_count(&parser);
+}
+
+#ifdef HAVE_CJSON
+
+static size_t heap_now;
+static size_t heap_peak;
+
+/** Allocations carry their size in front so free() can account for them */
+static void *counting_malloc(size_t size)
+{
+  size_t *block = malloc(sizeof(max_align_t) + size);
+  if (!block)
+    return NULL;
+  *block = size;
+  heap_now += size;
+  if (heap_now > heap_peak)
+    heap_peak = heap_now;
+  return (char *)block + sizeof(max_align_t);
+}
+
+static void counting_free(void *ptr)
+{
+  if (!ptr)
+    return;
+  size_t *block = (size_t *)((char *)ptr - sizeof(max_align_t));
+  heap_now -= *block;
+  free(block);
+}
+
+/**
+ * @brief Buffer the whole body, build the tree, scan every entity
+ */
+static int parse_cjson(const dump_ref_t *dump)
+{
+  char *body = counting_malloc(dump->len + 1);
+  for (size_t pos = 0; pos < dump->len; pos += dump->chunk)
+  {
+    size_t n = dump->len - pos < dump->chunk ? dump->len - pos : dump->chunk;
+    memcpy(body + pos, dump->text + pos, n);
+  }
+  body[dump->len] = '\0';
+
+  cJSON *json = cJSON_Parse(body);
+  counting_free(body);
+  if (!json)
+    return -1;
+
+  int found = 0;
+  cJSON *entity;
+  cJSON_ArrayForEach(entity, json)
+  {
+    const char *id = cJSON_GetStringValue(cJSON_GetObjectItem(entity, "entity_id"));
+    for (int i = 0; id && i < STATES_DUMP_WANTED; i++)
+    {
+      const char *state = cJSON_GetStringValue(cJSON_GetObjectItem(entity, "state"));
+      if (strcmp(id, states_dump_wanted[i]) == 0 && state)
+      {
+        strncpy(states[i].state, state, HA_MAX_STATE_LEN - 1);
+        found++;
+      }
+    }
+  }
+  cJSON_Delete(json);
+  return found;
+}
+
+#endif // HAVE_CJSON
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// BENCHMARK
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Parse the dump until BENCH_MIN_NS has passed
+ * @return Nanoseconds per parse, or 0 if the dump was rejected
+ */
+static double run(parse_fn_t parse, const dump_ref_t *dump, int *found)
+{
+  *found = parse(dump);
+  if (*found < 0)
+    return 0;
+
+  uint64_t start = host_test_now_ns();
+  uint64_t elapsed;
+  size_t passes = 0;
+  do
+  {
+    parse(dump);
+    passes++;
+    elapsed = host_test_now_ns() - start;
+  } while (elapsed < BENCH_MIN_NS);
+
+  return (double)elapsed / (double)passes;
+}
+
+static int bench_dump(const char *name, const char *text, size_t len)
+{
+  printf("%s: %zu bytes\n", name, len);
+
+  for (size_t c = 0; c < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); c++)
+  {
+    dump_ref_t dump = {text, len, chunk_sizes[c]};
+    int found;
+    double ns = run(parse_streaming, &dump, &found);
+    if (ns == 0)
+    {
+      fprintf(stderr, "%s: parser rejected the dump\n", name);
+      return EXIT_FAILURE;
+    }
+    printf("  streaming %5zu B chunks %8.2f ms %8.1f MB/s  found %d/%d  state %zu bytes\n", dump.chunk, ns / 1e6,
+           (double)len / ns * 1e3, found, STATES_DUMP_WANTED, sizeof(ha_states_parser_t));
+  }
+
+#ifdef HAVE_CJSON
+  dump_ref_t dump = {text, len, chunk_sizes[0]};
+  int found;
+  heap_peak = 0;
+  double ns = run(parse_cjson, &dump, &found);
+  if (ns == 0)
+  {
+    fprintf(stderr, "%s: cJSON rejected the dump\n", name);
+    return EXIT_FAILURE;
+  }
+  printf("  cJSON     %5zu B chunks %8.2f ms %8.1f MB/s  found %d/%d  peak heap %zu bytes\n", dump.chunk, ns / 1e6,
+         (double)len / ns * 1e3, found, STATES_DUMP_WANTED, heap_peak);
+#endif
+  return EXIT_SUCCESS;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MAIN
+// ═══════════════════════════════════════════════════════════════════════════════
+
+int main(int argc, char **argv)
+{
+#ifdef HAVE_CJSON
+  cJSON_Hooks hooks = {counting_malloc, counting_free};
+  cJSON_InitHooks(&hooks);
+#endif
+
+  int result = EXIT_SUCCESS;
+  if (argc > 1)
+  {
+    for (int i = 1; i < argc; i++)
+    {
+      size_t len;
+      char *text = host_test_read_file(argv[i], &len);
+      if (!text)
+      {
+        fprintf(stderr, "%s: cannot read\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+      if (bench_dump(argv[i], text, len) != EXIT_SUCCESS)
+        result = EXIT_FAILURE;
+      free(text);
+    }
+    return result;
+  }
+
+  for (size_t s = 0; s < sizeof(generated_sizes) / sizeof(generated_sizes[0]); s++)
+  {
+    states_dump_t dump;
+    char name[64];
+    states_dump_generate(&dump, generated_sizes[s], 0x51A7E + (uint32_t)s, false);
+    snprintf(name, sizeof(name), "generated, %u entities", (unsigned)dump.entities);
+    if (bench_dump(name, dump.text, dump.len) != EXIT_SUCCESS)
+      result = EXIT_FAILURE;
+    free(dump.text);
+  }
+  return result;
+}
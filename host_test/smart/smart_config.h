@@ -0,0 +1,12 @@
+/**
+ * @file smart_config.h
+ * @brief Host stand-in for the private smart home configuration
+ *
+ * The firmware's smart_config.h is a local copy of the template filled in
+ * with real credentials and is not in the repository; the host tests use
+ * the template's placeholder values.
+ */
+
+#pragma once
+
+#include "../../main/smart/smart_config_template.h"
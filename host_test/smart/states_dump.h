@@ -0,0 +1,127 @@
+/**
+ * @file states_dump.h
+ * @brief Synthetic Home Assistant /api/states responses for the parser
+ *        tests and benchmark
+ *
+ * Shaped like a real dump. Every entity carries attributes and a context.
+ * Friendly names contain escapes and non-ASCII text. Attributes nest
+ * objects and arrays whose keys repeat the top-level ones ("entity_id",
+ * "state") with the ID of a wanted entity. The wanted switches come last,
+ * past the 100-entity limit of the old cJSON path, with their keys in a
+ * different order from the other entities. "switch.pump_2", whose ID has a
+ * wanted ID as a prefix, sits among them.
+ */
+
+#pragma once
+
+#include "host_test.h"
+
+#include <stdarg.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define STATES_DUMP_WANTED 3
+
+static const char *const states_dump_wanted[STATES_DUMP_WANTED] = {"switch.pump", "switch.light_c", "switch.heater"};
+static const char *const states_dump_values[STATES_DUMP_WANTED] = {"on", "off", "unavailable"};
+
+/** last_changed of every wanted switch, and its Unix time */
+#define STATES_DUMP_CHANGED "2025-08-14T12:34:56.789012+02:00"
+#define STATES_DUMP_CHANGED_UNIX 1755167696u
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct
+{
+  char *text;        ///< malloc'd, NUL-terminated
+  size_t len;
+  size_t cap;
+  uint32_t entities; ///< Top-level objects written
+} states_dump_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// GENERATOR
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static inline void states_dump_printf(states_dump_t *dump, const char *fmt, ...)
+{
+  va_list args;
+  for (;;)
+  {
+    va_start(args, fmt);
+    int n = vsnprintf(dump->text + dump->len, dump->cap - dump->len, fmt, args);
+    va_end(args);
+    if ((size_t)n < dump->cap - dump->len)
+    {
+      dump->len += (size_t)n;
+      return;
+    }
+    dump->cap = dump->cap * 2 + (size_t)n;
+    dump->text = realloc(dump->text, dump->cap);
+  }
+}
+
+static inline void states_dump_filler(states_dump_t *dump, uint32_t *rng, const char *entity_id)
+{
+  uint32_t r = host_test_rand(rng);
+  uint32_t i = dump->entities;
+
+  states_dump_printf(dump,
+                     "{\"entity_id\":\"%s\",\"state\":\"%u.%02u\",\"attributes\":{"
+                     "\"friendly_name\":\"Thing %u \\\"quoted\\\" \\\\ %cu00e9 caf\xc3\xa9\","
+                     "\"unit_of_measurement\":\"\xc2\xb0" "C\",\"device_class\":\"temperature\","
+                     "\"nested\":{\"a\":[1,2,{\"b\":\"c}]{\"}],\"state\":\"decoy\",\"entity_id\":\"%s\"},"
+                     "\"list\":[",
+                     entity_id, r % 100, (r >> 8) % 100, i, '\\', states_dump_wanted[r % STATES_DUMP_WANTED]);
+  for (uint32_t n = (r >> 16) % 24, k = 0; k < n; k++)
+    states_dump_printf(dump, k ? ",%u" : "%u", host_test_rand(rng) % 100000);
+  states_dump_printf(dump,
+                     "],\"options\":[{\"entity_id\":\"%s\"},true,null,-1.5e3]},"
+                     "\"last_changed\":\"2025-08-14T10:%02u:%02u.123456+00:00\","
+                     "\"last_updated\":\"2025-08-14T10:00:00+00:00\","
+                     "\"context\":{\"id\":\"01J5%022u\",\"parent_id\":null,\"user_id\":null}}",
+                     states_dump_wanted[(r >> 4) % STATES_DUMP_WANTED], (i / 60) % 60, i % 60, r);
+  dump->entities++;
+}
+
+/**
+ * @brief Build a dump of at least target bytes
+ * @param pretty Indent like HA's "?pretty" output instead of compact JSON
+ */
+static inline void states_dump_generate(states_dump_t *dump, size_t target, uint32_t seed, bool pretty)
+{
+  uint32_t rng = seed;
+  const char *sep = pretty ? ",\n  " : ",";
+  char entity_id[32];
+
+  memset(dump, 0, sizeof(*dump));
+  dump->cap = target + 4096;
+  dump->text = malloc(dump->cap);
+  states_dump_printf(dump, "%s", pretty ? "[\n  " : "[");
+
+  while (dump->len + 2048 < target)
+  {
+    uint32_t i = dump->entities;
+    snprintf(entity_id, sizeof(entity_id), i % 7 ? "sensor.thing_%u" : "light.lamp_%u", i);
+    states_dump_filler(dump, &rng, entity_id);
+    states_dump_printf(dump, "%s", sep);
+  }
+
+  for (int w = 0; w < STATES_DUMP_WANTED; w++)
+  {
+    states_dump_printf(dump,
+                       "{\"state\":\"%s\",\"attributes\":{\"friendly_name\":\"Switch %d\",\"icon\":\"mdi:toggle\"},"
+                       "\"last_changed\":\"" STATES_DUMP_CHANGED "\",\"entity_id\":\"%s\","
+                       "\"context\":{\"id\":\"x\",\"parent_id\":null,\"user_id\":null}}%s",
+                       states_dump_values[w], w, states_dump_wanted[w], sep);
+    dump->entities++;
+    states_dump_filler(dump, &rng, w == 0 ? "switch.pump_2" : "sensor.after_switch");
+    states_dump_printf(dump, "%s", w + 1 < STATES_DUMP_WANTED ? sep : "");
+  }
+  states_dump_printf(dump, "%s", pretty ? "\n]\n" : "]");
+}
@@ -0,0 +1,331 @@
+/**
+ * @file test_ha_gzip.c
+ * @brief Host tests for the streaming gzip decoder
+ *
+ * Streams are compressed here with zlib, which writes every optional
+ * header field on request. They are fed in chunks from one byte to a
+ * megabyte, the way HTTP_EVENT_ON_DATA delivers them, and the output is
+ * compared with the original.
+ */
+
+#include "host_test.h"
+#include "ha_gzip.h"
+#include "states_dump.h"
+
+#include <string.h>
+#include <zlib.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/** Header flags to request from zlib (RFC 1952 names) */
+#define WITH_EXTRA 0x04
+#define WITH_NAME 0x08
+#define WITH_COMMENT 0x10
+#define WITH_HCRC 0x02
+
+typedef struct
+{
+  uint8_t *data;
+  size_t len;
+} buffer_t;
+
+typedef struct
+{
+  buffer_t out;
+  size_t cap;
+  size_t max_piece; ///< Largest single sink call
+} sink_t;
+
+static void collect_sink(void *ctx, const char *data, size_t len)
+{
+  sink_t *s = ctx;
+  if (s->out.len + len > s->cap)
+  {
+    s->cap = (s->out.len + len) * 2;
+    s->out.data = realloc(s->out.data, s->cap);
+  }
+  memcpy(s->out.data + s->out.len, data, len);
+  s->out.len += len;
+  if (len > s->max_piece)
+    s->max_piece = len;
+}
+
+static buffer_t gzip_compress(const uint8_t *data, size_t len, int level, unsigned with)
+{
+  static uint8_t extra[300];
+  for (size_t i = 0; i < sizeof(extra); i++)
+    extra[i] = (uint8_t)(i * 7);
+
+  gz_header header = {0};
+  header.time = 1755165600;
+  header.os = 3;
+  if (with & WITH_EXTRA)
+  {
+    header.extra = extra;
+    header.extra_len = sizeof(extra);
+  }
+  if (with & WITH_NAME)
+    header.name = (Bytef *)"states.json";
+  if (with & WITH_COMMENT)
+    header.comment = (Bytef *)"recorded from /api/states";
+  header.hcrc = (with & WITH_HCRC) != 0;
+
+  z_stream z = {0};
+  deflateInit2(&z, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+  deflateSetHeader(&z, &header);
+
+  buffer_t gz;
+  size_t cap = deflateBound(&z, (uLong)len) + 512;
+  gz.data = malloc(cap);
+  z.next_in = (Bytef *)data;
+  z.avail_in = (uInt)len;
+  z.next_out = gz.data;
+  z.avail_out = (uInt)cap;
+  deflate(&z, Z_FINISH);
+  gz.len = cap - z.avail_out;
+  deflateEnd(&z);
+  return gz;
+}
+
+/**
+ * @brief Decode in fixed chunks (0 = random chunk sizes up to 4096)
+ * @return ha_gzip_finish() result, or the first feed error
+ */
+static esp_err_t decode(ha_gzip_t *gz, const buffer_t *in, size_t chunk, sink_t *sink)
+{
+  uint32_t rng = 0x6219 + (uint32_t)in->len;
+  esp_err_t err = ESP_OK;
+
+  sink->out.len = 0;
+  sink->max_piece = 0;
+  ha_gzip_reset(gz, collect_sink, sink);
+  for (size_t pos = 0; pos < in->len && err == ESP_OK;)
+  {
+    size_t n = chunk ? chunk : 1 + host_test_rand(&rng) % 4096;
+    if (n > in->len - pos)
+      n = in->len - pos;
+    err = ha_gzip_feed(gz, in->data + pos, n);
+    pos += n;
+  }
+  return err != ESP_OK ? err : ha_gzip_finish(gz);
+}
+
+static bool same(const buffer_t *out, const uint8_t *data, size_t len)
+{
+  return out->len == len && (len == 0 || memcmp(out->data, data, len) == 0);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// TESTS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void test_payloads(ha_gzip_t *gz, sink_t *sink)
+{
+  static const size_t chunks[] = {1, 2, 3, 7, 100, 1436, 4096, 65536, 1 << 20, 0};
+  buffer_t payloads[4];
+  uint32_t rng = 0xF00D;
+
+  // A states dump, incompressible bytes, long repeats, nothing at all
+  states_dump_t dump;
+  states_dump_generate(&dump, 2000 * 1000, 0x23, false);
+  payloads[0] = (buffer_t){(uint8_t *)dump.text, dump.len};
+
+  payloads[1].len = 200 * 1000;
+  payloads[1].data = malloc(payloads[1].len);
+  for (size_t i = 0; i < payloads[1].len; i++)
+    payloads[1].data[i] = (uint8_t)host_test_rand(&rng);
+
+  payloads[2].len = 1 << 20;
+  payloads[2].data = malloc(payloads[2].len);
+  for (size_t i = 0; i < payloads[2].len; i++)
+    payloads[2].data[i] = "on,off,unavailable;"[i % 19];
+
+  payloads[3] = (buffer_t){NULL, 0};
+
+  for (size_t p = 0; p < 4; p++)
+  {
+    buffer_t in = gzip_compress(payloads[p].data, payloads[p].len, p == 2 ? 9 : 6, 0);
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++)
+    {
+      // Single bytes only on the smaller payloads; 2 MB one byte at a time is slow under ASan
+      if (chunks[c] == 1 && payloads[p].len > (1u << 20) - 1)
+        continue;
+      esp_err_t err = decode(gz, &in, chunks[c], sink);
+      if (err != ESP_OK || !same(&sink->out, payloads[p].data, payloads[p].len))
+        fprintf(stderr, "payload %zu, %zu-byte chunks: %s, %zu bytes out\n", p, chunks[c], esp_err_to_name(err),
+                sink->out.len);
+      CHECK_EQ_INT(err, ESP_OK);
+      CHECK(same(&sink->out, payloads[p].data, payloads[p].len));
+      CHECK_EQ_INT(ha_gzip_output_size(gz), payloads[p].len);
+      CHECK(sink->max_piece <= 32768);
+    }
+    free(in.data);
+    free(payloads[p].data);
+  }
+}
+
+static void test_header_fields(ha_gzip_t *gz, sink_t *sink)
+{
+  const char *text = "[{\"entity_id\":\"switch.pump\",\"state\":\"on\"}]";
+  size_t len = strlen(text);
+
+  for (unsigned with = 0; with < 32; with += 2)
+  {
+    buffer_t in = gzip_compress((const uint8_t *)text, len, 6, with);
+
+    // Split anywhere in the header and the start of the body
+    size_t header_len = in.len - 8;
+    for (size_t cut = 0; cut <= header_len; cut++)
+    {
+      sink->out.len = 0;
+      ha_gzip_reset(gz, collect_sink, sink);
+      esp_err_t err = ha_gzip_feed(gz, in.data, cut);
+      if (err == ESP_OK)
+        err = ha_gzip_feed(gz, in.data + cut, in.len - cut);
+      if (err == ESP_OK)
+        err = ha_gzip_finish(gz);
+      if (err != ESP_OK || !same(&sink->out, (const uint8_t *)text, len))
+      {
+        fprintf(stderr, "header flags 0x%02x, split at %zu: %s\n", with, cut, esp_err_to_name(err));
+        CHECK(!"header field variant decodes");
+        break;
+      }
+    }
+
+    CHECK_EQ_INT(decode(gz, &in, 1, sink), ESP_OK);
+    CHECK(same(&sink->out, (const uint8_t *)text, len));
+    free(in.data);
+  }
+}
+
+static void test_bad_header(ha_gzip_t *gz, sink_t *sink)
+{
+  const char *text = "{}";
+  buffer_t in = gzip_compress((const uint8_t *)text, 2, 6, 0);
+
+  // Magic, method, reserved flags
+  static const struct
+  {
+    size_t offset;
+    uint8_t value;
+  } bad[] = {{0, 0x1E}, {1, 0x8C}, {2, 7}, {3, 0x20}, {3, 0x80}};
+
+  for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+  {
+    uint8_t saved = in.data[bad[i].offset];
+    in.data[bad[i].offset] = bad[i].value;
+    CHECK_EQ_INT(decode(gz, &in, 1436, sink), ESP_ERR_INVALID_RESPONSE);
+    CHECK_EQ_INT(sink->out.len, 0);
+    in.data[bad[i].offset] = saved;
+  }
+
+  // An error sticks until the next reset
+  in.data[0] = 0;
+  ha_gzip_reset(gz, collect_sink, sink);
+  CHECK_EQ_INT(ha_gzip_feed(gz, in.data, in.len), ESP_ERR_INVALID_RESPONSE);
+  in.data[0] = 0x1F;
+  CHECK_EQ_INT(ha_gzip_feed(gz, in.data, in.len), ESP_ERR_INVALID_RESPONSE);
+  CHECK_EQ_INT(ha_gzip_finish(gz), ESP_ERR_INVALID_RESPONSE);
+  CHECK_EQ_INT(decode(gz, &in, 1436, sink), ESP_OK);
+  free(in.data);
+}
+
+static void test_truncated(ha_gzip_t *gz, sink_t *sink)
+{
+  states_dump_t dump;
+  states_dump_generate(&dump, 20 * 1000, 0x77, false);
+  buffer_t in = gzip_compress((const uint8_t *)dump.text, dump.len, 6, WITH_NAME | WITH_HCRC);
+
+  // Every prefix is incomplete, never corrupt and never accepted
+  for (size_t cut = 0; cut < in.len; cut++)
+  {
+    buffer_t prefix = {in.data, cut};
+    esp_err_t err = decode(gz, &prefix, 1436, sink);
+    if (err != ESP_ERR_INVALID_SIZE)
+    {
+      fprintf(stderr, "prefix of %zu/%zu bytes: %s\n", cut, in.len, esp_err_to_name(err));
+      CHECK(!"truncated stream reported as such");
+      break;
+    }
+  }
+
+  // Bytes after the trailer are ignored
+  buffer_t longer = {malloc(in.len * 2), in.len * 2};
+  memcpy(longer.data, in.data, in.len);
+  memcpy(longer.data + in.len, in.data, in.len);
+  CHECK_EQ_INT(decode(gz, &longer, 1436, sink), ESP_OK);
+  CHECK(same(&sink->out, (const uint8_t *)dump.text, dump.len));
+  free(longer.data);
+
+  free(in.data);
+  free(dump.text);
+}
+
+static void test_corrupt(ha_gzip_t *gz, sink_t *sink)
+{
+  states_dump_t dump;
+  states_dump_generate(&dump, 8 * 1000, 0x99, false);
+  buffer_t in = gzip_compress((const uint8_t *)dump.text, dump.len, 6, 0);
+
+  // Wrong CRC or size in the trailer
+  for (size_t i = in.len - 8; i < in.len; i++)
+  {
+    in.data[i] ^= 0x01;
+    CHECK_EQ_INT(decode(gz, &in, 1436, sink), ESP_ERR_INVALID_RESPONSE);
+    in.data[i] ^= 0x01;
+  }
+
+  // A flipped bit in the deflate data or the trailer is never accepted
+  // with wrong output. A few flips do decode to the same bytes: a
+  // back-reference moved to an identical stretch of JSON, or the padding
+  // after the final block. Header bytes 4-9 (time, flags, OS) carry
+  // nothing the decoder checks.
+  size_t rejected = 0;
+  size_t flips = 0;
+  for (size_t i = 10; i < in.len; i++)
+  {
+    for (int bit = 0; bit < 8; bit++, flips++)
+    {
+      in.data[i] ^= (uint8_t)(1 << bit);
+      if (decode(gz, &in, 1436, sink) != ESP_OK)
+        rejected++;
+      else if (!same(&sink->out, (const uint8_t *)dump.text, dump.len))
+      {
+        fprintf(stderr, "bit %d of byte %zu: accepted with wrong output\n", bit, i);
+        CHECK(!"corrupt stream rejected");
+      }
+      in.data[i] ^= (uint8_t)(1 << bit);
+    }
+  }
+  CHECK(rejected > flips * 99 / 100);
+
+  CHECK_EQ_INT(decode(gz, &in, 1436, sink), ESP_OK);
+  free(in.data);
+  free(dump.text);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MAIN
+// ═══════════════════════════════════════════════════════════════════════════════
+
+int main(void)
+{
+  ha_gzip_t *gz = ha_gzip_create();
+  sink_t sink = {0};
+  CHECK(gz != NULL);
+  if (!gz)
+    return host_test_result("ha_gzip");
+
+  // One decoder for every stream, as ha_api keeps it
+  test_payloads(gz, &sink);
+  test_header_fields(gz, &sink);
+  test_bad_header(gz, &sink);
+  test_truncated(gz, &sink);
+  test_corrupt(gz, &sink);
+
+  ha_gzip_destroy(gz);
+  free(sink.out.data);
+  return host_test_result("ha_gzip");
+}
@@ -0,0 +1,359 @@
+/**
+ * @file test_ha_states_parser.c
+ * @brief Host tests for the streaming /api/states parser
+ *
+ * The body arrives in HTTP_EVENT_ON_DATA chunks of whatever size the
+ * socket delivered, so every result is checked against the whole-buffer
+ * parse with the input split at every byte of a small document and at
+ * random points of large generated dumps.
+ */
+
+#include "host_test.h"
+#include "ha_states_parser.h"
+#include "states_dump.h"
+
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct
+{
+  ha_states_parser_t parser;
+  ha_entity_state_t states[HA_STATES_PARSER_MAX_WANTED];
+  bool ok;
+} result_t;
+
+static void parse_whole(result_t *r, const char *const *wanted, int count, const char *text, size_t len)
+{
+  ha_states_parser_init(&r->parser, wanted, count, r->states);
+  r->ok = ha_states_parser_feed(&r->parser, text, len);
+}
+
+static void parse_split(result_t *r, const char *const *wanted, int count, const char *text, size_t len,
+                        const size_t *cuts, size_t cut_count)
+{
+  size_t pos = 0;
+  ha_states_parser_init(&r->parser, wanted, count, r->states);
+  r->ok = true;
+  for (size_t i = 0; i <= cut_count; i++)
+  {
+    size_t end = i < cut_count ? cuts[i] : len;
+    r->ok = ha_states_parser_feed(&r->parser, text + pos, end - pos) && r->ok;
+    pos = end;
+  }
+}
+
+static bool same_result(const result_t *a, const result_t *b, int count)
+{
+  return a->ok == b->ok && a->parser.found == b->parser.found && a->parser.entities == b->parser.entities &&
+         a->parser.depth == b->parser.depth &&
+         memcmp(a->states, b->states, sizeof(ha_entity_state_t) * (size_t)count) == 0;
+}
+
+static void build_escaped(char *out, size_t size)
+{
+  // JSON text: a"b\c<newline>d<tab>é/ with every escape form spelled out
+  snprintf(out, size, "a%c\"b%c%cc%cnd%ct%cu00e9%c/", '\\', '\\', '\\', '\\', '\\', '\\', '\\');
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SMALL DOCUMENT
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static const char *const small_wanted[] = {"switch.pump", "light.kitchen", "sensor.escaped", "switch.missing"};
+#define SMALL_WANTED 4
+
+static char small_doc[2048];
+
+static void build_small_doc(void)
+{
+  char escaped[64];
+  build_escaped(escaped, sizeof(escaped));
+
+  snprintf(small_doc, sizeof(small_doc),
+           "[\n"
+           "  {\"entity_id\": \"sensor.decoy\", \"state\": \"12\",\n"
+           "   \"attributes\": {\"entity_id\": \"switch.pump\", \"state\": \"decoy\",\n"
+           "                  \"inner\": [{\"entity_id\": \"light.kitchen\"}, \"]}\", {\"x\": [[]]}]},\n"
+           "   \"last_changed\": \"2020-01-01T00:00:00+00:00\"},\n"
+           "  {\"attributes\": {\"friendly_name\": \"Pump \\\"P1\\\"\"}, \"state\": \"on\",\n"
+           "   \"last_changed\": \"2025-08-14T10:00:00.123+00:00\", \"entity_id\": \"switch.pump\"},\n"
+           "  {\"entity_id\":\"switch.pump_2\",\"state\":\"off\"},\n"
+           "  {\"entity_id\":\"light.kitchen\",\"state\":\"off\",\"last_changed\":\"2024-02-29T23:59:59Z\","
+           "\"last_changed_by_automation\":\"1999-12-31T23:59:59+00:00\",\"count\":-1.5e3,\"on\":true,\"x\":null},\n"
+           "  {\"entity_id\":\"sensor.escaped\",\"state\":\"%s\",\"last_changed\":\"2025-01-01 00:00:00-05:30\"},\n"
+           "  {\"entity_id\":\"switch.pump\",\"state\":\"duplicate\"}\n"
+           "]\n",
+           escaped);
+}
+
+static void check_small_result(const result_t *r)
+{
+  CHECK(r->ok);
+  CHECK_EQ_INT(r->parser.entities, 6);
+  CHECK_EQ_INT(r->parser.depth, 0);
+  CHECK_EQ_INT(ha_states_parser_found_count(&r->parser), 3);
+  CHECK(!ha_states_parser_done(&r->parser));
+
+  // Keys in any order; the first occurrence of an entity wins
+  CHECK(strcmp(r->states[0].entity_id, "switch.pump") == 0);
+  CHECK(strcmp(r->states[0].state, "on") == 0);
+  CHECK_EQ_INT(r->states[0].last_changed, 1755165600);
+
+  // A key that starts with "last_changed" but is longer is not last_changed
+  CHECK(strcmp(r->states[1].state, "off") == 0);
+  CHECK_EQ_INT(r->states[1].last_changed, 1709251199);
+
+  // Escapes decoded; \uXXXX stands in as '?'
+  CHECK(strcmp(r->states[2].state, "a\"b\\c\nd\t?/") == 0);
+  CHECK_EQ_INT(r->states[2].last_changed, 1735709400);
+
+  CHECK(r->states[3].entity_id[0] == '\0');
+}
+
+static void test_small_doc(void)
+{
+  size_t len = strlen(small_doc);
+  result_t whole;
+  result_t split;
+
+  parse_whole(&whole, small_wanted, SMALL_WANTED, small_doc, len);
+  check_small_result(&whole);
+
+  // Two chunks, split at every byte
+  for (size_t cut = 0; cut <= len; cut++)
+  {
+    parse_split(&split, small_wanted, SMALL_WANTED, small_doc, len, &cut, 1);
+    if (!same_result(&split, &whole, SMALL_WANTED))
+    {
+      fprintf(stderr, "split at byte %zu differs\n", cut);
+      CHECK(!"split result matches");
+      break;
+    }
+  }
+
+  // One byte per chunk
+  size_t cuts[sizeof(small_doc)];
+  for (size_t i = 0; i < len; i++)
+    cuts[i] = i;
+  parse_split(&split, small_wanted, SMALL_WANTED, small_doc, len, cuts, len);
+  CHECK(same_result(&split, &whole, SMALL_WANTED));
+
+  // Three chunks at random points
+  uint32_t rng = 0x22;
+  for (int i = 0; i < 20000; i++)
+  {
+    size_t pair[2] = {host_test_rand(&rng) % (len + 1), host_test_rand(&rng) % (len + 1)};
+    if (pair[0] > pair[1])
+    {
+      size_t t = pair[0];
+      pair[0] = pair[1];
+      pair[1] = t;
+    }
+    parse_split(&split, small_wanted, SMALL_WANTED, small_doc, len, pair, 2);
+    if (!same_result(&split, &whole, SMALL_WANTED))
+    {
+      fprintf(stderr, "split at bytes %zu and %zu differs\n", pair[0], pair[1]);
+      CHECK(!"split result matches");
+      break;
+    }
+  }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// FIELDS AND LIMITS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void test_long_values(void)
+{
+  static char doc[4096];
+  static const char *const wanted[] = {"switch.pump"};
+  result_t r;
+  char long_id[HA_MAX_ENTITY_ID_LEN + 16];
+  char long_state[HA_MAX_STATE_LEN + 64];
+
+  // An ID longer than the buffer never matches, even if its prefix does
+  snprintf(long_id, sizeof(long_id), "switch.pump%0*d", (int)sizeof(long_id) - 13, 0);
+  snprintf(doc, sizeof(doc), "[{\"entity_id\":\"%s\",\"state\":\"on\"}]", long_id);
+  parse_whole(&r, wanted, 1, doc, strlen(doc));
+  CHECK(r.ok);
+  CHECK_EQ_INT(r.parser.found, 0);
+
+  // A state longer than the buffer is truncated
+  memset(long_state, 'x', sizeof(long_state) - 1);
+  long_state[sizeof(long_state) - 1] = '\0';
+  snprintf(doc, sizeof(doc), "[{\"state\":\"%s\",\"entity_id\":\"switch.pump\"}]", long_state);
+  parse_whole(&r, wanted, 1, doc, strlen(doc));
+  CHECK(r.ok);
+  CHECK_EQ_INT(r.parser.found, 1);
+  CHECK_EQ_INT(strlen(r.states[0].state), HA_MAX_STATE_LEN - 1);
+
+  // Non-string values leave the field empty
+  snprintf(doc, sizeof(doc), "[{\"entity_id\":\"switch.pump\",\"state\":5,\"last_changed\":null}]");
+  parse_whole(&r, wanted, 1, doc, strlen(doc));
+  CHECK(r.ok);
+  CHECK_EQ_INT(r.parser.found, 1);
+  CHECK(r.states[0].state[0] == '\0');
+  CHECK_EQ_INT(r.states[0].last_changed, 0);
+
+  // An empty array is valid and finds nothing
+  parse_whole(&r, wanted, 1, " [ ] ", 5);
+  CHECK(r.ok);
+  CHECK_EQ_INT(r.parser.entities, 0);
+}
+
+static void test_wanted_limit(void)
+{
+  static char doc[8192];
+  static char ids[HA_STATES_PARSER_MAX_WANTED][24];
+  const char *wanted[HA_STATES_PARSER_MAX_WANTED];
+  size_t len = 0;
+  result_t r;
+
+  len += (size_t)snprintf(doc, sizeof(doc), "[");
+  for (int i = 0; i < HA_STATES_PARSER_MAX_WANTED; i++)
+  {
+    snprintf(ids[i], sizeof(ids[i]), "switch.s%d", i);
+    wanted[i] = ids[i];
+    len += (size_t)snprintf(doc + len, sizeof(doc) - len, "%s{\"entity_id\":\"switch.s%d\",\"state\":\"%d\"}",
+                            i ? "," : "", HA_STATES_PARSER_MAX_WANTED - 1 - i, HA_STATES_PARSER_MAX_WANTED - 1 - i);
+  }
+  len += (size_t)snprintf(doc + len, sizeof(doc) - len, "]");
+
+  parse_whole(&r, wanted, HA_STATES_PARSER_MAX_WANTED, doc, len);
+  CHECK(r.ok);
+  CHECK(ha_states_parser_done(&r.parser));
+  CHECK_EQ_INT(ha_states_parser_found_count(&r.parser), HA_STATES_PARSER_MAX_WANTED);
+  for (int i = 0; i < HA_STATES_PARSER_MAX_WANTED; i++)
+    CHECK_EQ_INT(atoi(r.states[i].state), i);
+
+  // Nothing wanted is never done
+  parse_whole(&r, wanted, 0, doc, len);
+  CHECK(!ha_states_parser_done(&r.parser));
+}
+
+static void test_malformed(void)
+{
+  static const char *const wanted[] = {"switch.pump"};
+  static const char *const bad[] = {
+      "{\"entity_id\":\"switch.pump\"}", // not an array
+      "[[\"switch.pump\"]]",             // array of arrays
+      "[{\"a\":1]",                      // mismatched close
+      "]",
+      "[}",
+  };
+  result_t r;
+
+  for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+  {
+    parse_whole(&r, wanted, 1, bad[i], strlen(bad[i]));
+    if (r.ok)
+      fprintf(stderr, "accepted: %s\n", bad[i]);
+    CHECK(!r.ok);
+  }
+
+  // Nesting past HA_STATES_PARSER_MAX_DEPTH
+  char deep[HA_STATES_PARSER_MAX_DEPTH + 8];
+  size_t n = 0;
+  deep[n++] = '[';
+  deep[n++] = '{';
+  deep[n++] = '"';
+  deep[n++] = 'a';
+  deep[n++] = '"';
+  deep[n++] = ':';
+  while (n < sizeof(deep))
+    deep[n++] = '[';
+  parse_whole(&r, wanted, 1, deep, sizeof(deep));
+  CHECK(!r.ok);
+
+  // Once failed, later input changes nothing
+  const char *tail = ",{\"entity_id\":\"switch.pump\",\"state\":\"on\"}]";
+  parse_whole(&r, wanted, 1, "[}", 2);
+  CHECK(!ha_states_parser_feed(&r.parser, tail, strlen(tail)));
+  CHECK_EQ_INT(r.parser.found, 0);
+}
+
+static void test_parse_time(void)
+{
+  CHECK_EQ_INT(ha_states_parser_parse_time("2025-08-14T10:00:00.123+00:00"), 1755165600);
+  CHECK_EQ_INT(ha_states_parser_parse_time(STATES_DUMP_CHANGED), STATES_DUMP_CHANGED_UNIX);
+  CHECK_EQ_INT(ha_states_parser_parse_time("2024-02-29T23:59:59Z"), 1709251199);
+  CHECK_EQ_INT(ha_states_parser_parse_time("2025-01-01 00:00:00-05:30"), 1735709400);
+  CHECK_EQ_INT(ha_states_parser_parse_time("1999-12-31T23:59:59"), 946684799);
+
+  CHECK_EQ_INT(ha_states_parser_parse_time(""), 0);
+  CHECK_EQ_INT(ha_states_parser_parse_time("2025-08-14"), 0);
+  CHECK_EQ_INT(ha_states_parser_parse_time("2025-13-01T00:00:00Z"), 0);
+  CHECK_EQ_INT(ha_states_parser_parse_time("2025-08-14X10:00:00Z"), 0);
+  CHECK_EQ_INT(ha_states_parser_parse_time("2025-08-1?T10:00:00Z"), 0);
+  CHECK_EQ_INT(ha_states_parser_parse_time("1960-01-01T00:00:00Z"), 0);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// LARGE DUMPS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void test_large_dumps(void)
+{
+  static const size_t sizes[] = {100 * 1000, 500 * 1000, 2000 * 1000};
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+  {
+    states_dump_t dump;
+    states_dump_generate(&dump, sizes[s], 0x51A7E + (uint32_t)s, s == 1);
+
+    result_t whole;
+    parse_whole(&whole, states_dump_wanted, STATES_DUMP_WANTED, dump.text, dump.len);
+    CHECK(whole.ok);
+    CHECK(ha_states_parser_done(&whole.parser));
+    CHECK_EQ_INT(whole.parser.entities, dump.entities);
+    CHECK_EQ_INT(whole.parser.depth, 0);
+    for (int w = 0; w < STATES_DUMP_WANTED; w++)
+    {
+      CHECK(strcmp(whole.states[w].entity_id, states_dump_wanted[w]) == 0);
+      CHECK(strcmp(whole.states[w].state, states_dump_values[w]) == 0);
+      CHECK_EQ_INT(whole.states[w].last_changed, STATES_DUMP_CHANGED_UNIX);
+    }
+
+    // Socket-sized chunks, from a single byte to a few TCP segments
+    uint32_t rng = 0xC4 + (uint32_t)s;
+    for (int run = 0; run < 8; run++)
+    {
+      static size_t cuts[1 << 20];
+      size_t count = 0;
+      uint32_t max_chunk = run < 4 ? 64 : 4096;
+      for (size_t pos = 0; count < sizeof(cuts) / sizeof(cuts[0]);)
+      {
+        pos += 1 + host_test_rand(&rng) % max_chunk;
+        if (pos >= dump.len)
+          break;
+        cuts[count++] = pos;
+      }
+
+      result_t split;
+      parse_split(&split, states_dump_wanted, STATES_DUMP_WANTED, dump.text, dump.len, cuts, count);
+      CHECK(same_result(&split, &whole, STATES_DUMP_WANTED));
+    }
+    free(dump.text);
+  }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MAIN
+// ═══════════════════════════════════════════════════════════════════════════════
+
+int main(void)
+{
+  build_small_doc();
+
+  test_small_doc();
+  test_long_values();
+  test_wanted_limit();
+  test_malformed();
+  test_parse_time();
+  test_large_dumps();
+
+  return host_test_result("ha_states_parser");
+}
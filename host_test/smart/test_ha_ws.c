@@ -0,0 +1,522 @@
+/**
+ * @file test_ha_ws.c
+ * @brief Host tests for the Home Assistant WebSocket subscription client
+ *
+ * ha_ws.c is built into the test, and the WebSocket client underneath it is
+ * replaced by the test playing the server: messages recorded from a Home
+ * Assistant 2025.8 instance are delivered through the registered event
+ * handler the way esp_websocket_client delivers them, whole, split into
+ * buffer-sized pieces, or spread over continuation frames, and what the
+ * client sends back is parsed and checked.
+ */
+
+#include "host_test.h"
+
+#include "ha_ws.c"
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// RECORDED FRAMES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static const char *const entity_ids[] = {"switch.pump", "switch.heater", "sensor.water_temperature"};
+#define ENTITY_COUNT 3
+
+static const char AUTH_REQUIRED[] = "{\"type\":\"auth_required\",\"ha_version\":\"2025.8.1\"}";
+static const char AUTH_OK[] = "{\"type\":\"auth_ok\",\"ha_version\":\"2025.8.1\"}";
+static const char AUTH_INVALID[] = "{\"type\":\"auth_invalid\",\"message\":\"Invalid access token or password\"}";
+static const char RESULT_OK[] = "{\"id\":1,\"type\":\"result\",\"success\":true,\"result\":null}";
+
+static const char SNAPSHOT[] =
+    "{\"id\":1,\"type\":\"event\",\"event\":{\"a\":{"
+    "\"switch.pump\":{\"s\":\"on\",\"a\":{\"friendly_name\":\"Pump\"},\"c\":\"01K2M8Z6QH1R3J5V7X9B2D4F6G\","
+    "\"lc\":1755170096.457813},"
+    "\"switch.heater\":{\"s\":\"off\",\"a\":{\"friendly_name\":\"Heater\"},\"c\":\"01K2M8Z6QJ2S4K6W8Y0C3E5G7H\","
+    "\"lc\":1755169811.02},"
+    "\"sensor.water_temperature\":{\"s\":\"24.5\",\"a\":{\"state_class\":\"measurement\","
+    "\"unit_of_measurement\":\"\\u00b0C\",\"device_class\":\"temperature\",\"friendly_name\":\"Water\"},"
+    "\"c\":\"01K2M8Z6QK3T5M7X9Z1D4F6H8J\",\"lc\":1755170001.5,\"lu\":1755170090.1}}}}";
+
+static const char CHANGED_STATE[] =
+    "{\"id\":1,\"type\":\"event\",\"event\":{\"c\":{\"switch.pump\":{\"+\":{\"s\":\"off\","
+    "\"c\":\"01K2M90B4C5D6E7F8G9H0J1K2M\",\"lc\":1755170160.883}}}}}";
+
+/** Attributes changed, state did not: nothing to deliver */
+static const char CHANGED_ATTRIBUTES[] =
+    "{\"id\":1,\"type\":\"event\",\"event\":{\"c\":{\"sensor.water_temperature\":{\"+\":{"
+    "\"a\":{\"friendly_name\":\"Water temperature\"},\"c\":\"01K2M91A5B6C7D8E9F0G1H2J3K\",\"lu\":1755170222.6},"
+    "\"-\":{\"a\":[\"icon\"]}}}}}";
+
+/** Two entities in one diff, one of them attribute-only */
+static const char CHANGED_MIXED[] =
+    "{\"id\":1,\"type\":\"event\",\"event\":{\"c\":{"
+    "\"sensor.water_temperature\":{\"+\":{\"lu\":1755170290.3}},"
+    "\"switch.heater\":{\"+\":{\"s\":\"on\",\"c\":\"01K2M92C7D8E9F0G1H2J3K4M5N\",\"lc\":1755170290.3}}}}}";
+
+/** Reply to a different request: not ours */
+static const char OTHER_ID_EVENT[] =
+    "{\"id\":7,\"type\":\"event\",\"event\":{\"c\":{\"switch.pump\":{\"+\":{\"s\":\"on\"}}}}}";
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PLATFORM STAND-INS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+struct esp_websocket_client
+{
+  int unused;
+};
+
+static struct esp_websocket_client client;
+static esp_event_handler_t handler;
+static bool connected;
+static int64_t clock_us;
+
+#define SENT_MAX 8
+static char *sent[SENT_MAX];
+static int sent_count;
+
+int64_t esp_timer_get_time(void)
+{
+  return clock_us;
+}
+
+esp_websocket_client_handle_t esp_websocket_client_init(const esp_websocket_client_config_t *config)
+{
+  (void)config;
+  return &client;
+}
+
+esp_err_t esp_websocket_register_events(esp_websocket_client_handle_t c, esp_websocket_event_id_t event,
+                                        esp_event_handler_t h, void *args)
+{
+  (void)c, (void)event, (void)args;
+  handler = h;
+  return ESP_OK;
+}
+
+esp_err_t esp_websocket_client_start(esp_websocket_client_handle_t c)
+{
+  (void)c;
+  return ESP_OK;
+}
+
+esp_err_t esp_websocket_client_stop(esp_websocket_client_handle_t c)
+{
+  (void)c;
+  connected = false;
+  return ESP_OK;
+}
+
+esp_err_t esp_websocket_client_destroy(esp_websocket_client_handle_t c)
+{
+  (void)c;
+  handler = NULL;
+  return ESP_OK;
+}
+
+int esp_websocket_client_send_text(esp_websocket_client_handle_t c, const char *data, int len, TickType_t timeout)
+{
+  (void)c, (void)timeout;
+  if (sent_count == SENT_MAX)
+  {
+    return -1;
+  }
+  sent[sent_count] = malloc((size_t)len + 1);
+  memcpy(sent[sent_count], data, (size_t)len);
+  sent[sent_count][len] = '\0';
+  sent_count++;
+  return len;
+}
+
+bool esp_websocket_client_is_connected(esp_websocket_client_handle_t c)
+{
+  (void)c;
+  return connected;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// SERVER SIDE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define RECEIVED_MAX 64
+
+typedef struct
+{
+  char entity_id[64];
+  char state[16];
+  uint32_t event_us;
+} received_t;
+
+static received_t received[RECEIVED_MAX];
+static int received_count;
+
+static void on_state(const char *entity_id, const char *state, uint32_t event_us)
+{
+  if (received_count < RECEIVED_MAX)
+  {
+    received_t *r = &received[received_count];
+    snprintf(r->entity_id, sizeof(r->entity_id), "%s", entity_id);
+    snprintf(r->state, sizeof(r->state), "%s", state);
+    r->event_us = event_us;
+  }
+  received_count++;
+}
+
+static void clear_sent(void)
+{
+  for (int i = 0; i < sent_count; i++)
+  {
+    free(sent[i]);
+  }
+  sent_count = 0;
+}
+
+static void server_event(int32_t id, esp_websocket_event_data_t *data)
+{
+  handler(NULL, "WEBSOCKET_EVENTS", id, data);
+}
+
+static void server_connect(void)
+{
+  connected = true;
+  server_event(WEBSOCKET_EVENT_CONNECTED, &(esp_websocket_event_data_t){0});
+}
+
+/**
+ * @brief Deliver one frame in pieces of at most piece bytes, as the client task does
+ * @param clock_step Microseconds to advance between pieces
+ */
+static void send_frame(uint8_t op_code, bool fin, const char *data, int len, int piece, int clock_step)
+{
+  for (int offset = 0; offset == 0 || offset < len; offset += piece)
+  {
+    esp_websocket_event_data_t d = {
+        .data_ptr = data + offset,
+        .data_len = len - offset < piece ? len - offset : piece,
+        .fin = fin,
+        .op_code = op_code,
+        .client = &client,
+        .payload_len = len,
+        .payload_offset = offset,
+    };
+    server_event(WEBSOCKET_EVENT_DATA, &d);
+    clock_us += clock_step;
+  }
+}
+
+static void send_message(const char *text)
+{
+  send_frame(WS_OPCODE_TEXT, true, text, (int)strlen(text), HA_WS_BUFFER_SIZE, 0);
+}
+
+/**
+ * @brief Deliver one message as a text frame and continuation frames of frame_len bytes
+ */
+static void send_fragmented(const char *text, int frame_len, int piece, int clock_step)
+{
+  int len = (int)strlen(text);
+  for (int pos = 0; pos < len; pos += frame_len)
+  {
+    int n = len - pos < frame_len ? len - pos : frame_len;
+    send_frame(pos == 0 ? WS_OPCODE_TEXT : WS_OPCODE_CONTINUATION, pos + n == len, text + pos, n, piece, clock_step);
+  }
+}
+
+/**
+ * @brief Parse the oldest message the client sent and check its type
+ * @return Parsed message (caller deletes), or NULL with a failed check
+ */
+static cJSON *take_sent(const char *type)
+{
+  CHECK(sent_count > 0);
+  if (sent_count == 0)
+  {
+    return NULL;
+  }
+  cJSON *json = cJSON_Parse(sent[0]);
+  free(sent[0]);
+  memmove(sent, sent + 1, sizeof(sent[0]) * (size_t)--sent_count);
+
+  CHECK(json != NULL);
+  const char *got = cJSON_GetStringValue(cJSON_GetObjectItem(json, "type"));
+  CHECK(got && strcmp(got, type) == 0);
+  return json;
+}
+
+/**
+ * @brief Start the client and take it through the handshake to a live subscription
+ */
+static void start_live(void)
+{
+  received_count = 0;
+  CHECK_EQ_INT(ha_ws_start(entity_ids, ENTITY_COUNT, on_state), ESP_OK);
+  server_connect();
+  send_message(AUTH_REQUIRED);
+  cJSON_Delete(take_sent("auth"));
+  send_message(AUTH_OK);
+  cJSON_Delete(take_sent("subscribe_entities"));
+  send_message(RESULT_OK);
+  CHECK_EQ_INT(ha_ws_get_state(), HA_WS_LIVE);
+}
+
+static bool received_is(int i, const char *entity_id, const char *state)
+{
+  return i < received_count && strcmp(received[i].entity_id, entity_id) == 0 &&
+         strcmp(received[i].state, state) == 0;
+}
+
+static ha_ws_stats_t read_stats(void)
+{
+  ha_ws_stats_t s;
+  ha_ws_get_stats(&s);
+  return s;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// TESTS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void test_handshake(void)
+{
+  CHECK_EQ_INT(ha_ws_start(entity_ids, 0, on_state), ESP_ERR_INVALID_ARG);
+  CHECK_EQ_INT(ha_ws_start(entity_ids, ENTITY_COUNT, on_state), ESP_OK);
+  CHECK_EQ_INT(ha_ws_start(entity_ids, ENTITY_COUNT, on_state), ESP_ERR_INVALID_STATE);
+  CHECK_EQ_INT(ha_ws_get_state(), HA_WS_CONNECTING);
+
+  // Twice: a reconnect starts the exchange over with message ID 1
+  for (int round = 0; round < 2; round++)
+  {
+    server_connect();
+    CHECK_EQ_INT(ha_ws_get_state(), HA_WS_CONNECTING);
+    CHECK(!ha_ws_is_live());
+
+    send_message(AUTH_REQUIRED);
+    CHECK_EQ_INT(ha_ws_get_state(), HA_WS_AUTHENTICATING);
+    cJSON *auth = take_sent("auth");
+    CHECK(strcmp(cJSON_GetStringValue(cJSON_GetObjectItem(auth, "access_token")), HA_API_TOKEN) == 0);
+    cJSON_Delete(auth);
+
+    send_message(AUTH_OK);
+    CHECK_EQ_INT(ha_ws_get_state(), HA_WS_SUBSCRIBING);
+    cJSON *sub = take_sent("subscribe_entities");
+    CHECK_EQ_INT(cJSON_GetObjectItem(sub, "id")->valueint, 1);
+    const cJSON *ids = cJSON_GetObjectItem(sub, "entity_ids");
+    const cJSON *id;
+    int n = 0;
+    cJSON_ArrayForEach(id, ids)
+    {
+      CHECK(n < ENTITY_COUNT && strcmp(cJSON_GetStringValue(id), entity_ids[n]) == 0);
+      n++;
+    }
+    CHECK_EQ_INT(n, ENTITY_COUNT);
+    cJSON_Delete(sub);
+
+    // A result for another request does not complete the subscription
+    send_message("{\"id\":2,\"type\":\"result\",\"success\":true,\"result\":null}");
+    CHECK_EQ_INT(ha_ws_get_state(), HA_WS_SUBSCRIBING);
+    send_message(RESULT_OK);
+    CHECK_EQ_INT(ha_ws_get_state(), HA_WS_LIVE);
+    CHECK(ha_ws_is_live());
+
+    connected = false;
+    CHECK(!ha_ws_is_live());
+    server_event(WEBSOCKET_EVENT_DISCONNECTED, &(esp_websocket_event_data_t){0});
+    CHECK_EQ_INT(ha_ws_get_state(), HA_WS_CONNECTING);
+  }
+  CHECK_EQ_INT(sent_count, 0);
+  CHECK_EQ_INT(read_stats().connects, 2);
+
+  ha_ws_stop();
+  CHECK_EQ_INT(ha_ws_get_state(), HA_WS_STOPPED);
+}
+
+static void test_auth_invalid(void)
+{
+  CHECK_EQ_INT(ha_ws_start(entity_ids, ENTITY_COUNT, on_state), ESP_OK);
+  server_connect();
+  send_message(AUTH_REQUIRED);
+  cJSON_Delete(take_sent("auth"));
+  send_message(AUTH_INVALID);
+  CHECK_EQ_INT(ha_ws_get_state(), HA_WS_AUTH_FAILED);
+
+  // The state sticks across reconnects, and nothing more is answered
+  server_event(WEBSOCKET_EVENT_DISCONNECTED, &(esp_websocket_event_data_t){0});
+  server_connect();
+  send_message(AUTH_REQUIRED);
+  CHECK_EQ_INT(ha_ws_get_state(), HA_WS_AUTH_FAILED);
+  CHECK_EQ_INT(sent_count, 0);
+
+  ha_ws_stop();
+}
+
+static void test_snapshot_and_changes(void)
+{
+  start_live();
+  ha_ws_stats_t before = read_stats();
+
+  clock_us = 5000000;
+  send_message(SNAPSHOT);
+  CHECK_EQ_INT(received_count, 3);
+  CHECK(received_is(0, "switch.pump", "on"));
+  CHECK(received_is(1, "switch.heater", "off"));
+  CHECK(received_is(2, "sensor.water_temperature", "24.5"));
+  CHECK_EQ_INT(received[0].event_us, 5000000);
+
+  // "c" maps carry the new values under "+"
+  received_count = 0;
+  clock_us = 6000000;
+  send_message(CHANGED_STATE);
+  CHECK_EQ_INT(received_count, 1);
+  CHECK(received_is(0, "switch.pump", "off"));
+  CHECK_EQ_INT(received[0].event_us, 6000000);
+
+  // Attribute-only changes are skipped, also next to a state change
+  received_count = 0;
+  send_message(CHANGED_ATTRIBUTES);
+  CHECK_EQ_INT(received_count, 0);
+  send_message(CHANGED_MIXED);
+  CHECK_EQ_INT(received_count, 1);
+  CHECK(received_is(0, "switch.heater", "on"));
+
+  received_count = 0;
+  send_message(OTHER_ID_EVENT);
+  CHECK_EQ_INT(received_count, 0);
+
+  ha_ws_stats_t after = read_stats();
+  CHECK_EQ_INT(after.snapshots - before.snapshots, 1);
+  CHECK_EQ_INT(after.updates - before.updates, 5);
+  CHECK_EQ_INT(after.bad_frames, before.bad_frames);
+  CHECK_EQ_INT(sent_count, 0);
+
+  ha_ws_stop();
+}
+
+/**
+ * @brief Build a snapshot of count filler lights followed by switch.pump
+ */
+static size_t build_large_snapshot(char *out, size_t size, int count)
+{
+  size_t len = (size_t)snprintf(out, size, "{\"id\":1,\"type\":\"event\",\"event\":{\"a\":{");
+  for (int i = 0; i < count; i++)
+  {
+    len += (size_t)snprintf(out + len, size - len,
+                            "\"light.filler_%03d\":{\"s\":\"off\",\"a\":{\"friendly_name\":\"Filler light %03d\","
+                            "\"supported_color_modes\":[\"brightness\"]},\"c\":\"01K2M8Z6QH1R3J5V7X9B2D4F6G\","
+                            "\"lc\":1755170096.457813},",
+                            i, i);
+  }
+  len += (size_t)snprintf(out + len, size - len, "\"switch.pump\":{\"s\":\"on\",\"a\":{},\"lc\":1755170096.5}}}}");
+  return len;
+}
+
+static void test_fragmented(void)
+{
+  static char big[HA_WS_MESSAGE_MAX];
+  size_t len = build_large_snapshot(big, sizeof(big), 60);
+  CHECK(len > 4 * HA_WS_BUFFER_SIZE && len < HA_WS_MESSAGE_MAX);
+
+  start_live();
+  ha_ws_stats_t before = read_stats();
+
+  // One frame in buffer-sized pieces, then in small ones
+  static const int pieces[] = {HA_WS_BUFFER_SIZE, 100, 1};
+  for (size_t p = 0; p < sizeof(pieces) / sizeof(pieces[0]); p++)
+  {
+    received_count = 0;
+    clock_us = 1000000;
+    send_frame(WS_OPCODE_TEXT, true, big, (int)len, pieces[p], 10);
+    CHECK_EQ_INT(received_count, 61);
+    CHECK(received_is(60, "switch.pump", "on"));
+    CHECK_EQ_INT(received[60].event_us, 1000000); // Stamped at the first piece
+  }
+
+  // Continuation frames, each in pieces, with a ping in between
+  received_count = 0;
+  clock_us = 2000000;
+  send_fragmented(big, 3000, 1024, 10);
+  CHECK_EQ_INT(received_count, 61);
+  CHECK_EQ_INT(received[0].event_us, 2000000);
+
+  received_count = 0;
+  send_frame(WS_OPCODE_TEXT, false, big, 5000, HA_WS_BUFFER_SIZE, 0);
+  send_frame(0x09, true, "ping", 4, HA_WS_BUFFER_SIZE, 0);
+  send_frame(WS_OPCODE_CONTINUATION, true, big + 5000, (int)len - 5000, HA_WS_BUFFER_SIZE, 0);
+  CHECK_EQ_INT(received_count, 61);
+
+  // A message cut short by a reconnect is dropped, not glued to the next one
+  received_count = 0;
+  send_frame(WS_OPCODE_TEXT, false, big, 5000, HA_WS_BUFFER_SIZE, 0);
+  server_connect();
+  send_message(AUTH_REQUIRED);
+  cJSON_Delete(take_sent("auth"));
+  send_message(AUTH_OK);
+  cJSON_Delete(take_sent("subscribe_entities"));
+  send_message(RESULT_OK);
+  send_message(CHANGED_STATE);
+  CHECK_EQ_INT(received_count, 1);
+  CHECK(received_is(0, "switch.pump", "off"));
+
+  ha_ws_stats_t after = read_stats();
+  CHECK_EQ_INT(after.snapshots - before.snapshots, 5);
+  CHECK_EQ_INT(after.bad_frames, before.bad_frames);
+
+  ha_ws_stop();
+}
+
+static void test_oversize_and_garbage(void)
+{
+  static char huge[2 * HA_WS_MESSAGE_MAX];
+  size_t len = build_large_snapshot(huge, sizeof(huge), 150);
+  CHECK(len > HA_WS_MESSAGE_MAX);
+
+  start_live();
+  ha_ws_stats_t before = read_stats();
+
+  // Over the limit in one frame, and over it only across continuation frames
+  send_frame(WS_OPCODE_TEXT, true, huge, (int)len, HA_WS_BUFFER_SIZE, 0);
+  send_fragmented(huge, 4000, HA_WS_BUFFER_SIZE, 0);
+  CHECK_EQ_INT(received_count, 0);
+  CHECK_EQ_INT(read_stats().bad_frames - before.bad_frames, 2);
+
+  // One byte short of the limit still fits with its terminator
+  static char edge[HA_WS_MESSAGE_MAX];
+  size_t edge_len = strlen(CHANGED_STATE);
+  memcpy(edge, CHANGED_STATE, edge_len);
+  memset(edge + edge_len, ' ', HA_WS_MESSAGE_MAX - 1 - edge_len);
+  edge[HA_WS_MESSAGE_MAX - 1] = '\0';
+  send_message(edge);
+  CHECK_EQ_INT(received_count, 1);
+
+  // At the limit there is no room left for the terminator
+  received_count = 0;
+  send_frame(WS_OPCODE_TEXT, false, edge, HA_WS_MESSAGE_MAX - 1, HA_WS_BUFFER_SIZE, 0);
+  send_frame(WS_OPCODE_CONTINUATION, true, " ", 1, HA_WS_BUFFER_SIZE, 0);
+  CHECK_EQ_INT(received_count, 0);
+  CHECK_EQ_INT(read_stats().bad_frames - before.bad_frames, 3);
+
+  // The next message after a dropped one is handled normally
+  send_message("{\"id\":1,\"type\":\"event\",\"event\":{\"c\":");
+  CHECK_EQ_INT(read_stats().bad_frames - before.bad_frames, 4);
+  send_message(CHANGED_STATE);
+  CHECK_EQ_INT(received_count, 1);
+  CHECK_EQ_INT(ha_ws_get_state(), HA_WS_LIVE);
+  CHECK_EQ_INT(sent_count, 0);
+
+  ha_ws_stop();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MAIN
+// ═══════════════════════════════════════════════════════════════════════════════
+
+int main(void)
+{
+  test_handshake();
+  test_auth_invalid();
+  test_snapshot_and_changes();
+  test_fragmented();
+  test_oversize_and_garbage();
+
+  clear_sent();
+  free(message_buf);
+  return host_test_result("ha_ws");
+}
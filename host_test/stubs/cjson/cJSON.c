@@ -0,0 +1,686 @@
+/**
+ * @file cJSON.c
+ * @brief Host stand-in for cJSON when the library is not installed
+ *
+ * A small recursive-descent parser and printer over the cJSON item tree;
+ * see cJSON.h for what is covered.
+ */
+
+#include "cJSON.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// ITEMS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static cJSON *new_item(int type)
+{
+  cJSON *item = calloc(1, sizeof(cJSON));
+  if (item)
+  {
+    item->type = type;
+  }
+  return item;
+}
+
+static char *copy_string(const char *s)
+{
+  size_t len = strlen(s) + 1;
+  char *copy = malloc(len);
+  if (copy)
+  {
+    memcpy(copy, s, len);
+  }
+  return copy;
+}
+
+static void set_number(cJSON *item, double num)
+{
+  item->valuedouble = num;
+  if (num >= INT_MAX)
+  {
+    item->valueint = INT_MAX;
+  }
+  else if (num <= (double)INT_MIN)
+  {
+    item->valueint = INT_MIN;
+  }
+  else
+  {
+    item->valueint = (int)num;
+  }
+}
+
+static void append_child(cJSON *parent, cJSON *item)
+{
+  cJSON *last = parent->child;
+  if (!last)
+  {
+    parent->child = item;
+    return;
+  }
+  while (last->next)
+  {
+    last = last->next;
+  }
+  last->next = item;
+  item->prev = last;
+}
+
+void cJSON_Delete(cJSON *item)
+{
+  while (item)
+  {
+    cJSON *next = item->next;
+    cJSON_Delete(item->child);
+    free(item->valuestring);
+    free(item->string);
+    free(item);
+    item = next;
+  }
+}
+
+cJSON *cJSON_CreateObject(void)
+{
+  return new_item(cJSON_Object);
+}
+
+cJSON *cJSON_CreateArray(void)
+{
+  return new_item(cJSON_Array);
+}
+
+cJSON *cJSON_CreateString(const char *string)
+{
+  cJSON *item = new_item(cJSON_String);
+  if (item && !(item->valuestring = copy_string(string)))
+  {
+    free(item);
+    return NULL;
+  }
+  return item;
+}
+
+cJSON *cJSON_CreateNumber(double num)
+{
+  cJSON *item = new_item(cJSON_Number);
+  if (item)
+  {
+    set_number(item, num);
+  }
+  return item;
+}
+
+cJSON_bool cJSON_AddItemToArray(cJSON *array, cJSON *item)
+{
+  if (!array || !item || array == item)
+  {
+    return false;
+  }
+  append_child(array, item);
+  return true;
+}
+
+cJSON_bool cJSON_AddItemToObject(cJSON *object, const char *string, cJSON *item)
+{
+  if (!object || !string || !item || object == item)
+  {
+    return false;
+  }
+  char *key = copy_string(string);
+  if (!key)
+  {
+    return false;
+  }
+  free(item->string);
+  item->string = key;
+  append_child(object, item);
+  return true;
+}
+
+static cJSON *add_or_delete(cJSON *object, const char *name, cJSON *item)
+{
+  if (cJSON_AddItemToObject(object, name, item))
+  {
+    return item;
+  }
+  cJSON_Delete(item);
+  return NULL;
+}
+
+cJSON *cJSON_AddStringToObject(cJSON *object, const char *name, const char *string)
+{
+  return add_or_delete(object, name, cJSON_CreateString(string));
+}
+
+cJSON *cJSON_AddNumberToObject(cJSON *object, const char *name, double number)
+{
+  return add_or_delete(object, name, cJSON_CreateNumber(number));
+}
+
+cJSON *cJSON_AddArrayToObject(cJSON *object, const char *name)
+{
+  return add_or_delete(object, name, cJSON_CreateArray());
+}
+
+cJSON *cJSON_GetObjectItem(const cJSON *object, const char *string)
+{
+  if (!object || !string)
+  {
+    return NULL;
+  }
+  cJSON *item = object->child;
+  while (item && (!item->string || strcasecmp(item->string, string) != 0))
+  {
+    item = item->next;
+  }
+  return item;
+}
+
+char *cJSON_GetStringValue(const cJSON *item)
+{
+  return cJSON_IsString(item) ? item->valuestring : NULL;
+}
+
+cJSON_bool cJSON_IsTrue(const cJSON *item)
+{
+  return item && (item->type & 0xff) == cJSON_True;
+}
+
+cJSON_bool cJSON_IsNumber(const cJSON *item)
+{
+  return item && (item->type & 0xff) == cJSON_Number;
+}
+
+cJSON_bool cJSON_IsString(const cJSON *item)
+{
+  return item && (item->type & 0xff) == cJSON_String;
+}
+
+cJSON_bool cJSON_IsArray(const cJSON *item)
+{
+  return item && (item->type & 0xff) == cJSON_Array;
+}
+
+cJSON_bool cJSON_IsObject(const cJSON *item)
+{
+  return item && (item->type & 0xff) == cJSON_Object;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PARSER
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct
+{
+  const char *p;
+  int depth;
+} parse_ctx_t;
+
+static void skip_ws(parse_ctx_t *ctx)
+{
+  while (*ctx->p == ' ' || *ctx->p == '\t' || *ctx->p == '\n' || *ctx->p == '\r')
+  {
+    ctx->p++;
+  }
+}
+
+static bool parse_value(parse_ctx_t *ctx, cJSON *item);
+
+static int hex_digit(char c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+static bool parse_hex4(const char *p, uint32_t *out)
+{
+  uint32_t v = 0;
+  for (int i = 0; i < 4; i++)
+  {
+    int d = hex_digit(p[i]);
+    if (d < 0)
+    {
+      return false;
+    }
+    v = (v << 4) | (uint32_t)d;
+  }
+  *out = v;
+  return true;
+}
+
+static size_t put_utf8(char *out, uint32_t cp)
+{
+  if (cp < 0x80)
+  {
+    out[0] = (char)cp;
+    return 1;
+  }
+  if (cp < 0x800)
+  {
+    out[0] = (char)(0xC0 | (cp >> 6));
+    out[1] = (char)(0x80 | (cp & 0x3F));
+    return 2;
+  }
+  if (cp < 0x10000)
+  {
+    out[0] = (char)(0xE0 | (cp >> 12));
+    out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[2] = (char)(0x80 | (cp & 0x3F));
+    return 3;
+  }
+  out[0] = (char)(0xF0 | (cp >> 18));
+  out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+  out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+  out[3] = (char)(0x80 | (cp & 0x3F));
+  return 4;
+}
+
+/**
+ * @brief Parse a quoted string; ctx->p points at the opening quote
+ * @return Decoded copy, or NULL on malformed input
+ */
+static char *parse_string(parse_ctx_t *ctx)
+{
+  const char *start = ++ctx->p;
+  const char *end = start;
+  while (*end != '"')
+  {
+    if (*end == '\0' || (unsigned char)*end < 0x20)
+    {
+      return NULL;
+    }
+    if (*end == '\\' && *++end == '\0')
+    {
+      return NULL;
+    }
+    end++;
+  }
+
+  // Escapes only ever shrink
+  char *out = malloc((size_t)(end - start) + 1);
+  if (!out)
+  {
+    return NULL;
+  }
+
+  size_t n = 0;
+  for (const char *p = start; p < end; p++)
+  {
+    if (*p != '\\')
+    {
+      out[n++] = *p;
+      continue;
+    }
+    switch (*++p)
+    {
+    case '"':
+    case '\\':
+    case '/':
+      out[n++] = *p;
+      break;
+    case 'b':
+      out[n++] = '\b';
+      break;
+    case 'f':
+      out[n++] = '\f';
+      break;
+    case 'n':
+      out[n++] = '\n';
+      break;
+    case 'r':
+      out[n++] = '\r';
+      break;
+    case 't':
+      out[n++] = '\t';
+      break;
+    case 'u':
+    {
+      uint32_t cp;
+      if (end - p < 5 || !parse_hex4(p + 1, &cp))
+      {
+        free(out);
+        return NULL;
+      }
+      p += 4;
+
+      // A high surrogate must be followed by its low half
+      if (cp >= 0xD800 && cp <= 0xDBFF)
+      {
+        uint32_t low;
+        if (end - p < 7 || p[1] != '\\' || p[2] != 'u' || !parse_hex4(p + 3, &low) || low < 0xDC00 || low > 0xDFFF)
+        {
+          free(out);
+          return NULL;
+        }
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        p += 6;
+      }
+      else if (cp >= 0xDC00 && cp <= 0xDFFF)
+      {
+        free(out);
+        return NULL;
+      }
+      n += put_utf8(out + n, cp);
+      break;
+    }
+    default:
+      free(out);
+      return NULL;
+    }
+  }
+  out[n] = '\0';
+  ctx->p = end + 1;
+  return out;
+}
+
+static bool parse_number(parse_ctx_t *ctx, cJSON *item)
+{
+  char *end;
+  double num = strtod(ctx->p, &end);
+  if (end == ctx->p)
+  {
+    return false;
+  }
+  item->type = cJSON_Number;
+  set_number(item, num);
+  ctx->p = end;
+  return true;
+}
+
+/**
+ * @brief Parse the members of an array or object; ctx->p points at '[' or '{'
+ */
+static bool parse_container(parse_ctx_t *ctx, cJSON *item, bool object)
+{
+  char close = object ? '}' : ']';
+  if (++ctx->depth > CJSON_NESTING_LIMIT)
+  {
+    return false;
+  }
+  item->type = object ? cJSON_Object : cJSON_Array;
+  ctx->p++;
+  skip_ws(ctx);
+  if (*ctx->p == close)
+  {
+    ctx->p++;
+    ctx->depth--;
+    return true;
+  }
+
+  while (true)
+  {
+    cJSON *child = new_item(cJSON_Invalid);
+    if (!child)
+    {
+      return false;
+    }
+    append_child(item, child);
+
+    if (object)
+    {
+      skip_ws(ctx);
+      if (*ctx->p != '"' || !(child->string = parse_string(ctx)))
+      {
+        return false;
+      }
+      skip_ws(ctx);
+      if (*ctx->p++ != ':')
+      {
+        return false;
+      }
+    }
+    if (!parse_value(ctx, child))
+    {
+      return false;
+    }
+
+    skip_ws(ctx);
+    if (*ctx->p == ',')
+    {
+      ctx->p++;
+      continue;
+    }
+    if (*ctx->p != close)
+    {
+      return false;
+    }
+    ctx->p++;
+    ctx->depth--;
+    return true;
+  }
+}
+
+static bool parse_value(parse_ctx_t *ctx, cJSON *item)
+{
+  skip_ws(ctx);
+  switch (*ctx->p)
+  {
+  case '{':
+    return parse_container(ctx, item, true);
+  case '[':
+    return parse_container(ctx, item, false);
+  case '"':
+    item->type = cJSON_String;
+    return (item->valuestring = parse_string(ctx)) != NULL;
+  case 't':
+    item->type = cJSON_True;
+    item->valueint = 1;
+    return strncmp(ctx->p, "true", 4) == 0 && (ctx->p += 4);
+  case 'f':
+    item->type = cJSON_False;
+    return strncmp(ctx->p, "false", 5) == 0 && (ctx->p += 5);
+  case 'n':
+    item->type = cJSON_NULL;
+    return strncmp(ctx->p, "null", 4) == 0 && (ctx->p += 4);
+  default:
+    return (*ctx->p == '-' || isdigit((unsigned char)*ctx->p)) && parse_number(ctx, item);
+  }
+}
+
+cJSON *cJSON_Parse(const char *value)
+{
+  if (!value)
+  {
+    return NULL;
+  }
+  cJSON *item = new_item(cJSON_Invalid);
+  if (!item)
+  {
+    return NULL;
+  }
+
+  parse_ctx_t ctx = {value, 0};
+  if (!parse_value(&ctx, item))
+  {
+    cJSON_Delete(item);
+    return NULL;
+  }
+  return item;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRINTER
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct
+{
+  char *buf;
+  size_t len;
+  size_t cap;
+  bool failed;
+} print_buf_t;
+
+static void put(print_buf_t *out, const char *s, size_t n)
+{
+  if (out->failed)
+  {
+    return;
+  }
+  if (out->len + n + 1 > out->cap)
+  {
+    size_t cap = out->cap ? out->cap : 64;
+    while (out->len + n + 1 > cap)
+    {
+      cap *= 2;
+    }
+    char *grown = realloc(out->buf, cap);
+    if (!grown)
+    {
+      out->failed = true;
+      return;
+    }
+    out->buf = grown;
+    out->cap = cap;
+  }
+  memcpy(out->buf + out->len, s, n);
+  out->len += n;
+  out->buf[out->len] = '\0';
+}
+
+static void put_str(print_buf_t *out, const char *s)
+{
+  put(out, s, strlen(s));
+}
+
+static void print_string(print_buf_t *out, const char *s)
+{
+  put(out, "\"", 1);
+  for (; *s; s++)
+  {
+    unsigned char c = (unsigned char)*s;
+    char esc[8];
+    switch (c)
+    {
+    case '"':
+      put_str(out, "\\\"");
+      break;
+    case '\\':
+      put_str(out, "\\\\");
+      break;
+    case '\b':
+      put_str(out, "\\b");
+      break;
+    case '\f':
+      put_str(out, "\\f");
+      break;
+    case '\n':
+      put_str(out, "\\n");
+      break;
+    case '\r':
+      put_str(out, "\\r");
+      break;
+    case '\t':
+      put_str(out, "\\t");
+      break;
+    default:
+      if (c < 0x20)
+      {
+        snprintf(esc, sizeof(esc), "\\" "u%04x", c);
+        put_str(out, esc);
+      }
+      else
+      {
+        put(out, s, 1);
+      }
+    }
+  }
+  put(out, "\"", 1);
+}
+
+static void print_number(print_buf_t *out, double d)
+{
+  char num[32];
+  if (isnan(d) || isinf(d))
+  {
+    put_str(out, "null");
+    return;
+  }
+  if (d == (double)(int64_t)d && fabs(d) < 1e15)
+  {
+    snprintf(num, sizeof(num), "%lld", (long long)d);
+  }
+  else
+  {
+    snprintf(num, sizeof(num), "%1.15g", d);
+    if (strtod(num, NULL) != d)
+    {
+      snprintf(num, sizeof(num), "%1.17g", d);
+    }
+  }
+  put_str(out, num);
+}
+
+static void print_value(print_buf_t *out, const cJSON *item)
+{
+  switch (item->type & 0xff)
+  {
+  case cJSON_False:
+    put_str(out, "false");
+    break;
+  case cJSON_True:
+    put_str(out, "true");
+    break;
+  case cJSON_NULL:
+    put_str(out, "null");
+    break;
+  case cJSON_Number:
+    print_number(out, item->valuedouble);
+    break;
+  case cJSON_String:
+    print_string(out, item->valuestring ? item->valuestring : "");
+    break;
+  case cJSON_Array:
+  case cJSON_Object:
+  {
+    bool object = (item->type & 0xff) == cJSON_Object;
+    put(out, object ? "{" : "[", 1);
+    for (const cJSON *child = item->child; child; child = child->next)
+    {
+      if (object)
+      {
+        print_string(out, child->string ? child->string : "");
+        put(out, ":", 1);
+      }
+      print_value(out, child);
+      if (child->next)
+      {
+        put(out, ",", 1);
+      }
+    }
+    put(out, object ? "}" : "]", 1);
+    break;
+  }
+  default:
+    out->failed = true;
+  }
+}
+
+char *cJSON_PrintUnformatted(const cJSON *item)
+{
+  if (!item)
+  {
+    return NULL;
+  }
+  print_buf_t out = {0};
+  print_value(&out, item);
+  if (out.failed)
+  {
+    free(out.buf);
+    return NULL;
+  }
+  return out.buf;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file cJSON.h
+ * @brief Host stand-in for cJSON when the library is not installed
+ *
+ * Covers the part of the cJSON API the firmware's WebSocket client uses:
+ * parsing, building small objects, unformatted printing and lookups. The
+ * struct layout, type bits and semantics follow cJSON 1.7, so code written
+ * against it behaves the same with the real library. Number printing and
+ * error reporting are simpler.
+ *
+ * Kept out of the main stubs directory so it never shadows the real header
+ * used by the benchmark baselines.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define cJSON_Invalid (0)
+#define cJSON_False (1 << 0)
+#define cJSON_True (1 << 1)
+#define cJSON_NULL (1 << 2)
+#define cJSON_Number (1 << 3)
+#define cJSON_String (1 << 4)
+#define cJSON_Array (1 << 5)
+#define cJSON_Object (1 << 6)
+#define cJSON_Raw (1 << 7)
+
+/** Nesting depth beyond which cJSON_Parse() gives up, as in cJSON */
+#define CJSON_NESTING_LIMIT 1000
+
+typedef int cJSON_bool;
+
+typedef struct cJSON
+{
+  struct cJSON *next;
+  struct cJSON *prev;
+  struct cJSON *child;
+  int type;
+  char *valuestring;
+  int valueint;
+  double valuedouble;
+  char *string; ///< Key when the item is an object member
+} cJSON;
+
+cJSON *cJSON_Parse(const char *value);
+char *cJSON_PrintUnformatted(const cJSON *item);
+void cJSON_Delete(cJSON *item);
+
+cJSON *cJSON_CreateObject(void);
+cJSON *cJSON_CreateArray(void);
+cJSON *cJSON_CreateString(const char *string);
+cJSON *cJSON_CreateNumber(double num);
+
+cJSON_bool cJSON_AddItemToArray(cJSON *array, cJSON *item);
+cJSON_bool cJSON_AddItemToObject(cJSON *object, const char *string, cJSON *item);
+cJSON *cJSON_AddStringToObject(cJSON *object, const char *name, const char *string);
+cJSON *cJSON_AddNumberToObject(cJSON *object, const char *name, double number);
+cJSON *cJSON_AddArrayToObject(cJSON *object, const char *name);
+
+/** Case-insensitive, as in cJSON */
+cJSON *cJSON_GetObjectItem(const cJSON *object, const char *string);
+char *cJSON_GetStringValue(const cJSON *item);
+
+cJSON_bool cJSON_IsTrue(const cJSON *item);
+cJSON_bool cJSON_IsNumber(const cJSON *item);
+cJSON_bool cJSON_IsString(const cJSON *item);
+cJSON_bool cJSON_IsArray(const cJSON *item);
+cJSON_bool cJSON_IsObject(const cJSON *item);
+
+#define cJSON_ArrayForEach(element, array) \
+  for (element = (array != NULL) ? (array)->child : NULL; element != NULL; element = element->next)
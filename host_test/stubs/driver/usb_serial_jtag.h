@@ -0,0 +1,37 @@
+/**
+ * @file usb_serial_jtag.h
+ * @brief Host stand-in for the USB-Serial-JTAG driver: never installed
+ */
+
+#pragma once
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct
+{
+  uint32_t tx_buffer_size;
+  uint32_t rx_buffer_size;
+} usb_serial_jtag_driver_config_t;
+
+#define USB_SERIAL_JTAG_DRIVER_CONFIG_DEFAULT() {.tx_buffer_size = 256, .rx_buffer_size = 256}
+
+static inline bool usb_serial_jtag_is_driver_installed(void)
+{
+  return false;
+}
+
+static inline esp_err_t usb_serial_jtag_driver_install(usb_serial_jtag_driver_config_t *config)
+{
+  (void)config;
+  return ESP_ERR_NOT_SUPPORTED;
+}
+
+static inline int usb_serial_jtag_write_bytes(const void *src, size_t size, TickType_t ticks)
+{
+  (void)src, (void)ticks;
+  return (int)size;
+}
@@ -0,0 +1,13 @@
+/**
+ * @file esp_http_client.h
+ * @brief Host stand-in for the HTTP client header pulled in by ha_api.h
+ *
+ * The tested modules only need the header and what it pulls in (size_t);
+ * no client calls are made on the host.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+typedef struct esp_http_client *esp_http_client_handle_t;
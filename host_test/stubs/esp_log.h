@@ -0,0 +1,32 @@
+/**
+ * @file esp_log.h
+ * @brief Host stand-in for ESP-IDF logging
+ *
+ * Silent unless HOST_TEST_LOG is set in the environment, so test output
+ * stays readable. Format strings are written for the 32-bit target, so
+ * they are not checked here.
+ */
+
+#pragma once
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static inline void host_log(char level, const char *tag, const char *fmt, ...)
+{
+  if (!getenv("HOST_TEST_LOG"))
+    return;
+
+  va_list args;
+  va_start(args, fmt);
+  fprintf(stderr, "%c (%s) ", level, tag);
+  vfprintf(stderr, fmt, args);
+  fputc('\n', stderr);
+  va_end(args);
+}
+
+#define ESP_LOGE(tag, fmt, ...) host_log('E', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) host_log('W', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) host_log('I', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) host_log('D', tag, fmt, ##__VA_ARGS__)
@@ -0,0 +1,13 @@
+/**
+ * @file esp_memory_utils.h
+ * @brief Host stand-in for the address range checks
+ *
+ * There is no flash mapping on the host; each test that needs it defines
+ * which pointers count as flash data (DROM).
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+bool esp_ptr_in_drom(const void *p);
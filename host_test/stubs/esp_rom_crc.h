@@ -0,0 +1,18 @@
+/**
+ * @file esp_rom_crc.h
+ * @brief Host stand-in for the ROM CRC-32, on zlib
+ *
+ * esp_rom_crc32_le(0, ...) is the gzip/zlib CRC-32, so zlib's crc32()
+ * gives the same values.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zlib.h>
+
+static inline uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+  return (uint32_t)crc32(crc, buf, len);
+}
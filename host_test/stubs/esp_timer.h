@@ -0,0 +1,12 @@
+/**
+ * @file esp_timer.h
+ * @brief Host stand-in for the microsecond clock
+ *
+ * Defined by each test that needs it, so the test controls time.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
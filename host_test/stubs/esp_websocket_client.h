@@ -0,0 +1,76 @@
+/**
+ * @file esp_websocket_client.h
+ * @brief Host stand-in for the esp_websocket_client component
+ *
+ * Types and event IDs follow esp_websocket_client 1.x. The functions are
+ * defined by each test that needs them, so the test plays the server: it
+ * captures what is sent and calls the registered handler with the events
+ * and frame pieces the client task would deliver.
+ */
+
+#pragma once
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef const char *esp_event_base_t;
+typedef void (*esp_event_handler_t)(void *arg, esp_event_base_t base, int32_t event_id, void *event_data);
+
+typedef struct esp_websocket_client *esp_websocket_client_handle_t;
+
+typedef enum
+{
+  WEBSOCKET_EVENT_ANY = -1,
+  WEBSOCKET_EVENT_ERROR = 0,
+  WEBSOCKET_EVENT_CONNECTED,
+  WEBSOCKET_EVENT_DISCONNECTED,
+  WEBSOCKET_EVENT_DATA,
+  WEBSOCKET_EVENT_CLOSED,
+  WEBSOCKET_EVENT_BEFORE_CONNECT,
+  WEBSOCKET_EVENT_BEGIN,
+  WEBSOCKET_EVENT_FINISH,
+  WEBSOCKET_EVENT_MAX
+} esp_websocket_event_id_t;
+
+/**
+ * @brief One piece of a received frame
+ *
+ * A frame larger than the client buffer arrives as several events with the
+ * same op_code, payload_len and fin, and a growing payload_offset.
+ */
+typedef struct
+{
+  const char *data_ptr;
+  int data_len;
+  bool fin;
+  uint8_t op_code;
+  esp_websocket_client_handle_t client;
+  void *user_context;
+  int payload_len;
+  int payload_offset;
+} esp_websocket_event_data_t;
+
+typedef struct
+{
+  const char *uri;
+  int task_stack;
+  int buffer_size;
+  int reconnect_timeout_ms;
+  int network_timeout_ms;
+  size_t ping_interval_sec;
+  size_t pingpong_timeout_sec;
+} esp_websocket_client_config_t;
+
+esp_websocket_client_handle_t esp_websocket_client_init(const esp_websocket_client_config_t *config);
+esp_err_t esp_websocket_register_events(esp_websocket_client_handle_t client, esp_websocket_event_id_t event,
+                                        esp_event_handler_t handler, void *handler_args);
+esp_err_t esp_websocket_client_start(esp_websocket_client_handle_t client);
+esp_err_t esp_websocket_client_stop(esp_websocket_client_handle_t client);
+esp_err_t esp_websocket_client_destroy(esp_websocket_client_handle_t client);
+int esp_websocket_client_send_text(esp_websocket_client_handle_t client, const char *data, int len,
+                                   TickType_t timeout);
+bool esp_websocket_client_is_connected(esp_websocket_client_handle_t client);
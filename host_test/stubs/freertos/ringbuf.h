@@ -0,0 +1,85 @@
+/**
+ * @file ringbuf.h
+ * @brief Host stand-in for a no-split FreeRTOS ring buffer
+ *
+ * Items are separate allocations kept in FIFO order. Capacity is counted
+ * the way the real ring counts it (8-byte header, 4-byte aligned items),
+ * so a full ring rejects sends at about the same fill level.
+ */
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+#include <stdlib.h>
+
+#define RINGBUF_TYPE_NOSPLIT 0
+#define HOST_RINGBUF_MAX_ITEMS 4096
+
+typedef struct
+{
+  size_t capacity;
+  size_t used;
+  size_t head;
+  size_t count;
+  void *items[HOST_RINGBUF_MAX_ITEMS];
+  size_t sizes[HOST_RINGBUF_MAX_ITEMS];
+} host_ringbuf_t;
+
+typedef host_ringbuf_t *RingbufHandle_t;
+
+static inline size_t host_ringbuf_cost(size_t size)
+{
+  return 8 + ((size + 3) & ~(size_t)3);
+}
+
+static inline RingbufHandle_t xRingbufferCreateWithCaps(size_t size, int type, unsigned caps)
+{
+  (void)type, (void)caps;
+  RingbufHandle_t ring = calloc(1, sizeof(*ring));
+  if (ring)
+    ring->capacity = size;
+  return ring;
+}
+
+/** Items are committed at once; the ring is drained from the same thread */
+static inline BaseType_t xRingbufferSendAcquire(RingbufHandle_t ring, void **item, size_t size, TickType_t ticks)
+{
+  (void)ticks;
+  if (ring->count == HOST_RINGBUF_MAX_ITEMS || ring->used + host_ringbuf_cost(size) > ring->capacity)
+    return pdFALSE;
+
+  size_t slot = (ring->head + ring->count) % HOST_RINGBUF_MAX_ITEMS;
+  ring->items[slot] = malloc(size ? size : 1);
+  ring->sizes[slot] = size;
+  ring->used += host_ringbuf_cost(size);
+  ring->count++;
+  *item = ring->items[slot];
+  return pdTRUE;
+}
+
+static inline BaseType_t xRingbufferSendComplete(RingbufHandle_t ring, void *item)
+{
+  (void)ring, (void)item;
+  return pdTRUE;
+}
+
+/** The oldest item, or NULL at once when the ring is empty */
+static inline void *xRingbufferReceive(RingbufHandle_t ring, size_t *size, TickType_t ticks)
+{
+  (void)ticks;
+  if (!ring->count)
+    return NULL;
+  *size = ring->sizes[ring->head];
+  return ring->items[ring->head];
+}
+
+static inline void vRingbufferReturnItem(RingbufHandle_t ring, void *item)
+{
+  if (!ring->count || ring->items[ring->head] != item)
+    return;
+  ring->used -= host_ringbuf_cost(ring->sizes[ring->head]);
+  ring->head = (ring->head + 1) % HOST_RINGBUF_MAX_ITEMS;
+  ring->count--;
+  free(item);
+}
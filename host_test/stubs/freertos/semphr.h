@@ -0,0 +1,28 @@
+/**
+ * @file semphr.h
+ * @brief Host stand-in for FreeRTOS mutexes (single-threaded: always free)
+ */
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef void *SemaphoreHandle_t;
+
+static inline SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+  static int mutex;
+  return &mutex;
+}
+
+static inline BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+  (void)sem, (void)ticks;
+  return pdTRUE;
+}
+
+static inline BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+  (void)sem;
+  return pdTRUE;
+}
@@ -0,0 +1,25 @@
+/**
+ * @file task.h
+ * @brief Host stand-in for FreeRTOS tasks: none are ever started
+ */
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+static inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                                 UBaseType_t priority, TaskHandle_t *handle, BaseType_t core)
+{
+  (void)fn, (void)name, (void)stack, (void)arg, (void)priority, (void)core;
+  if (handle)
+    *handle = NULL;
+  return pdFAIL;
+}
+
+static inline void vTaskDelay(TickType_t ticks)
+{
+  (void)ticks;
+}
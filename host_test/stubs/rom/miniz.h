@@ -0,0 +1,85 @@
+/**
+ * @file miniz.h
+ * @brief Host stand-in for the tinfl inflater in the ESP32 ROM, on zlib
+ *
+ * Implements the part of the tinfl API ha_gzip uses: raw deflate, fed in
+ * pieces (TINFL_FLAG_HAS_MORE_INPUT), writing at `next` up to `out_size`
+ * bytes, with the same status codes and consumed/produced counts. zlib
+ * keeps its own history, so the caller's window is only written, never
+ * read back as tinfl does; the wrap arithmetic of the caller is still
+ * exercised. zlib's allocations come from an arena inside the decompressor,
+ * so, like tinfl, it is plain data that needs no cleanup.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <zlib.h>
+
+#define TINFL_LZ_DICT_SIZE 32768
+#define TINFL_FLAG_HAS_MORE_INPUT 2
+
+typedef enum
+{
+  TINFL_STATUS_FAILED = -1,
+  TINFL_STATUS_DONE = 0,
+  TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+  TINFL_STATUS_HAS_MORE_OUTPUT = 2,
+} tinfl_status;
+
+typedef struct
+{
+  z_stream z;
+  size_t arena_used;
+  _Alignas(16) uint8_t arena[48 * 1024]; ///< Inflate state (~7 KB) and window (32 KB)
+} tinfl_decompressor;
+
+static inline voidpf tinfl_host_alloc(voidpf opaque, uInt items, uInt size)
+{
+  tinfl_decompressor *r = opaque;
+  size_t bytes = ((size_t)items * size + 15) & ~(size_t)15;
+  if (r->arena_used + bytes > sizeof(r->arena))
+    return Z_NULL;
+  voidpf block = r->arena + r->arena_used;
+  r->arena_used += bytes;
+  return block;
+}
+
+static inline void tinfl_host_free(voidpf opaque, voidpf address)
+{
+  (void)opaque;
+  (void)address;
+}
+
+static inline void tinfl_init(tinfl_decompressor *r)
+{
+  memset(&r->z, 0, sizeof(r->z));
+  r->arena_used = 0;
+  r->z.zalloc = tinfl_host_alloc;
+  r->z.zfree = tinfl_host_free;
+  r->z.opaque = r;
+  inflateInit2(&r->z, -15);
+}
+
+static inline tinfl_status tinfl_decompress(tinfl_decompressor *r, const uint8_t *in, size_t *in_size,
+                                            uint8_t *out_start, uint8_t *out_next, size_t *out_size, uint32_t flags)
+{
+  (void)out_start;
+  (void)flags;
+  r->z.next_in = (Bytef *)in;
+  r->z.avail_in = (uInt)*in_size;
+  r->z.next_out = out_next;
+  r->z.avail_out = (uInt)*out_size;
+
+  int rc = inflate(&r->z, Z_NO_FLUSH);
+  *in_size -= r->z.avail_in;
+  *out_size -= r->z.avail_out;
+
+  if (rc == Z_STREAM_END)
+    return TINFL_STATUS_DONE;
+  if (rc != Z_OK && rc != Z_BUF_ERROR)
+    return TINFL_STATUS_FAILED;
+  return r->z.avail_out == 0 ? TINFL_STATUS_HAS_MORE_OUTPUT : TINFL_STATUS_NEEDS_MORE_INPUT;
+}
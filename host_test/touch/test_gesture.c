@@ -0,0 +1,189 @@
+/**
+ * @file test_gesture.c
+ * @brief Replay touch traces through the gesture recognizer and compare
+ *        the result with the recorded expectations
+ *
+ * Usage: test_gesture <trace.ttrace> [...]
+ *
+ * Each trace has a .expected file next to it with one gesture per line in
+ * the trace_replay_format() layout (empty when the trace must produce
+ * nothing). touch_replay writes that format, so a new recording becomes a
+ * test case once its output has been checked by hand.
+ */
+
+#include "host_test.h"
+#include "trace_replay.h"
+
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define MAX_EVENTS 256
+
+/**
+ * @brief Gestures the traces must cover between them
+ */
+typedef enum
+{
+  KIND_SWIPE = 0,
+  KIND_PINCH_BEGIN,
+  KIND_PINCH_UPDATE,
+  KIND_PINCH_END,
+  KIND_TWO_FINGER_TAP,
+  KIND_LONG_PRESS,
+  KIND_COUNT,
+} event_kind_t;
+
+static const char *const kind_names[KIND_COUNT] = {
+    "swipe", "pinch begin", "pinch update", "pinch end", "two-finger tap", "long press",
+};
+
+static bool seen[KIND_COUNT];
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CHECKS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static event_kind_t kind_of(const gesture_event_t *event)
+{
+  switch (event->type)
+  {
+  case GESTURE_SWIPE:
+    return KIND_SWIPE;
+  case GESTURE_PINCH:
+    return KIND_PINCH_BEGIN + event->phase;
+  case GESTURE_TWO_FINGER_TAP:
+    return KIND_TWO_FINGER_TAP;
+  default:
+    return KIND_LONG_PRESS;
+  }
+}
+
+/**
+ * @brief Pinch events come as begin, updates, end, with the scale moving
+ *        one way and only reported after a change of at least one step
+ */
+static void check_pinch_order(const char *path, const trace_replay_event_t *events, size_t count)
+{
+  bool open = false;
+  int32_t last_scale = GESTURE_SCALE_ONE;
+  int direction = 0;
+
+  for (size_t i = 0; i < count; i++)
+  {
+    const gesture_event_t *e = &events[i].event;
+    if (e->type != GESTURE_PINCH)
+      continue;
+
+    switch (e->phase)
+    {
+    case GESTURE_PHASE_BEGIN:
+      CHECK(!open);
+      open = true;
+      direction = e->scale_q8 > GESTURE_SCALE_ONE ? 1 : -1;
+      break;
+    case GESTURE_PHASE_UPDATE:
+      CHECK(open);
+      CHECK((e->scale_q8 - last_scale) * direction >= GESTURE_PINCH_STEP_Q8);
+      break;
+    case GESTURE_PHASE_END:
+      CHECK(open);
+      CHECK((e->scale_q8 - last_scale) * direction >= 0);
+      open = false;
+      break;
+    }
+    last_scale = e->scale_q8;
+  }
+  if (open)
+    fprintf(stderr, "%s: pinch never ended\n", path);
+  CHECK(!open);
+}
+
+static void check_trace(const char *path)
+{
+  static trace_replay_event_t events[MAX_EVENTS];
+  touch_trace_t trace;
+
+  if (!trace_replay_load(path, &trace))
+  {
+    CHECK(!"trace loads");
+    return;
+  }
+  size_t count = trace_replay_gestures(&trace, events, MAX_EVENTS);
+  free(trace.buf);
+  CHECK(count <= MAX_EVENTS);
+  if (count > MAX_EVENTS)
+    count = MAX_EVENTS;
+
+  // <name>.ttrace -> <name>.expected
+  char expected_path[512];
+  const char *ext = strrchr(path, '.');
+  int stem = ext ? (int)(ext - path) : (int)strlen(path);
+  snprintf(expected_path, sizeof(expected_path), "%.*s.expected", stem, path);
+
+  size_t len;
+  char *expected = host_test_read_file(expected_path, &len);
+  if (!expected)
+  {
+    fprintf(stderr, "%s: cannot read\n", expected_path);
+    CHECK(!"expected file readable");
+    return;
+  }
+
+  const char *p = expected;
+  size_t line_no = 0;
+  for (; *p; line_no++)
+  {
+    size_t n = strcspn(p, "\r\n");
+    char actual[128] = "(nothing)";
+    if (line_no < count)
+      trace_replay_format(&events[line_no], actual, sizeof(actual));
+
+    if (strlen(actual) != n || strncmp(actual, p, n) != 0)
+    {
+      fprintf(stderr, "%s:%zu: expected \"%.*s\", got \"%s\"\n", expected_path, line_no + 1, (int)n, p, actual);
+      CHECK(!"gesture matches .expected");
+    }
+    p += n;
+    p += strspn(p, "\r\n");
+  }
+  for (size_t i = line_no; i < count; i++)
+  {
+    char actual[128];
+    trace_replay_format(&events[i], actual, sizeof(actual));
+    fprintf(stderr, "%s: unexpected \"%s\"\n", path, actual);
+    CHECK(!"no gestures beyond .expected");
+  }
+  free(expected);
+
+  check_pinch_order(path, events, count);
+  for (size_t i = 0; i < count; i++)
+    seen[kind_of(&events[i].event)] = true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MAIN
+// ═══════════════════════════════════════════════════════════════════════════════
+
+int main(int argc, char **argv)
+{
+  if (argc < 2)
+  {
+    fprintf(stderr, "usage: %s <trace.ttrace> [...]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  for (int i = 1; i < argc; i++)
+    check_trace(argv[i]);
+
+  for (int k = 0; k < KIND_COUNT; k++)
+  {
+    if (!seen[k])
+      fprintf(stderr, "no trace produces a %s\n", kind_names[k]);
+    CHECK(seen[k]);
+  }
+
+  return host_test_result("gesture");
+}
@@ -0,0 +1,311 @@
+/**
+ * @file test_touch_trace.c
+ * @brief Host tests for the touch trace codec and the dump loader
+ */
+
+#include "host_test.h"
+#include "trace_replay.h"
+
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static uint8_t storage[16384];
+
+static void random_frame(uint32_t *rng, touch_trace_frame_t *frame, uint32_t *time_ms)
+{
+  // Mostly 10 ms reports, now and then a pause longer than a u16 delta
+  uint32_t r = host_test_rand(rng);
+  *time_ms += r % 64 == 0 ? 60000 + r % 20000 : 5 + r % 20;
+
+  frame->time_ms = *time_ms;
+  frame->count = (uint8_t)(host_test_rand(rng) % (TOUCH_TRACE_MAX_POINTS + 1));
+  for (uint8_t i = 0; i < frame->count; i++)
+  {
+    frame->points[i].track_id = (uint8_t)host_test_rand(rng);
+    frame->points[i].x = (uint16_t)(host_test_rand(rng) & 0xFFF);
+    frame->points[i].y = (uint16_t)(host_test_rand(rng) & 0xFFF);
+  }
+}
+
+static bool same_points(const touch_trace_frame_t *a, const touch_trace_frame_t *b)
+{
+  if (a->count != b->count)
+    return false;
+  for (uint8_t i = 0; i < a->count; i++)
+  {
+    if (a->points[i].track_id != b->points[i].track_id || a->points[i].x != b->points[i].x ||
+        a->points[i].y != b->points[i].y)
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Print a trace the way gt911_trace_dump() does, with optional noise
+ * @return malloc'd dump text
+ */
+static char *make_dump(const touch_trace_t *trace, int version, long frames_delta, bool noise, bool crlf,
+                       int skip_data_line)
+{
+  const char *nl = crlf ? "\r\n" : "\n";
+  size_t cap = 256 + trace->len * 2 + (trace->len / TOUCH_TRACE_HEX_CHUNK + 1) * 200;
+  char *text = malloc(cap);
+  size_t n = 0;
+
+  if (noise)
+    n += (size_t)snprintf(text + n, cap - n, "I (47002) GT911: Touch trace stopped%s", nl);
+  n += (size_t)snprintf(text + n, cap - n, "TTRACE begin %d %lu %u%s", version,
+                        (unsigned long)((long)trace->frames + frames_delta), (unsigned)trace->len, nl);
+
+  int line = 0;
+  for (size_t pos = 0; pos < trace->len; pos += TOUCH_TRACE_HEX_CHUNK, line++)
+  {
+    char hex[2 * TOUCH_TRACE_HEX_CHUNK + 1];
+    size_t len = trace->len - pos < TOUCH_TRACE_HEX_CHUNK ? trace->len - pos : TOUCH_TRACE_HEX_CHUNK;
+    touch_trace_hex_encode(trace->buf + pos, len, hex);
+    if (line != skip_data_line)
+      n += (size_t)snprintf(text + n, cap - n, "TTRACE data %s%s", hex, nl);
+    if (noise && line == 1)
+      n += (size_t)snprintf(text + n, cap - n, "W (48213) HA_WS: ping timeout%s%s", nl, nl);
+  }
+  snprintf(text + n, cap - n, "TTRACE end%s", nl);
+  return text;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CODEC
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void test_round_trip(void)
+{
+  static touch_trace_frame_t frames[1000];
+  touch_trace_t trace;
+  uint32_t rng = 0x7AC3;
+  uint32_t time_ms = 0;
+  size_t stored = 0;
+
+  touch_trace_init(&trace, storage, sizeof(storage));
+  for (size_t i = 0; i < sizeof(frames) / sizeof(frames[0]); i++)
+  {
+    random_frame(&rng, &frames[i], &time_ms);
+    if (!touch_trace_append(&trace, &frames[i]))
+      break;
+    stored++;
+  }
+  CHECK(stored > 500);
+  CHECK_EQ_INT(trace.frames, stored);
+
+  // Pauses longer than 65535 ms are shortened; the frames after them keep their spacing
+  touch_trace_cursor_t cursor;
+  touch_trace_frame_t frame;
+  uint32_t expected_ms = 0;
+  uint32_t skipped_ms = 0;
+  uint32_t prev_ms = 0;
+  size_t decoded = 0;
+  touch_trace_rewind(&cursor);
+  while (touch_trace_next(&trace, &cursor, &frame))
+  {
+    uint32_t dt = frames[decoded].time_ms - skipped_ms - expected_ms;
+    if (dt > UINT16_MAX)
+    {
+      skipped_ms += dt - UINT16_MAX;
+      dt = UINT16_MAX;
+    }
+    expected_ms += dt;
+    CHECK_EQ_INT(frame.time_ms, expected_ms);
+    if (decoded > 0 && frames[decoded].time_ms - frames[decoded - 1].time_ms <= UINT16_MAX)
+      CHECK_EQ_INT(frame.time_ms - prev_ms, frames[decoded].time_ms - frames[decoded - 1].time_ms);
+    prev_ms = frame.time_ms;
+    CHECK(same_points(&frame, &frames[decoded]));
+    decoded++;
+  }
+  CHECK_EQ_INT(decoded, stored);
+  CHECK_EQ_INT(trace.last_ms, expected_ms);
+  CHECK(skipped_ms > 0);
+  CHECK_EQ_INT(trace.skipped_ms, skipped_ms);
+}
+
+static void test_limits(void)
+{
+  uint8_t small[20];
+  touch_trace_t trace;
+  touch_trace_frame_t frame = {.time_ms = 10, .count = 7};
+
+  // More points than the format holds are clamped
+  touch_trace_init(&trace, storage, sizeof(storage));
+  CHECK(touch_trace_append(&trace, &frame));
+  CHECK_EQ_INT(trace.len, 3 + 4 * TOUCH_TRACE_MAX_POINTS);
+
+  // A full buffer drops frames without touching the stored ones
+  touch_trace_init(&trace, small, sizeof(small));
+  frame.count = 2;
+  CHECK(touch_trace_append(&trace, &frame)); // 11 bytes
+  CHECK(!touch_trace_append(&trace, &frame));
+  frame.count = 0;
+  CHECK(touch_trace_append(&trace, &frame)); // 3 bytes still fit
+  CHECK_EQ_INT(trace.len, 14);
+  CHECK_EQ_INT(trace.frames, 2);
+  CHECK_EQ_INT(trace.dropped, 1);
+}
+
+static void test_validate(void)
+{
+  touch_trace_t trace;
+  touch_trace_frame_t frame = {.time_ms = 300, .count = 1};
+  uint8_t copy[64];
+
+  touch_trace_init(&trace, storage, sizeof(storage));
+  touch_trace_append(&trace, &frame);
+  frame.time_ms = 310;
+  frame.count = 0;
+  touch_trace_append(&trace, &frame);
+  memcpy(copy, storage, trace.len);
+  size_t len = trace.len;
+
+  // Raw bytes are counted again on validate
+  touch_trace_init(&trace, storage, sizeof(storage));
+  CHECK(touch_trace_append_raw(&trace, copy, len));
+  CHECK(touch_trace_validate(&trace));
+  CHECK_EQ_INT(trace.frames, 2);
+  CHECK_EQ_INT(trace.last_ms, 310);
+
+  // A frame cut short is rejected
+  touch_trace_init(&trace, storage, sizeof(storage));
+  touch_trace_append_raw(&trace, copy, len - 1);
+  CHECK(!touch_trace_validate(&trace));
+
+  // So is a point count the format cannot hold
+  copy[2] = TOUCH_TRACE_MAX_POINTS + 1;
+  touch_trace_init(&trace, storage, sizeof(storage));
+  touch_trace_append_raw(&trace, copy, len);
+  CHECK(!touch_trace_validate(&trace));
+
+  // Raw data that does not fit is refused whole
+  touch_trace_init(&trace, storage, 4);
+  CHECK(!touch_trace_append_raw(&trace, copy, len));
+  CHECK_EQ_INT(trace.len, 0);
+}
+
+static void test_hex(void)
+{
+  uint8_t data[TOUCH_TRACE_HEX_CHUNK];
+  uint8_t out[TOUCH_TRACE_HEX_CHUNK];
+  char hex[2 * TOUCH_TRACE_HEX_CHUNK + 1];
+
+  for (size_t i = 0; i < sizeof(data); i++)
+    data[i] = (uint8_t)(i * 37 + 11);
+
+  touch_trace_hex_encode(data, sizeof(data), hex);
+  CHECK_EQ_INT(strlen(hex), 2 * sizeof(data));
+  CHECK_EQ_INT(touch_trace_hex_decode(hex, out, sizeof(out)), sizeof(data));
+  CHECK(memcmp(data, out, sizeof(data)) == 0);
+
+  // Oversized, odd-length and non-hex strings are refused
+  CHECK_EQ_INT(touch_trace_hex_decode(hex, out, sizeof(out) - 1), 0);
+  CHECK_EQ_INT(touch_trace_hex_decode("abc", out, sizeof(out)), 0);
+  CHECK_EQ_INT(touch_trace_hex_decode("0g", out, sizeof(out)), 0);
+
+  // Upper case is accepted; a space or line ending terminates
+  CHECK_EQ_INT(touch_trace_hex_decode("A0fF\r\n", out, sizeof(out)), 2);
+  CHECK(out[0] == 0xA0 && out[1] == 0xFF);
+  CHECK_EQ_INT(touch_trace_hex_decode("0102 0304", out, sizeof(out)), 2);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DUMP LOADER
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void test_load_dump(void)
+{
+  touch_trace_t trace;
+  touch_trace_t loaded;
+  touch_trace_frame_t frame;
+  uint32_t rng = 0x5EED;
+  uint32_t time_ms = 0;
+
+  touch_trace_init(&trace, storage, 2000);
+  for (int i = 0; i < 200; i++)
+  {
+    random_frame(&rng, &frame, &time_ms);
+    touch_trace_append(&trace, &frame);
+  }
+
+  // As saved from a serial monitor: log lines, blank lines, CRLF
+  char *text = make_dump(&trace, TOUCH_TRACE_VERSION, 0, true, true, -1);
+  CHECK(trace_replay_parse(text, &loaded));
+  CHECK_EQ_INT(loaded.len, trace.len);
+  CHECK_EQ_INT(loaded.frames, trace.frames);
+  CHECK_EQ_INT(loaded.last_ms, trace.last_ms);
+  CHECK(loaded.buf && memcmp(loaded.buf, trace.buf, trace.len) == 0);
+  free(loaded.buf);
+  free(text);
+
+  text = make_dump(&trace, TOUCH_TRACE_VERSION, 0, false, false, -1);
+  CHECK(trace_replay_parse(text, &loaded));
+  free(loaded.buf);
+  free(text);
+
+  // Rejected: unknown version, wrong frame count, a missing data line
+  text = make_dump(&trace, TOUCH_TRACE_VERSION + 1, 0, false, false, -1);
+  CHECK(!trace_replay_parse(text, &loaded));
+  CHECK(loaded.buf == NULL);
+  free(text);
+
+  text = make_dump(&trace, TOUCH_TRACE_VERSION, 1, false, false, -1);
+  CHECK(!trace_replay_parse(text, &loaded));
+  free(text);
+
+  text = make_dump(&trace, TOUCH_TRACE_VERSION, 0, false, false, 3);
+  CHECK(!trace_replay_parse(text, &loaded));
+  free(text);
+
+  // Rejected: no end, data before begin, an unknown command
+  CHECK(!trace_replay_parse("TTRACE begin 1 0 0\n", &loaded));
+  CHECK(!trace_replay_parse("TTRACE data 000000\nTTRACE begin 1 1 3\nTTRACE end\n", &loaded));
+  CHECK(!trace_replay_parse("TTRACE begin 1 0 0\nTTRACE bogus\nTTRACE end\n", &loaded));
+
+  // An empty trace is valid
+  CHECK(trace_replay_parse("TTRACE begin 1 0 0\nTTRACE end\n", &loaded));
+  CHECK_EQ_INT(loaded.frames, 0);
+  free(loaded.buf);
+}
+
+static void test_replay(void)
+{
+  touch_trace_t trace;
+  trace_replay_event_t events[4];
+  char line[128];
+
+  // One finger, 300 px to the right in 200 ms, then lifted
+  touch_trace_init(&trace, storage, sizeof(storage));
+  for (uint32_t t = 0; t <= 200; t += 10)
+  {
+    touch_trace_frame_t frame = {.time_ms = t, .count = 1, .points = {{.track_id = 0, .x = 100 + t * 3 / 2, .y = 240}}};
+    touch_trace_append(&trace, &frame);
+  }
+  touch_trace_frame_t release = {.time_ms = 210};
+  touch_trace_append(&trace, &release);
+
+  CHECK_EQ_INT(trace_replay_gestures(&trace, events, 4), 1);
+  trace_replay_format(&events[0], line, sizeof(line));
+  CHECK(strcmp(line, "210 swipe right x=100 y=240") == 0);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// MAIN
+// ═══════════════════════════════════════════════════════════════════════════════
+
+int main(void)
+{
+  test_round_trip();
+  test_limits();
+  test_validate();
+  test_hex();
+  test_load_dump();
+  test_replay();
+
+  return host_test_result("touch_trace");
+}
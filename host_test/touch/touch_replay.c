@@ -0,0 +1,85 @@
+/**
+ * @file touch_replay.c
+ * @brief Replay a touch trace dump on the host and print the gestures
+ *
+ * Usage: touch_replay [-v] <dump.ttrace> [...]
+ *
+ * Record on the device with "TTRACE record", "TTRACE stop" and
+ * "TTRACE dump" over the serial console, save the dump lines to a file,
+ * then replay it here to see what the recognizer makes of it. -v also
+ * prints every frame. Printed events use the .expected format, so
+ *
+ *   touch_replay host_test/data/touch/new.ttrace > host_test/data/touch/new.expected
+ *
+ * turns a new recording into a test case (check the output first).
+ */
+
+#include "trace_replay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_EVENTS 1024
+
+static void print_frames(const touch_trace_t *trace)
+{
+  touch_trace_cursor_t cursor;
+  touch_trace_frame_t frame;
+
+  touch_trace_rewind(&cursor);
+  while (touch_trace_next(trace, &cursor, &frame))
+  {
+    printf("# %lu ms:", (unsigned long)frame.time_ms);
+    if (frame.count == 0)
+      printf(" release");
+    for (uint8_t i = 0; i < frame.count; i++)
+      printf(" [%u] %u,%u", frame.points[i].track_id, frame.points[i].x, frame.points[i].y);
+    printf("\n");
+  }
+}
+
+int main(int argc, char **argv)
+{
+  static trace_replay_event_t events[MAX_EVENTS];
+  bool verbose = false;
+  int first = 1;
+
+  if (argc > 1 && strcmp(argv[1], "-v") == 0)
+  {
+    verbose = true;
+    first++;
+  }
+  if (first >= argc)
+  {
+    fprintf(stderr, "usage: %s [-v] <dump.ttrace> [...]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  int result = EXIT_SUCCESS;
+  for (int i = first; i < argc; i++)
+  {
+    touch_trace_t trace;
+    if (!trace_replay_load(argv[i], &trace))
+    {
+      fprintf(stderr, "%s: not a valid trace dump\n", argv[i]);
+      result = EXIT_FAILURE;
+      continue;
+    }
+
+    if (argc - first > 1)
+      printf("# %s: %u frames, %lu ms\n", argv[i], (unsigned)trace.frames, (unsigned long)trace.last_ms);
+    if (verbose)
+      print_frames(&trace);
+
+    size_t count = trace_replay_gestures(&trace, events, MAX_EVENTS);
+    for (size_t e = 0; e < count && e < MAX_EVENTS; e++)
+    {
+      char line[128];
+      trace_replay_format(&events[e], line, sizeof(line));
+      printf("%s\n", line);
+    }
+    free(trace.buf);
+  }
+  return result;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file trace_replay.c
+ * @brief Load touch trace dumps and replay them through the gesture recognizer
+ *
+ * The loader follows gt911_trace_load_line() in gt911_touch.c, so a dump
+ * that loads here also uploads to the device and the other way round.
+ */
+
+#include "trace_replay.h"
+#include "host_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static const char *const dir_names[] = {"left", "right", "up", "down"};
+static const char *const phase_names[] = {"begin", "update", "end"};
+
+/**
+ * @brief Handle one "TTRACE ..." line
+ * @return false on a malformed or out-of-order line
+ */
+static bool load_line(const char *line, touch_trace_t *trace, unsigned long *expected_frames, bool *ended)
+{
+  char cmd[8] = {0};
+  int consumed = 0;
+
+  if (sscanf(line, "TTRACE %7s %n", cmd, &consumed) != 1)
+    return false;
+  const char *arg = consumed ? line + consumed : "";
+
+  if (strcmp(cmd, "begin") == 0)
+  {
+    int version = 0;
+    unsigned long bytes = 0;
+    if (sscanf(arg, "%d %lu %lu", &version, expected_frames, &bytes) != 3 || version != TOUCH_TRACE_VERSION)
+    {
+      fprintf(stderr, "unsupported trace header: %s\n", arg);
+      return false;
+    }
+    free(trace->buf);
+    touch_trace_init(trace, malloc(bytes ? bytes : 1), bytes);
+    return trace->buf != NULL;
+  }
+
+  if (!trace->buf || *ended)
+  {
+    fprintf(stderr, "trace line outside begin/end: %s\n", line);
+    return false;
+  }
+
+  if (strcmp(cmd, "data") == 0)
+  {
+    uint8_t chunk[TOUCH_TRACE_HEX_CHUNK];
+    size_t len = touch_trace_hex_decode(arg, chunk, sizeof(chunk));
+    if (len == 0 || !touch_trace_append_raw(trace, chunk, len))
+    {
+      fprintf(stderr, "bad or oversized trace data at byte %zu\n", trace->len);
+      return false;
+    }
+    return true;
+  }
+
+  if (strcmp(cmd, "end") == 0)
+  {
+    if (!touch_trace_validate(trace) || trace->frames != *expected_frames || trace->len != trace->size)
+    {
+      fprintf(stderr, "trace incomplete: %u of %lu frames, %zu of %zu bytes\n", (unsigned)trace->frames,
+              *expected_frames, trace->len, trace->size);
+      return false;
+    }
+    *ended = true;
+    return true;
+  }
+
+  fprintf(stderr, "unknown trace command: %s\n", cmd);
+  return false;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+bool trace_replay_parse(const char *text, touch_trace_t *trace)
+{
+  unsigned long expected_frames = 0;
+  bool ended = false;
+  bool ok = true;
+  char line[2 * TOUCH_TRACE_HEX_CHUNK + 64];
+
+  memset(trace, 0, sizeof(*trace));
+
+  for (const char *p = text; *p && ok;)
+  {
+    size_t len = strcspn(p, "\r\n");
+    if (len >= 7 && strncmp(p, "TTRACE ", 7) == 0)
+    {
+      if (len >= sizeof(line))
+      {
+        fprintf(stderr, "trace line too long\n");
+        ok = false;
+        break;
+      }
+      memcpy(line, p, len);
+      line[len] = '\0';
+      ok = load_line(line, trace, &expected_frames, &ended);
+    }
+    p += len;
+    p += strspn(p, "\r\n");
+  }
+
+  if (ok && !ended)
+  {
+    fprintf(stderr, "trace has no \"TTRACE end\"\n");
+    ok = false;
+  }
+  if (!ok)
+  {
+    free(trace->buf);
+    memset(trace, 0, sizeof(*trace));
+  }
+  return ok;
+}
+
+bool trace_replay_load(const char *path, touch_trace_t *trace)
+{
+  size_t len;
+  char *text = host_test_read_file(path, &len);
+  if (!text)
+  {
+    fprintf(stderr, "%s: cannot read\n", path);
+    memset(trace, 0, sizeof(*trace));
+    return false;
+  }
+
+  bool ok = trace_replay_parse(text, trace);
+  free(text);
+  return ok;
+}
+
+size_t trace_replay_gestures(const touch_trace_t *trace, trace_replay_event_t *events, size_t max_events)
+{
+  gesture_engine_t engine;
+  touch_trace_cursor_t cursor;
+  touch_trace_frame_t frame;
+  size_t total = 0;
+
+  gesture_init(&engine);
+  touch_trace_rewind(&cursor);
+
+  while (touch_trace_next(trace, &cursor, &frame))
+  {
+    gesture_contact_t contacts[TOUCH_TRACE_MAX_POINTS];
+    gesture_event_t out[4]; // As many as the touch task collects per frame
+
+    for (uint8_t i = 0; i < frame.count; i++)
+    {
+      contacts[i].track_id = frame.points[i].track_id;
+      contacts[i].x = (int16_t)frame.points[i].x;
+      contacts[i].y = (int16_t)frame.points[i].y;
+    }
+
+    uint32_t n = gesture_update(&engine, contacts, frame.count, frame.time_ms, out, sizeof(out) / sizeof(out[0]));
+    for (uint32_t i = 0; i < n; i++, total++)
+    {
+      if (total < max_events)
+        events[total] = (trace_replay_event_t){frame.time_ms, out[i]};
+    }
+  }
+  return total;
+}
+
+void trace_replay_format(const trace_replay_event_t *event, char *out, size_t size)
+{
+  const gesture_event_t *e = &event->event;
+  unsigned long time_ms = event->time_ms;
+
+  switch (e->type)
+  {
+  case GESTURE_SWIPE:
+    snprintf(out, size, "%lu swipe %s x=%d y=%d", time_ms, dir_names[e->dir], e->x, e->y);
+    break;
+  case GESTURE_PINCH:
+    snprintf(out, size, "%lu pinch %s x=%d y=%d scale_q8=%ld", time_ms, phase_names[e->phase], e->x, e->y,
+             (long)e->scale_q8);
+    break;
+  default:
+    snprintf(out, size, "%lu %s x=%d y=%d", time_ms, gesture_type_name(e->type), e->x, e->y);
+    break;
+  }
+}
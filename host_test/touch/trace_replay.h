@@ -0,0 +1,76 @@
+/**
+ * @file trace_replay.h
+ * @brief Load touch trace dumps and replay them through the gesture recognizer
+ *
+ * A dump is the text "TTRACE dump" prints on the device's serial console:
+ *
+ *   TTRACE begin <version> <frames> <bytes>
+ *   TTRACE data <hex>
+ *   ...
+ *   TTRACE end
+ *
+ * Saved straight from a serial monitor, it may contain log lines and CRLF
+ * line endings; anything not starting with "TTRACE " is skipped. Loading
+ * checks the same things as an upload to the device (version, whole
+ * frames, frame count).
+ */
+
+#pragma once
+
+#include "gesture.h"
+#include "touch_trace.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Gesture recognized during a replay
+ */
+typedef struct
+{
+  uint32_t time_ms; ///< Trace time of the frame that produced it
+  gesture_event_t event;
+} trace_replay_event_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION PROTOTYPES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Load a dump file
+ * @param path Dump file
+ * @param trace Receives the trace; its buffer is malloc'd, free trace->buf
+ * @return true if the dump is complete and well formed (errors go to stderr)
+ */
+bool trace_replay_load(const char *path, touch_trace_t *trace);
+
+/**
+ * @brief Load a dump from memory
+ * @param text Dump text (NUL-terminated)
+ * @param trace Receives the trace; its buffer is malloc'd, free trace->buf
+ * @return true if the dump is complete and well formed (errors go to stderr)
+ */
+bool trace_replay_parse(const char *text, touch_trace_t *trace);
+
+/**
+ * @brief Feed every frame of a trace to a fresh recognizer
+ * @param trace Trace to replay
+ * @param events Receives the gestures in order
+ * @param max_events Capacity of events
+ * @return Number of gestures recognized (may exceed max_events; the rest are dropped)
+ */
+size_t trace_replay_gestures(const touch_trace_t *trace, trace_replay_event_t *events, size_t max_events);
+
+/**
+ * @brief One-line description of a gesture, as used in .expected files
+ *
+ * "<time_ms> swipe <dir> x=<x> y=<y>", "<time_ms> pinch <phase> x=<x> y=<y>
+ * scale_q8=<scale>", "<time_ms> two-finger tap x=<x> y=<y>" or
+ * "<time_ms> long press x=<x> y=<y>".
+ */
+void trace_replay_format(const trace_replay_event_t *event, char *out, size_t size);
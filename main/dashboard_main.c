@@ -6,8 +6,10 @@
 #include "lvgl.h"
 #include "lvgl/lvgl_setup.h"
 #include "lvgl/system_monitor_ui.h"
+#include "serial/async_log.h"
 #include "serial/serial_data_handler.h"
 #include "wifi/wifi_manager.h"
+#include "smart/ha_command.h"
 #include "smart/ha_task_manager.h"
 #include "smart/smart_config.h"
 #include "smart/smart_home.h"
@@ -70,6 +72,9 @@ static void ui_wifi_status_callback(const char *status_text, bool is_connected)
 
 void app_main(void)
 {
+  // Move log formatting and output off UART0 before anything else logs
+  async_log_init();
+
   ESP_LOGI(TAG, "System Monitor Dashboard started!");
 
   // Initial memory analysis - before any major allocations
@@ -191,6 +196,13 @@ void app_main(void)
     ESP_LOGE(TAG, "Failed to initialize Smart Home integration: %s", esp_err_to_name(ret));
   }
 
+  // Switch and scene touches are sent from this worker, never from the LVGL task
+  ret = ha_command_init();
+  if (ret != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to start the Home Assistant command worker: %s", esp_err_to_name(ret));
+  }
+
   ESP_LOGI(TAG, "System monitor initialized and running");
   ESP_LOGI(TAG, "UI rendering running on core 1");
 
@@ -0,0 +1,80 @@
+/**
+ * @file data_snapshot.c
+ * @brief Lock-free latest-value snapshot of the metric frame
+ *
+ * The sequence counter is odd while a publish is in progress. Readers copy
+ * the payload and retry if the counter was odd or changed meanwhile. Every
+ * completed publish advances the counter by two, so (seq / 2) doubles as a
+ * sample generation for the coalescing counters.
+ */
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "data_snapshot.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATIC VARIABLES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static atomic_uint snapshot_seq = 0;    ///< Seqlock counter (odd = write in progress)
+static metric_frame_t snapshot_data;    ///< Latest published sample
+static uint32_t consumed_generation;    ///< Generation last returned to the consumer
+static atomic_uint rendered_count = 0;  ///< Samples picked up by the consumer
+static atomic_uint coalesced_count = 0; ///< Samples skipped by the consumer
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void data_snapshot_publish(const metric_frame_t *frame)
+{
+  unsigned seq = atomic_load_explicit(&snapshot_seq, memory_order_relaxed);
+
+  atomic_store_explicit(&snapshot_seq, seq + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+
+  memcpy(&snapshot_data, frame, sizeof(snapshot_data));
+
+  atomic_store_explicit(&snapshot_seq, seq + 2, memory_order_release);
+}
+
+bool data_snapshot_consume(metric_frame_t *out)
+{
+  unsigned before;
+  unsigned after;
+
+  do
+  {
+    before = atomic_load_explicit(&snapshot_seq, memory_order_acquire);
+    if (before / 2 == consumed_generation)
+    {
+      return false;
+    }
+    if (before & 1)
+    {
+      continue;
+    }
+
+    memcpy(out, &snapshot_data, sizeof(*out));
+    atomic_thread_fence(memory_order_acquire);
+    after = atomic_load_explicit(&snapshot_seq, memory_order_relaxed);
+  } while ((before & 1) || before != after);
+
+  uint32_t generation = before / 2;
+  atomic_fetch_add_explicit(&coalesced_count, generation - consumed_generation - 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&rendered_count, 1, memory_order_relaxed);
+  consumed_generation = generation;
+  return true;
+}
+
+void data_snapshot_get_stats(data_snapshot_stats_t *stats)
+{
+  stats->received = atomic_load_explicit(&snapshot_seq, memory_order_relaxed) / 2;
+  stats->coalesced = atomic_load_explicit(&coalesced_count, memory_order_relaxed);
+  stats->rendered = atomic_load_explicit(&rendered_count, memory_order_relaxed);
+}
@@ -0,0 +1,57 @@
+/**
+ * @file data_snapshot.h
+ * @brief Lock-free latest-value snapshot of the metric frame
+ *
+ * Single-producer seqlock between the serial ingest task and the LVGL task.
+ * The producer never blocks; the consumer retries a copy that raced with a
+ * publish. Intermediate samples published between two reads are coalesced,
+ * so UI work is bounded by the consumer's rate instead of the sender's.
+ */
+
+#pragma once
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "metric_registry.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Snapshot counters
+ */
+typedef struct
+{
+  uint32_t received;  ///< Samples published by the producer
+  uint32_t coalesced; ///< Samples overwritten before the consumer saw them
+  uint32_t rendered;  ///< Samples picked up by the consumer
+} data_snapshot_stats_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION PROTOTYPES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Publish a new sample (producer side, never blocks)
+ * @param frame Sample to publish
+ * @note Only one task may publish
+ */
+void data_snapshot_publish(const metric_frame_t *frame);
+
+/**
+ * @brief Copy the latest sample if it is newer than the last one consumed
+ * @param out Receives the sample
+ * @return true if a new sample was copied, false if nothing changed
+ */
+bool data_snapshot_consume(metric_frame_t *out);
+
+/**
+ * @brief Read the snapshot counters
+ * @param stats Receives the counters
+ */
+void data_snapshot_get_stats(data_snapshot_stats_t *stats);
@@ -0,0 +1,162 @@
+/**
+ * @file draw_units.c
+ * @brief Parallel LVGL software rendering across both cores
+ *
+ * lv_draw_dispatch() offers pending tasks to every unit's dispatch_cb.
+ * A SW unit returns 1 when it took a task (now in task_act), 0 when busy
+ * and LV_DRAW_UNIT_IDLE when it has nothing to do. The wrapper forwards to
+ * the original callback, counts what was taken, and reports a disabled
+ * unit as idle so the dispatcher moves on to the next one.
+ */
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "draw_units.h"
+
+#include "esp_log.h"
+#include "lvgl.h"
+#include "lvgl_private.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static const char *TAG = "draw_units";
+
+typedef int32_t (*dispatch_fn)(lv_draw_unit_t *draw_unit, lv_layer_t *layer);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATIC VARIABLES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static lv_draw_unit_t *units[DRAW_UNITS_MAX];           ///< Hooked units, in list order
+static dispatch_fn original_dispatch[DRAW_UNITS_MAX];   ///< Their own dispatch callbacks
+static draw_unit_stats_t unit_stats[DRAW_UNITS_MAX];    ///< Updated by the dispatcher (LVGL task)
+static uint32_t unit_count = 0;
+static uint32_t total_tasks = 0;                        ///< All tasks dispatched, never reset
+static atomic_bool parallel_enabled = true;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static int32_t dispatch_wrapper(lv_draw_unit_t *draw_unit, lv_layer_t *layer)
+{
+  uint32_t idx = 0;
+  while (idx < unit_count && units[idx] != draw_unit)
+    idx++;
+
+  // Extra units report idle while parallel rendering is off
+  if (idx > 0 && !atomic_load_explicit(&parallel_enabled, memory_order_relaxed))
+    return LV_DRAW_UNIT_IDLE;
+
+  int32_t taken = original_dispatch[idx](draw_unit, layer);
+  if (taken > 0)
+  {
+    const lv_draw_task_t *task = ((lv_draw_sw_unit_t *)draw_unit)->task_act;
+    unit_stats[idx].tasks++;
+    total_tasks++;
+    if (task)
+      unit_stats[idx].pixels += lv_area_get_size(&task->area);
+  }
+  return taken;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void draw_units_init(void)
+{
+#if LV_USE_DRAW_SW
+  for (lv_draw_unit_t *unit = LV_GLOBAL_DEFAULT()->draw_info.unit_head;
+       unit && unit_count < DRAW_UNITS_MAX; unit = unit->next)
+  {
+    units[unit_count] = unit;
+    original_dispatch[unit_count] = unit->dispatch_cb;
+    unit->dispatch_cb = dispatch_wrapper;
+    unit_count++;
+  }
+#endif
+
+  ESP_LOGI(TAG, "%lu software draw unit(s), parallel rendering %s",
+           unit_count, unit_count > 1 ? "available" : "not configured (LV_DRAW_SW_DRAW_UNIT_CNT=1)");
+}
+
+void draw_units_set_parallel(bool enable)
+{
+  atomic_store(&parallel_enabled, enable);
+  ESP_LOGI(TAG, "Parallel rendering %s", enable ? "enabled" : "disabled");
+}
+
+esp_err_t draw_units_command(const char *line)
+{
+  char cmd[10] = {0};
+  char arg[4] = {0};
+
+  if (sscanf(line, "DRAW %9s %3s", cmd, arg) < 2 || strcmp(cmd, "parallel") != 0)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (strcmp(arg, "on") == 0)
+    draw_units_set_parallel(true);
+  else if (strcmp(arg, "off") == 0)
+    draw_units_set_parallel(false);
+  else
+    return ESP_ERR_INVALID_ARG;
+  return ESP_OK;
+}
+
+bool draw_units_get_parallel(void)
+{
+  return atomic_load(&parallel_enabled);
+}
+
+uint32_t draw_units_count(void)
+{
+  return unit_count;
+}
+
+uint32_t draw_units_total_tasks(void)
+{
+  return total_tasks;
+}
+
+void draw_units_take_stats(draw_unit_stats_t *stats)
+{
+  memcpy(stats, unit_stats, unit_count * sizeof(draw_unit_stats_t));
+  memset(unit_stats, 0, sizeof(unit_stats));
+}
+
+void draw_units_log_stats(void)
+{
+  draw_unit_stats_t stats[DRAW_UNITS_MAX];
+  uint32_t total_tasks = 0;
+  uint64_t total_pixels = 0;
+
+  if (unit_count < 2)
+    return;
+
+  draw_units_take_stats(stats);
+  for (uint32_t i = 0; i < unit_count; i++)
+  {
+    total_tasks += stats[i].tasks;
+    total_pixels += stats[i].pixels;
+  }
+  if (total_tasks == 0)
+    return;
+
+  for (uint32_t i = 0; i < unit_count; i++)
+  {
+    ESP_LOGI(TAG, "Draw unit %lu: %lu tasks (%lu%%), %lu%% of pixels%s", i, stats[i].tasks,
+             stats[i].tasks * 100 / total_tasks,
+             total_pixels ? (uint32_t)(stats[i].pixels * 100 / total_pixels) : 0,
+             (i > 0 && !draw_units_get_parallel()) ? " [disabled]" : "");
+  }
+}
@@ -0,0 +1,93 @@
+/**
+ * @file draw_units.h
+ * @brief Parallel LVGL software rendering across both cores
+ *
+ * With CONFIG_LV_DRAW_SW_DRAW_UNIT_CNT > 1, LVGL 9.2 creates one software
+ * draw unit (and render thread) per count and hands independent draw tasks
+ * to whichever unit is idle. The LVGL task is pinned to core 1, so the
+ * extra render thread ends up on core 0, which is otherwise idle between
+ * WiFi events.
+ *
+ * This module wraps each unit's dispatch callback to count the work each
+ * unit takes and to switch the extra units off at runtime ("DRAW parallel
+ * on|off" over serial).
+ */
+
+#pragma once
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define DRAW_UNITS_MAX 4 ///< Units tracked (LVGL may create more; extras are not wrapped)
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Work taken by one draw unit
+ */
+typedef struct
+{
+  uint32_t tasks;  ///< Draw tasks dispatched to the unit
+  uint64_t pixels; ///< Sum of the dispatched task areas
+} draw_unit_stats_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION PROTOTYPES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Hook the software draw units created by lv_init()
+ * @note Call once after lv_init(), before rendering starts
+ */
+void draw_units_init(void);
+
+/**
+ * @brief Enable or disable rendering on the extra draw units
+ * @param enable false restricts rendering to the first unit
+ * @note Takes effect from the next dispatched draw task
+ */
+void draw_units_set_parallel(bool enable);
+
+/**
+ * @brief Run a draw unit command received over serial
+ * @param line "DRAW parallel on|off"
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for unknown commands
+ * @note Safe from any task
+ */
+esp_err_t draw_units_command(const char *line);
+
+/**
+ * @brief Whether the extra draw units take work
+ */
+bool draw_units_get_parallel(void);
+
+/**
+ * @brief Number of hooked draw units
+ */
+uint32_t draw_units_count(void);
+
+/**
+ * @brief Draw tasks dispatched to all units since boot (wraps around)
+ * @note Call from the LVGL task (or with the LVGL lock held)
+ */
+uint32_t draw_units_total_tasks(void);
+
+/**
+ * @brief Read and reset the per-unit counters
+ * @param stats Array of at least draw_units_count() entries
+ * @note Call from the LVGL task (or with the LVGL lock held)
+ */
+void draw_units_take_stats(draw_unit_stats_t *stats);
+
+/**
+ * @brief Log each unit's share of tasks and pixels since the last call
+ * @note Call from the LVGL task (or with the LVGL lock held)
+ */
+void draw_units_log_stats(void);
@@ -5,7 +5,10 @@
 
 #include "lvgl_setup.h"
 
+#include "draw_units.h"
 #include "driver/gpio.h"
+#include "esp_async_memcpy.h"
+#include "esp_cache.h"
 #include "esp_err.h"
 #include "esp_heap_caps.h"
 #include "esp_lcd_panel_ops.h"
@@ -13,21 +16,97 @@
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
 #include "gt911_touch.h"
+#include "render_profiler.h"
+#include <stdatomic.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/lock.h>
-#include <unistd.h>
 
 static const char *TAG = "lvgl_setup";
 static _lock_t lvgl_api_lock;
 
+#define FB_SWAP_TIMEOUT_MS 100     ///< Warn after waiting this long for VSYNC (one frame is ~29 ms)
+#define RENDER_STATS_FRAMES 100    ///< Frames between render statistics logs
+#define GOVERNOR_STATS_MS 10000    ///< Interval between governor statistics logs
+#define MAX_WAKE_TIMERS 4          ///< Timers made ready by lvgl_setup_wake()
+
+#if CONFIG_EXAMPLE_USE_DOUBLE_FB
+#define RENDER_MODE_NAME "direct, double FB"
+#elif CONFIG_EXAMPLE_USE_SRAM_TILES
+#define RENDER_MODE_NAME "SRAM tiles, GDMA copy"
+#else
+#define RENDER_MODE_NAME "partial, draw buffer"
+#endif
+
+#if CONFIG_EXAMPLE_USE_DOUBLE_FB
+static SemaphoreHandle_t vsync_sem = NULL; ///< Given by the VSYNC ISR, taken by the flush after a swap
+#elif CONFIG_EXAMPLE_USE_SRAM_TILES
+#define TILE_ALIGN 64 ///< GDMA burst alignment for PSRAM destinations
+static async_memcpy_handle_t tile_mcp = NULL; ///< GDMA memcpy channel
+static uint8_t *tile_fb = NULL;               ///< The panel's frame buffer
+#endif
+
+// Refresh governor
+typedef enum
+{
+  GOVERNOR_ACTIVE = 0, ///< Touch or animation in progress
+  GOVERNOR_NORMAL,     ///< Recent interaction, default refresh
+  GOVERNOR_IDLE,       ///< Nobody is touching the screen
+} governor_state_t;
+
+static const struct
+{
+  const char *name;
+  uint32_t refr_period_ms;  ///< Display refresh timer period
+  uint32_t indev_period_ms; ///< Touch read timer period
+} governor_modes[] = {
+    [GOVERNOR_ACTIVE] = {"active", LVGL_REFR_ACTIVE_MS, LVGL_INDEV_ACTIVE_MS},
+    [GOVERNOR_NORMAL] = {"normal", LVGL_REFR_NORMAL_MS, LVGL_INDEV_NORMAL_MS},
+    [GOVERNOR_IDLE] = {"idle", LVGL_REFR_IDLE_MS, LVGL_INDEV_IDLE_MS},
+};
+
+static lv_display_t *lvgl_display = NULL;
+static lv_indev_t *lvgl_indev = NULL;
+static TaskHandle_t lvgl_task_handle = NULL;
+static governor_state_t governor_state = GOVERNOR_NORMAL;
+static atomic_bool wake_pending = false;                ///< Set by lvgl_setup_wake()
+static lv_timer_t *wake_timers[MAX_WAKE_TIMERS];        ///< Made ready on wake
+static uint32_t wake_timer_count = 0;
+
+// Governor statistics (LVGL task only)
+static uint32_t governor_wakeups = 0;
+static uint32_t governor_notified = 0;
+static uint64_t governor_busy_us = 0;
+static int64_t governor_window_start_us = 0;
+
+// Render benchmark (LVGL task only)
+static int64_t frame_start_us = 0;
+static uint32_t frame_count = 0;
+static uint64_t frame_time_total_us = 0;
+static uint32_t frame_time_max_us = 0;
+static uint64_t rendered_bytes = 0;     ///< Pixels written by the renderer
+static uint64_t copied_bytes = 0;       ///< Extra PSRAM copies (draw buffer copy or buffer sync)
+static uint32_t frame_rendered_bytes = 0;
+static uint32_t last_frame_rendered_bytes = 0;
+
 // Static function prototypes (ordered by call sequence)
 static esp_err_t init_panel_config(esp_lcd_rgb_panel_config_t *panel_config);
-static bool lvgl_notify_flush_ready(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *event_data, void *user_ctx);
 static void lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
-static void lvgl_increase_tick(void *arg);
+#if CONFIG_EXAMPLE_USE_DOUBLE_FB
+static bool lvgl_on_vsync(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *event_data, void *user_ctx);
+#elif CONFIG_EXAMPLE_USE_SRAM_TILES
+static bool lvgl_tile_copy_done(async_memcpy_handle_t mcp, async_memcpy_event_t *event, void *cb_args);
+static void lvgl_tile_rounder_cb(lv_event_t *e);
+#else
+static bool lvgl_notify_flush_ready(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *event_data, void *user_ctx);
+#endif
+static void lvgl_render_stats_cb(lv_event_t *e);
+static void lvgl_lock_timed(void);
+static uint32_t lvgl_tick_get(void);
+static void governor_update(void);
 static void lvgl_port_task(void *arg);
 
 // 1. Backlight functions (called first)
@@ -75,6 +154,9 @@ lv_display_t *lvgl_setup_init(esp_lcd_panel_handle_t panel_handle)
 {
   lv_init();
 
+  // Count and gate the software draw units (one render thread per unit)
+  draw_units_init();
+
   lv_display_t *display = lv_display_create(LCD_H_RES, LCD_V_RES);
   if (!display)
   {
@@ -91,9 +173,43 @@ lv_display_t *lvgl_setup_init(esp_lcd_panel_handle_t panel_handle)
   void *buf2 = NULL;
 
 #if CONFIG_EXAMPLE_USE_DOUBLE_FB
+  // Render straight into the panel's two frame buffers. LVGL copies the
+  // previous frame's dirty areas into the back buffer before drawing, so
+  // only changed pixels are moved; the flush just swaps buffers at VSYNC.
+  vsync_sem = xSemaphoreCreateBinary();
+  if (!vsync_sem)
+  {
+    ESP_LOGE(TAG, "Failed to create VSYNC semaphore");
+    return NULL;
+  }
   ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(panel_handle, 2, &buf1, &buf2));
   lv_display_set_buffers(display, buf1, buf2, LCD_H_RES * LCD_V_RES * LCD_PIXEL_SIZE, LV_DISPLAY_RENDER_MODE_DIRECT);
-  ESP_LOGI(TAG, "Using double framebuffer mode");
+  ESP_LOGI(TAG, "Using direct mode with double frame buffer (%p, %p)", buf1, buf2);
+#elif CONFIG_EXAMPLE_USE_SRAM_TILES
+  // Two full-width tiles in internal SRAM: LVGL renders one while GDMA
+  // copies the other into the PSRAM frame buffer. Full-width tiles map to
+  // one contiguous, burst-aligned range of the frame buffer.
+  size_t tile_sz = LCD_H_RES * CONFIG_EXAMPLE_SRAM_TILE_LINES * LCD_PIXEL_SIZE;
+  buf1 = heap_caps_aligned_alloc(TILE_ALIGN, tile_sz, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+  buf2 = heap_caps_aligned_alloc(TILE_ALIGN, tile_sz, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+  if (!buf1 || !buf2)
+  {
+    ESP_LOGE(TAG, "Failed to allocate 2 x %zu bytes of internal SRAM for LVGL tiles", tile_sz);
+    heap_caps_free(buf1);
+    heap_caps_free(buf2);
+    return NULL;
+  }
+
+  async_memcpy_config_t mcp_config = ASYNC_MEMCPY_DEFAULT_CONFIG();
+  mcp_config.backlog = 4;
+  mcp_config.dma_burst_size = TILE_ALIGN;
+  ESP_ERROR_CHECK(esp_async_memcpy_install(&mcp_config, &tile_mcp));
+  ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(panel_handle, 1, (void **)&tile_fb));
+
+  lv_display_set_buffers(display, buf1, buf2, tile_sz, LV_DISPLAY_RENDER_MODE_PARTIAL);
+  lv_display_add_event_cb(display, lvgl_tile_rounder_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+  ESP_LOGI(TAG, "Using internal SRAM tiles: 2 x %zu bytes (%d lines), GDMA copy to %p",
+           tile_sz, CONFIG_EXAMPLE_SRAM_TILE_LINES, tile_fb);
 #else
   size_t draw_buffer_sz = LCD_H_RES * LVGL_DRAW_BUF_LINES * LCD_PIXEL_SIZE;
   // Use PSRAM for large draw buffer instead of internal RAM
@@ -123,19 +239,30 @@ lv_display_t *lvgl_setup_init(esp_lcd_panel_handle_t panel_handle)
 
   lv_display_set_flush_cb(display, lvgl_flush_cb);
 
-  // Register callbacks
+  lv_display_add_event_cb(display, lvgl_render_stats_cb, LV_EVENT_REFR_START, NULL);
+  lv_display_add_event_cb(display, lvgl_render_stats_cb, LV_EVENT_REFR_READY, NULL);
+
+  // Register callbacks (tiles complete through the GDMA callback instead)
+#if CONFIG_EXAMPLE_USE_DOUBLE_FB
+  esp_lcd_rgb_panel_event_callbacks_t cbs = {
+      .on_vsync = lvgl_on_vsync,
+  };
+  ESP_ERROR_CHECK(esp_lcd_rgb_panel_register_event_callbacks(panel_handle, &cbs, display));
+#elif !CONFIG_EXAMPLE_USE_SRAM_TILES
   esp_lcd_rgb_panel_event_callbacks_t cbs = {
       .on_color_trans_done = lvgl_notify_flush_ready,
   };
   ESP_ERROR_CHECK(esp_lcd_rgb_panel_register_event_callbacks(panel_handle, &cbs, display));
+#endif
 
-  // Setup tick timer
-  const esp_timer_create_args_t lvgl_tick_timer_args = {
-      .callback = &lvgl_increase_tick,
-      .name = "lvgl_tick"};
-  esp_timer_handle_t lvgl_tick_timer = NULL;
-  ESP_ERROR_CHECK(esp_timer_create(&lvgl_tick_timer_args, &lvgl_tick_timer));
-  ESP_ERROR_CHECK(esp_timer_start_periodic(lvgl_tick_timer, LVGL_TICK_PERIOD_MS * 1000));
+  // Tick is read from esp_timer on demand instead of a periodic interrupt
+  lv_tick_set_cb(lvgl_tick_get);
+
+  lvgl_display = display;
+  lv_timer_set_period(lv_display_get_refr_timer(display), governor_modes[governor_state].refr_period_ms);
+
+  // Frame/render/flush histograms, PROF reports and the toggleable overlay
+  render_profiler_init(display, RENDER_MODE_NAME);
 
   return display;
 }
@@ -144,7 +271,8 @@ lv_display_t *lvgl_setup_init(esp_lcd_panel_handle_t panel_handle)
 void lvgl_setup_start_task(void)
 {
   ESP_LOGI(TAG, "Creating LVGL task on core 1 with priority %d, stack size %d", LVGL_TASK_PRIORITY, LVGL_TASK_STACK_SIZE);
-  BaseType_t result = xTaskCreatePinnedToCore(lvgl_port_task, "LVGL", LVGL_TASK_STACK_SIZE, NULL, LVGL_TASK_PRIORITY, NULL, 1);
+  BaseType_t result = xTaskCreatePinnedToCore(lvgl_port_task, "LVGL", LVGL_TASK_STACK_SIZE, NULL, LVGL_TASK_PRIORITY,
+                                              &lvgl_task_handle, 1);
   if (result == pdPASS)
   {
     ESP_LOGI(TAG, "LVGL task created successfully on core 1");
@@ -155,6 +283,33 @@ void lvgl_setup_start_task(void)
   }
 }
 
+// Governor wakeups
+void lvgl_setup_wake(void)
+{
+  atomic_store(&wake_pending, true);
+  if (lvgl_task_handle)
+  {
+    xTaskNotifyGive(lvgl_task_handle);
+  }
+}
+
+void IRAM_ATTR lvgl_setup_wake_from_isr(BaseType_t *high_task_woken)
+{
+  atomic_store(&wake_pending, true);
+  if (lvgl_task_handle)
+  {
+    vTaskNotifyGiveFromISR(lvgl_task_handle, high_task_woken);
+  }
+}
+
+void lvgl_setup_add_wake_timer(lv_timer_t *timer)
+{
+  if (timer && wake_timer_count < MAX_WAKE_TIMERS)
+  {
+    wake_timers[wake_timer_count++] = timer;
+  }
+}
+
 // 5. UI creation helper (called fifth)
 void lvgl_setup_create_ui_safe(lv_display_t *display, void (*ui_create_func)(lv_display_t *))
 {
@@ -163,7 +318,7 @@ void lvgl_setup_create_ui_safe(lv_display_t *display, void (*ui_create_func)(lv_
     return;
   }
 
-  _lock_acquire(&lvgl_api_lock);
+  lvgl_lock_timed();
   ui_create_func(display);
   _lock_release(&lvgl_api_lock);
 }
@@ -171,7 +326,7 @@ void lvgl_setup_create_ui_safe(lv_display_t *display, void (*ui_create_func)(lv_
 // Thread safety functions
 void lvgl_lock_acquire(void)
 {
-  _lock_acquire(&lvgl_api_lock);
+  lvgl_lock_timed();
 }
 
 void lvgl_lock_release(void)
@@ -183,7 +338,7 @@ void lvgl_lock_release(void)
 bool lvgl_port_lock(int timeout_ms)
 {
   // For now, use blocking lock - can be enhanced with timeout later
-  _lock_acquire(&lvgl_api_lock);
+  lvgl_lock_timed();
   return true;
 }
 
@@ -257,9 +412,87 @@ static esp_err_t init_panel_config(esp_lcd_rgb_panel_config_t *panel_config)
   return ESP_OK;
 }
 
+#if CONFIG_EXAMPLE_USE_DOUBLE_FB
+static bool IRAM_ATTR lvgl_on_vsync(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *event_data, void *user_ctx)
+{
+  BaseType_t high_task_woken = pdFALSE;
+  xSemaphoreGiveFromISR(vsync_sem, &high_task_woken);
+  return high_task_woken == pdTRUE;
+}
+
+static void lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+  render_profiler_flush_begin();
+
+  // Areas are rendered in place; nothing to copy until the frame is complete
+  frame_rendered_bytes += lv_area_get_size(area) * LCD_PIXEL_SIZE;
+
+  if (lv_display_flush_is_last(disp))
+  {
+    esp_lcd_panel_handle_t panel_handle = lv_display_get_user_data(disp);
+
+    // px_map is the whole back buffer: the driver writes back the cache and
+    // scans it out from the next frame on. LVGL must not touch the old front
+    // buffer until the panel has left it, i.e. until the next VSYNC. A late
+    // VSYNC is waited out rather than released early, which would let LVGL
+    // draw into lines still being scanned out.
+    xSemaphoreTake(vsync_sem, 0);
+    esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, LCD_H_RES, LCD_V_RES, px_map);
+    uint32_t waited_ms = 0;
+    while (xSemaphoreTake(vsync_sem, pdMS_TO_TICKS(FB_SWAP_TIMEOUT_MS)) != pdTRUE)
+    {
+      waited_ms += FB_SWAP_TIMEOUT_MS;
+      ESP_LOGW(TAG, "No VSYNC within %lu ms after frame buffer swap, still waiting", waited_ms);
+    }
+  }
+
+  render_profiler_flush_end();
+  lv_display_flush_ready(disp);
+}
+#elif CONFIG_EXAMPLE_USE_SRAM_TILES
+/**
+ * @brief Widen every invalidated area to full lines (LV_EVENT_INVALIDATE_AREA)
+ * @note Full-width tiles are one contiguous, aligned frame buffer range, so
+ *       each flush is a single GDMA transfer instead of one per line
+ */
+static void lvgl_tile_rounder_cb(lv_event_t *e)
+{
+  lv_area_t *area = lv_event_get_param(e);
+  area->x1 = 0;
+  area->x2 = LCD_H_RES - 1;
+}
+
+static bool lvgl_tile_copy_done(async_memcpy_handle_t mcp, async_memcpy_event_t *event, void *cb_args)
+{
+  // The tile is free again; LVGL may start rendering into it
+  render_profiler_flush_end();
+  lv_display_flush_ready((lv_display_t *)cb_args);
+  return false;
+}
+
+static void lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+  uint32_t bytes = lv_area_get_size(area) * LCD_PIXEL_SIZE;
+  uint8_t *dst = tile_fb + (size_t)area->y1 * LCD_H_RES * LCD_PIXEL_SIZE;
+
+  // SRAM -> PSRAM by GDMA; the CPU goes back to rendering the other tile
+  render_profiler_flush_begin();
+  frame_rendered_bytes += bytes;
+  copied_bytes += bytes;
+  if (esp_async_memcpy(tile_mcp, dst, px_map, bytes, lvgl_tile_copy_done, disp) != ESP_OK)
+  {
+    // Queue full: fall back to a CPU copy, written back for the LCD DMA
+    memcpy(dst, px_map, bytes);
+    esp_cache_msync(dst, bytes, ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+    render_profiler_flush_end();
+    lv_display_flush_ready(disp);
+  }
+}
+#else
 static bool IRAM_ATTR lvgl_notify_flush_ready(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *event_data, void *user_ctx)
 {
   lv_display_t *disp = (lv_display_t *)user_ctx;
+  render_profiler_flush_end();
   lv_display_flush_ready(disp);
   return false;
 }
@@ -267,29 +500,179 @@ static bool IRAM_ATTR lvgl_notify_flush_ready(esp_lcd_panel_handle_t panel, cons
 static void lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
 {
   esp_lcd_panel_handle_t panel_handle = lv_display_get_user_data(disp);
+  uint32_t bytes = lv_area_get_size(area) * LCD_PIXEL_SIZE;
+
+  // The driver copies the draw buffer into the frame buffer (PSRAM to PSRAM)
+  render_profiler_flush_begin();
+  frame_rendered_bytes += bytes;
+  copied_bytes += bytes;
   esp_lcd_panel_draw_bitmap(panel_handle, area->x1, area->y1, area->x2 + 1, area->y2 + 1, px_map);
 }
+#endif
+
+/**
+ * @brief Measure frame time and PSRAM traffic per refresh (display REFR_START/READY)
+ * @note REFR_READY is only sent for refreshes that had something to redraw
+ */
+static void lvgl_render_stats_cb(lv_event_t *e)
+{
+  if (lv_event_get_code(e) == LV_EVENT_REFR_START)
+  {
+    frame_start_us = esp_timer_get_time();
+    frame_rendered_bytes = 0;
+    return;
+  }
+
+  if (frame_rendered_bytes == 0)
+    return;
+
+  uint32_t elapsed = (uint32_t)(esp_timer_get_time() - frame_start_us);
+  frame_count++;
+  frame_time_total_us += elapsed;
+  if (elapsed > frame_time_max_us)
+    frame_time_max_us = elapsed;
+  rendered_bytes += frame_rendered_bytes;
+
+#if CONFIG_EXAMPLE_USE_DOUBLE_FB
+  // Before drawing, LVGL copied the previous frame's dirty areas from the
+  // front buffer (minus what is redrawn anyway); this is the upper bound
+  copied_bytes += last_frame_rendered_bytes;
+#endif
+  last_frame_rendered_bytes = frame_rendered_bytes;
+
+  if (frame_count % RENDER_STATS_FRAMES == 0)
+  {
+    ESP_LOGI(TAG, "Render (%s): %lu frames, avg %lu us, max %lu us, %lu KB rendered + %lu KB copied per frame",
+             RENDER_MODE_NAME,
+             frame_count, (uint32_t)(frame_time_total_us / RENDER_STATS_FRAMES), frame_time_max_us,
+             (uint32_t)(rendered_bytes / RENDER_STATS_FRAMES / 1024), (uint32_t)(copied_bytes / RENDER_STATS_FRAMES / 1024));
+    draw_units_log_stats();
+    frame_time_total_us = 0;
+    frame_time_max_us = 0;
+    rendered_bytes = 0;
+    copied_bytes = 0;
+  }
+}
+
+/**
+ * @brief Acquire the LVGL lock and record how long that took
+ */
+static void lvgl_lock_timed(void)
+{
+  int64_t start_us = esp_timer_get_time();
+  _lock_acquire(&lvgl_api_lock);
+  render_profiler_record_lock_wait((uint32_t)(esp_timer_get_time() - start_us));
+}
 
-static void lvgl_increase_tick(void *arg)
+static uint32_t lvgl_tick_get(void)
 {
-  lv_tick_inc(LVGL_TICK_PERIOD_MS);
+  return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+/**
+ * @brief Pick the refresh mode from input and animation activity
+ * @note Called with the LVGL lock held
+ */
+static void governor_update(void)
+{
+  uint32_t inactive_ms = lv_display_get_inactive_time(lvgl_display);
+  governor_state_t state;
+
+  if (inactive_ms < LVGL_ACTIVE_HOLD_MS || lv_anim_count_running() > 0)
+  {
+    state = GOVERNOR_ACTIVE;
+  }
+  else if (inactive_ms < LVGL_IDLE_AFTER_MS)
+  {
+    state = GOVERNOR_NORMAL;
+  }
+  else
+  {
+    state = GOVERNOR_IDLE;
+  }
+
+  if (state == governor_state)
+    return;
+
+  governor_state = state;
+  lv_timer_set_period(lv_display_get_refr_timer(lvgl_display), governor_modes[state].refr_period_ms);
+  if (lvgl_indev)
+  {
+    lv_timer_set_period(lv_indev_get_read_timer(lvgl_indev), governor_modes[state].indev_period_ms);
+  }
+  ESP_LOGI(TAG, "Refresh governor: %s (refresh %lu ms, touch poll %lu ms)", governor_modes[state].name,
+           governor_modes[state].refr_period_ms, governor_modes[state].indev_period_ms);
 }
 
+/**
+ * @brief Log wakeups and LVGL task load for the last window
+ */
+static void governor_log_stats(int64_t now_us)
+{
+  int64_t window_us = now_us - governor_window_start_us;
+
+  if (window_us < GOVERNOR_STATS_MS * 1000LL)
+    return;
+
+  // Fixed polling used to cost >= 100 wakeups/s plus 500 tick interrupts/s
+  ESP_LOGI(TAG, "Governor (%s): %lu wakeups/s (%lu notified), LVGL task busy %lu.%lu%%",
+           governor_modes[governor_state].name,
+           (uint32_t)(governor_wakeups * 1000000LL / window_us),
+           governor_notified,
+           (uint32_t)(governor_busy_us * 100 / window_us),
+           (uint32_t)(governor_busy_us * 1000 / window_us % 10));
+
+  governor_wakeups = 0;
+  governor_notified = 0;
+  governor_busy_us = 0;
+  governor_window_start_us = now_us;
+}
+
+/**
+ * @brief LVGL task: run timers, then sleep until the next timer is due or a
+ *        wakeup (telemetry, touch) is notified
+ */
 static void lvgl_port_task(void *arg)
 {
   uint32_t time_till_next_ms = 0;
+
+  governor_window_start_us = esp_timer_get_time();
+
   while (1)
   {
-    _lock_acquire(&lvgl_api_lock);
+    int64_t start_us = esp_timer_get_time();
+
+    lvgl_lock_timed();
+    if (atomic_exchange(&wake_pending, false))
+    {
+      // New data: run the consumers now rather than at their next period
+      for (uint32_t i = 0; i < wake_timer_count; i++)
+      {
+        lv_timer_ready(wake_timers[i]);
+      }
+    }
+    int64_t handler_start_us = esp_timer_get_time();
     time_till_next_ms = lv_timer_handler();
+    render_profiler_record_handler((uint32_t)(esp_timer_get_time() - handler_start_us));
+    governor_update();
     _lock_release(&lvgl_api_lock);
 
-    if (time_till_next_ms < 10)
+    int64_t end_us = esp_timer_get_time();
+    governor_busy_us += end_us - start_us;
+    governor_log_stats(end_us);
+
+    if (time_till_next_ms == LV_NO_TIMER_READY || time_till_next_ms > LVGL_MAX_SLEEP_MS)
     {
-      time_till_next_ms = 10;
+      time_till_next_ms = LVGL_MAX_SLEEP_MS;
     }
 
-    usleep(1000 * time_till_next_ms);
+    // Sleep at least one tick so lower-priority tasks on core 1 can run
+    TickType_t sleep_ticks = pdMS_TO_TICKS(time_till_next_ms);
+    if (ulTaskNotifyTake(pdTRUE, sleep_ticks > 0 ? sleep_ticks : 1) > 0)
+    {
+      governor_notified++;
+    }
+    governor_wakeups++;
   }
 }
 
@@ -297,6 +680,40 @@ static void lvgl_port_task(void *arg)
 // TOUCH INPUT DEVICE SETUP
 // ═══════════════════════════════════════════════════════════════════════════════
 
+/**
+ * @brief Whether the RGB panel drives the given GPIO
+ */
+static bool lcd_uses_gpio(int gpio)
+{
+  const int lcd_pins[] = {
+      PIN_NUM_HSYNC, PIN_NUM_VSYNC, PIN_NUM_DE, PIN_NUM_PCLK, PIN_NUM_DISP_EN,
+      PIN_NUM_DATA0, PIN_NUM_DATA1, PIN_NUM_DATA2, PIN_NUM_DATA3,
+      PIN_NUM_DATA4, PIN_NUM_DATA5, PIN_NUM_DATA6, PIN_NUM_DATA7,
+      PIN_NUM_DATA8, PIN_NUM_DATA9, PIN_NUM_DATA10, PIN_NUM_DATA11,
+      PIN_NUM_DATA12, PIN_NUM_DATA13, PIN_NUM_DATA14, PIN_NUM_DATA15,
+  };
+
+  for (size_t i = 0; i < sizeof(lcd_pins) / sizeof(lcd_pins[0]); i++)
+  {
+    if (lcd_pins[i] == gpio)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Indev read callback: GT911 state, plus the input time of any new
+ *        touch change for the touch-to-flush latency
+ */
+static void lvgl_touch_read(lv_indev_t *indev, lv_indev_data_t *data)
+{
+  gt911_lvgl_read(indev, data);
+
+  uint32_t input_us = gt911_take_input_time();
+  if (input_us)
+    render_profiler_mark_input(input_us);
+}
+
 lv_indev_t *lvgl_setup_init_touch(void)
 {
   ESP_LOGI(TAG, "Initializing GT911 touch controller...");
@@ -320,7 +737,25 @@ lv_indev_t *lvgl_setup_init_touch(void)
 
   // Configure input device
   lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
-  lv_indev_set_read_cb(indev, gt911_lvgl_read);
+  lv_indev_set_read_cb(indev, lvgl_touch_read);
+  lvgl_indev = indev;
+  lv_timer_set_period(lv_indev_get_read_timer(indev), governor_modes[governor_state].indev_period_ms);
+
+  // The touch task wakes LVGL on every change, so a touch is read without
+  // waiting for the next poll of the read timer
+  lvgl_setup_add_wake_timer(lv_indev_get_read_timer(indev));
+
+  int irq_gpio = CONFIG_EXAMPLE_TOUCH_IRQ_GPIO;
+  if (irq_gpio >= 0 && lcd_uses_gpio(irq_gpio))
+  {
+    ESP_LOGW(TAG, "Touch INT GPIO%d is also an LCD pin, polling the touch controller instead", irq_gpio);
+    irq_gpio = -1;
+  }
+  ret = gt911_start(irq_gpio, lvgl_setup_wake);
+  if (ret != ESP_OK)
+  {
+    ESP_LOGE(TAG, "GT911 touch task failed to start: %s", esp_err_to_name(ret));
+  }
 
   ESP_LOGI(TAG, "GT911 touch controller initialized successfully");
   return indev;
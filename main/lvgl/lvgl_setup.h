@@ -1,6 +1,7 @@
 #pragma once
 
 #include "esp_lcd_panel_ops.h"
+#include "freertos/FreeRTOS.h"
 #include "lvgl.h"
 #include "sdkconfig.h"
 
@@ -65,10 +66,20 @@
 
 // LVGL configuration
 #define LVGL_DRAW_BUF_LINES 480 // MAXIMUM: Full screen height (480 lines) - 10Hz refresh allows massive buffering
-#define LVGL_TICK_PERIOD_MS 2
 #define LVGL_TASK_STACK_SIZE (12 * 1024) // Increased from 8KB to 12KB for stability
 #define LVGL_TASK_PRIORITY 2
 
+// Refresh governor: refresh rate follows touch/animation activity
+#define LVGL_REFR_ACTIVE_MS 33 // ~30 Hz while touching or animating
+#define LVGL_REFR_NORMAL_MS LV_DEF_REFR_PERIOD // 10 Hz after recent interaction
+#define LVGL_REFR_IDLE_MS 500 // 2 Hz when nobody touches the screen
+#define LVGL_INDEV_ACTIVE_MS 16 // Touch poll while touching
+#define LVGL_INDEV_NORMAL_MS 30 // Touch poll after recent interaction
+#define LVGL_INDEV_IDLE_MS 100 // Touch poll when idle
+#define LVGL_ACTIVE_HOLD_MS 1000 // Stay active this long after the last input
+#define LVGL_IDLE_AFTER_MS 30000 // Go idle after this long without input
+#define LVGL_MAX_SLEEP_MS 1000 // Longest sleep between timer runs
+
 /**
  * @brief Initialize LVGL with LCD panel
  * @param panel_handle LCD panel handle
@@ -111,6 +122,25 @@ lv_indev_t *lvgl_setup_init_touch(void);
  */
 void lvgl_setup_create_ui_safe(lv_display_t *display, void (*ui_create_func)(lv_display_t *));
 
+/**
+ * @brief Wake the LVGL task now (e.g. new telemetry was published)
+ * @note Never blocks; safe from any task
+ */
+void lvgl_setup_wake(void);
+
+/**
+ * @brief Wake the LVGL task from an interrupt handler
+ * @param high_task_woken Set to pdTRUE if a context switch is needed
+ */
+void lvgl_setup_wake_from_isr(BaseType_t *high_task_woken);
+
+/**
+ * @brief Make a timer ready whenever the LVGL task is woken
+ * @param timer Timer that consumes data published from other tasks
+ * @note Call with the LVGL lock held (e.g. during UI creation)
+ */
+void lvgl_setup_add_wake_timer(lv_timer_t *timer);
+
 /**
  * @brief Acquire LVGL API lock (for thread safety)
  */
@@ -0,0 +1,223 @@
+/**
+ * @file metric_subjects.c
+ * @brief LVGL observer bindings for metrics
+ *
+ * Numeric subjects are int subjects holding value * scale (truncated, NAN
+ * as NO_VALUE). lv_subject_set_int() notifies unconditionally, so the value
+ * is compared first; the same goes for lv_subject_copy_string().
+ */
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "metric_subjects.h"
+
+#include "esp_log.h"
+#include <math.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static const char *TAG = "metric_subjects";
+
+#define NO_VALUE INT32_MIN   ///< Quantized value of a metric that was never received
+#define LABEL_TEXT_MAX 64    ///< Longest formatted label text
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATIC VARIABLES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static lv_subject_t subjects[METRIC_MAX];                               ///< By metric ID
+static char string_values[METRIC_STRING_SLOTS][METRIC_STRING_LEN];      ///< String subject buffers
+static char string_previous[METRIC_STRING_SLOTS][METRIC_STRING_LEN];    ///< Previous values (LVGL API)
+static metric_subjects_stats_t stats = {0};
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Display resolution of a metric: GB values are shown with one decimal
+ */
+static int32_t metric_scale(const metric_desc_t *desc)
+{
+  return desc->unit == METRIC_UNIT_GB ? 10 : 1;
+}
+
+static int32_t quantize(const metric_desc_t *desc, float value)
+{
+  if (isnan(value))
+    return NO_VALUE;
+
+  float scaled = value * metric_scale(desc);
+  if (scaled >= (float)INT32_MAX)
+    return INT32_MAX;
+  if (scaled <= (float)(INT32_MIN + 1))
+    return INT32_MIN + 1;
+  return (int32_t)scaled;
+}
+
+/**
+ * @brief Get the subject of a registered metric, creating it on first use
+ */
+static lv_subject_t *ensure_subject(metric_id_t id)
+{
+  const metric_desc_t *desc = metric_registry_get(id);
+  if (!desc)
+    return NULL;
+
+  // subjects[] is zero-initialised, and 0 is LV_SUBJECT_TYPE_INVALID (not NONE)
+  lv_subject_t *subject = &subjects[id];
+  if (subject->type != LV_SUBJECT_TYPE_INVALID)
+    return subject;
+
+  if (desc->type == METRIC_TYPE_STRING)
+  {
+    lv_subject_init_string(subject, string_values[desc->slot], string_previous[desc->slot],
+                           METRIC_STRING_LEN, "");
+  }
+  else
+  {
+    lv_subject_init_int(subject, NO_VALUE);
+  }
+  return subject;
+}
+
+static void label_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+  LV_UNUSED(subject);
+  lv_obj_t *label = lv_observer_get_target_obj(observer);
+  const metric_label_binding_t *binding = lv_observer_get_user_data(observer);
+  char text[LABEL_TEXT_MAX];
+
+  binding->format(binding, text, sizeof(text));
+
+  // Same text means no re-layout and no invalidation
+  if (text[0] == '\0' || strcmp(lv_label_get_text(label), text) == 0)
+  {
+    stats.unchanged++;
+    return;
+  }
+
+  lv_label_set_text(label, text);
+  stats.rewritten++;
+}
+
+static void bar_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+  float value = metric_subjects_value((metric_id_t)(uintptr_t)lv_observer_get_user_data(observer));
+
+  LV_UNUSED(subject);
+  if (!isnan(value))
+  {
+    // lv_bar_set_value() returns early when the value is unchanged
+    lv_bar_set_value(lv_observer_get_target_obj(observer), (int32_t)value, LV_ANIM_OFF);
+  }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void metric_subjects_init(void)
+{
+  metric_registry_init();
+
+  for (metric_id_t id = 0; id < METRIC_BUILTIN_COUNT; id++)
+  {
+    ensure_subject(id);
+  }
+}
+
+uint32_t metric_subjects_update(const metric_frame_t *frame)
+{
+  uint32_t changed = 0;
+
+  for (metric_id_t id = 0; id < frame->count; id++)
+  {
+    lv_subject_t *subject = ensure_subject(id);
+    if (!subject)
+      continue;
+
+    if (subject->type == LV_SUBJECT_TYPE_STRING)
+    {
+      const char *value = metric_frame_string(frame, id);
+      if (value[0] == '\0' || strcmp(lv_subject_get_string(subject), value) == 0)
+        continue;
+
+      lv_subject_copy_string(subject, value);
+    }
+    else
+    {
+      int32_t value = quantize(metric_registry_get(id), frame->values[id]);
+      if (lv_subject_get_int(subject) == value)
+        continue;
+
+      lv_subject_set_int(subject, value);
+    }
+    changed++;
+  }
+
+  stats.notified += changed;
+  return changed;
+}
+
+float metric_subjects_value(metric_id_t id)
+{
+  const metric_desc_t *desc = metric_registry_get(id);
+
+  if (!desc || subjects[id].type != LV_SUBJECT_TYPE_INT)
+    return NAN;
+
+  int32_t value = lv_subject_get_int(&subjects[id]);
+  return value == NO_VALUE ? NAN : (float)value / metric_scale(desc);
+}
+
+const char *metric_subjects_string(metric_id_t id)
+{
+  if (id >= METRIC_MAX || subjects[id].type != LV_SUBJECT_TYPE_STRING)
+    return "";
+
+  return lv_subject_get_string(&subjects[id]);
+}
+
+void metric_subjects_bind_label(lv_obj_t *label, const metric_label_binding_t *binding)
+{
+  lv_subject_t *subject = ensure_subject(binding->id);
+  if (!label || !subject)
+  {
+    ESP_LOGW(TAG, "Cannot bind label to metric %u", binding->id);
+    return;
+  }
+
+  lv_subject_add_observer_obj(subject, label_observer_cb, label, (void *)binding);
+
+  if (binding->aux != METRIC_ID_INVALID)
+  {
+    lv_subject_t *aux = ensure_subject(binding->aux);
+    if (aux)
+    {
+      lv_subject_add_observer_obj(aux, label_observer_cb, label, (void *)binding);
+    }
+  }
+}
+
+void metric_subjects_bind_bar(lv_obj_t *bar, metric_id_t id)
+{
+  lv_subject_t *subject = ensure_subject(id);
+  if (!bar || !subject)
+  {
+    ESP_LOGW(TAG, "Cannot bind bar to metric %u", id);
+    return;
+  }
+
+  lv_subject_add_observer_obj(subject, bar_observer_cb, bar, (void *)(uintptr_t)id);
+}
+
+void metric_subjects_get_stats(metric_subjects_stats_t *out)
+{
+  *out = stats;
+}
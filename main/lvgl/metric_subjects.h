@@ -0,0 +1,107 @@
+/**
+ * @file metric_subjects.h
+ * @brief LVGL observer bindings for metrics
+ *
+ * Each metric has an lv_subject_t holding its value quantized to display
+ * resolution (0.1 for GB, 1 for everything else) or, for string metrics,
+ * its text. A new frame only notifies subjects whose quantized value
+ * actually changed, and label observers only call lv_label_set_text() when
+ * the formatted text differs, so stable fields cause no re-layout and no
+ * invalidation.
+ *
+ * All functions must be called from the LVGL task (or with the LVGL lock).
+ */
+
+#pragma once
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "lvgl.h"
+#include "metric_registry.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct metric_label_binding metric_label_binding_t;
+
+/**
+ * @brief Render a bound metric to text
+ * @param binding Binding being rendered (read values with metric_subjects_value())
+ * @param buf Output buffer
+ * @param size Output buffer size
+ * @note Leaving buf empty keeps the label's current text
+ */
+typedef void (*metric_format_fn)(const metric_label_binding_t *binding, char *buf, size_t size);
+
+/**
+ * @brief Connects a metric (and an optional second one for derived values) to a label
+ */
+struct metric_label_binding
+{
+  metric_id_t id;          ///< Primary metric
+  metric_id_t aux;         ///< Secondary metric for derived values, or METRIC_ID_INVALID
+  metric_format_fn format; ///< Text formatter
+};
+
+/**
+ * @brief Binding counters
+ */
+typedef struct
+{
+  uint32_t notified;  ///< Subjects whose value changed
+  uint32_t rewritten; ///< Labels whose text was rewritten
+  uint32_t unchanged; ///< Observer calls that produced the same text
+} metric_subjects_stats_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION PROTOTYPES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Create the subjects of the built-in metrics
+ */
+void metric_subjects_init(void);
+
+/**
+ * @brief Push a frame into the subjects, notifying only changed ones
+ * @param frame Latest metric frame
+ * @return Number of subjects that changed
+ */
+uint32_t metric_subjects_update(const metric_frame_t *frame);
+
+/**
+ * @brief Current value of a numeric metric at display resolution
+ * @return Value, or NAN if not received or not a numeric metric
+ */
+float metric_subjects_value(metric_id_t id);
+
+/**
+ * @brief Current value of a string metric
+ * @return String, or "" if not received or not a string metric
+ */
+const char *metric_subjects_string(metric_id_t id);
+
+/**
+ * @brief Bind a label to a metric
+ * @param label Label to update; the observers are removed with it
+ * @param binding Binding description, must stay valid while the label exists
+ */
+void metric_subjects_bind_label(lv_obj_t *label, const metric_label_binding_t *binding);
+
+/**
+ * @brief Bind a bar to a numeric metric
+ * @param bar Bar to update; the observer is removed with it
+ * @param id Metric shown by the bar
+ */
+void metric_subjects_bind_bar(lv_obj_t *bar, metric_id_t id);
+
+/**
+ * @brief Read the binding counters
+ * @param stats Receives the counters
+ */
+void metric_subjects_get_stats(metric_subjects_stats_t *stats);
@@ -0,0 +1,351 @@
+/**
+ * @file render_profiler.c
+ * @brief Frame-time and render-pipeline profiler
+ *
+ * Display events and the flush hooks run in the LVGL task, except
+ * render_profiler_flush_end(), which may run in the LCD or GDMA completion
+ * ISR. LVGL keeps at most one flush in flight, so a single start timestamp
+ * suffices; completed flush time is handed to the LVGL task through
+ * atomics and charged to the frame that is current when it is collected.
+ */
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "render_profiler.h"
+
+#include "draw_units.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lvgl_private.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static const char *TAG = "render_prof";
+
+#ifndef PROFILER_REPORT_MS
+#define PROFILER_REPORT_MS 10000 ///< Interval between PROF reports
+#endif
+#define PROFILER_OVERLAY_MS 1000 ///< Overlay refresh interval
+#define PROFILER_LINE_MAX 640    ///< Longest PROF line
+
+/**
+ * @brief Profiled quantities, in report order
+ */
+typedef enum
+{
+  PROF_FRAME = 0, ///< REFR_START to REFR_READY (us)
+  PROF_RENDER,    ///< RENDER_START to RENDER_READY (us)
+  PROF_FLUSH,     ///< Flush time per frame, DMA included (us)
+  PROF_AREA,      ///< Invalidated pixels per frame
+  PROF_TASKS,     ///< Draw tasks dispatched per frame
+  PROF_HANDLER,   ///< lv_timer_handler() run time (us)
+  PROF_LOCK,      ///< LVGL lock wait (us)
+  PROF_TOUCH,     ///< Touch read to end of the first frame after it (us)
+  PROF_HA_EVENT,  ///< HA event arrival to end of the first frame after it (us)
+  PROF_COUNT
+} prof_metric_t;
+
+static const char *const prof_names[PROF_COUNT] = {
+    [PROF_FRAME] = "frame_us",
+    [PROF_RENDER] = "render_us",
+    [PROF_FLUSH] = "flush_us",
+    [PROF_AREA] = "area_px",
+    [PROF_TASKS] = "draw_tasks",
+    [PROF_HANDLER] = "handler_us",
+    [PROF_LOCK] = "lock_wait_us",
+    [PROF_TOUCH] = "touch_us",
+    [PROF_HA_EVENT] = "ha_event_us",
+};
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATIC VARIABLES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static profiler_hist_t hists[PROF_COUNT]; ///< Current window (LVGL task / LVGL lock)
+static const char *render_mode = "";
+static lv_display_t *profiled_display = NULL;
+static lv_obj_t *overlay_label = NULL;
+static uint32_t ticks_since_report = 0;
+
+// Per-frame state (LVGL task only)
+static int64_t frame_start_us = 0;
+static int64_t render_start_us = 0;
+static uint32_t frame_start_tasks = 0;
+static uint32_t frame_area_px = 0;
+
+// Open touch-to-flush and event-to-flush measurements (LVGL task only, 0 = none)
+static uint32_t touch_input_us = 0;
+static uint32_t ha_event_us = 0;
+
+// Flush timing (flush_end may run in an ISR)
+static uint32_t flush_start_us = 0;
+static atomic_uint flush_pending_us = 0;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void hist_add(profiler_hist_t *hist, uint32_t value)
+{
+  uint32_t bucket = value ? 32 - __builtin_clz(value) : 0;
+  if (bucket >= PROFILER_BUCKETS)
+    bucket = PROFILER_BUCKETS - 1;
+
+  hist->buckets[bucket]++;
+  hist->count++;
+  hist->sum += value;
+  if (value > hist->max)
+    hist->max = value;
+}
+
+/**
+ * @brief Upper bound of the bucket holding the given percentile, capped at max
+ */
+static uint32_t hist_percentile(const profiler_hist_t *hist, uint32_t percent)
+{
+  if (hist->count == 0)
+    return 0;
+
+  uint32_t rank = (hist->count * percent + 99) / 100;
+  uint32_t seen = 0;
+  for (uint32_t i = 0; i < PROFILER_BUCKETS; i++)
+  {
+    seen += hist->buckets[i];
+    if (seen >= rank)
+    {
+      uint32_t bound = i == 0 ? 0 : (1u << i) - 1;
+      return bound < hist->max ? bound : hist->max;
+    }
+  }
+  return hist->max;
+}
+
+static uint32_t hist_avg(const profiler_hist_t *hist)
+{
+  return hist->count ? (uint32_t)(hist->sum / hist->count) : 0;
+}
+
+/**
+ * @brief Sum of the areas LVGL is about to redraw (joined areas skipped)
+ */
+static uint32_t invalidated_area(lv_display_t *disp)
+{
+  uint32_t px = 0;
+  for (int32_t i = 0; i < disp->inv_p; i++)
+  {
+    if (!disp->inv_area_joined[i])
+      px += lv_area_get_size(&disp->inv_areas[i]);
+  }
+  return px;
+}
+
+static void display_event_cb(lv_event_t *e)
+{
+  lv_display_t *disp = lv_event_get_target(e);
+  int64_t now = esp_timer_get_time();
+
+  switch (lv_event_get_code(e))
+  {
+  case LV_EVENT_REFR_START:
+    frame_start_us = now;
+    frame_start_tasks = draw_units_total_tasks();
+    frame_area_px = 0;
+    break;
+
+  case LV_EVENT_RENDER_START:
+    render_start_us = now;
+    frame_area_px = invalidated_area(disp);
+    break;
+
+  case LV_EVENT_RENDER_READY:
+    hist_add(&hists[PROF_RENDER], (uint32_t)(now - render_start_us));
+    break;
+
+  case LV_EVENT_REFR_READY:
+    // Refreshes with nothing invalidated are timer ticks, not frames
+    if (frame_area_px == 0)
+      break;
+
+    hist_add(&hists[PROF_FRAME], (uint32_t)(now - frame_start_us));
+    hist_add(&hists[PROF_FLUSH], atomic_exchange(&flush_pending_us, 0));
+    hist_add(&hists[PROF_AREA], frame_area_px);
+    hist_add(&hists[PROF_TASKS], draw_units_total_tasks() - frame_start_tasks);
+
+    if (touch_input_us)
+    {
+      uint32_t latency = (uint32_t)now - touch_input_us;
+      if (latency < PROFILER_TOUCH_TIMEOUT_MS * 1000)
+        hist_add(&hists[PROF_TOUCH], latency);
+      touch_input_us = 0;
+    }
+
+    if (ha_event_us)
+    {
+      uint32_t latency = (uint32_t)now - ha_event_us;
+      if (latency < PROFILER_EVENT_TIMEOUT_MS * 1000)
+        hist_add(&hists[PROF_HA_EVENT], latency);
+      ha_event_us = 0;
+    }
+    break;
+
+  default:
+    break;
+  }
+}
+
+static void overlay_update(void)
+{
+  const profiler_hist_t *frame = &hists[PROF_FRAME];
+
+  lv_label_set_text_fmt(overlay_label,
+                        "frames %lu  frame p95 %lu us\n"
+                        "render p95 %lu us  flush p95 %lu us\n"
+                        "area avg %lu px  tasks avg %lu\n"
+                        "handler max %lu us  lock max %lu us\n"
+                        "touch p95 %lu us",
+                        frame->count, hist_percentile(frame, 95),
+                        hist_percentile(&hists[PROF_RENDER], 95), hist_percentile(&hists[PROF_FLUSH], 95),
+                        hist_avg(&hists[PROF_AREA]), hist_avg(&hists[PROF_TASKS]),
+                        hists[PROF_HANDLER].max, hists[PROF_LOCK].max, hist_percentile(&hists[PROF_TOUCH], 95));
+}
+
+/**
+ * @brief Emit one machine-readable PROF line for the window and reset it
+ */
+static void report(void)
+{
+  static char line[PROFILER_LINE_MAX]; // LVGL task only
+  int len = snprintf(line, sizeof(line), "PROF {\"mode\":\"%s\",\"ms\":%d,\"frames\":%lu",
+                     render_mode, PROFILER_REPORT_MS, hists[PROF_FRAME].count);
+
+  for (int m = 0; m < PROF_COUNT && len < (int)sizeof(line); m++)
+  {
+    const profiler_hist_t *hist = &hists[m];
+    len += snprintf(line + len, sizeof(line) - len, ",\"%s\":[%lu,%lu,%lu,%lu,%lu]", prof_names[m],
+                    hist_avg(hist), hist_percentile(hist, 50), hist_percentile(hist, 95),
+                    hist_percentile(hist, 99), hist->max);
+  }
+  if (len < (int)sizeof(line))
+    snprintf(line + len, sizeof(line) - len, "}");
+
+  ESP_LOGI(TAG, "%s", line);
+  memset(hists, 0, sizeof(hists));
+}
+
+static void profiler_timer_cb(lv_timer_t *timer)
+{
+  LV_UNUSED(timer);
+
+  if (overlay_label && !lv_obj_has_flag(overlay_label, LV_OBJ_FLAG_HIDDEN))
+    overlay_update();
+
+  if (++ticks_since_report >= PROFILER_REPORT_MS / PROFILER_OVERLAY_MS)
+  {
+    ticks_since_report = 0;
+    report();
+  }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void render_profiler_init(lv_display_t *display, const char *mode_name)
+{
+  profiled_display = display;
+  render_mode = mode_name;
+
+  lv_display_add_event_cb(display, display_event_cb, LV_EVENT_REFR_START, NULL);
+  lv_display_add_event_cb(display, display_event_cb, LV_EVENT_RENDER_START, NULL);
+  lv_display_add_event_cb(display, display_event_cb, LV_EVENT_RENDER_READY, NULL);
+  lv_display_add_event_cb(display, display_event_cb, LV_EVENT_REFR_READY, NULL);
+
+  overlay_label = lv_label_create(lv_display_get_layer_top(display));
+  lv_obj_set_style_bg_color(overlay_label, lv_color_black(), 0);
+  lv_obj_set_style_bg_opa(overlay_label, LV_OPA_70, 0);
+  lv_obj_set_style_text_color(overlay_label, lv_color_hex(0x00ff88), 0);
+  lv_obj_set_style_text_font(overlay_label, &lv_font_montserrat_12, 0);
+  lv_obj_set_style_pad_all(overlay_label, 4, 0);
+  lv_obj_align(overlay_label, LV_ALIGN_TOP_LEFT, 4, 4);
+  lv_label_set_text(overlay_label, "");
+  render_profiler_set_overlay(false);
+
+  lv_timer_create(profiler_timer_cb, PROFILER_OVERLAY_MS, NULL);
+
+  ESP_LOGI(TAG, "Render profiler ready (%s), PROF report every %d ms", mode_name, PROFILER_REPORT_MS);
+}
+
+void render_profiler_flush_begin(void)
+{
+  flush_start_us = (uint32_t)esp_timer_get_time();
+}
+
+void IRAM_ATTR render_profiler_flush_end(void)
+{
+  atomic_fetch_add(&flush_pending_us, (uint32_t)esp_timer_get_time() - flush_start_us);
+}
+
+void render_profiler_record_handler(uint32_t us)
+{
+  hist_add(&hists[PROF_HANDLER], us);
+}
+
+void render_profiler_record_lock_wait(uint32_t us)
+{
+  hist_add(&hists[PROF_LOCK], us);
+}
+
+void render_profiler_mark_input(uint32_t input_us)
+{
+  // An open measurement that timed out had no visible effect: start over
+  if (touch_input_us && (uint32_t)esp_timer_get_time() - touch_input_us >= PROFILER_TOUCH_TIMEOUT_MS * 1000)
+    touch_input_us = 0;
+
+  if (!touch_input_us)
+    touch_input_us = input_us;
+}
+
+void render_profiler_mark_event(uint32_t event_us)
+{
+  if (ha_event_us && (uint32_t)esp_timer_get_time() - ha_event_us >= PROFILER_EVENT_TIMEOUT_MS * 1000)
+    ha_event_us = 0;
+
+  if (!ha_event_us)
+    ha_event_us = event_us;
+}
+
+void render_profiler_set_overlay(bool show)
+{
+  if (!overlay_label)
+    return;
+
+  if (show)
+  {
+    overlay_update();
+    lv_obj_remove_flag(overlay_label, LV_OBJ_FLAG_HIDDEN);
+#if LV_USE_PERF_MONITOR
+    lv_sysmon_show_performance(profiled_display);
+#endif
+  }
+  else
+  {
+    lv_obj_add_flag(overlay_label, LV_OBJ_FLAG_HIDDEN);
+#if LV_USE_PERF_MONITOR
+    lv_sysmon_hide_performance(profiled_display);
+#endif
+  }
+}
+
+void render_profiler_toggle_overlay(void)
+{
+  if (overlay_label)
+    render_profiler_set_overlay(lv_obj_has_flag(overlay_label, LV_OBJ_FLAG_HIDDEN));
+}
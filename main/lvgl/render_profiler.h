@@ -0,0 +1,122 @@
+/**
+ * @file render_profiler.h
+ * @brief Frame-time and render-pipeline profiler
+ *
+ * Every refresh records its frame time (REFR_START to REFR_READY), render
+ * time (RENDER_START to RENDER_READY, i.e. drawing plus flush waits),
+ * flush time (flush_cb entry to flush ready, DMA included), invalidated
+ * area and number of draw tasks. The LVGL task adds its lv_timer_handler()
+ * run time, and every LVGL lock acquisition its wait time.
+ *
+ * Touch-to-flush latency runs from the moment the touch task read a touch
+ * change to the end of the first frame that redraws anything after LVGL
+ * picked the change up. Touches that cause no redraw within
+ * PROFILER_TOUCH_TIMEOUT_MS are not counted. Replaying a recorded touch
+ * trace (gt911_trace_replay) makes these numbers comparable between builds.
+ * Home Assistant event-to-flush latency is measured the same way, from the
+ * arrival of a pushed state change to the first frame after it was applied.
+ *
+ * Each quantity goes into a fixed log2 histogram that is reported and reset
+ * every PROFILER_REPORT_MS:
+ *
+ *   PROF {"mode":"...","ms":10000,"frames":97,"frame_us":[avg,p50,p95,p99,max],...}
+ *
+ * Percentiles are bucket upper bounds (at most 2x high, never above max).
+ * The overlay shows LVGL's sysmon FPS/CPU monitor plus the same numbers
+ * for the current window; it redraws a small label once per second, so
+ * leave it off while measuring idle behaviour.
+ */
+
+#pragma once
+
+#include "lvgl.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define PROFILER_BUCKETS 20 ///< Log2 buckets: 0, 1, 2-3, 4-7, ... 2^18 and up
+#define PROFILER_TOUCH_TIMEOUT_MS 250 ///< Touch changes not followed by a frame within this are dropped
+#define PROFILER_EVENT_TIMEOUT_MS 1000 ///< HA events not followed by a frame within this are dropped
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Fixed-size log2 histogram
+ */
+typedef struct
+{
+  uint32_t buckets[PROFILER_BUCKETS]; ///< Bucket i counts values in [2^(i-1), 2^i)
+  uint32_t count;                     ///< Values recorded
+  uint64_t sum;                       ///< Sum of the values
+  uint32_t max;                       ///< Largest value
+} profiler_hist_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION PROTOTYPES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Hook the display events and start the periodic report
+ * @param display Display to profile
+ * @param mode_name Rendering mode, included in every report
+ * @note Call with the LVGL lock held, after the display is configured
+ */
+void render_profiler_init(lv_display_t *display, const char *mode_name);
+
+/**
+ * @brief Mark the start of a flush (call at the top of the flush callback)
+ */
+void render_profiler_flush_begin(void);
+
+/**
+ * @brief Mark the end of a flush, right before lv_display_flush_ready()
+ * @note Safe from ISR and DMA completion callbacks
+ */
+void render_profiler_flush_end(void);
+
+/**
+ * @brief Record one lv_timer_handler() run
+ * @param us Run time in microseconds
+ * @note Call from the LVGL task
+ */
+void render_profiler_record_handler(uint32_t us);
+
+/**
+ * @brief Record how long acquiring the LVGL lock took
+ * @param us Wait time in microseconds
+ * @note Call while holding the LVGL lock, which serializes the histogram
+ */
+void render_profiler_record_lock_wait(uint32_t us);
+
+/**
+ * @brief Start a touch-to-flush measurement
+ * @param input_us Low 32 bits of esp_timer_get_time() when the touch was read
+ * @note Call from the LVGL input read callback; while a measurement is
+ *       open, later touches are folded into it
+ */
+void render_profiler_mark_input(uint32_t input_us);
+
+/**
+ * @brief Start a Home Assistant event-to-flush measurement
+ * @param event_us Low 32 bits of esp_timer_get_time() when the event arrived
+ * @note Call from the LVGL task when the event changes a widget; while a
+ *       measurement is open, later events are folded into it
+ */
+void render_profiler_mark_event(uint32_t event_us);
+
+/**
+ * @brief Show or hide the profiler overlay
+ * @note Call with the LVGL lock held
+ */
+void render_profiler_set_overlay(bool show);
+
+/**
+ * @brief Toggle the profiler overlay
+ * @note Call with the LVGL lock held
+ */
+void render_profiler_toggle_overlay(void);
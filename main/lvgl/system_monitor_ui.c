@@ -13,26 +13,67 @@
  * - Equal padding for all panels
  * - Increased panel heights for better spacing
  * - Clean design without emoji icons
+ *
+ * Usage sparklines sit at the right end of each panel's title row. One
+ * point is one completed 1 s bucket of the metric history, whatever rate
+ * the sender runs at. They run in shift mode: each new second appends one
+ * point and invalidates only the chart (110x30 px for CPU/GPU, 200x30 px
+ * for memory, ~12.6k px in total against ~57k px for one CPU panel), so the
+ * panels around them are not redrawn.
+ * The per-point draw cost is measured between LV_EVENT_DRAW_MAIN_BEGIN
+ * and _END and logged as "Sparkline draw" with the UI statistics. With the
+ * threaded SW renderer this covers building the line draw tasks in the
+ * LVGL task; rasterization of the small invalidated area happens in the
+ * draw unit.
+ *
+ * Touch gestures arrive from the touch task through the UI queue. A pinch
+ * on a CPU/GPU/memory panel zooms its sparkline between 30 s and 10 min,
+ * refilled from the 1 s metric history; a two-finger tap resets all of
+ * them to one minute.
+ *
+ * Switch and scene touches never wait on Home Assistant: the handlers
+ * queue the request with the command worker (smart/ha_command.h) and
+ * return. The widget shows the new state straight away and is rolled back
+ * if the call fails, so touch-to-feedback is one frame (touch_us in PROF).
  */
 
 #include "system_monitor_ui.h"
 
+#include "data_snapshot.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "lvgl_setup.h"
+#include "metric_subjects.h"
+#include "render_profiler.h"
+#include "ui_queue.h"
+#include "serial/metric_history.h"
 #include "smart/ha_api.h"
+#include "smart/ha_command.h"
 #include "smart/smart_home.h"
 #include "smart/smart_config.h"
+#include "touch/gt911_touch.h"
+#include <math.h>
+#include <stdatomic.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 
 static const char *TAG = "system_monitor";
 
+#define UI_REFRESH_PERIOD_MS 1000  ///< Fallback snapshot poll; publishes wake the LVGL task directly
+#define UI_STATS_LOG_INTERVAL 100  ///< Rendered samples between statistics logs
+
+#define SPARKLINE_POINTS 60     ///< 1 s points visible in a sparkline (one minute)
+#define SPARKLINE_WIDTH 110     ///< Panel sparkline width
+#define SPARKLINE_HEIGHT 30     ///< Sparkline height (fits the title row)
+#define SPARKLINE_MEM_WIDTH 200 ///< Memory panel has a wider title row
+#define SPARKLINE_FILL_CHUNK 60 ///< History points read per query when refilling a sparkline
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // UI ELEMENT HANDLES FOR REAL-TIME UPDATES
 // ═══════════════════════════════════════════════════════════════════════════════
 
 // Status and Info Elements
-static lv_obj_t *timestamp_label = NULL;
 static lv_obj_t *connection_status_label = NULL;
 static lv_obj_t *wifi_status_label = NULL;
 
@@ -60,6 +101,29 @@ static lv_obj_t *mem_usage_bar = NULL;
 static lv_obj_t *mem_usage_label = NULL;
 static lv_obj_t *mem_info_label = NULL;
 
+// Serial link state shown in the status bar (tracked here, not parsed back from the label)
+typedef enum
+{
+  SERIAL_LINK_WAITING = 0,
+  SERIAL_LINK_CONNECTED,
+  SERIAL_LINK_LOST,
+} serial_link_state_t;
+
+static serial_link_state_t serial_link_state = SERIAL_LINK_WAITING;
+static atomic_uint switch_states = 0; ///< Bit n = switch n checked, readable from any task
+static char last_sample_time[24] = "Last: Never"; ///< "Last: HH:MM:SS" of the newest sample
+
+// Sparklines (title row of each panel)
+static lv_obj_t *cpu_sparkline = NULL;
+static lv_obj_t *gpu_sparkline = NULL;
+static lv_obj_t *mem_sparkline = NULL;
+
+// Sparkline draw cost (LVGL task only)
+static int64_t sparkline_draw_start_us = 0;
+static uint32_t sparkline_draw_count = 0;
+static uint32_t sparkline_draw_total_us = 0;
+static uint32_t sparkline_draw_max_us = 0;
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // FONT DEFINITIONS WITH FALLBACK
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -83,6 +147,18 @@ static const lv_font_t *font_big_numbers = &lv_font_montserrat_32; // Large numb
 static const lv_font_t *font_big_numbers = &lv_font_montserrat_14; // Fallback to 14px
 #endif
 
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION PROTOTYPES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void ui_refresh_timer_cb(lv_timer_t *timer);
+static void bind_metrics(void);
+static void update_connection_label(void);
+static void post_ui_message(const ui_msg_t *msg);
+static void remember_switch_state(uint8_t index, bool state);
+static void apply_ui_messages(void);
+static void on_gesture(const gesture_event_t *event);
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // EVENT HANDLERS - USING SYSTEM MANAGER TO PREVENT LVGL BLOCKING
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -126,18 +202,21 @@ static void switch_a_event_handler(lv_event_t *e)
   if (code == LV_EVENT_VALUE_CHANGED)
   {
     bool state = lv_obj_has_state(obj, LV_STATE_CHECKED);
+    remember_switch_state(0, state);
     ESP_LOGI(TAG, "� SWITCH A (%s) TOUCH EVENT: User selected %s", UI_LABEL_A, state ? "ON" : "OFF");
 
-    // Control the actual device via Home Assistant
-    esp_err_t ret = smart_home_control_switch(HA_ENTITY_A, state);
+    // Queue it for the command worker; the widget already shows the new state
+    esp_err_t ret = ha_command_set_switch(0, state);
     if (ret != ESP_OK)
     {
       ESP_LOGE(TAG, "� SWITCH A (%s) FAILED: %s", UI_LABEL_A, esp_err_to_name(ret));
-      // TODO: Consider reverting the switch state on failure
+      // Nothing will be sent, so undo the toggle
+      lv_obj_set_state(obj, LV_STATE_CHECKED, !state);
+      remember_switch_state(0, !state);
     }
     else
     {
-      ESP_LOGI(TAG, "� SWITCH A (%s) SUCCESS: Device state changed to %s", UI_LABEL_A, state ? "ON" : "OFF");
+      ESP_LOGI(TAG, "� SWITCH A (%s) QUEUED: %s", UI_LABEL_A, state ? "ON" : "OFF");
     }
   }
 }
@@ -155,18 +234,21 @@ static void switch_b_event_handler(lv_event_t *e)
   if (code == LV_EVENT_VALUE_CHANGED)
   {
     bool state = lv_obj_has_state(obj, LV_STATE_CHECKED);
+    remember_switch_state(1, state);
     ESP_LOGI(TAG, "🔌 SWITCH B (%s) TOUCH EVENT: User selected %s", UI_LABEL_B, state ? "ON" : "OFF");
 
-    // Control the actual device via Home Assistant
-    esp_err_t ret = smart_home_control_switch(HA_ENTITY_B, state);
+    // Queue it for the command worker; the widget already shows the new state
+    esp_err_t ret = ha_command_set_switch(1, state);
     if (ret != ESP_OK)
     {
       ESP_LOGE(TAG, "🔌 SWITCH B (%s) FAILED: %s", UI_LABEL_B, esp_err_to_name(ret));
-      // TODO: Consider reverting the switch state on failure
+      // Nothing will be sent, so undo the toggle
+      lv_obj_set_state(obj, LV_STATE_CHECKED, !state);
+      remember_switch_state(1, !state);
     }
     else
     {
-      ESP_LOGI(TAG, "🔌 SWITCH B (%s) SUCCESS: Device state changed to %s", UI_LABEL_B, state ? "ON" : "OFF");
+      ESP_LOGI(TAG, "🔌 SWITCH B (%s) QUEUED: %s", UI_LABEL_B, state ? "ON" : "OFF");
     }
   }
 }
@@ -184,22 +266,34 @@ static void switch_c_event_handler(lv_event_t *e)
   if (code == LV_EVENT_VALUE_CHANGED)
   {
     bool state = lv_obj_has_state(obj, LV_STATE_CHECKED);
+    remember_switch_state(2, state);
     ESP_LOGI(TAG, "� SWITCH C (%s) TOUCH EVENT: User selected %s", UI_LABEL_C, state ? "ON" : "OFF");
 
-    // Control the actual device via Home Assistant
-    esp_err_t ret = smart_home_control_switch(HA_ENTITY_C, state);
+    // Queue it for the command worker; the widget already shows the new state
+    esp_err_t ret = ha_command_set_switch(2, state);
     if (ret != ESP_OK)
     {
       ESP_LOGE(TAG, "� SWITCH C (%s) FAILED: %s", UI_LABEL_C, esp_err_to_name(ret));
-      // TODO: Consider reverting the switch state on failure
+      // Nothing will be sent, so undo the toggle
+      lv_obj_set_state(obj, LV_STATE_CHECKED, !state);
+      remember_switch_state(2, !state);
     }
     else
     {
-      ESP_LOGI(TAG, "� SWITCH C (%s) SUCCESS: Device state changed to %s", UI_LABEL_C, state ? "ON" : "OFF");
+      ESP_LOGI(TAG, "� SWITCH C (%s) QUEUED: %s", UI_LABEL_C, state ? "ON" : "OFF");
     }
   }
 }
 
+/**
+ * @brief Status panel long press: show or hide the render profiler overlay
+ */
+static void status_panel_event_handler(lv_event_t *e)
+{
+  LV_UNUSED(e);
+  render_profiler_toggle_overlay();
+}
+
 /**
  * @brief Scene button event handler
  */
@@ -213,15 +307,15 @@ static void scene_button_event_handler(lv_event_t *e)
   {
     ESP_LOGI(TAG, "🎬 SCENE BUTTON (%s) PRESSED", UI_LABEL_D);
 
-    // Trigger the scene via Home Assistant
-    esp_err_t ret = smart_home_trigger_scene();
+    // Queue the scene for the command worker
+    esp_err_t ret = ha_command_trigger_scene();
     if (ret != ESP_OK)
     {
       ESP_LOGE(TAG, "🎬 SCENE BUTTON (%s) FAILED: %s", UI_LABEL_D, esp_err_to_name(ret));
     }
     else
     {
-      ESP_LOGI(TAG, "🎬 SCENE BUTTON (%s) SUCCESS: Scene triggered", UI_LABEL_D);
+      ESP_LOGI(TAG, "🎬 SCENE BUTTON (%s) QUEUED", UI_LABEL_D);
     }
   }
 }
@@ -407,6 +501,63 @@ static lv_obj_t *create_progress_bar(lv_obj_t *parent, int width, int height, in
   return bar;
 }
 
+/**
+ * @brief Time sparkline drawing (LV_EVENT_DRAW_MAIN_BEGIN/END)
+ */
+static void sparkline_draw_event_cb(lv_event_t *e)
+{
+  if (lv_event_get_code(e) == LV_EVENT_DRAW_MAIN_BEGIN)
+  {
+    sparkline_draw_start_us = esp_timer_get_time();
+    return;
+  }
+
+  uint32_t elapsed = (uint32_t)(esp_timer_get_time() - sparkline_draw_start_us);
+  sparkline_draw_count++;
+  sparkline_draw_total_us += elapsed;
+  if (elapsed > sparkline_draw_max_us)
+    sparkline_draw_max_us = elapsed;
+}
+
+/**
+ * @brief Create a borderless line sparkline with a 0-100 range
+ * @param parent Parent panel
+ * @param width Sparkline width
+ * @param x X position
+ * @param y Y position
+ * @param line_color Line color (hex)
+ * @return Created chart object
+ * @note Shift mode: each new sample scrolls the line left by one point and
+ *       only the chart's own area is invalidated
+ */
+static lv_obj_t *create_sparkline(lv_obj_t *parent, int width, int x, int y, uint32_t line_color)
+{
+  lv_obj_t *chart = lv_chart_create(parent);
+  lv_obj_set_size(chart, width, SPARKLINE_HEIGHT);
+  lv_obj_set_pos(chart, x, y);
+  lv_chart_set_type(chart, LV_CHART_TYPE_LINE);
+  lv_chart_set_update_mode(chart, LV_CHART_UPDATE_MODE_SHIFT);
+  lv_chart_set_point_count(chart, SPARKLINE_POINTS);
+  lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, 0, 100);
+  lv_chart_set_div_line_count(chart, 0, 0);
+
+  // Plain line: no background, border, padding or point markers
+  lv_obj_set_style_bg_opa(chart, LV_OPA_TRANSP, LV_PART_MAIN);
+  lv_obj_set_style_border_width(chart, 0, LV_PART_MAIN);
+  lv_obj_set_style_pad_all(chart, 0, LV_PART_MAIN);
+  lv_obj_set_style_line_width(chart, 2, LV_PART_ITEMS);
+  lv_obj_set_style_width(chart, 0, LV_PART_INDICATOR);
+  lv_obj_set_style_height(chart, 0, LV_PART_INDICATOR);
+  lv_obj_remove_flag(chart, LV_OBJ_FLAG_CLICKABLE);
+
+  lv_chart_series_t *series = lv_chart_add_series(chart, lv_color_hex(line_color), LV_CHART_AXIS_PRIMARY_Y);
+  lv_chart_set_all_value(chart, series, LV_CHART_POINT_NONE);
+
+  lv_obj_add_event_cb(chart, sparkline_draw_event_cb, LV_EVENT_DRAW_MAIN_BEGIN, NULL);
+  lv_obj_add_event_cb(chart, sparkline_draw_event_cb, LV_EVENT_DRAW_MAIN_END, NULL);
+  return chart;
+}
+
 /**
  * @brief Create a status panel with minimal styling
  * @param parent Parent object
@@ -531,6 +682,11 @@ static lv_obj_t *create_cpu_panel(lv_obj_t *parent)
   lv_obj_set_style_text_font(cpu_name_label, font_small, 0);
   lv_obj_set_style_text_color(cpu_name_label, lv_color_hex(0x888888), 0);
   lv_obj_set_pos(cpu_name_label, 80, 8);
+  lv_obj_set_width(cpu_name_label, 355 - 80 - SPARKLINE_WIDTH - 10);
+  lv_label_set_long_mode(cpu_name_label, LV_LABEL_LONG_DOT);
+
+  // Usage sparkline at the right end of the title row
+  cpu_sparkline = create_sparkline(cpu_panel, SPARKLINE_WIDTH, 355 - SPARKLINE_WIDTH, 2, 0x4fc3f7);
 
   // Create CPU fields - Temperature first
   cpu_temp_label = create_field(cpu_panel, "Temp", "--°C", 10, font_normal, font_big_numbers, 0xaaaaaa, 0xff7043);
@@ -562,6 +718,11 @@ static lv_obj_t *create_gpu_panel(lv_obj_t *parent)
   lv_obj_set_style_text_font(gpu_name_label, font_small, 0);
   lv_obj_set_style_text_color(gpu_name_label, lv_color_hex(0x888888), 0);
   lv_obj_set_pos(gpu_name_label, 80, 8);
+  lv_obj_set_width(gpu_name_label, 355 - 80 - SPARKLINE_WIDTH - 10);
+  lv_label_set_long_mode(gpu_name_label, LV_LABEL_LONG_DOT);
+
+  // Usage sparkline at the right end of the title row
+  gpu_sparkline = create_sparkline(gpu_panel, SPARKLINE_WIDTH, 355 - SPARKLINE_WIDTH, 2, 0x4caf50);
 
   // Create GPU fields - Temperature first
   gpu_temp_label = create_field(gpu_panel, "Temp", "--°C", 10, font_normal, font_big_numbers, 0xaaaaaa, 0xff7043);
@@ -594,6 +755,9 @@ static lv_obj_t *create_memory_panel(lv_obj_t *parent)
   lv_obj_set_style_text_color(mem_info_label, lv_color_hex(0xcccccc), 0);
   lv_obj_set_pos(mem_info_label, 240, 8);
 
+  // Usage sparkline at the right end of the title row
+  mem_sparkline = create_sparkline(mem_panel, SPARKLINE_MEM_WIDTH, 750 - SPARKLINE_MEM_WIDTH, 2, 0xff7043);
+
   // Create memory usage value (without label)
   mem_usage_label = lv_label_create(mem_panel);
   lv_label_set_text(mem_usage_label, "0%");
@@ -619,6 +783,9 @@ static lv_obj_t *create_status_info_panel(lv_obj_t *parent)
 {
   lv_obj_t *status_panel = create_status_panel(parent, 780, 50, 10, 410, 0x0f0f0f, 0x222222);
 
+  // Long press toggles the render profiler overlay
+  lv_obj_add_event_cb(status_panel, status_panel_event_handler, LV_EVENT_LONG_PRESSED, NULL);
+
   // Serial connection status with last update time (left side)
   connection_status_label = lv_label_create(status_panel);
   lv_label_set_text(connection_status_label, "[SERIAL] Waiting... | Last: Never");
@@ -633,11 +800,6 @@ static lv_obj_t *create_status_info_panel(lv_obj_t *parent)
   lv_obj_set_style_text_color(wifi_status_label, lv_color_hex(0x00aaff), 0);
   lv_obj_align(wifi_status_label, LV_ALIGN_TOP_RIGHT, -10, 11);
 
-  // Hidden timestamp label for internal timestamp tracking
-  timestamp_label = lv_label_create(status_panel);
-  lv_label_set_text(timestamp_label, "Last: Never");
-  lv_obj_add_flag(timestamp_label, LV_OBJ_FLAG_HIDDEN); // Hide this element
-
   return status_panel;
 }
 
@@ -664,6 +826,15 @@ void system_monitor_ui_create(lv_display_t *disp)
   create_memory_panel(screen);
   create_status_info_panel(screen);
 
+  // Labels and bars follow metric subjects and only change when their text does
+  bind_metrics();
+
+  // Pick up published samples in the LVGL task as soon as they are published
+  lvgl_setup_add_wake_timer(lv_timer_create(ui_refresh_timer_cb, UI_REFRESH_PERIOD_MS, NULL));
+
+  // Gestures are recognized in the touch task and queued like other updates
+  gt911_set_gesture_handler(on_gesture);
+
   ESP_LOGI(TAG, "System Monitor UI created successfully");
 }
 
@@ -672,140 +843,463 @@ void system_monitor_ui_create(lv_display_t *disp)
 // ═══════════════════════════════════════════════════════════════════════════════
 
 /**
- * @brief Update all system monitor display elements with new data
- * @param data Pointer to system monitoring data structure
- * @note This function is thread-safe and handles LVGL mutex locking
+ * @brief Format a numeric metric according to its registered unit
  */
-void system_monitor_ui_update(const system_data_t *data)
+static void format_unit(const metric_label_binding_t *binding, char *buf, size_t size)
 {
-  if (!data)
+  const metric_desc_t *desc = metric_registry_get(binding->id);
+  float value = metric_subjects_value(binding->id);
+  metric_unit_t unit = desc ? desc->unit : METRIC_UNIT_NONE;
+
+  if (isnan(value))
+  {
+    snprintf(buf, size, "--%s", unit == METRIC_UNIT_PERCENT ? "%" : (unit == METRIC_UNIT_CELSIUS ? "°C" : ""));
     return;
+  }
 
-  lvgl_lock_acquire();
+  switch (unit)
+  {
+  case METRIC_UNIT_PERCENT:
+    snprintf(buf, size, "%d%%", (int)value);
+    break;
+  case METRIC_UNIT_CELSIUS:
+    snprintf(buf, size, "%d°C", (int)value); // Shortened format
+    break;
+  case METRIC_UNIT_MB:
+    snprintf(buf, size, "%d MB", (int)value);
+    break;
+  case METRIC_UNIT_GB:
+    snprintf(buf, size, "%.1f GB", value);
+    break;
+  default:
+    snprintf(buf, size, "%d", (int)value);
+    break;
+  }
+}
 
-  // ─────────────────────────────────────────────────────────────────
-  // Update Timestamp and Clock Display
-  // ─────────────────────────────────────────────────────────────────
+/**
+ * @brief Format a string metric (empty until received, so the placeholder stays)
+ */
+static void format_string(const metric_label_binding_t *binding, char *buf, size_t size)
+{
+  snprintf(buf, size, "%s", metric_subjects_string(binding->id));
+}
+
+/**
+ * @brief Format id / aux as a percentage (e.g. GPU memory used / total)
+ */
+static void format_ratio(const metric_label_binding_t *binding, char *buf, size_t size)
+{
+  float used = metric_subjects_value(binding->id);
+  float total = metric_subjects_value(binding->aux);
 
-  if (timestamp_label && connection_status_label)
+  if (isnan(used) || isnan(total) || total <= 0)
   {
-    time_t timestamp_sec = data->timestamp / 1000;
-    struct tm *timeinfo = localtime(&timestamp_sec);
-    char time_str[64];
-    strftime(time_str, sizeof(time_str), "Last: %H:%M:%S", timeinfo);
-    lv_label_set_text(timestamp_label, time_str);
-
-    // Update the combined connection status with timestamp
-    char combined_status[128];
-    const char *current_status = lv_label_get_text(connection_status_label);
-    if (strstr(current_status, "[SERIAL] Connected"))
-    {
-      snprintf(combined_status, sizeof(combined_status), "[SERIAL] Connected | %s", time_str);
-    }
-    else if (strstr(current_status, "[SERIAL] Connection Lost"))
-    {
-      snprintf(combined_status, sizeof(combined_status), "[SERIAL] Connection Lost | %s", time_str);
-    }
-    else
+    snprintf(buf, size, "--%%");
+    return;
+  }
+  snprintf(buf, size, "%d%%", (int)(used * 100.0f / total));
+}
+
+/**
+ * @brief Format id / aux as "(used GB / total GB)"
+ */
+static void format_used_of_total(const metric_label_binding_t *binding, char *buf, size_t size)
+{
+  float used = metric_subjects_value(binding->id);
+  float total = metric_subjects_value(binding->aux);
+
+  if (isnan(used) || isnan(total))
+  {
+    snprintf(buf, size, "(-.- GB / -.- GB)");
+    return;
+  }
+  snprintf(buf, size, "(%.1f GB / %.1f GB)", used, total); // Updated format to match new compact layout
+}
+
+/**
+ * @brief Label bindings: which metric drives which label, and how it is shown
+ */
+static const struct
+{
+  lv_obj_t **label;
+  metric_label_binding_t binding;
+} label_bindings[] = {
+    {&cpu_name_label, {METRIC_CPU_NAME, METRIC_ID_INVALID, format_string}},
+    {&cpu_usage_label, {METRIC_CPU_USAGE, METRIC_ID_INVALID, format_unit}},
+    {&cpu_temp_label, {METRIC_CPU_TEMP, METRIC_ID_INVALID, format_unit}},
+    {&cpu_fan_label, {METRIC_CPU_FAN, METRIC_ID_INVALID, format_unit}},
+    {&gpu_name_label, {METRIC_GPU_NAME, METRIC_ID_INVALID, format_string}},
+    {&gpu_usage_label, {METRIC_GPU_USAGE, METRIC_ID_INVALID, format_unit}},
+    {&gpu_temp_label, {METRIC_GPU_TEMP, METRIC_ID_INVALID, format_unit}},
+    {&gpu_mem_label, {METRIC_GPU_MEM_USED, METRIC_GPU_MEM_TOTAL, format_ratio}},
+    {&mem_usage_label, {METRIC_MEM_USAGE, METRIC_ID_INVALID, format_unit}},
+    {&mem_info_label, {METRIC_MEM_USED, METRIC_MEM_TOTAL, format_used_of_total}},
+};
+
+/**
+ * @brief Sparkline bindings: percentage metrics appended to a chart per second
+ */
+static const struct
+{
+  lv_obj_t **chart;
+  metric_id_t id;
+} sparkline_bindings[] = {
+    {&cpu_sparkline, METRIC_CPU_USAGE},
+    {&gpu_sparkline, METRIC_GPU_USAGE},
+    {&mem_sparkline, METRIC_MEM_USAGE},
+};
+
+#define SPARKLINE_COUNT (sizeof(sparkline_bindings) / sizeof(sparkline_bindings[0]))
+
+static uint16_t sparkline_points[] = {SPARKLINE_POINTS, SPARKLINE_POINTS, SPARKLINE_POINTS};
+static uint32_t sparkline_next_s[] = {0, 0, 0}; ///< Next 1 s bucket to append, per sparkline
+
+_Static_assert(sizeof(sparkline_points) / sizeof(sparkline_points[0]) == SPARKLINE_COUNT,
+               "one window per sparkline");
+_Static_assert(sizeof(sparkline_next_s) / sizeof(sparkline_next_s[0]) == SPARKLINE_COUNT,
+               "one position per sparkline");
+
+/**
+ * @brief Append the 1 s history buckets [from_s, to_s] to a sparkline
+ * @note Buckets are contiguous, so seconds without samples arrive as gaps
+ */
+static void sparkline_append(size_t index, uint32_t from_s, uint32_t to_s)
+{
+  static metric_history_point_t history[SPARKLINE_FILL_CHUNK]; // LVGL task only
+  lv_obj_t *chart = *sparkline_bindings[index].chart;
+  lv_chart_series_t *series = lv_chart_get_series_next(chart, NULL);
+
+  for (uint32_t from = from_s; from <= to_s; from += SPARKLINE_FILL_CHUNK)
+  {
+    uint32_t to = to_s - from >= SPARKLINE_FILL_CHUNK ? from + SPARKLINE_FILL_CHUNK - 1 : to_s;
+    size_t count = metric_history_query(sparkline_bindings[index].id, METRIC_HISTORY_1S, from, to, history,
+                                        SPARKLINE_FILL_CHUNK);
+
+    for (size_t i = 0; i < count; i++)
     {
-      snprintf(combined_status, sizeof(combined_status), "[SERIAL] Waiting... | %s", time_str);
+      float value = history[i].avg;
+      lv_chart_set_next_value(chart, series, isnan(value) ? LV_CHART_POINT_NONE : (int32_t)value);
+      sparkline_next_s[index] = history[i].time + 1;
     }
-    lv_label_set_text(connection_status_label, combined_status);
   }
+}
 
-  // ─────────────────────────────────────────────────────────────────
-  // Update CPU Section
-  // ─────────────────────────────────────────────────────────────────
+/**
+ * @brief Append every 1 s bucket completed since the last call
+ * @note The bucket of the current second is still filling and waits for
+ *       the next call, so live points and a refill share one time base
+ */
+static void sparklines_advance(void)
+{
+  uint32_t now = metric_history_now();
+
+  if (now == 0)
+    return;
 
-  if (cpu_name_label)
+  for (size_t i = 0; i < SPARKLINE_COUNT; i++)
   {
-    lv_label_set_text(cpu_name_label, data->cpu.name);
+    uint32_t from = sparkline_next_s[i];
+
+    if (!*sparkline_bindings[i].chart)
+      continue;
+
+    // After a long pause only the newest window's worth is visible anyway
+    if (now - from > sparkline_points[i])
+      from = now - sparkline_points[i];
+    if (from < now)
+      sparkline_append(i, from, now - 1);
   }
+}
 
-  if (cpu_usage_label)
+/**
+ * @brief Attach the metric observers to the dashboard widgets
+ */
+static void bind_metrics(void)
+{
+  metric_subjects_init();
+
+  for (size_t i = 0; i < sizeof(label_bindings) / sizeof(label_bindings[0]); i++)
   {
-    char usage_str[16];
-    snprintf(usage_str, sizeof(usage_str), "%d%%", data->cpu.usage);
-    lv_label_set_text(cpu_usage_label, usage_str);
+    metric_subjects_bind_label(*label_bindings[i].label, &label_bindings[i].binding);
   }
 
-  if (cpu_temp_label)
+  metric_subjects_bind_bar(mem_usage_bar, METRIC_MEM_USAGE);
+}
+
+/**
+ * @brief Rewrite the serial status label from the tracked link state
+ * @note Called with the LVGL lock held; skips the write when nothing changed
+ */
+static void update_connection_label(void)
+{
+  static const char *const state_text[] = {
+      [SERIAL_LINK_WAITING] = "Waiting...",
+      [SERIAL_LINK_CONNECTED] = "Connected",
+      [SERIAL_LINK_LOST] = "Connection Lost",
+  };
+  static const uint32_t state_color[] = {
+      [SERIAL_LINK_WAITING] = 0xffaa00,   // Amber
+      [SERIAL_LINK_CONNECTED] = 0x00ff88, // Green
+      [SERIAL_LINK_LOST] = 0xff4444,      // Red
+  };
+  static serial_link_state_t shown_state = SERIAL_LINK_WAITING;
+
+  if (!connection_status_label)
+    return;
+
+  char combined_status[128];
+  snprintf(combined_status, sizeof(combined_status), "[SERIAL] %s | %s",
+           state_text[serial_link_state], last_sample_time);
+
+  if (strcmp(lv_label_get_text(connection_status_label), combined_status) != 0)
   {
-    char temp_str[16];
-    snprintf(temp_str, sizeof(temp_str), "%d°C", data->cpu.temp); // Shortened format
-    lv_label_set_text(cpu_temp_label, temp_str);
+    lv_label_set_text(connection_status_label, combined_status);
   }
 
-  if (cpu_fan_label)
+  if (shown_state != serial_link_state)
   {
-    char fan_str[16];
-    snprintf(fan_str, sizeof(fan_str), "%d", data->cpu.fan);
-    lv_label_set_text(cpu_fan_label, fan_str);
+    lv_obj_set_style_text_color(connection_status_label, lv_color_hex(state_color[serial_link_state]), 0);
+    shown_state = serial_link_state;
   }
+}
 
+/**
+ * @brief Update all system monitor display elements with new data
+ * @param frame Metric frame to display
+ * @note Runs in the LVGL task with the LVGL lock already held
+ */
+static void apply_metric_frame(const metric_frame_t *frame)
+{
   // ─────────────────────────────────────────────────────────────────
-  // Update GPU Section
+  // Update Timestamp and Connection Status
   // ─────────────────────────────────────────────────────────────────
 
-  if (gpu_name_label)
+  time_t timestamp_sec = frame->timestamp / 1000;
+  struct tm *timeinfo = localtime(&timestamp_sec);
+  strftime(last_sample_time, sizeof(last_sample_time), "Last: %H:%M:%S", timeinfo);
+  serial_link_state = SERIAL_LINK_CONNECTED;
+  update_connection_label();
+
+  // ─────────────────────────────────────────────────────────────────
+  // Update Bound Metrics (observers redraw only what changed)
+  // ─────────────────────────────────────────────────────────────────
+
+  metric_subjects_update(frame);
+
+  // Shift the seconds completed since the last frame into the sparklines
+  sparklines_advance();
+}
+
+/**
+ * @brief Render the latest published sample, if any (LVGL timer callback)
+ */
+static void ui_refresh_timer_cb(lv_timer_t *timer)
+{
+  static metric_frame_t frame; // LVGL task only; too large for the stack
+
+  apply_ui_messages();
+
+  if (!data_snapshot_consume(&frame))
+    return;
+
+  apply_metric_frame(&frame);
+
+  // Log less frequently to avoid blocking UI updates
+  data_snapshot_stats_t stats;
+  data_snapshot_get_stats(&stats);
+  if (stats.rendered % UI_STATS_LOG_INTERVAL == 0)
   {
-    lv_label_set_text(gpu_name_label, data->gpu.name);
+    ESP_LOGI(TAG, "UI updated - CPU: %.0f%%, GPU: %.0f%%, MEM: %.0f%%, %u metrics (samples: %lu received, %lu coalesced, %lu rendered)",
+             frame.values[METRIC_CPU_USAGE], frame.values[METRIC_GPU_USAGE], frame.values[METRIC_MEM_USAGE],
+             frame.count, stats.received, stats.coalesced, stats.rendered);
+
+    ui_queue_stats_t queue_stats;
+    ui_queue_get_stats(&queue_stats);
+    ESP_LOGI(TAG, "UI queue: %lu posted, %lu applied, %lu dropped, max depth %lu",
+             queue_stats.posted, queue_stats.drained, queue_stats.dropped, queue_stats.max_depth);
+
+    metric_subjects_stats_t binding_stats;
+    metric_subjects_get_stats(&binding_stats);
+    ESP_LOGI(TAG, "Bindings: %lu values changed, %lu labels rewritten, %lu unchanged",
+             binding_stats.notified, binding_stats.rewritten, binding_stats.unchanged);
+
+    if (sparkline_draw_count > 0)
+    {
+      ESP_LOGI(TAG, "Sparkline draw: %lu draws, avg %lu us, max %lu us",
+               sparkline_draw_count, sparkline_draw_total_us / sparkline_draw_count, sparkline_draw_max_us);
+      sparkline_draw_count = 0;
+      sparkline_draw_total_us = 0;
+      sparkline_draw_max_us = 0;
+    }
   }
+}
 
-  if (gpu_usage_label)
+/**
+ * @brief Publish a new metric frame for display
+ * @param frame Metric frame to display
+ * @note Never blocks or takes the LVGL lock; the LVGL task is woken to
+ *       render the latest sample and coalesces anything older
+ */
+void system_monitor_ui_update(const metric_frame_t *frame)
+{
+  if (!frame)
+    return;
+
+  data_snapshot_publish(frame);
+  lvgl_setup_wake();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// TOUCH GESTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define SPARKLINE_WINDOW_COUNT (sizeof(sparkline_windows) / sizeof(sparkline_windows[0]))
+
+static const uint16_t sparkline_windows[] = {30, 60, 120, 300, 600}; ///< Pinch zoom steps (1 s points)
+
+/**
+ * @brief Queue a gesture for the LVGL task
+ * @note Runs in the touch task
+ */
+static void on_gesture(const gesture_event_t *event)
+{
+  ui_msg_t msg = {.type = UI_MSG_GESTURE, .gesture = *event};
+  post_ui_message(&msg);
+}
+
+/**
+ * @brief Index of the sparkline whose panel contains a point
+ * @return Binding index, or -1 if the point is outside every sparkline panel
+ */
+static int sparkline_at(int32_t x, int32_t y)
+{
+  lv_point_t point = {x, y};
+
+  for (size_t i = 0; i < SPARKLINE_COUNT; i++)
   {
-    char usage_str[16];
-    snprintf(usage_str, sizeof(usage_str), "%d%%", data->gpu.usage);
-    lv_label_set_text(gpu_usage_label, usage_str);
+    lv_obj_t *chart = *sparkline_bindings[i].chart;
+    lv_area_t area;
+
+    if (!chart)
+      continue;
+
+    // The whole panel is the target; the chart itself is only 30 px tall
+    lv_obj_get_coords(lv_obj_get_parent(chart), &area);
+    if (lv_area_is_point_on(&area, &point, 0))
+      return (int)i;
   }
+  return -1;
+}
+
+/**
+ * @brief Show the newest points seconds of a metric in its sparkline
+ * @note Refills the chart from the completed 1 s buckets, oldest point
+ *       first; sparklines_advance() continues from where the refill ends
+ */
+static void sparkline_set_window(size_t index, uint16_t points)
+{
+  lv_obj_t *chart = *sparkline_bindings[index].chart;
+  uint32_t now = metric_history_now();
+
+  sparkline_points[index] = points;
+  sparkline_next_s[index] = now > points ? now - points : 0;
+  lv_chart_set_point_count(chart, points);
+  lv_chart_set_all_value(chart, lv_chart_get_series_next(chart, NULL), LV_CHART_POINT_NONE);
+
+  // Buckets are contiguous, so the points come back right-aligned in the chart
+  if (now > 0)
+    sparkline_append(index, sparkline_next_s[index], now - 1);
+}
+
+/**
+ * @brief Zoom steps for a pinch scale: one per doubling or halving, rounded
+ */
+static int pinch_steps(int32_t scale_q8)
+{
+  int steps = 0;
 
-  if (gpu_temp_label)
+  while (scale_q8 >= 362 && steps < (int)SPARKLINE_WINDOW_COUNT) // sqrt(2) in Q8.8
   {
-    char temp_str[16];
-    snprintf(temp_str, sizeof(temp_str), "%d°C", data->gpu.temp); // Shortened format
-    lv_label_set_text(gpu_temp_label, temp_str);
+    scale_q8 /= 2;
+    steps++;
   }
-
-  if (gpu_mem_label)
+  while (scale_q8 > 0 && scale_q8 <= 181 && steps > -(int)SPARKLINE_WINDOW_COUNT) // 1/sqrt(2)
   {
-    uint8_t mem_usage_pct = (data->gpu.mem_used * 100) / data->gpu.mem_total;
-    char mem_str[32];
-    snprintf(mem_str, sizeof(mem_str), "%d%%", mem_usage_pct);
-    lv_label_set_text(gpu_mem_label, mem_str);
+    scale_q8 *= 2;
+    steps--;
   }
+  return steps;
+}
 
-  // ─────────────────────────────────────────────────────────────────
-  // Update Memory Section
-  // ─────────────────────────────────────────────────────────────────
+/**
+ * @brief Pinch out to show fewer seconds, pinch in to show more
+ */
+static void apply_pinch(const gesture_event_t *gesture)
+{
+  static int target = -1;   // Sparkline being zoomed
+  static int base_step = 0; // Its window step when the pinch began
 
-  if (mem_usage_bar && mem_usage_label)
+  if (gesture->phase == GESTURE_PHASE_BEGIN)
   {
-    lv_bar_set_value(mem_usage_bar, data->mem.usage, LV_ANIM_OFF); // Disable animation for instant updates
-    char usage_str[16];
-    snprintf(usage_str, sizeof(usage_str), "%d%%", data->mem.usage);
-    lv_label_set_text(mem_usage_label, usage_str);
+    target = sparkline_at(gesture->x, gesture->y);
+    base_step = 0;
+    for (size_t i = 0; target >= 0 && i < SPARKLINE_WINDOW_COUNT; i++)
+    {
+      if (sparkline_windows[i] == sparkline_points[target])
+        base_step = (int)i;
+    }
   }
+  if (target < 0)
+    return;
+
+  int step = base_step - pinch_steps(gesture->scale_q8);
+  if (step < 0)
+    step = 0;
+  if (step >= (int)SPARKLINE_WINDOW_COUNT)
+    step = SPARKLINE_WINDOW_COUNT - 1;
+
+  if (sparkline_windows[step] != sparkline_points[target])
+    sparkline_set_window(target, sparkline_windows[step]);
 
-  if (mem_info_label)
+  if (gesture->phase == GESTURE_PHASE_END)
   {
-    char mem_str[32];
-    snprintf(mem_str, sizeof(mem_str), "(%.1f GB / %.1f GB)", // Updated format to match new compact layout
-             data->mem.used, data->mem.total);
-    lv_label_set_text(mem_info_label, mem_str);
+    ESP_LOGI(TAG, "Sparkline %d window: %u s", target, sparkline_points[target]);
+    target = -1;
   }
+}
 
-  // ─────────────────────────────────────────────────────────────────
-  // Release LVGL Mutex and Log Update
-  // ─────────────────────────────────────────────────────────────────
-
-  lvgl_lock_release();
+/**
+ * @brief Act on a recognized gesture
+ * @note Runs in the LVGL task with the LVGL lock already held
+ */
+static void apply_gesture(const gesture_event_t *gesture)
+{
+  static const char *const dir_names[] = {"left", "right", "up", "down"};
 
-  // Log less frequently to avoid blocking UI updates
-  static uint32_t log_counter = 0;
-  if (++log_counter % 10 == 0) // Log every 10th update
+  switch (gesture->type)
   {
-    ESP_LOGI(TAG, "UI updated - CPU: %d%%, GPU: %d%%, MEM: %d%%",
-             data->cpu.usage, data->gpu.usage, data->mem.usage);
+  case GESTURE_PINCH:
+    apply_pinch(gesture);
+    break;
+
+  case GESTURE_TWO_FINGER_TAP:
+    for (size_t i = 0; i < SPARKLINE_COUNT; i++)
+    {
+      if (*sparkline_bindings[i].chart && sparkline_points[i] != SPARKLINE_POINTS)
+        sparkline_set_window(i, SPARKLINE_POINTS);
+    }
+    ESP_LOGI(TAG, "Sparkline windows reset to %d s", SPARKLINE_POINTS);
+    break;
+
+  case GESTURE_SWIPE:
+    // Single-page dashboard: nothing to navigate to yet
+    ESP_LOGI(TAG, "Gesture: swipe %s from (%d,%d)", dir_names[gesture->dir], gesture->x, gesture->y);
+    break;
+
+  default:
+    ESP_LOGD(TAG, "Gesture: %s at (%d,%d)", gesture_type_name(gesture->type), gesture->x, gesture->y);
+    break;
   }
 }
 
@@ -813,6 +1307,20 @@ void system_monitor_ui_update(const system_data_t *data)
 // CONNECTION STATUS MANAGEMENT
 // ═══════════════════════════════════════════════════════════════════════════════
 
+/**
+ * @brief Queue a UI message for the LVGL task and wake it
+ * @note Never blocks; a full queue drops the message (counted in the UI statistics)
+ */
+static void post_ui_message(const ui_msg_t *msg)
+{
+  if (!ui_queue_post(msg))
+  {
+    ESP_LOGW(TAG, "UI queue full, message type %d dropped", msg->type);
+    return;
+  }
+  lvgl_setup_wake();
+}
+
 /**
  * @brief Update connection status indicator
  * @param connected True if connection is active, false if lost
@@ -823,46 +1331,22 @@ void system_monitor_ui_set_connection_status(bool connected)
   if (!connection_status_label)
     return;
 
-  lvgl_lock_acquire();
-
-  // Get current timestamp from the hidden timestamp label
-  const char *current_timestamp = "Last: Never";
-  if (timestamp_label)
-  {
-    current_timestamp = lv_label_get_text(timestamp_label);
-  }
-
-  char combined_status[128];
-  if (connected)
-  {
-    snprintf(combined_status, sizeof(combined_status), "[SERIAL] Connected | %s", current_timestamp);
-    lv_label_set_text(connection_status_label, combined_status);
-    lv_obj_set_style_text_color(connection_status_label, lv_color_hex(0x00ff88), 0); // Green
-  }
-  else
-  {
-    snprintf(combined_status, sizeof(combined_status), "[SERIAL] Connection Lost | %s", current_timestamp);
-    lv_label_set_text(connection_status_label, combined_status);
-    lv_obj_set_style_text_color(connection_status_label, lv_color_hex(0xff4444), 0); // Red
-  }
-
-  lvgl_lock_release();
+  ui_msg_t msg = {.type = UI_MSG_SERIAL_LINK, .flag = connected};
+  post_ui_message(&msg);
 }
 
 /**
  * @brief Update WiFi connection status in the status panel
  * @param status_text WiFi status message to display
  * @param connected True if WiFi is connected, false otherwise
+ * @note The text is formatted here, in the caller's task
  */
 void system_monitor_ui_update_wifi_status(const char *status_text, bool connected)
 {
   if (!wifi_status_label || !status_text)
     return;
 
-  lvgl_lock_acquire();
-
-  // Create formatted status message
-  char wifi_msg[128];
+  ui_msg_t msg = {.type = UI_MSG_WIFI_STATUS, .flag = connected};
 
   if (connected && strstr(status_text, "Connected:") != NULL)
   {
@@ -872,39 +1356,21 @@ void system_monitor_ui_update_wifi_status(const char *status_text, bool connecte
 
     if (ssid_end != NULL)
     {
-      // Extract SSID
-      size_t ssid_len = ssid_end - ssid_start;
-      char ssid[64];
-      strncpy(ssid, ssid_start, ssid_len);
-      ssid[ssid_len] = '\0';
-
-      snprintf(wifi_msg, sizeof(wifi_msg), "[WIFI:%s] Connected", ssid);
+      snprintf(msg.text, sizeof(msg.text), "[WIFI:%.*s] Connected", (int)(ssid_end - ssid_start), ssid_start);
     }
     else
     {
       // Fallback if format is unexpected
-      snprintf(wifi_msg, sizeof(wifi_msg), "[WIFI] %s", status_text);
+      snprintf(msg.text, sizeof(msg.text), "[WIFI] %s", status_text);
     }
   }
   else
   {
     // For non-connected states, use normal format
-    snprintf(wifi_msg, sizeof(wifi_msg), "[WIFI] %s", status_text);
+    snprintf(msg.text, sizeof(msg.text), "[WIFI] %s", status_text);
   }
 
-  lv_label_set_text(wifi_status_label, wifi_msg);
-
-  // Set color based on connection status
-  if (connected)
-  {
-    lv_obj_set_style_text_color(wifi_status_label, lv_color_hex(0x00ff88), 0); // Green
-  }
-  else
-  {
-    lv_obj_set_style_text_color(wifi_status_label, lv_color_hex(0xff4444), 0); // Red
-  }
-
-  lvgl_lock_release();
+  post_ui_message(&msg);
 }
 
 /**
@@ -917,31 +1383,110 @@ void system_monitor_ui_update_ha_status(const char *status_text, bool connected)
   if (!ha_status_label || !status_text)
     return;
 
-  lvgl_lock_acquire();
+  // Keep it short
+  ui_msg_t msg = {.type = UI_MSG_HA_STATUS, .flag = connected};
+  snprintf(msg.text, sizeof(msg.text), "HA: %s", status_text);
+  post_ui_message(&msg);
+}
 
-  // Create formatted status message (keep it short)
-  char ha_msg[32];
-  snprintf(ha_msg, sizeof(ha_msg), "HA: %s", status_text);
+/**
+ * @brief Set a status label's text and connected/disconnected color
+ * @note LVGL task only; unchanged text and color are not rewritten, so a
+ *       repeated status does not invalidate the label
+ */
+static void apply_status_label(lv_obj_t *label, const char *text, bool connected)
+{
+  lv_color_t color = lv_color_hex(connected ? 0x00ff88 : 0xff4444); // Green / red
 
-  lv_label_set_text(ha_status_label, ha_msg);
+  if (!label)
+    return;
 
-  // Set color based on connection status
-  if (connected)
+  if (strcmp(lv_label_get_text(label), text) != 0)
   {
-    lv_obj_set_style_text_color(ha_status_label, lv_color_hex(0x00ff88), 0); // Green
+    lv_label_set_text(label, text);
   }
-  else
+  if (!lv_color_eq(lv_obj_get_style_text_color(label, LV_PART_MAIN), color))
   {
-    lv_obj_set_style_text_color(ha_status_label, lv_color_hex(0xff4444), 0); // Red
+    lv_obj_set_style_text_color(label, color, 0);
   }
+}
+
+/**
+ * @brief Apply every queued UI message
+ * @note Runs in the LVGL task with the LVGL lock already held
+ */
+static void apply_ui_messages(void)
+{
+  lv_obj_t *const switches[] = {switch_a, switch_b, switch_c};
+  ui_msg_t msg;
 
-  lvgl_lock_release();
+  while (ui_queue_pop(&msg))
+  {
+    switch (msg.type)
+    {
+    case UI_MSG_SERIAL_LINK:
+      serial_link_state = msg.flag ? SERIAL_LINK_CONNECTED : SERIAL_LINK_LOST;
+      update_connection_label();
+      break;
+
+    case UI_MSG_WIFI_STATUS:
+      apply_status_label(wifi_status_label, msg.text, msg.flag);
+      break;
+
+    case UI_MSG_HA_STATUS:
+      apply_status_label(ha_status_label, msg.text, msg.flag);
+      break;
+
+    case UI_MSG_SWITCH:
+      if (msg.index < sizeof(switches) / sizeof(switches[0]) && switches[msg.index])
+      {
+        // Time pushed HA events that actually change the widget
+        if (msg.event_us && lv_obj_has_state(switches[msg.index], LV_STATE_CHECKED) != msg.flag)
+          render_profiler_mark_event(msg.event_us);
+
+        if (msg.flag)
+          lv_obj_add_state(switches[msg.index], LV_STATE_CHECKED);
+        else
+          lv_obj_clear_state(switches[msg.index], LV_STATE_CHECKED);
+        remember_switch_state(msg.index, msg.flag);
+      }
+      break;
+
+    case UI_MSG_GESTURE:
+      apply_gesture(&msg.gesture);
+      break;
+    }
+  }
 }
 
 // ═══════════════════════════════════════════════════════════════════════════════
 // SMART HOME CONTROL FUNCTIONS
 // ═══════════════════════════════════════════════════════════════════════════════
 
+static void remember_switch_state(uint8_t index, bool state)
+{
+  if (state)
+    atomic_fetch_or(&switch_states, 1u << index);
+  else
+    atomic_fetch_and(&switch_states, ~(1u << index));
+}
+
+static void post_switch_state(uint8_t index, bool state)
+{
+  ui_msg_t msg = {.type = UI_MSG_SWITCH, .index = index, .flag = state};
+  post_ui_message(&msg);
+}
+
+void system_monitor_ui_set_switch_from_event(uint8_t index, bool state, uint32_t event_us)
+{
+  lv_obj_t *const switches[] = {switch_a, switch_b, switch_c};
+  if (index >= sizeof(switches) / sizeof(switches[0]) || !switches[index])
+    return;
+
+  ui_msg_t msg = {.type = UI_MSG_SWITCH, .index = index, .flag = state, .event_us = event_us};
+  post_ui_message(&msg);
+}
+
 /**
  * @brief Set the state of switch A
  * @param state True to turn on, false to turn off
@@ -951,12 +1496,7 @@ void system_monitor_ui_set_switch_a(bool state)
   if (!switch_a)
     return;
 
-  lvgl_lock_acquire();
-  if (state)
-    lv_obj_add_state(switch_a, LV_STATE_CHECKED);
-  else
-    lv_obj_clear_state(switch_a, LV_STATE_CHECKED);
-  lvgl_lock_release();
+  post_switch_state(0, state);
 }
 
 /**
@@ -968,12 +1508,7 @@ void system_monitor_ui_set_switch_b(bool state)
   if (!switch_b)
     return;
 
-  lvgl_lock_acquire();
-  if (state)
-    lv_obj_add_state(switch_b, LV_STATE_CHECKED);
-  else
-    lv_obj_clear_state(switch_b, LV_STATE_CHECKED);
-  lvgl_lock_release();
+  post_switch_state(1, state);
 }
 
 /**
@@ -985,28 +1520,17 @@ void system_monitor_ui_set_switch_c(bool state)
   if (!switch_c)
     return;
 
-  lvgl_lock_acquire();
-  if (state)
-    lv_obj_add_state(switch_c, LV_STATE_CHECKED);
-  else
-    lv_obj_clear_state(switch_c, LV_STATE_CHECKED);
-  lvgl_lock_release();
+  post_switch_state(2, state);
 }
 
 /**
  * @brief Get the state of switch A
  * @return True if on, false if off
+ * @note Reads the last state shown or set by touch; no LVGL lock needed
  */
 bool system_monitor_ui_get_switch_a(void)
 {
-  if (!switch_a)
-    return false;
-
-  bool state = false;
-  lvgl_lock_acquire();
-  state = lv_obj_has_state(switch_a, LV_STATE_CHECKED);
-  lvgl_lock_release();
-  return state;
+  return atomic_load(&switch_states) & (1u << 0);
 }
 
 /**
@@ -1015,14 +1539,7 @@ bool system_monitor_ui_get_switch_a(void)
  */
 bool system_monitor_ui_get_switch_b(void)
 {
-  if (!switch_b)
-    return false;
-
-  bool state = false;
-  lvgl_lock_acquire();
-  state = lv_obj_has_state(switch_b, LV_STATE_CHECKED);
-  lvgl_lock_release();
-  return state;
+  return atomic_load(&switch_states) & (1u << 1);
 }
 
 /**
@@ -1031,12 +1548,5 @@ bool system_monitor_ui_get_switch_b(void)
  */
 bool system_monitor_ui_get_switch_c(void)
 {
-  if (!switch_c)
-    return false;
-
-  bool state = false;
-  lvgl_lock_acquire();
-  state = lv_obj_has_state(switch_c, LV_STATE_CHECKED);
-  lvgl_lock_release();
-  return state;
+  return atomic_load(&switch_states) & (1u << 2);
 }
@@ -16,56 +16,10 @@
 #pragma once
 
 #include "lvgl.h"
+#include "metric_registry.h"
 #include <stdbool.h>
 #include <stdint.h>
 
-// ═══════════════════════════════════════════════════════════════════════════════
-// DATA STRUCTURES
-// ═══════════════════════════════════════════════════════════════════════════════
-
-/**
- * @brief System monitoring data structure
- *
- * Contains all system metrics received via JSON from serial port:
- * - Timestamp for data freshness tracking
- * - CPU usage, temperature, and identification
- * - GPU usage, temperature, memory, and identification
- * - System memory usage and availability
- */
-typedef struct
-{
-  // Timestamp (milliseconds since epoch)
-  uint64_t timestamp;
-
-  // CPU Information Section
-  struct
-  {
-    uint8_t usage; ///< CPU usage percentage (0-100)
-    uint8_t temp;  ///< CPU temperature in Celsius
-    uint16_t fan;  ///< CPU fan speed in RPM
-    char name[32]; ///< CPU name/model string
-  } cpu;
-
-  // GPU Information Section
-  struct
-  {
-    uint8_t usage;      ///< GPU usage percentage (0-100)
-    uint8_t temp;       ///< GPU temperature in Celsius
-    char name[32];      ///< GPU name/model string
-    uint32_t mem_used;  ///< GPU memory used (MB)
-    uint32_t mem_total; ///< GPU memory total (MB)
-  } gpu;
-
-  // System Memory Information Section
-  struct
-  {
-    uint8_t usage; ///< Memory usage percentage (0-100)
-    float used;    ///< Memory used (GB)
-    float total;   ///< Memory total (GB)
-    float avail;   ///< Memory available (GB)
-  } mem;
-} system_data_t;
-
 // ═══════════════════════════════════════════════════════════════════════════════
 // PUBLIC FUNCTION PROTOTYPES
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -77,10 +31,15 @@ typedef struct
 void system_monitor_ui_create(lv_display_t *disp);
 
 /**
- * @brief Update system monitor display with new data
- * @param data System monitoring data
+ * @brief Update system monitor display with a new metric frame
+ * @param frame Metric frame (see metric_registry.h)
+ * @note Lock-free publish; the display picks up the latest sample once per
+ *       refresh period (counters: data_snapshot_get_stats())
  */
-void system_monitor_ui_update(const system_data_t *data);
+void system_monitor_ui_update(const metric_frame_t *frame);
+
+// Status and switch setters below may be called from any task: they queue a
+// message for the LVGL task (ui_queue.h) and return without taking the LVGL lock.
 
 /**
  * @brief Update connection status
@@ -124,6 +83,15 @@ void system_monitor_ui_set_switch_b(bool state);
  */
 void system_monitor_ui_set_switch_c(bool state);
 
+/**
+ * @brief Set a switch from a pushed Home Assistant event
+ * @param index Switch index (0 = A, 1 = B, 2 = C)
+ * @param state True to turn on, false to turn off
+ * @param event_us Low 32 bits of esp_timer_get_time() when the event arrived,
+ *        used for the event-to-flush latency (see render_profiler.h)
+ */
+void system_monitor_ui_set_switch_from_event(uint8_t index, bool state, uint32_t event_us);
+
 /**
  * @brief Get the state of switch A
  * @return True if on, false if off
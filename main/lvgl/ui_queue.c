@@ -0,0 +1,143 @@
+/**
+ * @file ui_queue.c
+ * @brief Bounded lock-free message queue into the LVGL task
+ *
+ * Dmitry Vyukov's bounded queue: every cell carries a sequence number.
+ * A cell at position pos is free for the producer that claims pos when
+ * seq == pos, and holds a message for the consumer when seq == pos + 1.
+ * Producers claim positions with a CAS on enqueue_pos, copy the message,
+ * then publish it with a release store of seq; the consumer hands the cell
+ * back by setting seq to pos + capacity. A producer preempted between the
+ * claim and the publish only delays the messages behind it.
+ *
+ * Cells store seq minus their index, so the zero-initialized array already
+ * means "cell i is free for position i" and no init call is needed.
+ */
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "ui_queue.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define UI_QUEUE_MASK (UI_QUEUE_CAPACITY - 1)
+
+_Static_assert((UI_QUEUE_CAPACITY & UI_QUEUE_MASK) == 0, "UI_QUEUE_CAPACITY must be a power of two");
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct
+{
+  atomic_uint seq; ///< Position this cell is ready for, minus the cell index
+  ui_msg_t msg;
+} ui_queue_cell_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATIC VARIABLES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static ui_queue_cell_t cells[UI_QUEUE_CAPACITY];
+static atomic_uint enqueue_pos = 0;
+static atomic_uint dequeue_pos = 0; ///< Written by the consumer only
+static atomic_uint stat_posted = 0;
+static atomic_uint stat_dropped = 0;
+static atomic_uint stat_max_depth = 0;
+static uint32_t stat_drained = 0; ///< Consumer only
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static uint32_t cell_seq(uint32_t pos)
+{
+  return atomic_load_explicit(&cells[pos & UI_QUEUE_MASK].seq, memory_order_acquire) + (pos & UI_QUEUE_MASK);
+}
+
+static void cell_set_seq(uint32_t pos, uint32_t seq)
+{
+  atomic_store_explicit(&cells[pos & UI_QUEUE_MASK].seq, seq - (pos & UI_QUEUE_MASK), memory_order_release);
+}
+
+static void note_depth(uint32_t pos)
+{
+  uint32_t depth = pos + 1 - atomic_load_explicit(&dequeue_pos, memory_order_relaxed);
+  uint32_t max = atomic_load_explicit(&stat_max_depth, memory_order_relaxed);
+
+  while (depth > max &&
+         !atomic_compare_exchange_weak_explicit(&stat_max_depth, &max, depth, memory_order_relaxed,
+                                                memory_order_relaxed))
+  {
+  }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+bool ui_queue_post(const ui_msg_t *msg)
+{
+  uint32_t pos = atomic_load_explicit(&enqueue_pos, memory_order_relaxed);
+
+  while (1)
+  {
+    int32_t diff = (int32_t)(cell_seq(pos) - pos);
+
+    if (diff == 0)
+    {
+      // Free cell: claim the position (on failure pos is reloaded)
+      if (atomic_compare_exchange_weak_explicit(&enqueue_pos, &pos, pos + 1, memory_order_relaxed,
+                                                memory_order_relaxed))
+        break;
+    }
+    else if (diff < 0)
+    {
+      // The consumer has not released this cell yet: the queue is full
+      atomic_fetch_add_explicit(&stat_dropped, 1, memory_order_relaxed);
+      return false;
+    }
+    else
+    {
+      // Another producer claimed this position first
+      pos = atomic_load_explicit(&enqueue_pos, memory_order_relaxed);
+    }
+  }
+
+  cells[pos & UI_QUEUE_MASK].msg = *msg;
+  cell_set_seq(pos, pos + 1);
+
+  atomic_fetch_add_explicit(&stat_posted, 1, memory_order_relaxed);
+  note_depth(pos);
+  return true;
+}
+
+bool ui_queue_pop(ui_msg_t *msg)
+{
+  uint32_t pos = atomic_load_explicit(&dequeue_pos, memory_order_relaxed);
+
+  // Empty, or the next producer has claimed the cell but not published yet
+  if ((int32_t)(cell_seq(pos) - (pos + 1)) < 0)
+    return false;
+
+  *msg = cells[pos & UI_QUEUE_MASK].msg;
+  atomic_store_explicit(&dequeue_pos, pos + 1, memory_order_relaxed);
+  cell_set_seq(pos, pos + UI_QUEUE_CAPACITY);
+  stat_drained++;
+  return true;
+}
+
+void ui_queue_get_stats(ui_queue_stats_t *stats)
+{
+  stats->posted = atomic_load(&stat_posted);
+  stats->dropped = atomic_load(&stat_dropped);
+  stats->drained = stat_drained;
+  stats->max_depth = atomic_load(&stat_max_depth);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file ui_queue.h
+ * @brief Bounded lock-free message queue into the LVGL task
+ *
+ * Tasks other than the LVGL task (serial, WiFi event loop, Home Assistant,
+ * touch) post typed UI messages here instead of taking the LVGL lock.
+ * Posting is a few atomic operations and never blocks on rendering; the LVGL task
+ * drains the queue before it renders. If the queue is full the message is
+ * dropped and counted.
+ *
+ * Multiple producers, one consumer (the LVGL task).
+ */
+
+#pragma once
+
+#include "gesture.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define UI_QUEUE_CAPACITY 32 ///< Messages in flight (power of two)
+#define UI_MSG_TEXT_LEN 48   ///< Longest status text, including terminator
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef enum
+{
+  UI_MSG_SERIAL_LINK = 0, ///< Serial link up/down (flag)
+  UI_MSG_WIFI_STATUS,     ///< WiFi status text and connected flag
+  UI_MSG_HA_STATUS,       ///< Home Assistant status text and connected flag
+  UI_MSG_SWITCH,          ///< Switch index and on/off state (flag), optional event_us
+  UI_MSG_GESTURE,         ///< Touch gesture (gesture)
+} ui_msg_type_t;
+
+/**
+ * @brief One UI update
+ */
+typedef struct
+{
+  ui_msg_type_t type;
+  bool flag;                   ///< Connected / on
+  uint8_t index;               ///< Switch index (UI_MSG_SWITCH)
+  char text[UI_MSG_TEXT_LEN];  ///< Status text, formatted by the producer
+  gesture_event_t gesture;     ///< Recognized gesture (UI_MSG_GESTURE)
+  uint32_t event_us;           ///< Arrival of the HA event behind a switch change (0 = none)
+} ui_msg_t;
+
+/**
+ * @brief Queue counters
+ */
+typedef struct
+{
+  uint32_t posted;    ///< Messages accepted
+  uint32_t dropped;   ///< Messages rejected because the queue was full
+  uint32_t drained;   ///< Messages taken by the LVGL task
+  uint32_t max_depth; ///< Highest number of queued messages seen by a producer
+} ui_queue_stats_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION PROTOTYPES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Queue a message
+ * @param msg Message to copy into the queue
+ * @return true if queued, false if the queue was full
+ * @note Safe from any task; never blocks
+ */
+bool ui_queue_post(const ui_msg_t *msg);
+
+/**
+ * @brief Take the oldest message
+ * @param msg Receives the message
+ * @return true if a message was taken, false if the queue is empty
+ * @note Single consumer: call from the LVGL task only
+ */
+bool ui_queue_pop(ui_msg_t *msg);
+
+/**
+ * @brief Read the queue counters
+ * @param stats Receives the counters
+ */
+void ui_queue_get_stats(ui_queue_stats_t *stats);
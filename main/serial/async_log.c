@@ -0,0 +1,855 @@
+/**
+ * @file async_log.c
+ * @brief Asynchronous ESP_LOG backend that keeps log traffic off the telemetry UART
+ *
+ * A record is a record_header_t followed either by the encoded arguments
+ * (fmt != NULL) or by the NUL-terminated formatted text (fmt == NULL).
+ * Arguments are encoded in format order, each in its own C type: the ints
+ * of '*' width/precision first, then the value. Strings are one mode byte
+ * followed by a pointer (mode 0, string in flash) or the characters and a
+ * NUL (mode 1).
+ *
+ * The level comes from the format itself: log v1 formats begin with an
+ * optional LOG_COLOR escape and the level letter, "E (%lu) %s: ...". The
+ * hook walks the format twice: once to size the record and find the tag,
+ * once to write the arguments straight into the space
+ * acquired in the ring, so no staging buffer is needed on the caller's
+ * stack. The drain task formats each conversion with its own snprintf call,
+ * which needs no va_list reconstruction.
+ */
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "async_log.h"
+
+#include "driver/usb_serial_jtag.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_memory_utils.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/ringbuf.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static const char *TAG = "async_log";
+
+#ifndef CONFIG_ASYNC_LOG_RING_SIZE
+#define CONFIG_ASYNC_LOG_RING_SIZE 32768
+#endif
+#ifndef CONFIG_ASYNC_LOG_TAG_RATE
+#define CONFIG_ASYNC_LOG_TAG_RATE 20
+#endif
+#ifndef CONFIG_ASYNC_LOG_TAG_BURST
+#define CONFIG_ASYNC_LOG_TAG_BURST 40
+#endif
+
+#define ASYNC_LOG_TASK_STACK_SIZE 4096
+#define ASYNC_LOG_TASK_PRIORITY 1      ///< Lowest application priority: logs never delay rendering or I/O
+#define ASYNC_LOG_LINE_MAX 512         ///< Longest formatted record
+#define ASYNC_LOG_STR_MAX 128          ///< Longest copied %s argument
+#define ASYNC_LOG_MAX_STRS 8           ///< Copied %s arguments per record
+#define ASYNC_LOG_SPEC_MAX 16          ///< Longest conversion specification
+#define ASYNC_LOG_TAG_SLOTS 32         ///< Tags with their own rate limit
+#define ASYNC_LOG_UART_IDLE_MS 20      ///< Telemetry silence before UART output resumes
+#define ASYNC_LOG_USB_TIMEOUT_MS 20    ///< USB write timeout (no host attached: drop)
+#define ASYNC_LOG_MEMORY_SIZE 65536    ///< Memory output ring (PSRAM)
+#define ASYNC_LOG_STATS_INTERVAL_MS 60000
+
+/**
+ * @brief Argument classes, each stored in its own C type
+ */
+typedef enum
+{
+  ARG_NONE = 0, ///< "%%"
+  ARG_INT,
+  ARG_LONG,
+  ARG_LLONG,
+  ARG_SIZE,
+  ARG_DOUBLE,
+  ARG_PTR,
+  ARG_STR,
+} arg_kind_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef struct
+{
+  const char *fmt;     ///< Format in flash, or NULL for a text record
+  uint16_t suppressed; ///< Records of the same tag rate-limited just before this one
+} record_header_t;
+
+typedef struct
+{
+  arg_kind_t kind;
+  uint8_t len;   ///< Characters from '%' through the conversion
+  uint8_t stars; ///< '*' width/precision arguments
+  char conv;     ///< Conversion character
+} log_spec_t;
+
+/**
+ * @brief What the sizing pass learned about a record
+ */
+typedef struct
+{
+  const char *tag;                     ///< First %s argument (the ESP_LOG tag)
+  uint8_t strs;                        ///< Copied strings
+  uint16_t str_len[ASYNC_LOG_MAX_STRS]; ///< Their lengths
+} record_meta_t;
+
+typedef struct
+{
+  const char *tag;
+  uint32_t tokens;     ///< Thousandths of a record
+  uint32_t last_ms;
+  uint16_t suppressed;
+} tag_bucket_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATIC VARIABLES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static RingbufHandle_t log_ring = NULL;
+static TaskHandle_t drain_task_handle = NULL;
+static atomic_int log_output = ASYNC_LOG_OUTPUT_UART_IDLE;
+static _Atomic uint32_t last_uart_rx_ms = 0;
+
+// Per-tag rate limit
+static tag_bucket_t tag_buckets[ASYNC_LOG_TAG_SLOTS];
+static portMUX_TYPE tag_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Memory output (drain task writes, async_log_dump reads)
+static SemaphoreHandle_t memory_lock = NULL;
+static char *memory_ring = NULL;
+static size_t memory_head = 0;
+static bool memory_wrapped = false;
+
+// Counters
+static _Atomic uint32_t stat_deferred = 0;
+static _Atomic uint32_t stat_text = 0;
+static _Atomic uint32_t stat_rate_limited = 0;
+static _Atomic uint32_t stat_dropped = 0;
+static uint32_t stat_written = 0; ///< Drain task only
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static uint32_t now_ms(void)
+{
+  return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+/**
+ * @brief Parse the conversion specification at p ('%')
+ * @return false for conversions the deferred path does not support
+ */
+static bool parse_spec(const char *p, log_spec_t *spec)
+{
+  const char *s = p + 1;
+  int longs = 0;
+  bool size = false;
+
+  spec->stars = 0;
+  if (*s == '%')
+  {
+    spec->kind = ARG_NONE;
+    spec->conv = '%';
+    spec->len = 2;
+    return true;
+  }
+
+  while (*s && strchr("-+ #0", *s))
+    s++;
+  if (*s == '*')
+  {
+    spec->stars++;
+    s++;
+  }
+  while (*s >= '0' && *s <= '9')
+    s++;
+  if (*s == '.')
+  {
+    s++;
+    if (*s == '*')
+    {
+      spec->stars++;
+      s++;
+    }
+    while (*s >= '0' && *s <= '9')
+      s++;
+  }
+
+  if (*s == 'h')
+  {
+    s += s[1] == 'h' ? 2 : 1;
+  }
+  else if (*s == 'l')
+  {
+    longs = s[1] == 'l' ? 2 : 1;
+    s += longs;
+  }
+  else if (*s == 'z')
+  {
+    size = true;
+    s++;
+  }
+
+  spec->conv = *s;
+  switch (*s)
+  {
+  case 'c':
+    if (longs || size)
+      return false; // Wide character
+    spec->kind = ARG_INT;
+    break;
+  case 'd':
+  case 'i':
+  case 'u':
+  case 'x':
+  case 'X':
+  case 'o':
+    spec->kind = size ? ARG_SIZE : longs == 2 ? ARG_LLONG : longs == 1 ? ARG_LONG : ARG_INT;
+    break;
+  case 'f':
+  case 'F':
+  case 'e':
+  case 'E':
+  case 'g':
+  case 'G':
+  case 'a':
+  case 'A':
+    spec->kind = ARG_DOUBLE;
+    break;
+  case 'p':
+    spec->kind = ARG_PTR;
+    break;
+  case 's':
+    if (longs)
+      return false; // Wide string
+    spec->kind = ARG_STR;
+    break;
+  default:
+    return false; // %n, %j, %t, %L and anything unknown
+  }
+
+  spec->len = (uint8_t)(s + 1 - p);
+  return s + 1 - p < ASYNC_LOG_SPEC_MAX;
+}
+
+#define PUT_ARG(value)                             \
+  do                                               \
+  {                                                \
+    if (out)                                       \
+      memcpy(out + len, &(value), sizeof(value));  \
+    len += sizeof(value);                          \
+  } while (0)
+
+/**
+ * @brief Size (out == NULL) or write the encoded arguments of a record
+ * @param fmt Format
+ * @param args Arguments (consumed)
+ * @param out Destination, or NULL to size the record and fill meta
+ * @param meta Filled when sizing, used when writing
+ * @return Encoded size, or -1 if the format needs the text path
+ */
+static int encode_args(const char *fmt, va_list args, uint8_t *out, record_meta_t *meta)
+{
+  size_t len = 0;
+  uint8_t strs = 0;
+  const char *p = fmt;
+
+  while ((p = strchr(p, '%')) != NULL)
+  {
+    log_spec_t spec;
+    if (!parse_spec(p, &spec))
+      return -1;
+    p += spec.len;
+
+    for (uint8_t i = 0; i < spec.stars; i++)
+    {
+      int star = va_arg(args, int);
+      PUT_ARG(star);
+    }
+
+    switch (spec.kind)
+    {
+    case ARG_NONE:
+      break;
+    case ARG_INT:
+    {
+      int value = va_arg(args, int);
+      PUT_ARG(value);
+      break;
+    }
+    case ARG_LONG:
+    {
+      long value = va_arg(args, long);
+      PUT_ARG(value);
+      break;
+    }
+    case ARG_LLONG:
+    {
+      long long value = va_arg(args, long long);
+      PUT_ARG(value);
+      break;
+    }
+    case ARG_SIZE:
+    {
+      size_t value = va_arg(args, size_t);
+      PUT_ARG(value);
+      break;
+    }
+    case ARG_DOUBLE:
+    {
+      double value = va_arg(args, double);
+      PUT_ARG(value);
+      break;
+    }
+    case ARG_PTR:
+    {
+      void *value = va_arg(args, void *);
+      PUT_ARG(value);
+      break;
+    }
+    case ARG_STR:
+    {
+      const char *value = va_arg(args, const char *);
+      if (!value)
+        value = "(null)";
+      if (!out && !meta->tag)
+        meta->tag = value;
+
+      uint8_t mode = esp_ptr_in_drom(value) ? 0 : 1;
+      PUT_ARG(mode);
+      if (mode == 0)
+      {
+        PUT_ARG(value);
+        break;
+      }
+
+      // Copied strings use the length measured in the sizing pass
+      if (!out)
+      {
+        if (strs >= ASYNC_LOG_MAX_STRS)
+          return -1;
+        meta->str_len[strs] = (uint16_t)strnlen(value, ASYNC_LOG_STR_MAX);
+      }
+      size_t str_len = meta->str_len[strs++];
+      if (out)
+      {
+        memcpy(out + len, value, str_len);
+        out[len + str_len] = '\0';
+      }
+      len += str_len + 1;
+      break;
+    }
+    }
+  }
+
+  if (!out)
+    meta->strs = strs;
+  return (int)len;
+}
+
+/**
+ * @brief Level letter of an ESP_LOG format
+ *
+ * Log v1 builds every format as LOG_COLOR_x "x (%lu) %s: " format, where
+ * the color is "\033[0;3Nm" (or "\033[0;3N;1m") when CONFIG_LOG_COLORS is
+ * set and empty otherwise.
+ *
+ * @return 'E', 'W', 'I', 'D' or 'V', or 0 for a format not built by ESP_LOG
+ */
+static char format_level(const char *fmt)
+{
+  if (fmt[0] == '\033' && fmt[1] == '[')
+  {
+    const char *m = strchr(fmt + 2, 'm');
+    if (!m)
+      return 0;
+    fmt = m + 1;
+  }
+
+  if (fmt[0] && strchr("EWIDV", fmt[0]) && fmt[1] == ' ' && fmt[2] == '(')
+    return fmt[0];
+  return 0;
+}
+
+/**
+ * @brief Take a token from the tag's bucket
+ * @param suppressed Receives the records of this tag rejected since it last passed
+ * @return true if the record may be logged
+ */
+static bool tag_admit(const char *tag, uint16_t *suppressed)
+{
+  uint32_t now = now_ms();
+  size_t slot = ((uintptr_t)tag >> 2) % ASYNC_LOG_TAG_SLOTS;
+  bool admit = true;
+
+  portENTER_CRITICAL(&tag_lock);
+  for (size_t probe = 0; probe < ASYNC_LOG_TAG_SLOTS; probe++)
+  {
+    tag_bucket_t *bucket = &tag_buckets[(slot + probe) % ASYNC_LOG_TAG_SLOTS];
+
+    if (!bucket->tag)
+    {
+      bucket->tag = tag;
+      bucket->tokens = CONFIG_ASYNC_LOG_TAG_BURST * 1000;
+      bucket->last_ms = now;
+    }
+    if (bucket->tag != tag)
+      continue;
+
+    uint32_t refill = (now - bucket->last_ms) * CONFIG_ASYNC_LOG_TAG_RATE;
+    bucket->last_ms = now;
+    bucket->tokens = bucket->tokens + refill < CONFIG_ASYNC_LOG_TAG_BURST * 1000
+                         ? bucket->tokens + refill
+                         : CONFIG_ASYNC_LOG_TAG_BURST * 1000;
+
+    if (bucket->tokens >= 1000)
+    {
+      bucket->tokens -= 1000;
+      *suppressed = bucket->suppressed;
+      bucket->suppressed = 0;
+    }
+    else
+    {
+      if (bucket->suppressed < UINT16_MAX)
+        bucket->suppressed++;
+      admit = false;
+    }
+    break;
+  }
+  portEXIT_CRITICAL(&tag_lock);
+
+  return admit; // Table full: tags without a bucket are not limited
+}
+
+/**
+ * @brief esp_log vprintf hook: store the record and return without formatting
+ */
+static int async_log_vprintf(const char *fmt, va_list args)
+{
+  record_header_t header = {.fmt = fmt};
+  record_meta_t meta = {0};
+  char level = format_level(fmt);
+  int args_len = -1;
+  va_list copy;
+
+  if (esp_ptr_in_drom(fmt))
+  {
+    va_copy(copy, args);
+    args_len = encode_args(fmt, copy, NULL, &meta);
+    va_end(copy);
+  }
+
+  // Errors and warnings always pass
+  if (meta.tag && level != 'E' && level != 'W' && !tag_admit(meta.tag, &header.suppressed))
+  {
+    atomic_fetch_add_explicit(&stat_rate_limited, 1, memory_order_relaxed);
+    return 0;
+  }
+
+  size_t payload;
+  if (args_len >= 0)
+  {
+    payload = (size_t)args_len;
+  }
+  else
+  {
+    header.fmt = NULL;
+    va_copy(copy, args);
+    int text_len = vsnprintf(NULL, 0, fmt, copy);
+    va_end(copy);
+    if (text_len < 0)
+      return 0;
+    payload = (text_len < ASYNC_LOG_LINE_MAX ? (size_t)text_len : ASYNC_LOG_LINE_MAX - 1) + 1;
+  }
+
+  uint8_t *item = NULL;
+  if (xRingbufferSendAcquire(log_ring, (void **)&item, sizeof(header) + payload, 0) != pdTRUE)
+  {
+    atomic_fetch_add_explicit(&stat_dropped, 1, memory_order_relaxed);
+    return 0;
+  }
+
+  memcpy(item, &header, sizeof(header));
+  if (header.fmt)
+  {
+    va_copy(copy, args);
+    encode_args(fmt, copy, item + sizeof(header), &meta);
+    va_end(copy);
+    atomic_fetch_add_explicit(&stat_deferred, 1, memory_order_relaxed);
+  }
+  else
+  {
+    va_copy(copy, args);
+    vsnprintf((char *)item + sizeof(header), payload, fmt, copy);
+    va_end(copy);
+    atomic_fetch_add_explicit(&stat_text, 1, memory_order_relaxed);
+  }
+  xRingbufferSendComplete(log_ring, item);
+
+  return 0;
+}
+
+#define FORMAT_ARG(value)                                                                                  \
+  (spec.stars == 0   ? snprintf(out + n, size - n, spec_buf, value)                                        \
+   : spec.stars == 1 ? snprintf(out + n, size - n, spec_buf, star[0], value)                               \
+                     : snprintf(out + n, size - n, spec_buf, star[0], star[1], value))
+
+#define TAKE_ARG(type, var) \
+  type var;                 \
+  memcpy(&var, args, sizeof(var)); \
+  args += sizeof(var)
+
+/**
+ * @brief Format a deferred record
+ * @return Length of the formatted text
+ */
+static size_t format_deferred(const char *fmt, const uint8_t *args, char *out, size_t size)
+{
+  size_t n = 0;
+  const char *p = fmt;
+
+  while (*p && n + 1 < size)
+  {
+    if (*p != '%')
+    {
+      out[n++] = *p++;
+      continue;
+    }
+
+    // The hook only defers formats whose every conversion parses
+    log_spec_t spec;
+    parse_spec(p, &spec);
+    char spec_buf[ASYNC_LOG_SPEC_MAX];
+    memcpy(spec_buf, p, spec.len);
+    spec_buf[spec.len] = '\0';
+    p += spec.len;
+
+    int star[2] = {0, 0};
+    for (uint8_t i = 0; i < spec.stars; i++)
+    {
+      memcpy(&star[i], args, sizeof(int));
+      args += sizeof(int);
+    }
+
+    int written = 0;
+    switch (spec.kind)
+    {
+    case ARG_NONE:
+      out[n++] = '%';
+      break;
+    case ARG_INT:
+    {
+      TAKE_ARG(int, value);
+      written = FORMAT_ARG(value);
+      break;
+    }
+    case ARG_LONG:
+    {
+      TAKE_ARG(long, value);
+      written = FORMAT_ARG(value);
+      break;
+    }
+    case ARG_LLONG:
+    {
+      TAKE_ARG(long long, value);
+      written = FORMAT_ARG(value);
+      break;
+    }
+    case ARG_SIZE:
+    {
+      TAKE_ARG(size_t, value);
+      written = FORMAT_ARG(value);
+      break;
+    }
+    case ARG_DOUBLE:
+    {
+      TAKE_ARG(double, value);
+      written = FORMAT_ARG(value);
+      break;
+    }
+    case ARG_PTR:
+    {
+      TAKE_ARG(void *, value);
+      written = FORMAT_ARG(value);
+      break;
+    }
+    case ARG_STR:
+    {
+      const char *value;
+      if (*args++ == 0)
+      {
+        memcpy(&value, args, sizeof(value));
+        args += sizeof(value);
+      }
+      else
+      {
+        value = (const char *)args;
+        args += strlen(value) + 1;
+      }
+      written = FORMAT_ARG(value);
+      break;
+    }
+    }
+
+    if (written > 0)
+      n += (size_t)written < size - n ? (size_t)written : size - n - 1;
+  }
+
+  out[n] = '\0';
+  return n;
+}
+
+static void memory_write(const char *text, size_t len)
+{
+  if (!memory_ring)
+  {
+    memory_ring = heap_caps_malloc(ASYNC_LOG_MEMORY_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!memory_ring)
+      return;
+  }
+
+  xSemaphoreTake(memory_lock, portMAX_DELAY);
+  for (size_t i = 0; i < len; i++)
+  {
+    memory_ring[memory_head++] = text[i];
+    if (memory_head == ASYNC_LOG_MEMORY_SIZE)
+    {
+      memory_head = 0;
+      memory_wrapped = true;
+    }
+  }
+  xSemaphoreGive(memory_lock);
+}
+
+/**
+ * @brief Write formatted text to the current output
+ */
+static void output_write(const char *text, size_t len)
+{
+  switch (atomic_load(&log_output))
+  {
+  case ASYNC_LOG_OUTPUT_USB_JTAG:
+    usb_serial_jtag_write_bytes(text, len, pdMS_TO_TICKS(ASYNC_LOG_USB_TIMEOUT_MS));
+    break;
+
+  case ASYNC_LOG_OUTPUT_MEMORY:
+    memory_write(text, len);
+    break;
+
+  case ASYNC_LOG_OUTPUT_UART_IDLE:
+    // Hold the record (the ring absorbs new ones) until telemetry pauses
+    while (atomic_load(&log_output) == ASYNC_LOG_OUTPUT_UART_IDLE &&
+           now_ms() - atomic_load(&last_uart_rx_ms) < ASYNC_LOG_UART_IDLE_MS)
+    {
+      vTaskDelay(pdMS_TO_TICKS(ASYNC_LOG_UART_IDLE_MS));
+    }
+    fwrite(text, 1, len, stdout);
+    fflush(stdout);
+    break;
+  }
+}
+
+static void output_printf(const char *fmt, ...)
+{
+  char line[96];
+  va_list args;
+
+  va_start(args, fmt);
+  int len = vsnprintf(line, sizeof(line), fmt, args);
+  va_end(args);
+
+  if (len > 0)
+    output_write(line, (size_t)len < sizeof(line) ? (size_t)len : sizeof(line) - 1);
+}
+
+static void drain_task(void *arg)
+{
+  static char line[ASYNC_LOG_LINE_MAX]; // Drain task only
+  uint32_t reported_dropped = 0;
+  uint32_t stats_start = now_ms();
+
+  while (1)
+  {
+    size_t size;
+    uint8_t *item = xRingbufferReceive(log_ring, &size, pdMS_TO_TICKS(ASYNC_LOG_STATS_INTERVAL_MS));
+
+    uint32_t dropped = atomic_load(&stat_dropped);
+    if (dropped != reported_dropped)
+    {
+      output_printf("async_log: %lu records dropped, log ring full\n", dropped - reported_dropped);
+      reported_dropped = dropped;
+    }
+
+    if (item)
+    {
+      record_header_t header;
+      memcpy(&header, item, sizeof(header));
+
+      if (header.suppressed)
+        output_printf("async_log: %u earlier records of the next tag rate-limited\n", header.suppressed);
+
+      if (header.fmt)
+      {
+        size_t len = format_deferred(header.fmt, item + sizeof(header), line, sizeof(line));
+        output_write(line, len);
+      }
+      else
+      {
+        const char *text = (const char *)item + sizeof(header);
+        output_write(text, strlen(text));
+      }
+      vRingbufferReturnItem(log_ring, item);
+      stat_written++;
+    }
+
+    if (now_ms() - stats_start >= ASYNC_LOG_STATS_INTERVAL_MS)
+    {
+      stats_start = now_ms();
+      ESP_LOGI(TAG, "Records: %lu deferred, %lu text, %lu written, %lu rate-limited, %lu dropped",
+               atomic_load(&stat_deferred), atomic_load(&stat_text), stat_written,
+               atomic_load(&stat_rate_limited), atomic_load(&stat_dropped));
+    }
+  }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t async_log_init(void)
+{
+#ifdef CONFIG_ASYNC_LOG_ENABLE
+  if (log_ring)
+  {
+    return ESP_OK;
+  }
+
+  memory_lock = xSemaphoreCreateMutex();
+  log_ring = xRingbufferCreateWithCaps(CONFIG_ASYNC_LOG_RING_SIZE, RINGBUF_TYPE_NOSPLIT, MALLOC_CAP_SPIRAM);
+  if (!memory_lock || !log_ring)
+  {
+    ESP_LOGE(TAG, "No memory for the %d byte log ring", CONFIG_ASYNC_LOG_RING_SIZE);
+    return ESP_ERR_NO_MEM;
+  }
+
+#if CONFIG_ASYNC_LOG_OUTPUT_USB_JTAG
+  async_log_set_output(ASYNC_LOG_OUTPUT_USB_JTAG);
+#elif CONFIG_ASYNC_LOG_OUTPUT_MEMORY
+  async_log_set_output(ASYNC_LOG_OUTPUT_MEMORY);
+#else
+  async_log_set_output(ASYNC_LOG_OUTPUT_UART_IDLE);
+#endif
+
+  BaseType_t result = xTaskCreatePinnedToCore(drain_task, "async_log", ASYNC_LOG_TASK_STACK_SIZE, NULL,
+                                              ASYNC_LOG_TASK_PRIORITY, &drain_task_handle, 0);
+  if (result != pdPASS)
+  {
+    ESP_LOGE(TAG, "Failed to create log drain task");
+    return ESP_ERR_NO_MEM;
+  }
+
+  esp_log_set_vprintf(async_log_vprintf);
+  ESP_LOGI(TAG, "Asynchronous logging: %d byte ring, %d records/s per tag (burst %d)",
+           CONFIG_ASYNC_LOG_RING_SIZE, CONFIG_ASYNC_LOG_TAG_RATE, CONFIG_ASYNC_LOG_TAG_BURST);
+#endif
+  return ESP_OK;
+}
+
+void async_log_set_output(async_log_output_t output)
+{
+  if (output == ASYNC_LOG_OUTPUT_USB_JTAG && !usb_serial_jtag_is_driver_installed())
+  {
+    usb_serial_jtag_driver_config_t config = USB_SERIAL_JTAG_DRIVER_CONFIG_DEFAULT();
+    if (usb_serial_jtag_driver_install(&config) != ESP_OK)
+    {
+      ESP_LOGW(TAG, "USB-Serial-JTAG driver unavailable, keeping the current log output");
+      return;
+    }
+  }
+  atomic_store(&log_output, output);
+}
+
+void async_log_note_uart_rx(void)
+{
+  atomic_store_explicit(&last_uart_rx_ms, now_ms(), memory_order_relaxed);
+}
+
+esp_err_t async_log_dump(void)
+{
+  if (!memory_lock || !memory_ring)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  xSemaphoreTake(memory_lock, portMAX_DELAY);
+  printf("LOG dump begin\n");
+  if (memory_wrapped)
+  {
+    // Oldest data first; the line cut by the wrap is skipped
+    const char *start = memchr(memory_ring + memory_head, '\n', ASYNC_LOG_MEMORY_SIZE - memory_head);
+    if (start)
+      fwrite(start + 1, 1, memory_ring + ASYNC_LOG_MEMORY_SIZE - start - 1, stdout);
+  }
+  fwrite(memory_ring, 1, memory_head, stdout);
+  printf("LOG dump end\n");
+  fflush(stdout);
+  xSemaphoreGive(memory_lock);
+
+  return ESP_OK;
+}
+
+esp_err_t async_log_command(const char *line)
+{
+  char cmd[8] = {0};
+  char arg[8] = {0};
+
+  if (sscanf(line, "LOG %7s %7s", cmd, arg) < 1)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (strcmp(cmd, "dump") == 0)
+  {
+    return async_log_dump();
+  }
+  if (strcmp(cmd, "output") == 0)
+  {
+    if (strcmp(arg, "usb") == 0)
+      async_log_set_output(ASYNC_LOG_OUTPUT_USB_JTAG);
+    else if (strcmp(arg, "memory") == 0)
+      async_log_set_output(ASYNC_LOG_OUTPUT_MEMORY);
+    else if (strcmp(arg, "uart") == 0)
+      async_log_set_output(ASYNC_LOG_OUTPUT_UART_IDLE);
+    else
+      return ESP_ERR_INVALID_ARG;
+    return ESP_OK;
+  }
+  return ESP_ERR_INVALID_ARG;
+}
+
+void async_log_get_stats(async_log_stats_t *stats)
+{
+  stats->deferred = atomic_load(&stat_deferred);
+  stats->text = atomic_load(&stat_text);
+  stats->rate_limited = atomic_load(&stat_rate_limited);
+  stats->dropped = atomic_load(&stat_dropped);
+  stats->written = stat_written;
+}
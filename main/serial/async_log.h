@@ -0,0 +1,103 @@
+/**
+ * @file async_log.h
+ * @brief Asynchronous ESP_LOG backend that keeps log traffic off the telemetry UART
+ *
+ * Installed with esp_log_set_vprintf(), the hook does not format anything.
+ * It stores the format pointer and the raw argument values as a binary
+ * record in a PSRAM ring buffer and returns. A low-priority drain task
+ * formats the records later and writes them to the selected output:
+ *
+ *   - USB-Serial-JTAG, leaving UART0 to telemetry entirely
+ *   - memory: a PSRAM text ring, printed on request (async_log_dump)
+ *   - UART0, but only while no telemetry has arrived for a short while
+ *
+ * Deferring the formatting needs the format string to outlive the call.
+ * This holds for ESP_LOG formats, which live in flash. Formats elsewhere
+ * in memory are formatted at once into a text record. %s arguments in
+ * flash are kept as pointers; other strings are copied.
+ *
+ * Info, debug and verbose records are rate-limited per tag with a token
+ * bucket. Errors and warnings always pass. A full ring drops the record.
+ * Both losses are counted and reported in the output.
+ *
+ * Bootloader, early and panic logs bypass the hook and go to UART0 as
+ * before.
+ */
+
+#pragma once
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "esp_err.h"
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Where the drain task writes formatted logs
+ */
+typedef enum
+{
+  ASYNC_LOG_OUTPUT_USB_JTAG = 0, ///< USB-Serial-JTAG console
+  ASYNC_LOG_OUTPUT_MEMORY,       ///< PSRAM text ring, see async_log_dump()
+  ASYNC_LOG_OUTPUT_UART_IDLE,    ///< UART0 while telemetry is idle
+} async_log_output_t;
+
+/**
+ * @brief Logger counters
+ */
+typedef struct
+{
+  uint32_t deferred;     ///< Records stored as format pointer plus arguments
+  uint32_t text;         ///< Records formatted at once (format not in flash)
+  uint32_t rate_limited; ///< Records dropped by the per-tag rate limit
+  uint32_t dropped;      ///< Records dropped because the ring was full
+  uint32_t written;      ///< Records written to the output
+} async_log_stats_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION PROTOTYPES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Create the ring and the drain task and install the log hook
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the ring or task cannot be created
+ * @note Call first thing in app_main; logs before it go to UART0 directly
+ */
+esp_err_t async_log_init(void);
+
+/**
+ * @brief Switch the output
+ * @param output New output; takes effect with the next record
+ */
+void async_log_set_output(async_log_output_t output);
+
+/**
+ * @brief Note telemetry activity on UART0
+ * @note Call from the serial task whenever bytes arrive; UART output waits
+ *       for ASYNC_LOG_UART_IDLE_MS of silence
+ */
+void async_log_note_uart_rx(void);
+
+/**
+ * @brief Print the memory output ring to stdout between "LOG dump begin/end" lines
+ * @return ESP_OK, or ESP_ERR_INVALID_STATE if nothing was logged to memory
+ */
+esp_err_t async_log_dump(void);
+
+/**
+ * @brief Run a log command received over serial
+ * @param line "LOG dump" or "LOG output usb|memory|uart"
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for unknown commands
+ */
+esp_err_t async_log_command(const char *line);
+
+/**
+ * @brief Read the logger counters
+ * @param stats Receives the counters
+ */
+void async_log_get_stats(async_log_stats_t *stats);
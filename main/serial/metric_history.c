@@ -0,0 +1,336 @@
+/**
+ * @file metric_history.c
+ * @brief Fixed-memory multi-resolution metric history in PSRAM
+ *
+ * Every resolution of a series is a ring of finalized buckets plus one
+ * accumulator for the bucket currently being filled. A sample updates the
+ * three accumulators; when it lands in a later bucket the accumulator is
+ * pushed into the ring first, followed by NAN buckets for any skipped
+ * periods. The invariant "accumulator start == newest bucket start + period"
+ * keeps the whole ring contiguous in time.
+ */
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "metric_history.h"
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <math.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static const char *TAG = "metric_history";
+
+#ifndef METRIC_HISTORY_MAX_SERIES
+#define METRIC_HISTORY_MAX_SERIES 64 ///< Metrics with history (~33 KB PSRAM each)
+#endif
+
+/**
+ * @brief Bucket period and ring length per resolution
+ */
+static const struct
+{
+  uint16_t period_s;
+  uint16_t capacity;
+} resolutions[METRIC_HISTORY_RES_COUNT] = {
+    [METRIC_HISTORY_1S] = {1, 600},
+    [METRIC_HISTORY_10S] = {10, 720},
+    [METRIC_HISTORY_1M] = {60, 1440},
+};
+
+#define SERIES_BUCKETS (600 + 720 + 1440) ///< Sum of all ring capacities
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Finalized bucket
+ */
+typedef struct
+{
+  float min;
+  float max;
+  float avg;
+} history_bucket_t;
+
+/**
+ * @brief One resolution of one metric
+ */
+typedef struct
+{
+  history_bucket_t *ring; ///< Finalized buckets
+  uint16_t head;          ///< Next write position
+  uint16_t count;         ///< Finalized buckets stored
+  uint32_t acc_start;     ///< Start of the bucket being filled
+  float acc_min;          ///< Running minimum
+  float acc_max;          ///< Running maximum
+  float acc_sum;          ///< Running sum
+  uint16_t acc_samples;   ///< Samples in the bucket being filled (0 = none yet)
+} history_level_t;
+
+/**
+ * @brief All resolutions of one metric, allocated as a single PSRAM block
+ */
+typedef struct
+{
+  history_level_t levels[METRIC_HISTORY_RES_COUNT];
+  history_bucket_t buckets[SERIES_BUCKETS];
+} history_series_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATIC VARIABLES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static history_series_t *series[METRIC_MAX]; ///< Lazily allocated, by metric ID
+static uint16_t series_count = 0;            ///< Series allocated so far
+static bool series_limit_logged = false;     ///< Warn once when the cap is hit
+static SemaphoreHandle_t history_mutex = NULL;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static history_series_t *get_or_create_series(metric_id_t id)
+{
+  if (series[id])
+  {
+    return series[id];
+  }
+
+  if (series_count >= METRIC_HISTORY_MAX_SERIES)
+  {
+    if (!series_limit_logged)
+    {
+      ESP_LOGW(TAG, "History limit of %d metrics reached, %s is not recorded",
+               METRIC_HISTORY_MAX_SERIES, metric_registry_get(id)->path);
+      series_limit_logged = true;
+    }
+    return NULL;
+  }
+
+  history_series_t *s = heap_caps_calloc(1, sizeof(history_series_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!s)
+  {
+    return NULL;
+  }
+
+  history_bucket_t *ring = s->buckets;
+  for (int r = 0; r < METRIC_HISTORY_RES_COUNT; r++)
+  {
+    s->levels[r].ring = ring;
+    ring += resolutions[r].capacity;
+  }
+
+  series[id] = s;
+  series_count++;
+  ESP_LOGI(TAG, "History for %s allocated (%u bytes, %u series)",
+           metric_registry_get(id)->path, (unsigned)sizeof(history_series_t), series_count);
+  return s;
+}
+
+static void push_bucket(history_level_t *level, uint16_t capacity, float min, float max, float avg)
+{
+  history_bucket_t *bucket = &level->ring[level->head];
+  bucket->min = min;
+  bucket->max = max;
+  bucket->avg = avg;
+
+  level->head = (level->head + 1) % capacity;
+  if (level->count < capacity)
+  {
+    level->count++;
+  }
+}
+
+/**
+ * @brief Fold one sample into a level, finalizing buckets as time advances
+ */
+static void level_add(history_level_t *level, metric_history_res_t res, float value, uint32_t now_s)
+{
+  uint32_t period = resolutions[res].period_s;
+  uint16_t capacity = resolutions[res].capacity;
+  uint32_t start = now_s - now_s % period;
+
+  if (level->acc_samples > 0 && start > level->acc_start)
+  {
+    push_bucket(level, capacity, level->acc_min, level->acc_max, level->acc_sum / level->acc_samples);
+
+    // Periods without samples become NAN buckets so the ring stays contiguous
+    uint32_t gap = (start - level->acc_start) / period - 1;
+    if (gap > capacity)
+    {
+      gap = capacity;
+    }
+    while (gap--)
+    {
+      push_bucket(level, capacity, NAN, NAN, NAN);
+    }
+    level->acc_samples = 0;
+  }
+
+  if (level->acc_samples == 0)
+  {
+    level->acc_start = start;
+    level->acc_min = value;
+    level->acc_max = value;
+    level->acc_sum = value;
+    level->acc_samples = 1;
+    return;
+  }
+
+  // Samples that arrive late (start < acc_start) are folded into the current bucket
+  if (value < level->acc_min)
+    level->acc_min = value;
+  if (value > level->acc_max)
+    level->acc_max = value;
+  level->acc_sum += value;
+  if (level->acc_samples < UINT16_MAX)
+    level->acc_samples++;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t metric_history_init(void)
+{
+  if (history_mutex)
+  {
+    return ESP_OK;
+  }
+
+  history_mutex = xSemaphoreCreateMutex();
+  if (!history_mutex)
+  {
+    return ESP_ERR_NO_MEM;
+  }
+
+  ESP_LOGI(TAG, "History store ready: 1s x %u, 10s x %u, 1m x %u per metric",
+           resolutions[METRIC_HISTORY_1S].capacity, resolutions[METRIC_HISTORY_10S].capacity,
+           resolutions[METRIC_HISTORY_1M].capacity);
+  return ESP_OK;
+}
+
+uint32_t metric_history_now(void)
+{
+  return (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+void metric_history_record(const metric_frame_t *frame, uint32_t now_s)
+{
+  if (!history_mutex)
+  {
+    return;
+  }
+
+  xSemaphoreTake(history_mutex, portMAX_DELAY);
+
+  for (metric_id_t id = 0; id < frame->count; id++)
+  {
+    const metric_desc_t *desc = metric_registry_get(id);
+    float value = frame->values[id];
+
+    // Values the record did not carry are the previous sample, not a new one
+    if (!desc || desc->type != METRIC_TYPE_NUMBER || isnan(value) || !metric_frame_is_updated(frame, id))
+    {
+      continue;
+    }
+
+    history_series_t *s = get_or_create_series(id);
+    if (!s)
+    {
+      continue;
+    }
+
+    for (int r = 0; r < METRIC_HISTORY_RES_COUNT; r++)
+    {
+      level_add(&s->levels[r], (metric_history_res_t)r, value, now_s);
+    }
+  }
+
+  xSemaphoreGive(history_mutex);
+}
+
+size_t metric_history_query(metric_id_t id, metric_history_res_t res, uint32_t from_s, uint32_t to_s,
+                            metric_history_point_t *out, size_t max_points)
+{
+  size_t written = 0;
+
+  if (!history_mutex || id >= METRIC_MAX || res >= METRIC_HISTORY_RES_COUNT ||
+      !out || max_points == 0 || from_s > to_s)
+  {
+    return 0;
+  }
+
+  xSemaphoreTake(history_mutex, portMAX_DELAY);
+
+  history_series_t *s = series[id];
+  if (s && s->levels[res].acc_samples > 0)
+  {
+    const history_level_t *level = &s->levels[res];
+    uint32_t period = resolutions[res].period_s;
+    uint16_t capacity = resolutions[res].capacity;
+
+    // Virtual timeline: count finalized buckets followed by the accumulator
+    uint32_t total = level->count + 1;
+    uint32_t first_start = level->acc_start - level->count * period;
+
+    if (to_s >= first_start)
+    {
+      uint32_t lo = from_s > first_start ? (from_s - first_start) / period : 0;
+      uint32_t hi = (to_s - first_start) / period;
+      if (hi >= total)
+      {
+        hi = total - 1;
+      }
+      if (lo <= hi && hi - lo + 1 > max_points)
+      {
+        lo = hi + 1 - max_points;
+      }
+
+      for (uint32_t k = lo; k <= hi && lo <= hi; k++)
+      {
+        metric_history_point_t *p = &out[written++];
+        p->time = first_start + k * period;
+
+        if (k == total - 1)
+        {
+          p->min = level->acc_min;
+          p->max = level->acc_max;
+          p->avg = level->acc_sum / level->acc_samples;
+        }
+        else
+        {
+          const history_bucket_t *b = &level->ring[(level->head + capacity - level->count + k) % capacity];
+          p->min = b->min;
+          p->max = b->max;
+          p->avg = b->avg;
+        }
+      }
+    }
+  }
+
+  xSemaphoreGive(history_mutex);
+  return written;
+}
+
+size_t metric_history_latest(metric_id_t id, metric_history_res_t res,
+                             metric_history_point_t *out, size_t max_points)
+{
+  return metric_history_query(id, res, 0, UINT32_MAX, out, max_points);
+}
+
+uint32_t metric_history_period(metric_history_res_t res)
+{
+  return res < METRIC_HISTORY_RES_COUNT ? resolutions[res].period_s : 0;
+}
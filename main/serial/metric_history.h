@@ -0,0 +1,112 @@
+/**
+ * @file metric_history.h
+ * @brief Fixed-memory multi-resolution metric history in PSRAM
+ *
+ * Each numeric metric gets one ring per resolution:
+ *
+ *   METRIC_HISTORY_1S    1 s buckets,   600 points  (10 minutes)
+ *   METRIC_HISTORY_10S   10 s buckets,  720 points  (2 hours)
+ *   METRIC_HISTORY_1M    60 s buckets, 1440 points  (24 hours)
+ *
+ * A bucket keeps min/max/avg of every sample that fell into it; the
+ * aggregates are updated incrementally on insert, so raw samples are never
+ * stored. Buckets are contiguous in time (periods without samples are NAN),
+ * which makes a range query plain index arithmetic: O(points returned).
+ *
+ * Rings are allocated lazily in PSRAM the first time a metric has a value,
+ * ~33 KB per metric, capped at METRIC_HISTORY_MAX_SERIES metrics.
+ */
+
+#pragma once
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "esp_err.h"
+#include "metric_registry.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief History resolution
+ */
+typedef enum
+{
+  METRIC_HISTORY_1S = 0, ///< 1 s buckets for 10 minutes
+  METRIC_HISTORY_10S,    ///< 10 s buckets for 2 hours
+  METRIC_HISTORY_1M,     ///< 1 min buckets for 24 hours
+  METRIC_HISTORY_RES_COUNT
+} metric_history_res_t;
+
+/**
+ * @brief One aggregated history point
+ */
+typedef struct
+{
+  uint32_t time; ///< Bucket start, seconds on the metric_history_now() clock
+  float min;     ///< Smallest sample in the bucket (NAN if none)
+  float max;     ///< Largest sample in the bucket (NAN if none)
+  float avg;     ///< Mean of the samples in the bucket (NAN if none)
+} metric_history_point_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION PROTOTYPES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Initialize the history store
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the lock cannot be created
+ */
+esp_err_t metric_history_init(void);
+
+/**
+ * @brief Monotonic clock used for history timestamps
+ * @return Seconds since boot
+ */
+uint32_t metric_history_now(void);
+
+/**
+ * @brief Add one sample of every numeric metric the frame's record updated
+ * @param frame Current metric values (NAN values and values not marked
+ *              updated are skipped)
+ * @param now_s Sample time from metric_history_now()
+ * @note Called by the serial task after each accepted record
+ */
+void metric_history_record(const metric_frame_t *frame, uint32_t now_s);
+
+/**
+ * @brief Read the points covering [from_s, to_s] in chronological order
+ * @param id Metric to read
+ * @param res Resolution to read from
+ * @param from_s First second of interest
+ * @param to_s Last second of interest
+ * @param out Receives the points
+ * @param max_points Capacity of out; when the range holds more points the
+ *                   newest max_points are returned
+ * @return Number of points written (the bucket still being filled is
+ *         included as the last point)
+ */
+size_t metric_history_query(metric_id_t id, metric_history_res_t res, uint32_t from_s, uint32_t to_s,
+                            metric_history_point_t *out, size_t max_points);
+
+/**
+ * @brief Read the newest points of a metric in chronological order
+ * @param id Metric to read
+ * @param res Resolution to read from
+ * @param out Receives the points
+ * @param max_points Number of points wanted
+ * @return Number of points written
+ */
+size_t metric_history_latest(metric_id_t id, metric_history_res_t res,
+                             metric_history_point_t *out, size_t max_points);
+
+/**
+ * @brief Bucket period of a resolution
+ * @return Period in seconds
+ */
+uint32_t metric_history_period(metric_history_res_t res);
@@ -0,0 +1,245 @@
+/**
+ * @file metric_registry.c
+ * @brief Schema-driven metric registry
+ *
+ * Open-addressed hash table (linear probing) from path hash to metric ID.
+ * The table is twice the registry size, so probes stay short. A hash match
+ * is confirmed against the stored path; two paths with the same hash are
+ * simply two entries on the same probe chain. Descriptors
+ * are appended only; the count is published with release ordering after
+ * the descriptor is complete, which makes readers on other tasks safe.
+ */
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "metric_registry.h"
+
+#include "esp_log.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static const char *TAG = "metric_registry";
+
+#define HASH_TABLE_SIZE (METRIC_MAX * 2) ///< Power of two, at most half full
+
+/**
+ * @brief Built-in metric paths, in metric ID order
+ */
+static const struct
+{
+  const char *path;
+  metric_type_t type;
+} builtin_metrics[METRIC_BUILTIN_COUNT] = {
+    [METRIC_CPU_USAGE] = {"cpu.usage", METRIC_TYPE_NUMBER},
+    [METRIC_CPU_TEMP] = {"cpu.temp", METRIC_TYPE_NUMBER},
+    [METRIC_CPU_FAN] = {"cpu.fan", METRIC_TYPE_NUMBER},
+    [METRIC_CPU_NAME] = {"cpu.name", METRIC_TYPE_STRING},
+    [METRIC_GPU_USAGE] = {"gpu.usage", METRIC_TYPE_NUMBER},
+    [METRIC_GPU_TEMP] = {"gpu.temp", METRIC_TYPE_NUMBER},
+    [METRIC_GPU_NAME] = {"gpu.name", METRIC_TYPE_STRING},
+    [METRIC_GPU_MEM_USED] = {"gpu.mem_used", METRIC_TYPE_NUMBER},
+    [METRIC_GPU_MEM_TOTAL] = {"gpu.mem_total", METRIC_TYPE_NUMBER},
+    [METRIC_MEM_USAGE] = {"mem.usage", METRIC_TYPE_NUMBER},
+    [METRIC_MEM_USED] = {"mem.used", METRIC_TYPE_NUMBER},
+    [METRIC_MEM_TOTAL] = {"mem.total", METRIC_TYPE_NUMBER},
+    [METRIC_MEM_AVAIL] = {"mem.avail", METRIC_TYPE_NUMBER},
+};
+
+/**
+ * @brief Leaf key to unit mapping used when registering
+ */
+static const struct
+{
+  const char *leaf;
+  metric_unit_t unit;
+} unit_rules[] = {
+    {"usage", METRIC_UNIT_PERCENT},
+    {"load", METRIC_UNIT_PERCENT},
+    {"util", METRIC_UNIT_PERCENT},
+    {"cores", METRIC_UNIT_PERCENT},
+    {"temp", METRIC_UNIT_CELSIUS},
+    {"fan", METRIC_UNIT_RPM},
+    {"rpm", METRIC_UNIT_RPM},
+    {"mem_used", METRIC_UNIT_MB},
+    {"mem_total", METRIC_UNIT_MB},
+    {"used", METRIC_UNIT_GB},
+    {"total", METRIC_UNIT_GB},
+    {"avail", METRIC_UNIT_GB},
+    {"free", METRIC_UNIT_GB},
+};
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STATIC VARIABLES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static metric_desc_t metrics[METRIC_MAX];    ///< Descriptors by ID
+static uint16_t hash_table[HASH_TABLE_SIZE]; ///< Hash -> ID + 1 (0 = empty)
+static atomic_ushort metric_count = 0;       ///< Published descriptor count
+static uint8_t string_count = 0;             ///< String slots in use
+static uint32_t rejected_count = 0;          ///< Paths that could not be registered
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Infer the unit from the last path segment
+ */
+static metric_unit_t infer_unit(const char *path)
+{
+  const char *leaf = strrchr(path, '.');
+  leaf = leaf ? leaf + 1 : path;
+
+  // Array elements ("cpu.cores.3") inherit the unit of the array key
+  if (*leaf >= '0' && *leaf <= '9' && leaf != path)
+  {
+    const char *end = leaf - 1;
+    const char *start = end;
+    while (start > path && start[-1] != '.')
+      start--;
+
+    for (size_t i = 0; i < sizeof(unit_rules) / sizeof(unit_rules[0]); i++)
+    {
+      size_t len = strlen(unit_rules[i].leaf);
+      if ((size_t)(end - start) >= len && strncmp(start, unit_rules[i].leaf, len) == 0)
+        return unit_rules[i].unit;
+    }
+    return METRIC_UNIT_NONE;
+  }
+
+  for (size_t i = 0; i < sizeof(unit_rules) / sizeof(unit_rules[0]); i++)
+  {
+    if (strcmp(leaf, unit_rules[i].leaf) == 0)
+      return unit_rules[i].unit;
+  }
+  return METRIC_UNIT_NONE;
+}
+
+static metric_id_t register_metric(const char *path, size_t path_len, uint32_t hash, metric_type_t type)
+{
+  uint16_t count = atomic_load_explicit(&metric_count, memory_order_relaxed);
+
+  if (!metric_registry_can_register(type) || path_len >= METRIC_PATH_LEN)
+  {
+    if (rejected_count++ % 10 == 0)
+    {
+      ESP_LOGW(TAG, "Cannot register metric %.*s (total rejected: %lu)", (int)path_len, path, rejected_count);
+    }
+    return METRIC_ID_INVALID;
+  }
+
+  metric_desc_t *desc = &metrics[count];
+  memcpy(desc->path, path, path_len);
+  desc->path[path_len] = '\0';
+  desc->hash = hash;
+  desc->path_len = (uint8_t)path_len;
+  desc->type = type;
+  desc->unit = infer_unit(desc->path);
+  desc->slot = (type == METRIC_TYPE_STRING) ? string_count++ : 0;
+
+  uint32_t idx = hash & (HASH_TABLE_SIZE - 1);
+  while (hash_table[idx] != 0)
+  {
+    idx = (idx + 1) & (HASH_TABLE_SIZE - 1);
+  }
+  hash_table[idx] = count + 1;
+
+  atomic_store_explicit(&metric_count, count + 1, memory_order_release);
+
+  ESP_LOGI(TAG, "Registered metric %u: %s", count, desc->path);
+  return count;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t metric_registry_init(void)
+{
+  if (atomic_load(&metric_count) != 0)
+  {
+    return ESP_OK;
+  }
+
+  for (int i = 0; i < METRIC_BUILTIN_COUNT; i++)
+  {
+    const char *path = builtin_metrics[i].path;
+    size_t len = strlen(path);
+    uint32_t hash = metric_hash_extend(METRIC_HASH_INIT, path, len);
+
+    if (register_metric(path, len, hash, builtin_metrics[i].type) != (metric_id_t)i)
+    {
+      return ESP_FAIL;
+    }
+  }
+  return ESP_OK;
+}
+
+metric_id_t metric_registry_lookup(const char *path, size_t path_len, uint32_t hash)
+{
+  uint32_t idx = hash & (HASH_TABLE_SIZE - 1);
+
+  while (hash_table[idx] != 0)
+  {
+    metric_id_t id = hash_table[idx] - 1;
+    const metric_desc_t *desc = &metrics[id];
+    if (desc->hash == hash && desc->path_len == path_len && memcmp(desc->path, path, path_len) == 0)
+    {
+      return id;
+    }
+    idx = (idx + 1) & (HASH_TABLE_SIZE - 1);
+  }
+  return METRIC_ID_INVALID;
+}
+
+metric_id_t metric_registry_resolve(const char *path, size_t path_len, uint32_t hash, metric_type_t type)
+{
+  metric_id_t id = metric_registry_lookup(path, path_len, hash);
+
+  if (id == METRIC_ID_INVALID)
+  {
+    return register_metric(path, path_len, hash, type);
+  }
+  return metrics[id].type == type ? id : METRIC_ID_INVALID;
+}
+
+const metric_desc_t *metric_registry_get(metric_id_t id)
+{
+  return id < atomic_load_explicit(&metric_count, memory_order_acquire) ? &metrics[id] : NULL;
+}
+
+uint16_t metric_registry_count(void)
+{
+  return atomic_load_explicit(&metric_count, memory_order_acquire);
+}
+
+bool metric_registry_can_register(metric_type_t type)
+{
+  return atomic_load_explicit(&metric_count, memory_order_relaxed) < METRIC_MAX &&
+         (type != METRIC_TYPE_STRING || string_count < METRIC_STRING_SLOTS);
+}
+
+void metric_frame_init(metric_frame_t *frame)
+{
+  frame->timestamp = 0;
+  frame->count = metric_registry_count();
+  for (int i = 0; i < METRIC_MAX; i++)
+  {
+    frame->values[i] = NAN;
+  }
+  memset(frame->strings, 0, sizeof(frame->strings));
+  memset(frame->updated, 0, sizeof(frame->updated));
+}
+
+const char *metric_frame_string(const metric_frame_t *frame, metric_id_t id)
+{
+  const metric_desc_t *desc = metric_registry_get(id);
+  return (desc && desc->type == METRIC_TYPE_STRING) ? frame->strings[desc->slot] : "";
+}
@@ -0,0 +1,212 @@
+/**
+ * @file metric_registry.h
+ * @brief Schema-driven metric registry
+ *
+ * Every telemetry value is a metric with a compact numeric ID, a type and a
+ * unit. Metrics are identified by their dotted JSON path ("cpu.usage",
+ * "cpu.cores.3", "gpu.1.temp", ...). A path is resolved to an ID once, the
+ * first time it is seen; afterwards lookups are a hash-table probe on the
+ * path's FNV-1a hash, which the parser computes while scanning, confirmed
+ * by comparing the stored path so colliding paths stay distinct. Values live
+ * in a flat array indexed by ID, so the sender can add per-core CPU, extra
+ * GPUs, disks or NICs without firmware changes.
+ *
+ * The registry is written by the serial task only. Descriptors below
+ * metric_registry_count() are immutable and may be read from any task.
+ */
+
+#pragma once
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define METRIC_MAX 128           ///< Maximum number of registered metrics
+#define METRIC_PATH_LEN 32       ///< Longest dotted path, including terminator
+#define METRIC_STRING_SLOTS 8    ///< Maximum number of string metrics
+#define METRIC_STRING_LEN 32     ///< String metric capacity, including terminator
+#define METRIC_ID_INVALID 0xFFFF ///< Returned when a path cannot be resolved
+#define METRIC_UPDATED_WORDS ((METRIC_MAX + 31) / 32) ///< Words in metric_frame_t.updated
+
+#define METRIC_HASH_INIT 0x811C9DC5U  ///< FNV-1a 32-bit offset basis
+#define METRIC_HASH_PRIME 0x01000193U ///< FNV-1a 32-bit prime
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef uint16_t metric_id_t;
+
+/**
+ * @brief Metric value type
+ */
+typedef enum
+{
+  METRIC_TYPE_NUMBER = 0, ///< Stored in metric_frame_t.values
+  METRIC_TYPE_STRING,     ///< Stored in metric_frame_t.strings
+} metric_type_t;
+
+/**
+ * @brief Metric unit, inferred from the leaf key at registration
+ */
+typedef enum
+{
+  METRIC_UNIT_NONE = 0,
+  METRIC_UNIT_PERCENT, ///< "usage", "load", "util", "cores"
+  METRIC_UNIT_CELSIUS, ///< "temp"
+  METRIC_UNIT_RPM,     ///< "fan", "rpm"
+  METRIC_UNIT_MB,      ///< "mem_used", "mem_total"
+  METRIC_UNIT_GB,      ///< "used", "total", "avail", "free"
+} metric_unit_t;
+
+/**
+ * @brief Built-in metrics, always registered with these IDs
+ */
+enum
+{
+  METRIC_CPU_USAGE = 0,
+  METRIC_CPU_TEMP,
+  METRIC_CPU_FAN,
+  METRIC_CPU_NAME,
+  METRIC_GPU_USAGE,
+  METRIC_GPU_TEMP,
+  METRIC_GPU_NAME,
+  METRIC_GPU_MEM_USED,
+  METRIC_GPU_MEM_TOTAL,
+  METRIC_MEM_USAGE,
+  METRIC_MEM_USED,
+  METRIC_MEM_TOTAL,
+  METRIC_MEM_AVAIL,
+  METRIC_BUILTIN_COUNT
+};
+
+/**
+ * @brief Metric descriptor
+ */
+typedef struct
+{
+  char path[METRIC_PATH_LEN]; ///< Dotted JSON path
+  uint32_t hash;              ///< FNV-1a hash of path
+  uint8_t path_len;           ///< strlen(path)
+  uint8_t type;               ///< metric_type_t
+  uint8_t unit;               ///< metric_unit_t
+  uint8_t slot;               ///< String slot for METRIC_TYPE_STRING
+} metric_desc_t;
+
+/**
+ * @brief One complete sample of every registered metric
+ *
+ * Numbers that were never received are NAN. Values a record does not
+ * carry keep their previous value; updated tells them apart from the ones
+ * the last record actually wrote.
+ */
+typedef struct
+{
+  uint64_t timestamp;                                   ///< Milliseconds since epoch
+  uint16_t count;                                       ///< Registered metrics when sampled
+  float values[METRIC_MAX];                             ///< Numeric values by metric ID
+  char strings[METRIC_STRING_SLOTS][METRIC_STRING_LEN]; ///< String values by slot
+  uint32_t updated[METRIC_UPDATED_WORDS];               ///< Bit per metric ID written by the last record
+} metric_frame_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// INLINE HELPERS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Continue an FNV-1a hash over more bytes
+ */
+static inline uint32_t metric_hash_extend(uint32_t hash, const char *s, size_t len)
+{
+  for (size_t i = 0; i < len; i++)
+  {
+    hash = (hash ^ (uint8_t)s[i]) * METRIC_HASH_PRIME;
+  }
+  return hash;
+}
+
+/**
+ * @brief Note that the record being decoded wrote a metric
+ */
+static inline void metric_frame_mark_updated(metric_frame_t *frame, metric_id_t id)
+{
+  frame->updated[id / 32] |= 1U << (id % 32);
+}
+
+/**
+ * @brief Check whether the last record wrote a metric
+ */
+static inline bool metric_frame_is_updated(const metric_frame_t *frame, metric_id_t id)
+{
+  return id < METRIC_MAX && (frame->updated[id / 32] & (1U << (id % 32))) != 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION PROTOTYPES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Register the built-in metrics (idempotent)
+ * @return ESP_OK on success
+ */
+esp_err_t metric_registry_init(void);
+
+/**
+ * @brief Resolve a path to an ID, registering the path on first use
+ * @param path Dotted path
+ * @param path_len Path length in bytes
+ * @param hash FNV-1a hash of the path
+ * @param type Value type seen in the payload
+ * @return Metric ID, or METRIC_ID_INVALID if the registry is full, the path
+ *         is too long, or the type conflicts with the registered one
+ */
+metric_id_t metric_registry_resolve(const char *path, size_t path_len, uint32_t hash, metric_type_t type);
+
+/**
+ * @brief Look up an already registered path
+ * @param path Dotted path
+ * @param path_len Path length in bytes
+ * @param hash FNV-1a hash of the path
+ * @return Metric ID, or METRIC_ID_INVALID if unknown
+ */
+metric_id_t metric_registry_lookup(const char *path, size_t path_len, uint32_t hash);
+
+/**
+ * @brief Get a metric descriptor
+ * @return Descriptor, or NULL if id is not registered
+ */
+const metric_desc_t *metric_registry_get(metric_id_t id);
+
+/**
+ * @brief Number of registered metrics
+ */
+uint16_t metric_registry_count(void);
+
+/**
+ * @brief Check whether one more metric of a type can be registered
+ * @param type Value type of the new metric
+ * @return false once the registry, or for strings the string slots, are full
+ * @note Serial task only, like metric_registry_resolve()
+ */
+bool metric_registry_can_register(metric_type_t type);
+
+/**
+ * @brief Reset a frame to "nothing received"
+ * @param frame Frame to initialize
+ */
+void metric_frame_init(metric_frame_t *frame);
+
+/**
+ * @brief Get a string metric from a frame
+ * @return The string, or "" if id is not a registered string metric
+ */
+const char *metric_frame_string(const metric_frame_t *frame, metric_id_t id);
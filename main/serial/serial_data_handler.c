@@ -5,9 +5,17 @@
  * Provides UART communication and JSON parsing functionality for real-time
  * system monitoring data. Handles connection timeout detection and data
  * validation for reliable operation.
- *      }
-
-      // Prevent buffer overflow32 System Monitor
+ *
+ * Reception is event driven: the UART driver raises a pattern-detect event
+ * for every '\n', and the task drains the driver buffer straight into a
+ * PSRAM ring (see serial_line_framer.h) from which complete lines are parsed.
+ * Each record is auto-detected as either a JSON line or a binary frame
+ * (see telemetry_frame.h), so senders can switch formats at any time.
+ * Text lines starting with "TTRACE " are touch trace commands (see
+ * gt911_trace_command()), lines starting with "LOG " are log output
+ * commands (see async_log_command()) and lines starting with "DRAW " switch
+ * parallel rendering (see draw_units_command()) rather than telemetry.
+ *
  * @version 1.0
  * @date 2024
  */
@@ -18,16 +26,22 @@
 
 #include "serial_data_handler.h"
 
-#include "cjson.h"
+#include "async_log.h"
+#include "draw_units.h"
 #include "driver/uart.h"
 #include "esp_log.h"
 #include "esp_heap_caps.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "freertos/task.h"
+#include "gt911_touch.h"
+#include "metric_history.h"
+#include "metric_registry.h"
+#include "serial_line_framer.h"
 #include "system_monitor_ui.h"
+#include "telemetry_frame.h"
+#include "telemetry_parser.h"
 #include <string.h>
-#include <time.h>
 
 // ═══════════════════════════════════════════════════════════════════════════════
 // CONSTANTS AND CONFIGURATION
@@ -47,6 +61,14 @@ static const char *TAG = "serial_data";
 // Buffer Management
 #define BUF_SIZE 2048         ///< UART receive buffer size
 #define JSON_BUFFER_SIZE 1024 ///< JSON parsing buffer size
+#define RING_BUFFER_SIZE 4096 ///< Line framer ring size (power of two, PSRAM)
+
+// Event Queue Configuration
+#define UART_EVENT_QUEUE_LEN 20     ///< UART driver event queue depth
+#define UART_PATTERN_QUEUE_LEN 20   ///< Pending pattern positions tracked by the driver
+#define UART_LINE_DELIMITER '\n'    ///< Pattern that terminates a telemetry line
+#define UART_EVENT_WAIT_MS 500      ///< Max block time, bounds connection timeout latency
+#define STATS_LOG_INTERVAL_MS 60000 ///< Interval between ingest statistics logs
 
 // Task Configuration
 #define SERIAL_TASK_STACK_SIZE 8192 ///< Task stack size in bytes (reduced for memory optimization)
@@ -65,34 +87,56 @@ static StaticTask_t serial_task_tcb;          ///< Task control block
 static StackType_t *serial_task_stack = NULL; ///< Task stack allocated from SPIRAM
 static uint32_t connection_timeout_ms = 5000; ///< Connection timeout (5 seconds)
 
+// Event-driven ingest
+static QueueHandle_t uart_event_queue = NULL; ///< UART driver event queue
+static serial_line_framer_t line_framer;      ///< PSRAM ring line framer
+static uint32_t uart_wakeups = 0;             ///< Task wakeups caused by UART events
+static uint32_t uart_overruns = 0;            ///< FIFO / driver buffer overflows
+static uint32_t frame_errors = 0;             ///< Binary frames rejected (COBS / CRC / version)
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // PRIVATE FUNCTION PROTOTYPES
 // ═══════════════════════════════════════════════════════════════════════════════
 
 /**
- * @brief Parse JSON string and extract system monitoring data
- * @param json_str Input JSON string to parse
- * @param data Output system data structure
- * @return true if parsing successful, false otherwise
+ * @brief Hand an accepted sample to the UI and the history store
+ * @param frame Metric frame that was just updated
  */
-static bool parse_json_data(const char *json_str, system_data_t *data);
+static void publish_frame(const metric_frame_t *frame);
 
 /**
  * @brief Process a complete line of received data
  * @param line_buffer The line buffer containing the data
- * @param system_data System data structure to update
+ * @param line_len Length of the line in bytes
+ * @param frame Metric frame to update
+ */
+static void process_received_line(const char *line_buffer, size_t line_len, metric_frame_t *frame);
+
+/**
+ * @brief Decode a binary telemetry frame and update the UI
+ * @param frame COBS-encoded record without delimiters
+ * @param frame_len Record length in bytes
+ * @param metrics Metric frame to update
+ */
+static void process_binary_frame(const uint8_t *frame, size_t frame_len, metric_frame_t *metrics);
+
+/**
+ * @brief Drain the UART driver buffer into the framer and process complete lines
+ * @param frame Metric frame to update
+ * @return Number of bytes read from the driver
  */
-static void process_received_line(const char *line_buffer, system_data_t *system_data);
+static size_t drain_uart(metric_frame_t *frame);
 
 /**
- * @brief Add a byte to the line buffer and handle line completion
- * @param byte The byte to add
- * @param line_buffer The line buffer
- * @param line_pos Pointer to the current line position
- * @param system_data System data structure to update
- * @return true if a complete line was processed, false otherwise
+ * @brief Discard all buffered input after a FIFO or driver buffer overflow
  */
-static bool handle_incoming_byte(uint8_t byte, char *line_buffer, int *line_pos, system_data_t *system_data);
+static void recover_from_overflow(void);
+
+/**
+ * @brief Periodically log ingest statistics
+ * @param current_time Current timestamp
+ */
+static void log_ingest_stats(uint32_t current_time);
 
 /**
  * @brief Check for connection timeout and update UI status
@@ -103,151 +147,73 @@ static void check_connection_timeout(uint32_t current_time);
 // ═══════════════════════════════════════════════════════════════════════════════
 // PRIVATE FUNCTION IMPLEMENTATIONS
 // ═══════════════════════════════════════════════════════════════════════════════
-static bool parse_json_data(const char *json_str, system_data_t *data)
+/**
+ * @brief Hand an accepted sample to the UI and the history store
+ */
+static void publish_frame(const metric_frame_t *frame)
 {
-  cJSON *json = cJSON_Parse(json_str);
-  if (json == NULL)
-  {
-    ESP_LOGW(TAG, "Invalid JSON format");
-    return false;
-  }
+  system_monitor_ui_update(frame);
+  metric_history_record(frame, metric_history_now());
+}
 
-  // ─────────────────────────────────────────────────────────────────
-  // Parse Timestamp
-  // ─────────────────────────────────────────────────────────────────
+/**
+ * @brief Process a complete line of received data
+ */
+static void process_received_line(const char *line_buffer, size_t line_len, metric_frame_t *frame)
+{
+  // Skip empty lines
+  if (line_len < 5)
+    return;
 
-  cJSON *ts = cJSON_GetObjectItem(json, "ts");
-  if (cJSON_IsNumber(ts))
-  {
-    data->timestamp = (uint64_t)cJSON_GetNumberValue(ts);
-  }
-  else
-  {
-    data->timestamp = (uint64_t)time(NULL) * 1000; // Current time in ms
-  }
+  // Check if this looks like JSON data (starts with { and ends with })
+  const char *trimmed = line_buffer;
+  while (*trimmed == ' ' || *trimmed == '\t')
+    trimmed++; // Skip whitespace
 
-  // Parse CPU data
-  cJSON *cpu = cJSON_GetObjectItem(json, "cpu");
-  if (cJSON_IsObject(cpu))
+  // Touch trace control and uploads share the link with telemetry
+  if (strncmp(trimmed, "TTRACE ", 7) == 0)
   {
-    cJSON *cpu_usage = cJSON_GetObjectItem(cpu, "usage");
-    cJSON *cpu_temp = cJSON_GetObjectItem(cpu, "temp");
-    cJSON *cpu_fan = cJSON_GetObjectItem(cpu, "fan");
-    cJSON *cpu_name = cJSON_GetObjectItem(cpu, "name");
-
-    if (cJSON_IsNumber(cpu_usage))
-    {
-      data->cpu.usage = (uint8_t)cJSON_GetNumberValue(cpu_usage);
-    }
-    if (cJSON_IsNumber(cpu_temp))
-    {
-      data->cpu.temp = (uint8_t)cJSON_GetNumberValue(cpu_temp);
-    }
-    if (cJSON_IsNumber(cpu_fan))
+    esp_err_t ret = gt911_trace_command(trimmed);
+    if (ret != ESP_OK)
     {
-      data->cpu.fan = (uint16_t)cJSON_GetNumberValue(cpu_fan);
-    }
-    if (cJSON_IsString(cpu_name))
-    {
-      strncpy(data->cpu.name, cJSON_GetStringValue(cpu_name),
-              sizeof(data->cpu.name) - 1);
-      data->cpu.name[sizeof(data->cpu.name) - 1] = '\0';
+      ESP_LOGW(TAG, "Touch trace command failed: %s", esp_err_to_name(ret));
     }
+    return;
   }
 
-  // Parse GPU data
-  cJSON *gpu = cJSON_GetObjectItem(json, "gpu");
-  if (cJSON_IsObject(gpu))
+  if (strncmp(trimmed, "LOG ", 4) == 0)
   {
-    cJSON *gpu_usage = cJSON_GetObjectItem(gpu, "usage");
-    cJSON *gpu_temp = cJSON_GetObjectItem(gpu, "temp");
-    cJSON *gpu_name = cJSON_GetObjectItem(gpu, "name");
-    cJSON *gpu_mem_used = cJSON_GetObjectItem(gpu, "mem_used");
-    cJSON *gpu_mem_total = cJSON_GetObjectItem(gpu, "mem_total");
-
-    if (cJSON_IsNumber(gpu_usage))
-    {
-      data->gpu.usage = (uint8_t)cJSON_GetNumberValue(gpu_usage);
-    }
-    if (cJSON_IsNumber(gpu_temp))
-    {
-      data->gpu.temp = (uint8_t)cJSON_GetNumberValue(gpu_temp);
-    }
-    if (cJSON_IsString(gpu_name))
-    {
-      strncpy(data->gpu.name, cJSON_GetStringValue(gpu_name),
-              sizeof(data->gpu.name) - 1);
-      data->gpu.name[sizeof(data->gpu.name) - 1] = '\0';
-    }
-    if (cJSON_IsNumber(gpu_mem_used))
-    {
-      data->gpu.mem_used = (uint32_t)cJSON_GetNumberValue(gpu_mem_used);
-    }
-    if (cJSON_IsNumber(gpu_mem_total))
+    esp_err_t ret = async_log_command(trimmed);
+    if (ret != ESP_OK)
     {
-      data->gpu.mem_total = (uint32_t)cJSON_GetNumberValue(gpu_mem_total);
+      ESP_LOGW(TAG, "Log command failed: %s", esp_err_to_name(ret));
     }
+    return;
   }
 
-  // Parse memory data
-  cJSON *mem = cJSON_GetObjectItem(json, "mem");
-  if (cJSON_IsObject(mem))
+  if (strncmp(trimmed, "DRAW ", 5) == 0)
   {
-    cJSON *mem_usage = cJSON_GetObjectItem(mem, "usage");
-    cJSON *mem_used = cJSON_GetObjectItem(mem, "used");
-    cJSON *mem_total = cJSON_GetObjectItem(mem, "total");
-    cJSON *mem_avail = cJSON_GetObjectItem(mem, "avail");
-
-    if (cJSON_IsNumber(mem_usage))
+    esp_err_t ret = draw_units_command(trimmed);
+    if (ret != ESP_OK)
     {
-      data->mem.usage = (uint8_t)cJSON_GetNumberValue(mem_usage);
+      ESP_LOGW(TAG, "Draw command failed: %s", esp_err_to_name(ret));
     }
-    if (cJSON_IsNumber(mem_used))
-    {
-      data->mem.used = (float)cJSON_GetNumberValue(mem_used);
-    }
-    if (cJSON_IsNumber(mem_total))
-    {
-      data->mem.total = (float)cJSON_GetNumberValue(mem_total);
-    }
-    if (cJSON_IsNumber(mem_avail))
-    {
-      data->mem.avail = (float)cJSON_GetNumberValue(mem_avail);
-    }
-  }
-
-  cJSON_Delete(json);
-  return true;
-}
-
-/**
- * @brief Process a complete line of received data
- */
-static void process_received_line(const char *line_buffer, system_data_t *system_data)
-{
-  // Skip empty lines
-  if (strlen(line_buffer) < 5)
     return;
-
-  // Check if this looks like JSON data (starts with { and ends with })
-  const char *trimmed = line_buffer;
-  while (*trimmed == ' ' || *trimmed == '\t')
-    trimmed++; // Skip whitespace
+  }
 
   if (trimmed[0] == '{')
   {
     // Find the end of JSON
-    size_t len = strlen(trimmed);
-    const char *end = trimmed + len - 1;
+    const char *end = line_buffer + line_len - 1;
     while (end > trimmed && (*end == ' ' || *end == '\t' || *end == '\n' || *end == '\r'))
       end--;
 
     if (*end == '}')
     {
       // Parse and update UI (reduce logging frequency)
-      if (parse_json_data(trimmed, system_data))
+      if (telemetry_parse_json(trimmed, (size_t)(end - trimmed) + 1, frame))
       {
-        system_monitor_ui_update(system_data);
+        publish_frame(frame);
 
         // Log less frequently to avoid blocking serial processing
         static uint32_t success_counter = 0;
@@ -278,38 +244,110 @@ static void process_received_line(const char *line_buffer, system_data_t *system
 }
 
 /**
- * @brief Add a byte to the line buffer and handle line completion
+ * @brief Decode a binary telemetry frame and update the UI
  */
-static bool handle_incoming_byte(uint8_t byte, char *line_buffer, int *line_pos, system_data_t *system_data)
+static void process_binary_frame(const uint8_t *frame, size_t frame_len, metric_frame_t *metrics)
 {
-  // Check for end of line
-  if (byte == '\n' || byte == '\r')
+  uint8_t seq;
+  esp_err_t ret = telemetry_frame_decode(frame, frame_len, metrics, &seq);
+
+  if (ret != ESP_OK)
   {
-    // Process line if we have data
-    if (*line_pos > 0)
+    // Rate-limit: a noisy line can produce many of these
+    if (++frame_errors % 10 == 1)
     {
-      line_buffer[*line_pos] = '\0';
-      process_received_line(line_buffer, system_data);
-      *line_pos = 0; // Reset for next line
-      return true;
+      ESP_LOGW(TAG, "Rejected binary frame (%u bytes): %s (total: %lu)",
+               (unsigned)frame_len, esp_err_to_name(ret), frame_errors);
     }
+    return;
   }
-  else if (byte >= 32 && byte <= 126) // Only accept printable ASCII characters
+
+  publish_frame(metrics);
+}
+
+/**
+ * @brief Drain the UART driver buffer into the framer and process complete lines
+ */
+static size_t drain_uart(metric_frame_t *frame)
+{
+  size_t total = 0;
+  size_t buffered = 0;
+
+  uart_get_buffered_data_len(UART_PORT_NUM, &buffered);
+
+  while (buffered > 0)
   {
-    if (*line_pos < JSON_BUFFER_SIZE - 1)
+    uint8_t *dst;
+    size_t space = serial_line_framer_write_ptr(&line_framer, &dst);
+    if (space == 0)
     {
-      // Add character to line buffer
-      line_buffer[(*line_pos)++] = byte;
+      // Cannot happen while lines are popped below, but never spin on it
+      serial_line_framer_reset(&line_framer);
+      continue;
     }
-    else
+
+    int len = uart_read_bytes(UART_PORT_NUM, dst, buffered < space ? buffered : space, 0);
+    if (len <= 0)
     {
-      // Line too long, reset buffer
-      ESP_LOGW(TAG, "Line buffer overflow, resetting");
-      *line_pos = 0;
+      break;
     }
+
+    serial_line_framer_commit(&line_framer, (size_t)len);
+    async_log_note_uart_rx();
+    buffered -= (size_t)len;
+    total += (size_t)len;
+
+    // Pop records between chunks so the ring never fills up
+    const char *record;
+    size_t record_len;
+    serial_record_type_t type;
+    while (serial_line_framer_next(&line_framer, &record, &record_len, &type))
+    {
+      if (type == SERIAL_RECORD_BINARY)
+      {
+        process_binary_frame((const uint8_t *)record, record_len, frame);
+      }
+      else
+      {
+        process_received_line(record, record_len, frame);
+      }
+    }
+  }
+
+  return total;
+}
+
+/**
+ * @brief Discard all buffered input after a FIFO or driver buffer overflow
+ */
+static void recover_from_overflow(void)
+{
+  uart_overruns++;
+  ESP_LOGW(TAG, "UART overflow, flushing input (total: %lu)", uart_overruns);
+
+  uart_flush_input(UART_PORT_NUM);
+  uart_pattern_queue_reset(UART_PORT_NUM, UART_PATTERN_QUEUE_LEN);
+  xQueueReset(uart_event_queue);
+  serial_line_framer_reset(&line_framer);
+}
+
+/**
+ * @brief Periodically log ingest statistics
+ */
+static void log_ingest_stats(uint32_t current_time)
+{
+  static uint32_t last_log_time = 0;
+
+  if (current_time - last_log_time < STATS_LOG_INTERVAL_MS)
+  {
+    return;
   }
+  last_log_time = current_time;
 
-  return false;
+  ESP_LOGI(TAG, "Ingest: %lu wakeups, %lu lines, %lu frames (%lu rejected, %lu resyncs), "
+                "%lu wrapped, %lu oversized, %lu overruns",
+           uart_wakeups, line_framer.lines, line_framer.frames, frame_errors, line_framer.resyncs,
+           line_framer.wrapped, line_framer.overflow, uart_overruns);
 }
 
 /**
@@ -324,6 +362,7 @@ static void check_connection_timeout(uint32_t current_time)
     if (!timeout_logged)
     {
       ESP_LOGW(TAG, "No data received for %d ms", connection_timeout_ms);
+      system_monitor_ui_set_connection_status(false);
       timeout_logged = true;
     }
   }
@@ -336,41 +375,56 @@ static void check_connection_timeout(uint32_t current_time)
 
 /**
  * @brief Serial data reception task
+ *
+ * Blocks on the UART event queue instead of polling, so the task only runs
+ * when the driver has data or a line delimiter was detected.
  */
 static void serial_data_task(void *pvParameters)
 {
-  static char line_buffer[JSON_BUFFER_SIZE];
-  static int line_pos = 0;
-
-  system_data_t system_data = {0};
+  static metric_frame_t frame; // Too large for the PSRAM task stack budget
+  uart_event_t event;
   uint32_t current_time;
 
+  metric_frame_init(&frame);
+
   ESP_LOGI(TAG, "Serial data task started");
 
   while (serial_running)
   {
-    // Read multiple bytes at once for better performance, but smaller buffer
-    // to reduce risk of partial JSON objects
-    uint8_t data_buffer[32];                                                                       // Reduced from 64 to 32 bytes
-    int len = uart_read_bytes(UART_PORT_NUM, data_buffer, sizeof(data_buffer), pdMS_TO_TICKS(20)); // Reduced timeout
-
-    current_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
-
-    if (len > 0)
+    if (xQueueReceive(uart_event_queue, &event, pdMS_TO_TICKS(UART_EVENT_WAIT_MS)) == pdTRUE)
     {
-      last_data_time = current_time;
+      uart_wakeups++;
 
-      // Process each received byte
-      for (int i = 0; i < len; i++)
+      switch (event.type)
       {
-        handle_incoming_byte(data_buffer[i], line_buffer, &line_pos, &system_data);
+      case UART_DATA:
+      case UART_PATTERN_DET:
+        // Positions are not needed, the framer finds delimiters itself
+        if (event.type == UART_PATTERN_DET)
+        {
+          uart_pattern_pop_pos(UART_PORT_NUM);
+        }
+        if (drain_uart(&frame) > 0)
+        {
+          last_data_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
+        }
+        break;
+
+      case UART_FIFO_OVF:
+      case UART_BUFFER_FULL:
+        recover_from_overflow();
+        break;
+
+      default:
+        break;
       }
     }
 
+    current_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
+
     // Check for connection timeout
     check_connection_timeout(current_time);
-
-    vTaskDelay(pdMS_TO_TICKS(5)); // Reduced delay for faster response
+    log_ingest_stats(current_time);
   }
 
   ESP_LOGI(TAG, "Serial data task stopped");
@@ -388,10 +442,39 @@ esp_err_t serial_data_init(void)
       .source_clk = UART_SOURCE_CLK,
   };
 
-  // Install UART driver
-  ESP_ERROR_CHECK(uart_driver_install(UART_PORT_NUM, BUF_SIZE * 2, 0, 0, NULL, 0));
+  // Install UART driver with an event queue
+  ESP_ERROR_CHECK(uart_driver_install(UART_PORT_NUM, BUF_SIZE * 2, 0, UART_EVENT_QUEUE_LEN,
+                                      &uart_event_queue, 0));
   ESP_ERROR_CHECK(uart_param_config(UART_PORT_NUM, &uart_config));
 
+  // Raise an event on every line delimiter instead of waiting for RX timeout
+  ESP_ERROR_CHECK(uart_enable_pattern_det_baud_intr(UART_PORT_NUM, UART_LINE_DELIMITER, 1, 9, 0, 0));
+  ESP_ERROR_CHECK(uart_pattern_queue_reset(UART_PORT_NUM, UART_PATTERN_QUEUE_LEN));
+
+  esp_err_t ret = metric_registry_init();
+  if (ret != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to initialize metric registry: %s", esp_err_to_name(ret));
+    uart_driver_delete(UART_PORT_NUM);
+    return ret;
+  }
+
+  ret = metric_history_init();
+  if (ret != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to initialize metric history: %s", esp_err_to_name(ret));
+    uart_driver_delete(UART_PORT_NUM);
+    return ret;
+  }
+
+  ret = serial_line_framer_init(&line_framer, RING_BUFFER_SIZE, JSON_BUFFER_SIZE - 1);
+  if (ret != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to allocate line framer: %s", esp_err_to_name(ret));
+    uart_driver_delete(UART_PORT_NUM);
+    return ret;
+  }
+
   ESP_LOGI(TAG, "UART initialized on port %d at %d baud", UART_PORT_NUM, UART_BAUD_RATE);
 
   return ESP_OK;
@@ -0,0 +1,258 @@
+/**
+ * @file serial_line_framer.c
+ * @brief Zero-copy line framer over a PSRAM ring buffer
+ *
+ * Delimiters are located with memchr() over at most two contiguous ring
+ * segments per call, so the per-byte cost is a scan rather than a copy.
+ * Text mode searches for '\n' and 0x00, binary mode only for 0x00.
+ */
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "serial_line_framer.h"
+
+#include "esp_heap_caps.h"
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Allocate from PSRAM, falling back to internal RAM
+ */
+static void *framer_alloc(size_t size)
+{
+  void *ptr = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (ptr == NULL)
+  {
+    ptr = heap_caps_malloc(size, MALLOC_CAP_8BIT);
+  }
+  return ptr;
+}
+
+/**
+ * @brief Hand out a line that starts at line_start, copying only if it wraps
+ */
+static const char *framer_emit(serial_line_framer_t *framer, size_t line_start, size_t line_len)
+{
+  const size_t mask = framer->size - 1;
+  const size_t offset = line_start & mask;
+
+  if (offset + line_len < framer->size)
+  {
+    // Contiguous: terminate in place over the consumed delimiter
+    framer->ring[offset + line_len] = '\0';
+    return (const char *)&framer->ring[offset];
+  }
+
+  // Wrapped: one copy of the two segments into scratch
+  size_t first = framer->size - offset;
+  if (first > line_len)
+  {
+    first = line_len;
+  }
+  memcpy(framer->scratch, &framer->ring[offset], first);
+  memcpy(framer->scratch + first, framer->ring, line_len - first);
+  framer->scratch[line_len] = '\0';
+  framer->wrapped++;
+  return framer->scratch;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t serial_line_framer_init(serial_line_framer_t *framer, size_t ring_size, size_t max_line)
+{
+  if (!framer || ring_size == 0 || (ring_size & (ring_size - 1)) != 0 || max_line == 0 ||
+      max_line >= ring_size / 2)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  memset(framer, 0, sizeof(*framer));
+
+  framer->ring = framer_alloc(ring_size);
+  framer->scratch = framer_alloc(max_line + 1);
+  if (!framer->ring || !framer->scratch)
+  {
+    serial_line_framer_deinit(framer);
+    return ESP_ERR_NO_MEM;
+  }
+
+  framer->size = ring_size;
+  framer->max_line = max_line;
+  return ESP_OK;
+}
+
+void serial_line_framer_deinit(serial_line_framer_t *framer)
+{
+  if (!framer)
+  {
+    return;
+  }
+
+  heap_caps_free(framer->ring);
+  heap_caps_free(framer->scratch);
+  memset(framer, 0, sizeof(*framer));
+}
+
+void serial_line_framer_reset(serial_line_framer_t *framer)
+{
+  framer->head = 0;
+  framer->tail = 0;
+  framer->scan = 0;
+  framer->discarding = false;
+  framer->binary = false;
+}
+
+size_t serial_line_framer_write_ptr(serial_line_framer_t *framer, uint8_t **ptr)
+{
+  const size_t mask = framer->size - 1;
+  const size_t free_bytes = framer->size - (framer->head - framer->tail);
+  const size_t offset = framer->head & mask;
+  size_t contiguous = framer->size - offset;
+
+  *ptr = &framer->ring[offset];
+  return contiguous < free_bytes ? contiguous : free_bytes;
+}
+
+void serial_line_framer_commit(serial_line_framer_t *framer, size_t len)
+{
+  framer->head += len;
+}
+
+bool serial_line_framer_next(serial_line_framer_t *framer, const char **data, size_t *len,
+                             serial_record_type_t *type)
+{
+  const size_t mask = framer->size - 1;
+
+  while (framer->scan != framer->head)
+  {
+    if (framer->binary && framer->scan == framer->tail && framer->ring[framer->tail & mask] == '{')
+    {
+      // JSON after a binary frame: back to text without losing a byte
+      framer->binary = false;
+    }
+
+    // Search the next contiguous run for the delimiter(s)
+    const size_t offset = framer->scan & mask;
+    size_t run = framer->size - offset;
+    if (run > framer->head - framer->scan)
+    {
+      run = framer->head - framer->scan;
+    }
+
+    const uint8_t *seg = &framer->ring[offset];
+    const uint8_t *hit = memchr(seg, '\0', run);
+    if (!framer->binary)
+    {
+      const uint8_t *newline = memchr(seg, '\n', hit ? (size_t)(hit - seg) : run);
+      if (newline != NULL)
+      {
+        hit = newline;
+      }
+    }
+
+    if (hit == NULL)
+    {
+      framer->scan += run;
+      if (framer->binary && framer->scan - framer->tail > SERIAL_LINE_FRAMER_MAX_BINARY)
+      {
+        // No frame delimiter in sight: rescan the bytes as text
+        framer->binary = false;
+        framer->scan = framer->tail;
+        framer->resyncs++;
+      }
+      continue;
+    }
+
+    const size_t end = framer->scan + (size_t)(hit - seg);
+    const size_t record_start = framer->tail;
+    size_t record_len = end - record_start;
+
+    if (framer->binary)
+    {
+      if (record_len > SERIAL_LINE_FRAMER_MAX_BINARY)
+      {
+        framer->binary = false;
+        framer->scan = framer->tail;
+        framer->resyncs++;
+        continue;
+      }
+
+      framer->scan = end + 1;
+      framer->tail = framer->scan;
+
+      // An empty record is a repeated opening delimiter, keep waiting
+      if (record_len == 0)
+      {
+        continue;
+      }
+
+      // The closing delimiter returns to text until the next frame opens
+      framer->binary = false;
+      *data = framer_emit(framer, record_start, record_len);
+      *len = record_len;
+      *type = SERIAL_RECORD_BINARY;
+      framer->frames++;
+      return true;
+    }
+
+    framer->scan = end + 1;
+    framer->tail = framer->scan;
+
+    if (*hit == '\0')
+    {
+      // Start of binary framing; any text before it is still a record
+      framer->binary = true;
+    }
+    else if (record_len > 0 && framer->ring[(end - 1) & mask] == '\r')
+    {
+      // Accept "\r\n" as well as "\n"
+      record_len--;
+    }
+
+    if (framer->discarding)
+    {
+      // Remainder of a line already counted as oversized
+      framer->discarding = false;
+      continue;
+    }
+
+    if (record_len == 0)
+    {
+      continue;
+    }
+
+    if (record_len > framer->max_line)
+    {
+      framer->overflow++;
+      continue;
+    }
+
+    *data = framer_emit(framer, record_start, record_len);
+    *len = record_len;
+    *type = SERIAL_RECORD_TEXT;
+    framer->lines++;
+    return true;
+  }
+
+  // No delimiter buffered: never let a runaway line starve the ring. The
+  // rest of it is skipped up to its delimiter, so the next line starts clean.
+  if (!framer->binary && framer->head - framer->tail > framer->max_line)
+  {
+    if (!framer->discarding)
+    {
+      framer->overflow++;
+      framer->discarding = true;
+    }
+    framer->tail = framer->head;
+    framer->scan = framer->head;
+  }
+
+  return false;
+}
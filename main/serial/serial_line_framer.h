@@ -0,0 +1,126 @@
+/**
+ * @file serial_line_framer.h
+ * @brief Zero-copy line framer over a PSRAM ring buffer
+ *
+ * UART data is read straight into the ring, and complete lines are handed
+ * out as pointers into the ring itself. Only lines that wrap around the end
+ * of the ring are copied (once) into a linear scratch buffer. The delimiter
+ * is overwritten with a NUL terminator in place, so callers get a regular
+ * C string without any per-byte copying.
+ *
+ * Besides '\n'-terminated text the stream may carry binary frames wrapped
+ * in 0x00 delimiters on both ends (COBS encoded, so they contain no zero
+ * bytes). An opening 0x00 switches the framer to binary mode and the closing
+ * one switches it back to text. A record that starts with '{' or grows past
+ * SERIAL_LINE_FRAMER_MAX_BINARY without a delimiter is rescanned as text.
+ *
+ * The framer has no ESP-IDF dependencies beyond heap_caps and can be built
+ * on a host for replaying recorded byte streams.
+ */
+
+#pragma once
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define SERIAL_LINE_FRAMER_MAX_BINARY 128 ///< Longest binary record before resyncing as text
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Kind of record returned by the framer
+ */
+typedef enum
+{
+  SERIAL_RECORD_TEXT = 0, ///< '\n'-terminated text line
+  SERIAL_RECORD_BINARY,   ///< 0x00-delimited binary frame (still COBS encoded)
+} serial_record_type_t;
+
+/**
+ * @brief Line framer state
+ *
+ * Indices are free-running and masked on access, so head - tail is always
+ * the number of buffered bytes.
+ */
+typedef struct
+{
+  uint8_t *ring;     ///< Ring storage (power-of-two size, PSRAM)
+  size_t size;       ///< Ring size in bytes
+  size_t head;       ///< Write index (free-running)
+  size_t tail;       ///< Start of the pending line (free-running)
+  size_t scan;       ///< Next index to search for a delimiter (free-running)
+  char *scratch;     ///< Linear copy target for lines that wrap the ring
+  size_t max_line;   ///< Longest accepted line, excluding the terminator
+  uint32_t lines;    ///< Complete lines handed out
+  uint32_t wrapped;  ///< Lines that had to be copied into scratch
+  bool discarding;   ///< Dropping the rest of an oversized line
+  bool binary;       ///< Inside 0x00-delimited binary framing
+  uint32_t overflow; ///< Lines discarded for exceeding max_line
+  uint32_t frames;   ///< Binary records handed out
+  uint32_t resyncs;  ///< Binary records that turned out to be text
+} serial_line_framer_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION PROTOTYPES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Allocate the ring (PSRAM preferred) and scratch buffers
+ * @param framer Framer to initialize
+ * @param ring_size Ring size in bytes, must be a power of two
+ * @param max_line Longest accepted line, must be less than half the ring
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG or ESP_ERR_NO_MEM otherwise
+ */
+esp_err_t serial_line_framer_init(serial_line_framer_t *framer, size_t ring_size, size_t max_line);
+
+/**
+ * @brief Free framer buffers
+ * @param framer Framer to release
+ */
+void serial_line_framer_deinit(serial_line_framer_t *framer);
+
+/**
+ * @brief Drop all buffered bytes (e.g. after a UART overflow)
+ * @param framer Framer to reset
+ */
+void serial_line_framer_reset(serial_line_framer_t *framer);
+
+/**
+ * @brief Get the largest contiguous free region of the ring
+ * @param framer Framer instance
+ * @param ptr Receives the write pointer
+ * @return Number of bytes that may be written at ptr (0 if the ring is full)
+ */
+size_t serial_line_framer_write_ptr(serial_line_framer_t *framer, uint8_t **ptr);
+
+/**
+ * @brief Mark bytes written at the write pointer as valid
+ * @param framer Framer instance
+ * @param len Number of bytes written
+ */
+void serial_line_framer_commit(serial_line_framer_t *framer, size_t len);
+
+/**
+ * @brief Pop the next complete record
+ * @param framer Framer instance
+ * @param data Receives a NUL-terminated record without its delimiter
+ *             ("\n" / "\r\n" for text, 0x00 for binary)
+ * @param len Receives the record length
+ * @param type Receives the record kind
+ * @return true if a record was returned, false if none is complete yet
+ * @note The returned pointer is valid until the next write or pop
+ */
+bool serial_line_framer_next(serial_line_framer_t *framer, const char **data, size_t *len,
+                             serial_record_type_t *type);
@@ -0,0 +1,238 @@
+/**
+ * @file telemetry_frame.c
+ * @brief Compact binary telemetry frame (COBS + CRC16, versioned)
+ */
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "telemetry_frame.h"
+
+#include <math.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define CRC16_INIT 0xFFFF     ///< CRC16-CCITT initial value
+#define CRC16_POLY 0x1021     ///< CRC16-CCITT polynomial
+#define CRC_OFFSET 31         ///< Offset of the CRC in the decoded frame
+#define MEM_GB_SCALE 100.0f   ///< Memory sizes are sent in hundredths of a GB
+#define DECODED_MAX 254       ///< Longest record decoded before its version is known
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static uint16_t crc16_ccitt(const uint8_t *buf, size_t len)
+{
+  uint16_t crc = CRC16_INIT;
+
+  for (size_t i = 0; i < len; i++)
+  {
+    crc ^= (uint16_t)buf[i] << 8;
+    for (int bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ CRC16_POLY) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+static inline void put_u16(uint8_t *p, uint16_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t *p, uint32_t v)
+{
+  put_u16(p, (uint16_t)v);
+  put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static inline uint16_t get_u16(const uint8_t *p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t *p)
+{
+  return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+/**
+ * @brief Convert a metric to an unsigned wire field, saturating (NAN -> 0)
+ */
+static uint32_t metric_to_wire(const metric_frame_t *frame, metric_id_t id, float scale, uint32_t max)
+{
+  float scaled = frame->values[id] * scale + 0.5f;
+  if (isnan(scaled) || scaled <= 0)
+    return 0;
+  return scaled >= (float)max ? max : (uint32_t)scaled;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+size_t telemetry_frame_cobs_encode(const uint8_t *in, size_t len, uint8_t *out, size_t out_size)
+{
+  if (out_size < TELEMETRY_COBS_MAX(len))
+  {
+    return 0;
+  }
+
+  size_t n = 0;
+  size_t code_pos = n++;
+  uint8_t code = 1;
+  for (size_t i = 0; i < len; i++)
+  {
+    if (in[i] == 0)
+    {
+      out[code_pos] = code;
+      code_pos = n++;
+      code = 1;
+      continue;
+    }
+
+    out[n++] = in[i];
+    if (++code == 0xFF)
+    {
+      out[code_pos] = code;
+      code_pos = n++;
+      code = 1;
+    }
+  }
+  out[code_pos] = code;
+  return n;
+}
+
+size_t telemetry_frame_cobs_decode(const uint8_t *in, size_t len, uint8_t *out, size_t out_size)
+{
+  size_t n = 0;
+  size_t i = 0;
+
+  while (i < len)
+  {
+    uint8_t code = in[i++];
+    if (code == 0 || i + code - 1 > len || n + code - 1 > out_size)
+    {
+      return 0;
+    }
+
+    memcpy(&out[n], &in[i], code - 1);
+    n += code - 1;
+    i += code - 1;
+
+    // A full block (0xFF) or the final block carries no implicit zero
+    if (code != 0xFF && i < len)
+    {
+      if (n >= out_size)
+        return 0;
+      out[n++] = 0;
+    }
+  }
+  return n;
+}
+
+size_t telemetry_frame_encode(const metric_frame_t *metrics, uint8_t seq, uint8_t *out, size_t out_size)
+{
+  uint8_t frame[TELEMETRY_FRAME_SIZE];
+
+  if (out_size < TELEMETRY_FRAME_WIRE_MAX)
+  {
+    return 0;
+  }
+
+  frame[0] = TELEMETRY_FRAME_VERSION;
+  frame[1] = seq;
+  put_u32(&frame[2], (uint32_t)metrics->timestamp);
+  put_u32(&frame[6], (uint32_t)(metrics->timestamp >> 32));
+  frame[10] = (uint8_t)metric_to_wire(metrics, METRIC_CPU_USAGE, 1, UINT8_MAX);
+  frame[11] = (uint8_t)metric_to_wire(metrics, METRIC_CPU_TEMP, 1, UINT8_MAX);
+  put_u16(&frame[12], (uint16_t)metric_to_wire(metrics, METRIC_CPU_FAN, 1, UINT16_MAX));
+  frame[14] = (uint8_t)metric_to_wire(metrics, METRIC_GPU_USAGE, 1, UINT8_MAX);
+  frame[15] = (uint8_t)metric_to_wire(metrics, METRIC_GPU_TEMP, 1, UINT8_MAX);
+  put_u32(&frame[16], metric_to_wire(metrics, METRIC_GPU_MEM_USED, 1, UINT32_MAX));
+  put_u32(&frame[20], metric_to_wire(metrics, METRIC_GPU_MEM_TOTAL, 1, UINT32_MAX));
+  frame[24] = (uint8_t)metric_to_wire(metrics, METRIC_MEM_USAGE, 1, UINT8_MAX);
+  put_u16(&frame[25], (uint16_t)metric_to_wire(metrics, METRIC_MEM_USED, MEM_GB_SCALE, UINT16_MAX));
+  put_u16(&frame[27], (uint16_t)metric_to_wire(metrics, METRIC_MEM_TOTAL, MEM_GB_SCALE, UINT16_MAX));
+  put_u16(&frame[29], (uint16_t)metric_to_wire(metrics, METRIC_MEM_AVAIL, MEM_GB_SCALE, UINT16_MAX));
+  put_u16(&frame[CRC_OFFSET], crc16_ccitt(frame, CRC_OFFSET));
+
+  // COBS encode between two delimiters
+  out[0] = 0x00;
+  size_t n = 1 + telemetry_frame_cobs_encode(frame, sizeof(frame), &out[1], out_size - 2);
+  out[n++] = 0x00;
+  return n;
+}
+
+/**
+ * @brief Check and unpack a version 1 frame
+ */
+static esp_err_t decode_v1(const uint8_t *frame, size_t len, metric_frame_t *metrics, uint8_t *seq)
+{
+  if (len != TELEMETRY_FRAME_SIZE)
+  {
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  if (crc16_ccitt(frame, CRC_OFFSET) != get_u16(&frame[CRC_OFFSET]))
+  {
+    return ESP_ERR_INVALID_CRC;
+  }
+
+  if (seq)
+  {
+    *seq = frame[1];
+  }
+
+  static const metric_id_t carried[] = {
+      METRIC_CPU_USAGE, METRIC_CPU_TEMP, METRIC_CPU_FAN, METRIC_GPU_USAGE, METRIC_GPU_TEMP, METRIC_GPU_MEM_USED,
+      METRIC_GPU_MEM_TOTAL, METRIC_MEM_USAGE, METRIC_MEM_USED, METRIC_MEM_TOTAL, METRIC_MEM_AVAIL,
+  };
+  memset(metrics->updated, 0, sizeof(metrics->updated));
+  for (size_t i = 0; i < sizeof(carried) / sizeof(carried[0]); i++)
+  {
+    metric_frame_mark_updated(metrics, carried[i]);
+  }
+
+  metrics->timestamp = get_u32(&frame[2]) | ((uint64_t)get_u32(&frame[6]) << 32);
+  metrics->values[METRIC_CPU_USAGE] = frame[10];
+  metrics->values[METRIC_CPU_TEMP] = frame[11];
+  metrics->values[METRIC_CPU_FAN] = get_u16(&frame[12]);
+  metrics->values[METRIC_GPU_USAGE] = frame[14];
+  metrics->values[METRIC_GPU_TEMP] = frame[15];
+  metrics->values[METRIC_GPU_MEM_USED] = (float)get_u32(&frame[16]);
+  metrics->values[METRIC_GPU_MEM_TOTAL] = (float)get_u32(&frame[20]);
+  metrics->values[METRIC_MEM_USAGE] = frame[24];
+  metrics->values[METRIC_MEM_USED] = get_u16(&frame[25]) / MEM_GB_SCALE;
+  metrics->values[METRIC_MEM_TOTAL] = get_u16(&frame[27]) / MEM_GB_SCALE;
+  metrics->values[METRIC_MEM_AVAIL] = get_u16(&frame[29]) / MEM_GB_SCALE;
+
+  return ESP_OK;
+}
+
+esp_err_t telemetry_frame_decode(const uint8_t *encoded, size_t len, metric_frame_t *metrics, uint8_t *seq)
+{
+  uint8_t frame[DECODED_MAX];
+
+  size_t n = telemetry_frame_cobs_decode(encoded, len, frame, sizeof(frame));
+  if (n == 0)
+  {
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  // The version byte selects the layout, so size and CRC are checked per version
+  switch (frame[0])
+  {
+  case TELEMETRY_FRAME_VERSION:
+    return decode_v1(frame, n, metrics, seq);
+  default:
+    return ESP_ERR_NOT_SUPPORTED;
+  }
+}
@@ -0,0 +1,92 @@
+/**
+ * @file telemetry_frame.h
+ * @brief Compact binary telemetry frame (COBS + CRC16, versioned)
+ *
+ * Fixed little-endian layout sent as an alternative to the JSON line:
+ *
+ *   off  size  field
+ *   0    1     version (TELEMETRY_FRAME_VERSION)
+ *   1    1     sequence number (wraps)
+ *   2    8     timestamp, ms since epoch
+ *   10   1     cpu.usage          11   1  cpu.temp     12  2  cpu.fan
+ *   14   1     gpu.usage          15   1  gpu.temp
+ *   16   4     gpu.mem_used (MB)  20   4  gpu.mem_total (MB)
+ *   24   1     mem.usage
+ *   25   2     mem.used  (GB/100) 27   2  mem.total (GB/100)  29  2  mem.avail (GB/100)
+ *   31   2     CRC16-CCITT (poly 0x1021, init 0xFFFF) over bytes 0..30
+ *
+ * The 33-byte frame is COBS encoded and wrapped in 0x00 delimiters, which
+ * is 36 bytes on the wire against ~250 for the equivalent JSON line. The
+ * frame carries the built-in metrics only; CPU/GPU names and any dynamic
+ * metrics keep the values from the last JSON line.
+ */
+
+#pragma once
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "esp_err.h"
+#include "metric_registry.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define TELEMETRY_FRAME_VERSION 1 ///< Layout version produced by the encoder
+#define TELEMETRY_FRAME_SIZE 33   ///< Decoded frame size including CRC
+#define TELEMETRY_COBS_MAX(len) ((len) + (len) / 254 + 1)                ///< Worst-case COBS size of len bytes
+#define TELEMETRY_FRAME_WIRE_MAX (TELEMETRY_COBS_MAX(TELEMETRY_FRAME_SIZE) + 2) ///< Encoded size with delimiters
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION PROTOTYPES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief COBS-encode a buffer (no delimiters added)
+ * @param in Bytes to encode, may contain zeros
+ * @param len Number of input bytes
+ * @param out Output buffer, at least TELEMETRY_COBS_MAX(len) bytes
+ * @param out_size Size of the output buffer
+ * @return Encoded length (never contains 0x00), 0 if out is too small
+ */
+size_t telemetry_frame_cobs_encode(const uint8_t *in, size_t len, uint8_t *out, size_t out_size);
+
+/**
+ * @brief COBS-decode one record (delimiters already stripped)
+ * @param in Encoded bytes
+ * @param len Number of encoded bytes
+ * @param out Output buffer
+ * @param out_size Size of the output buffer
+ * @return Decoded length, 0 on malformed input or if out is too small
+ */
+size_t telemetry_frame_cobs_decode(const uint8_t *in, size_t len, uint8_t *out, size_t out_size);
+
+/**
+ * @brief Reference encoder: build a delimited wire frame from a metric frame
+ * @param metrics Metrics to encode (built-in numeric metrics only, NAN as 0)
+ * @param seq Sequence number to embed
+ * @param out Output buffer, at least TELEMETRY_FRAME_WIRE_MAX bytes
+ * @param out_size Size of the output buffer
+ * @return Number of bytes written (including both 0x00 delimiters), 0 if out is too small
+ */
+size_t telemetry_frame_encode(const metric_frame_t *metrics, uint8_t seq, uint8_t *out, size_t out_size);
+
+/**
+ * @brief Decode one COBS record (delimiters already stripped) into a metric frame
+ * @param encoded COBS bytes between two 0x00 delimiters
+ * @param len Number of encoded bytes
+ * @param metrics Frame to update; only built-in numeric metrics are written,
+ *                and only they are marked updated
+ * @param seq Receives the frame sequence number, may be NULL
+ * @return ESP_OK on success,
+ *         ESP_ERR_INVALID_SIZE for bad COBS or a wrong size for the version,
+ *         ESP_ERR_NOT_SUPPORTED for an unknown version (checked first, so a
+ *         newer sender's frames are not reported as corrupt),
+ *         ESP_ERR_INVALID_CRC on checksum mismatch
+ * @note metrics is only modified when decoding succeeds
+ */
+esp_err_t telemetry_frame_decode(const uint8_t *encoded, size_t len, metric_frame_t *metrics, uint8_t *seq);
@@ -0,0 +1,623 @@
+/**
+ * @file telemetry_parser.c
+ * @brief Allocation-free JSON parser for the telemetry schema
+ *
+ * Recursive-descent tokenizer working directly on the received line. While
+ * descending, the dotted path of the current value is built in a small
+ * stack buffer and its FNV-1a hash is extended incrementally, so each leaf
+ * resolves to a metric ID with one hash-table probe.
+ *
+ * Unseen paths are only registered once the whole line has validated, so
+ * a malformed payload cannot use up registry slots: the first pass looks
+ * paths up without registering and notes whether any new one could be
+ * registered; only then is the valid line parsed a second time with
+ * registration enabled. New paths are rare after the first line, so the
+ * second pass is too, and a sender that keeps adding paths once the
+ * registry or its string slots are full does not bring it back.
+ */
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "telemetry_parser.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define MAX_NESTING_DEPTH 16 ///< Deepest object/array nesting accepted
+#define KEY_TS 0x46454E70U   ///< FNV-1a hash of the top-level "ts" key
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Read position within the input text
+ */
+typedef struct
+{
+  const char *p;   ///< Current character
+  const char *end; ///< One past the last character
+} cursor_t;
+
+/**
+ * @brief Parse state shared by the value walker
+ */
+typedef struct
+{
+  metric_frame_t *frame;      ///< Working copy, committed on success
+  bool has_ts;                ///< Payload carried a numeric timestamp
+  bool register_new;          ///< Register unseen paths (second pass)
+  bool has_new;               ///< An unseen path could be registered
+  char path[METRIC_PATH_LEN]; ///< Dotted path of the current value
+} parse_ctx_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION PROTOTYPES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static bool parse_value(cursor_t *c, parse_ctx_t *ctx, size_t path_len, uint32_t hash, int depth);
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// TOKENIZER
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static inline char peek(const cursor_t *c)
+{
+  return c->p < c->end ? *c->p : '\0';
+}
+
+static inline bool is_digit(char ch)
+{
+  return ch >= '0' && ch <= '9';
+}
+
+static void skip_ws(cursor_t *c)
+{
+  while (c->p < c->end && (*c->p == ' ' || *c->p == '\t' || *c->p == '\n' || *c->p == '\r'))
+  {
+    c->p++;
+  }
+}
+
+static int hex_value(char ch)
+{
+  if (ch >= '0' && ch <= '9')
+    return ch - '0';
+  if (ch >= 'a' && ch <= 'f')
+    return ch - 'a' + 10;
+  if (ch >= 'A' && ch <= 'F')
+    return ch - 'A' + 10;
+  return -1;
+}
+
+/**
+ * @brief Scan a string token, optionally hashing and/or copying it
+ * @param c Cursor positioned on the opening quote
+ * @param out Destination buffer, or NULL to only validate
+ * @param out_size Size of out in bytes; longer strings are truncated
+ * @param hash In: hash to continue from, out: FNV-1a hash including the
+ *             decoded bytes. May be NULL
+ * @param decoded_len Receives the untruncated decoded length, may be NULL
+ * @return true if the string is well formed
+ */
+static bool parse_string(cursor_t *c, char *out, size_t out_size, uint32_t *hash, size_t *decoded_len)
+{
+  uint32_t h = hash ? *hash : METRIC_HASH_INIT;
+  size_t n = 0;
+  size_t total = 0;
+  bool truncated = false;
+
+  c->p++; // opening quote
+
+  while (c->p < c->end)
+  {
+    uint8_t bytes[3];
+    size_t count = 1;
+    char ch = *c->p++;
+
+    if (ch == '"')
+    {
+      if (out)
+      {
+        // Never leave a partial UTF-8 sequence behind after truncation
+        if (truncated)
+        {
+          while (n > 0 && ((uint8_t)out[n - 1] & 0xC0) == 0x80)
+            n--;
+          if (n > 0 && (uint8_t)out[n - 1] >= 0xC0)
+            n--;
+        }
+        out[n] = '\0';
+      }
+      if (hash)
+      {
+        *hash = h;
+      }
+      if (decoded_len)
+      {
+        *decoded_len = total;
+      }
+      return true;
+    }
+
+    if ((uint8_t)ch < 0x20)
+    {
+      return false;
+    }
+
+    bytes[0] = (uint8_t)ch;
+    if (ch == '\\')
+    {
+      if (c->p >= c->end)
+        return false;
+
+      switch (*c->p++)
+      {
+      case '"':
+        bytes[0] = '"';
+        break;
+      case '\\':
+        bytes[0] = '\\';
+        break;
+      case '/':
+        bytes[0] = '/';
+        break;
+      case 'b':
+        bytes[0] = '\b';
+        break;
+      case 'f':
+        bytes[0] = '\f';
+        break;
+      case 'n':
+        bytes[0] = '\n';
+        break;
+      case 'r':
+        bytes[0] = '\r';
+        break;
+      case 't':
+        bytes[0] = '\t';
+        break;
+      case 'u':
+      {
+        if (c->end - c->p < 4)
+          return false;
+
+        uint32_t cp = 0;
+        for (int i = 0; i < 4; i++)
+        {
+          int v = hex_value(*c->p++);
+          if (v < 0)
+            return false;
+          cp = (cp << 4) | (uint32_t)v;
+        }
+
+        // Encode the BMP code point as UTF-8 (surrogates are kept as-is)
+        if (cp < 0x80)
+        {
+          bytes[0] = (uint8_t)cp;
+        }
+        else if (cp < 0x800)
+        {
+          bytes[0] = (uint8_t)(0xC0 | (cp >> 6));
+          bytes[1] = (uint8_t)(0x80 | (cp & 0x3F));
+          count = 2;
+        }
+        else
+        {
+          bytes[0] = (uint8_t)(0xE0 | (cp >> 12));
+          bytes[1] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+          bytes[2] = (uint8_t)(0x80 | (cp & 0x3F));
+          count = 3;
+        }
+        break;
+      }
+      default:
+        return false;
+      }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+      h = (h ^ bytes[i]) * METRIC_HASH_PRIME;
+      total++;
+      if (out)
+      {
+        if (n + 1 < out_size)
+          out[n++] = (char)bytes[i];
+        else
+          truncated = true;
+      }
+    }
+  }
+
+  return false; // unterminated
+}
+
+/**
+ * @brief Parse a JSON number without going through strtod()
+ */
+static bool parse_number(cursor_t *c, double *out)
+{
+  static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+                                 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+  const uint64_t mantissa_limit = 100000000000000000ULL; // keep 17 significant digits
+  uint64_t mantissa = 0;
+  int exp10 = 0;
+  bool negative = false;
+
+  if (peek(c) == '-')
+  {
+    negative = true;
+    c->p++;
+  }
+
+  if (!is_digit(peek(c)))
+  {
+    return false;
+  }
+
+  if (peek(c) == '0')
+  {
+    c->p++;
+  }
+  else
+  {
+    while (is_digit(peek(c)))
+    {
+      if (mantissa < mantissa_limit)
+        mantissa = mantissa * 10 + (uint64_t)(*c->p - '0');
+      else
+        exp10++;
+      c->p++;
+    }
+  }
+
+  if (peek(c) == '.')
+  {
+    c->p++;
+    if (!is_digit(peek(c)))
+      return false;
+
+    while (is_digit(peek(c)))
+    {
+      if (mantissa < mantissa_limit)
+      {
+        mantissa = mantissa * 10 + (uint64_t)(*c->p - '0');
+        exp10--;
+      }
+      c->p++;
+    }
+  }
+
+  if (peek(c) == 'e' || peek(c) == 'E')
+  {
+    int sign = 1;
+    int exponent = 0;
+
+    c->p++;
+    if (peek(c) == '+' || peek(c) == '-')
+    {
+      sign = (*c->p == '-') ? -1 : 1;
+      c->p++;
+    }
+    if (!is_digit(peek(c)))
+      return false;
+
+    while (is_digit(peek(c)))
+    {
+      if (exponent < 1000)
+        exponent = exponent * 10 + (*c->p - '0');
+      c->p++;
+    }
+    exp10 += sign * exponent;
+  }
+
+  double value = (double)mantissa;
+  while (exp10 > 0)
+  {
+    int step = exp10 > 15 ? 15 : exp10;
+    value *= pow10[step];
+    exp10 -= step;
+  }
+  while (exp10 < 0)
+  {
+    int step = -exp10 > 15 ? 15 : -exp10;
+    value /= pow10[step];
+    exp10 += step;
+  }
+
+  *out = negative ? -value : value;
+  return true;
+}
+
+static bool match_literal(cursor_t *c, const char *literal, size_t len)
+{
+  if ((size_t)(c->end - c->p) < len || memcmp(c->p, literal, len) != 0)
+  {
+    return false;
+  }
+  c->p += len;
+  return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// VALUE WALKER
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Append to the current path, tracking the virtual (untruncated) length
+ */
+static size_t path_append(parse_ctx_t *ctx, size_t path_len, const char *s, size_t len, uint32_t *hash)
+{
+  for (size_t i = 0; i < len; i++, path_len++)
+  {
+    if (path_len < METRIC_PATH_LEN)
+      ctx->path[path_len] = s[i];
+  }
+  *hash = metric_hash_extend(*hash, s, len);
+  return path_len;
+}
+
+/**
+ * @brief Resolve the current path, registering it only in the second pass
+ */
+static metric_id_t resolve_leaf(parse_ctx_t *ctx, size_t path_len, uint32_t hash, metric_type_t type)
+{
+  if (ctx->register_new)
+  {
+    return metric_registry_resolve(ctx->path, path_len, hash, type);
+  }
+
+  metric_id_t id = metric_registry_lookup(ctx->path, path_len, hash);
+  if (id == METRIC_ID_INVALID)
+  {
+    if (path_len < METRIC_PATH_LEN && metric_registry_can_register(type))
+      ctx->has_new = true;
+    return METRIC_ID_INVALID;
+  }
+  return metric_registry_get(id)->type == type ? id : METRIC_ID_INVALID;
+}
+
+/**
+ * @brief Store a numeric leaf under the current path
+ */
+static void store_number(parse_ctx_t *ctx, size_t path_len, uint32_t hash, double value)
+{
+  metric_id_t id = resolve_leaf(ctx, path_len, hash, METRIC_TYPE_NUMBER);
+  if (id != METRIC_ID_INVALID)
+  {
+    ctx->frame->values[id] = (float)value;
+    metric_frame_mark_updated(ctx->frame, id);
+  }
+}
+
+static bool parse_object_members(cursor_t *c, parse_ctx_t *ctx, size_t path_len, uint32_t hash, int depth)
+{
+  c->p++;
+  skip_ws(c);
+  if (peek(c) == '}')
+  {
+    c->p++;
+    return true;
+  }
+
+  for (;;)
+  {
+    uint32_t key_hash = hash;
+    size_t key_pos = path_len;
+    size_t key_len;
+
+    skip_ws(c);
+    if (peek(c) != '"')
+      return false;
+
+    if (path_len > 0)
+      key_pos = path_append(ctx, path_len, ".", 1, &key_hash);
+
+    char *out = key_pos < METRIC_PATH_LEN ? &ctx->path[key_pos] : NULL;
+    if (!parse_string(c, out, METRIC_PATH_LEN - key_pos, &key_hash, &key_len))
+      return false;
+
+    skip_ws(c);
+    if (peek(c) != ':')
+      return false;
+    c->p++;
+    skip_ws(c);
+
+    bool ok;
+    if (depth == 0 && key_hash == KEY_TS && (peek(c) == '-' || is_digit(peek(c))))
+    {
+      double ts;
+      ok = parse_number(c, &ts);
+      if (ok && ts >= 0)
+      {
+        ctx->frame->timestamp = (uint64_t)ts;
+        ctx->has_ts = true;
+      }
+    }
+    else
+    {
+      ok = parse_value(c, ctx, key_pos + key_len, key_hash, depth + 1);
+    }
+    if (!ok)
+      return false;
+
+    skip_ws(c);
+    if (peek(c) == ',')
+    {
+      c->p++;
+      continue;
+    }
+    if (peek(c) == '}')
+    {
+      c->p++;
+      return true;
+    }
+    return false;
+  }
+}
+
+static bool parse_array_elements(cursor_t *c, parse_ctx_t *ctx, size_t path_len, uint32_t hash, int depth)
+{
+  c->p++;
+  skip_ws(c);
+  if (peek(c) == ']')
+  {
+    c->p++;
+    return true;
+  }
+
+  for (unsigned index = 0;; index++)
+  {
+    char digits[10];
+    size_t n = sizeof(digits);
+    unsigned v = index;
+    do
+    {
+      digits[--n] = (char)('0' + v % 10);
+      v /= 10;
+    } while (v > 0);
+
+    uint32_t elem_hash = hash;
+    size_t elem_len = path_append(ctx, path_len, ".", 1, &elem_hash);
+    elem_len = path_append(ctx, elem_len, &digits[n], sizeof(digits) - n, &elem_hash);
+
+    skip_ws(c);
+    if (!parse_value(c, ctx, elem_len, elem_hash, depth + 1))
+      return false;
+
+    skip_ws(c);
+    if (peek(c) == ',')
+    {
+      c->p++;
+      continue;
+    }
+    if (peek(c) == ']')
+    {
+      c->p++;
+      return true;
+    }
+    return false;
+  }
+}
+
+/**
+ * @brief Parse any value at the current path, storing leaves as metrics
+ * @param c Cursor positioned on the value
+ * @param ctx Parse context; ctx->path holds the first path_len bytes of the path
+ * @param path_len Virtual path length (may exceed the buffer, then nothing registers)
+ * @param hash FNV-1a hash of the full path
+ * @param depth Current nesting depth
+ */
+static bool parse_value(cursor_t *c, parse_ctx_t *ctx, size_t path_len, uint32_t hash, int depth)
+{
+  if (depth > MAX_NESTING_DEPTH)
+  {
+    return false;
+  }
+
+  switch (peek(c))
+  {
+  case '{':
+    return parse_object_members(c, ctx, path_len, hash, depth);
+
+  case '[':
+    return parse_array_elements(c, ctx, path_len, hash, depth);
+
+  case '"':
+  {
+    metric_id_t id = resolve_leaf(ctx, path_len, hash, METRIC_TYPE_STRING);
+    const metric_desc_t *desc = metric_registry_get(id);
+    if (desc == NULL)
+    {
+      return parse_string(c, NULL, 0, NULL, NULL);
+    }
+    metric_frame_mark_updated(ctx->frame, id);
+    return parse_string(c, ctx->frame->strings[desc->slot], METRIC_STRING_LEN, NULL, NULL);
+  }
+
+  case 't':
+    if (!match_literal(c, "true", 4))
+      return false;
+    store_number(ctx, path_len, hash, 1);
+    return true;
+
+  case 'f':
+    if (!match_literal(c, "false", 5))
+      return false;
+    store_number(ctx, path_len, hash, 0);
+    return true;
+
+  case 'n':
+    return match_literal(c, "null", 4);
+
+  default:
+  {
+    double value;
+    if (!parse_number(c, &value))
+      return false;
+    store_number(ctx, path_len, hash, value);
+    return true;
+  }
+  }
+}
+
+/**
+ * @brief Parse the whole text into ctx->frame
+ */
+static bool parse_document(const char *json, size_t len, parse_ctx_t *ctx)
+{
+  cursor_t c = {.p = json, .end = json + len};
+
+  skip_ws(&c);
+  if (peek(&c) != '{' || !parse_value(&c, ctx, 0, METRIC_HASH_INIT, 0))
+  {
+    return false;
+  }
+
+  // Nothing but whitespace may follow the closing brace
+  skip_ws(&c);
+  return c.p == c.end;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+bool telemetry_parse_json(const char *json, size_t len, metric_frame_t *frame)
+{
+  static metric_frame_t work; // Only the serial task parses; keeps the copy off the stack
+  parse_ctx_t ctx = {.frame = &work};
+
+  memcpy(&work, frame, sizeof(work));
+  memset(work.updated, 0, sizeof(work.updated));
+  if (!parse_document(json, len, &ctx))
+  {
+    return false;
+  }
+
+  if (ctx.has_new)
+  {
+    // The line is valid: parse it again, this time registering its new paths
+    memcpy(&work, frame, sizeof(work));
+    memset(work.updated, 0, sizeof(work.updated));
+    ctx = (parse_ctx_t){.frame = &work, .register_new = true};
+    parse_document(json, len, &ctx);
+  }
+
+  if (!ctx.has_ts)
+  {
+    work.timestamp = (uint64_t)time(NULL) * 1000; // Current time in ms
+  }
+  work.count = metric_registry_count();
+
+  memcpy(frame, &work, sizeof(*frame));
+  return true;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file telemetry_parser.h
+ * @brief Allocation-free JSON parser for the telemetry schema
+ *
+ * Single-pass tokenizer for the payload sent by the host monitor. Every
+ * leaf value is stored under its dotted path in the metric registry, so new
+ * metrics (per-core CPU, extra GPUs, disks, ...) need no firmware changes.
+ * Keys are resolved by FNV-1a hash instead of string comparison. No heap
+ * memory is used, so long runs do not fragment the internal heap.
+ */
+
+#pragma once
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "metric_registry.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION PROTOTYPES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Parse one telemetry JSON object into a metric frame
+ * @param json JSON text (need not be NUL-terminated)
+ * @param len Length of the JSON text in bytes
+ * @param frame Frame to update; new paths are registered once the whole
+ *              text has validated, and metrics missing from the payload
+ *              keep their previous values; frame->updated marks the ones
+ *              the payload carried
+ * @return true if the text is one valid JSON object (surrounding whitespace
+ *         allowed), false otherwise
+ * @note frame is only modified when parsing succeeds. Serial task only.
+ */
+bool telemetry_parse_json(const char *json, size_t len, metric_frame_t *frame);
@@ -4,15 +4,39 @@
  *
  * This module implements HTTP client functionality for Home Assistant REST API.
  *
+ * All requests share one esp_http_client handle. HTTP/1.1 connections are
+ * persistent by default, so keeping the handle alive keeps the connection
+ * open: the DNS lookup, TCP handshake and buffer allocation happen once per
+ * connection instead of once per request. (TCP keep-alive probes are a
+ * different thing and stay off.) A mutex serializes the callers
+ * (HA task, UI actions) on that handle. After a failed attempt the handle
+ * is torn down, and the next attempt reconnects from scratch.
+ *
+ * HA closes idle connections, and the client only finds out when it sends
+ * the next request. An attempt on a reused connection that fails before
+ * any response arrives is therefore resent at once on a new connection:
+ * no backoff, no retry used up, not counted as a failure.
+ *
+ * Responses are requested with gzip encoding. A compressed body is
+ * inflated chunk by chunk (ha_gzip) and the output goes to the same place
+ * an uncompressed body would: the streaming parser or the buffer.
+ *
  * @author System Monitor Dashboard
  * @date 2025-08-14
  */
 
 #include "ha_api.h"
+#include "ha_gzip.h"
+#include "ha_states_parser.h"
 #include "smart_config.h"
+#include <esp_heap_caps.h>
 #include <esp_log.h>
 #include <esp_http_client.h>
+#include <esp_timer.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include <string.h>
+#include <strings.h>
 #include <stdio.h>
 
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -28,6 +52,22 @@ static const char *TAG = "HA_API";
 #define AUTH_HEADER_TEMPLATE "Bearer %s"
 #define CONTENT_TYPE_JSON "application/json"
 
+/** Reuse one connection for all requests (0 = new connection per request, for comparison) */
+#ifndef HA_HTTP_REUSE_CONNECTION
+#define HA_HTTP_REUSE_CONNECTION 1
+#endif
+
+/** Ask for gzip-encoded responses and inflate them as they stream in */
+#ifndef HA_HTTP_GZIP
+#define HA_HTTP_GZIP 1
+#endif
+
+/** Latencies kept for the median */
+#define HA_LATENCY_SAMPLES 32
+
+/** Requests between latency summaries in the log */
+#define HA_STATS_LOG_INTERVAL 20
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // PRIVATE VARIABLES
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -35,41 +75,124 @@ static const char *TAG = "HA_API";
 static bool ha_api_initialized = false;
 static char auth_header[256];
 
+// Shared client, owned by whoever holds client_lock
+static SemaphoreHandle_t client_lock = NULL;
+static esp_http_client_handle_t client = NULL;
+static ha_gzip_t *gzip = NULL; ///< NULL if compression is off or out of memory
+
+// Receives the states service calls report back (set once, before calls start)
+static const char *const *listener_ids = NULL;
+static int listener_count = 0;
+static ha_api_state_cb_t listener_cb = NULL;
+
+// Request statistics (client_lock)
+static ha_api_stats_t stats;
+static uint32_t latency_ms[HA_LATENCY_SAMPLES];
+static uint32_t latency_count = 0;
+
+/**
+ * @brief What the event handler does with one request's body
+ */
+typedef struct
+{
+  ha_api_response_t *response; ///< Status and error; body buffered here unless streamed
+  ha_states_parser_t *parser;  ///< Streaming parser fed each chunk instead (optional)
+  bool truncated;              ///< Buffered body exceeded HA_MAX_RESPONSE_SIZE
+  bool gzip;                   ///< Body is gzip-encoded and goes through the decoder first
+  bool responded;              ///< Any part of a response (headers or body) arrived
+} request_ctx_t;
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // PRIVATE FUNCTION DECLARATIONS
 // ═══════════════════════════════════════════════════════════════════════════════
 
 static esp_err_t http_event_handler(esp_http_client_event_t *evt);
-static esp_http_client_handle_t create_http_client(const char *url);
-static esp_err_t perform_http_request(const char *url, const char *method, const char *post_data, ha_api_response_t *response);
+static esp_http_client_handle_t create_http_client(void);
+static esp_err_t perform_http_request(const char *url, const char *method, const char *post_data,
+                                      ha_api_response_t *response, ha_states_parser_t *parser);
 
 // ═══════════════════════════════════════════════════════════════════════════════
 // PRIVATE FUNCTION IMPLEMENTATIONS
 // ═══════════════════════════════════════════════════════════════════════════════
 
+/**
+ * @brief Hand a piece of the (decoded) body to the parser or the buffer
+ * @note Also the gzip sink, so it takes the request_ctx_t as void *
+ */
+static void deliver_body(void *user_data, const char *data, size_t len)
+{
+  request_ctx_t *ctx = (request_ctx_t *)user_data;
+  ha_api_response_t *response = ctx->response;
+
+  stats.body_bytes += len;
+
+  if (ctx->parser)
+  {
+    // Streamed: nothing is buffered, the parser keeps only what it needs
+    ha_states_parser_feed(ctx->parser, data, len);
+  }
+  else if (response)
+  {
+    if (response->response_data == NULL)
+    {
+      response->response_data = malloc(HA_MAX_RESPONSE_SIZE);
+      response->response_len = 0;
+    }
+
+    if (response->response_data && (response->response_len + len) < HA_MAX_RESPONSE_SIZE)
+    {
+      memcpy(response->response_data + response->response_len, data, len);
+      response->response_len += len;
+      response->response_data[response->response_len] = '\0';
+    }
+    else if (!ctx->truncated)
+    {
+      ctx->truncated = true;
+      ESP_LOGW(TAG, "Response larger than %d bytes, truncated", HA_MAX_RESPONSE_SIZE);
+    }
+  }
+}
+
 /**
  * @brief HTTP event handler for response data collection
  */
 static esp_err_t http_event_handler(esp_http_client_event_t *evt)
 {
-  ha_api_response_t *response = (ha_api_response_t *)evt->user_data;
+  request_ctx_t *ctx = (request_ctx_t *)evt->user_data;
+  ha_api_response_t *response = ctx ? ctx->response : NULL;
 
   switch (evt->event_id)
   {
+  case HTTP_EVENT_ON_CONNECTED:
+    stats.connections++;
+    break;
+
+  case HTTP_EVENT_ON_HEADER:
+    if (ctx)
+    {
+      ctx->responded = true;
+    }
+    // Only requested when the decoder exists, but check anyway
+    if (ctx && gzip && strcasecmp(evt->header_key, "Content-Encoding") == 0 && strstr(evt->header_value, "gzip"))
+    {
+      ctx->gzip = true;
+      ha_gzip_reset(gzip, deliver_body, ctx);
+    }
+    break;
+
   case HTTP_EVENT_ON_DATA:
-    if (response && evt->data_len > 0)
+    if (ctx && evt->data_len > 0)
     {
-      if (response->response_data == NULL)
+      ctx->responded = true;
+      stats.wire_bytes += evt->data_len;
+      if (ctx->gzip)
       {
-        response->response_data = malloc(HA_MAX_RESPONSE_SIZE);
-        response->response_len = 0;
+        // Errors stick in the decoder and are reported after the request
+        ha_gzip_feed(gzip, evt->data, evt->data_len);
       }
-
-      if (response->response_data && (response->response_len + evt->data_len) < HA_MAX_RESPONSE_SIZE)
+      else
       {
-        memcpy(response->response_data + response->response_len, evt->data, evt->data_len);
-        response->response_len += evt->data_len;
-        response->response_data[response->response_len] = '\0';
+        deliver_body(ctx, evt->data, evt->data_len);
       }
     }
     break;
@@ -98,12 +221,13 @@ static esp_err_t http_event_handler(esp_http_client_event_t *evt)
 }
 
 /**
- * @brief Create and configure HTTP client
+ * @brief Create the shared HTTP client
+ * @note The URL is only a placeholder; every request sets its own
  */
-static esp_http_client_handle_t create_http_client(const char *url)
+static esp_http_client_handle_t create_http_client(void)
 {
   esp_http_client_config_t config = {
-      .url = url,
+      .url = HA_API_BASE_URL,
       .event_handler = http_event_handler,
       .timeout_ms = HA_HTTP_TIMEOUT_MS,
       .user_agent = USER_AGENT,
@@ -111,13 +235,94 @@ static esp_http_client_handle_t create_http_client(const char *url)
       .buffer_size_tx = 1024,
   };
 
-  return esp_http_client_init(&config);
+  esp_http_client_handle_t new_client = esp_http_client_init(&config);
+  if (new_client)
+  {
+    esp_http_client_set_header(new_client, "Authorization", auth_header);
+    esp_http_client_set_header(new_client, "Content-Type", CONTENT_TYPE_JSON);
+    if (gzip)
+    {
+      esp_http_client_set_header(new_client, "Accept-Encoding", "gzip");
+    }
+  }
+  return new_client;
+}
+
+/**
+ * @brief Drop the shared client so the next request reconnects
+ */
+static void destroy_http_client(void)
+{
+  if (client)
+  {
+    esp_http_client_cleanup(client);
+    client = NULL;
+  }
+}
+
+/**
+ * @brief Record the latency of a completed request
+ */
+static void record_latency(uint32_t elapsed_ms)
+{
+  stats.requests++;
+  stats.total_ms += elapsed_ms;
+  if (elapsed_ms > stats.max_ms)
+  {
+    stats.max_ms = elapsed_ms;
+  }
+  latency_ms[latency_count++ % HA_LATENCY_SAMPLES] = elapsed_ms;
+
+  if (stats.requests % HA_STATS_LOG_INTERVAL == 0)
+  {
+    ha_api_stats_t snapshot;
+    ha_api_get_stats(&snapshot);
+    ESP_LOGI(TAG,
+             "HTTP: %lu requests over %lu connections (%lu found closed), median %lu ms, max %lu ms, "
+             "%lu.%02lu req/s busy",
+             snapshot.requests, snapshot.connections, snapshot.stale, snapshot.median_ms, snapshot.max_ms,
+             snapshot.requests * 1000 / (snapshot.total_ms ? snapshot.total_ms : 1),
+             snapshot.requests * 100000 / (snapshot.total_ms ? snapshot.total_ms : 1) % 100);
+    ESP_LOGI(TAG, "HTTP: %lu KB on air for %lu KB of JSON",
+             (unsigned long)(snapshot.wire_bytes / 1024), (unsigned long)(snapshot.body_bytes / 1024));
+  }
+}
+
+/**
+ * @brief Pass the states a service call reported to the listener
+ * @param tracked Leading entries of the parser's wanted set that belong to the listener
+ */
+static void report_service_states(const ha_states_parser_t *parser, const ha_entity_state_t *states, int tracked)
+{
+  if (parser->error)
+  {
+    ESP_LOGW(TAG, "Service response is not a state list, nothing to apply");
+    return;
+  }
+
+  uint32_t event_us = (uint32_t)esp_timer_get_time();
+  for (int i = 0; i < parser->wanted_count; i++)
+  {
+    if (!(parser->found & (1u << i)))
+    {
+      continue;
+    }
+
+    ESP_LOGI(TAG, "Service response: %s = %s", states[i].entity_id, states[i].state);
+    if (listener_cb && i < tracked)
+    {
+      listener_cb(states[i].entity_id, states[i].state, event_us);
+    }
+  }
 }
 
 /**
  * @brief Perform HTTP request with retry logic
+ * @param parser If set, the body is streamed into it instead of being buffered
+ *        in response; it is reinitialized for every attempt
  */
-static esp_err_t perform_http_request(const char *url, const char *method, const char *post_data, ha_api_response_t *response)
+static esp_err_t perform_http_request(const char *url, const char *method, const char *post_data,
+                                      ha_api_response_t *response, ha_states_parser_t *parser)
 {
   if (!ha_api_initialized)
   {
@@ -137,47 +342,104 @@ static esp_err_t perform_http_request(const char *url, const char *method, const
 
   for (int retry = 0; retry < HA_SYNC_RETRY_COUNT; retry++)
   {
-    esp_http_client_handle_t client = create_http_client(url);
+    xSemaphoreTake(client_lock, portMAX_DELAY);
+
+    // A handle that survived an earlier request holds a kept-alive connection
+    bool reused = client != NULL;
+    if (client == NULL)
+    {
+      client = create_http_client();
+    }
     if (client == NULL)
     {
+      xSemaphoreGive(client_lock);
       ESP_LOGE(TAG, "Failed to create HTTP client");
       continue;
     }
 
-    // Set headers
-    esp_http_client_set_header(client, "Authorization", auth_header);
-    esp_http_client_set_header(client, "Content-Type", CONTENT_TYPE_JSON);
+    esp_http_client_set_url(client, url);
 
-    // Set method
+    // Set method; a GET must not inherit the body of a previous POST
     if (strcmp(method, "POST") == 0)
     {
       esp_http_client_set_method(client, HTTP_METHOD_POST);
-      if (post_data)
-      {
-        esp_http_client_set_post_field(client, post_data, strlen(post_data));
-      }
+      esp_http_client_set_post_field(client, post_data, post_data ? strlen(post_data) : 0);
     }
     else
     {
       esp_http_client_set_method(client, HTTP_METHOD_GET);
+      esp_http_client_set_post_field(client, NULL, 0);
     }
 
     // Set user data for event handler
     if (response)
     {
       memset(response, 0, sizeof(ha_api_response_t));
-      esp_http_client_set_user_data(client, response);
     }
+    if (parser)
+    {
+      ha_states_parser_init(parser, parser->wanted, parser->wanted_count, parser->states);
+    }
+    request_ctx_t ctx = {.response = response, .parser = parser};
+    esp_http_client_set_user_data(client, &ctx);
 
     // Perform request
     ESP_LOGI(TAG, "Sending HTTP request (attempt %d/%d)...", retry + 1, HA_SYNC_RETRY_COUNT);
+    int64_t start_us = esp_timer_get_time();
     err = esp_http_client_perform(client);
+    uint32_t elapsed_ms = (uint32_t)((esp_timer_get_time() - start_us) / 1000);
 
     // Get status code for logging
     status_code = esp_http_client_get_status_code(client);
-    ESP_LOGI(TAG, "HTTP Status Code: %d", status_code);
+    ESP_LOGI(TAG, "HTTP Status Code: %d (%lu ms)", status_code, elapsed_ms);
 
-    esp_http_client_cleanup(client);
+    if (err == ESP_OK && ctx.gzip)
+    {
+      esp_err_t gzip_err = ha_gzip_finish(gzip);
+      if (gzip_err != ESP_OK)
+      {
+        ESP_LOGW(TAG, "Gzip body %s after %u bytes", gzip_err == ESP_ERR_INVALID_SIZE ? "cut short" : "corrupt",
+                 (unsigned)ha_gzip_output_size(gzip));
+        err = ESP_ERR_INVALID_RESPONSE;
+      }
+    }
+
+    // Nothing came back on a reused connection: the server had closed it
+    bool stale = err != ESP_OK && reused && !ctx.responded;
+
+    if (err == ESP_OK)
+    {
+#if !HA_HTTP_REUSE_CONNECTION
+      destroy_http_client();
+#endif
+      record_latency(elapsed_ms);
+    }
+    else
+    {
+      // The connection state is unknown: reconnect on the next attempt
+      destroy_http_client();
+      if (stale)
+      {
+        stats.stale++;
+      }
+      else
+      {
+        stats.failures++;
+      }
+    }
+    if (client)
+    {
+      esp_http_client_set_user_data(client, NULL); // ctx goes out of scope
+    }
+    xSemaphoreGive(client_lock);
+
+    if (stale)
+    {
+      // The next attempt runs on a new connection, so this happens at most once
+      ESP_LOGI(TAG, "Reused connection was closed (%s), resending on a new one", esp_err_to_name(err));
+      retry--;
+      continue;
+    }
 
     if (err == ESP_OK)
     {
@@ -252,6 +514,26 @@ esp_err_t ha_api_init(void)
 
   ESP_LOGI(TAG, "Authorization header formatted successfully");
 
+  if (client_lock == NULL)
+  {
+    client_lock = xSemaphoreCreateMutex();
+    if (client_lock == NULL)
+    {
+      ESP_LOGE(TAG, "Failed to create HTTP client mutex");
+      return ESP_ERR_NO_MEM;
+    }
+  }
+
+  // Kept across deinit like the mutex; about 43 KB of PSRAM
+  if (HA_HTTP_GZIP && gzip == NULL)
+  {
+    gzip = ha_gzip_create();
+    if (gzip == NULL)
+    {
+      ESP_LOGW(TAG, "No memory for the gzip decoder, responses will be uncompressed");
+    }
+  }
+
   ha_api_initialized = true;
 
   ESP_LOGI(TAG, "Home Assistant API client initialized (Server: %s:%d)",
@@ -270,7 +552,10 @@ esp_err_t ha_api_deinit(void)
 
   ESP_LOGI(TAG, "Deinitializing Home Assistant API client");
 
+  xSemaphoreTake(client_lock, portMAX_DELAY);
+  destroy_http_client();
   ha_api_initialized = false;
+  xSemaphoreGive(client_lock);
   memset(auth_header, 0, sizeof(auth_header));
 
   return ESP_OK;
@@ -281,7 +566,7 @@ esp_err_t ha_api_test_connection(void)
   ESP_LOGI(TAG, "Testing connection to Home Assistant...");
 
   ha_api_response_t response;
-  esp_err_t err = perform_http_request(HA_API_BASE_URL, "GET", NULL, &response);
+  esp_err_t err = perform_http_request(HA_API_BASE_URL, "GET", NULL, &response, NULL);
 
   if (err == ESP_OK && response.success)
   {
@@ -307,7 +592,7 @@ esp_err_t ha_api_get_entity_state(const char *entity_id, ha_entity_state_t *stat
   snprintf(url, sizeof(url), "%s/%s", HA_API_STATES_URL, entity_id);
 
   ha_api_response_t response;
-  esp_err_t err = perform_http_request(url, "GET", NULL, &response);
+  esp_err_t err = perform_http_request(url, "GET", NULL, &response, NULL);
 
   if (err == ESP_OK && response.success)
   {
@@ -320,7 +605,7 @@ esp_err_t ha_api_get_entity_state(const char *entity_id, ha_entity_state_t *stat
 
 esp_err_t ha_api_get_multiple_entity_states(const char **entity_ids, int entity_count, ha_entity_state_t *states)
 {
-  if (!entity_ids || !states || entity_count <= 0)
+  if (!entity_ids || !states || entity_count <= 0 || entity_count > HA_STATES_PARSER_MAX_WANTED)
   {
     return ESP_ERR_INVALID_ARG;
   }
@@ -331,98 +616,46 @@ esp_err_t ha_api_get_multiple_entity_states(const char **entity_ids, int entity_
   char url[128];
   snprintf(url, sizeof(url), "%s", HA_API_STATES_URL);
 
+  // Stream the response through the parser: it can be megabytes on large
+  // installations, and only a handful of entities are wanted
+  ha_states_parser_t parser = {
+      .wanted = entity_ids,
+      .wanted_count = entity_count,
+      .states = states,
+  };
   ha_api_response_t response;
-  esp_err_t err = perform_http_request(url, "GET", NULL, &response);
+  esp_err_t err = perform_http_request(url, "GET", NULL, &response, &parser);
 
   if (err == ESP_OK && response.success)
   {
-    // Parse JSON response to extract our entities
-    cJSON *json = cJSON_Parse(response.response_data);
-    if (json)
-    {
-      // Clear all states first
-      memset(states, 0, sizeof(ha_entity_state_t) * entity_count);
-
-      int found_count = 0;
-      int processed_count = 0;
-      const int MAX_ENTITIES_TO_PROCESS = 100; // Safety limit to prevent memory issues
-
-      // Iterate through the response array to find our entities
-      cJSON *entity_json = NULL;
-      cJSON_ArrayForEach(entity_json, json)
-      {
-        // Safety check to prevent processing too many entities
-        if (++processed_count > MAX_ENTITIES_TO_PROCESS)
-        {
-          ESP_LOGW(TAG, "Reached maximum entity processing limit (%d), stopping search", MAX_ENTITIES_TO_PROCESS);
-          break;
-        }
-        cJSON *entity_id_json = cJSON_GetObjectItem(entity_json, "entity_id");
-        if (cJSON_IsString(entity_id_json))
-        {
-          const char *entity_id = entity_id_json->valuestring;
-
-          // Check if this entity is in our requested list
-          for (int i = 0; i < entity_count; i++)
-          {
-            if (strcmp(entity_id, entity_ids[i]) == 0)
-            {
-              // Parse entity state directly from JSON object to avoid memory allocation
-              cJSON *state_json = cJSON_GetObjectItem(entity_json, "state");
-              if (cJSON_IsString(state_json))
-              {
-                // Clear the state structure
-                memset(&states[i], 0, sizeof(ha_entity_state_t));
-
-                // Copy entity ID and state
-                strncpy(states[i].entity_id, entity_id, HA_MAX_ENTITY_ID_LEN - 1);
-                strncpy(states[i].state, state_json->valuestring, HA_MAX_STATE_LEN - 1);
-                states[i].entity_id[HA_MAX_ENTITY_ID_LEN - 1] = '\0';
-                states[i].state[HA_MAX_STATE_LEN - 1] = '\0';
-
-                found_count++;
-                ESP_LOGD(TAG, "Found state for %s: %s", entity_id, states[i].state);
-              }
-              else
-              {
-                ESP_LOGW(TAG, "Entity %s has no valid state", entity_id);
-              }
-              break;
-            }
-          }
-
-          // Early exit if we found all entities
-          if (found_count >= entity_count)
-          {
-            ESP_LOGI(TAG, "Found all %d entities, stopping search early", entity_count);
-            break;
-          }
-        }
-      }
-
-      cJSON_Delete(json);
+    int found_count = ha_states_parser_found_count(&parser);
+    ESP_LOGI(TAG, "Scanned %lu entities in %u bytes", parser.entities, (unsigned)parser.bytes);
 
-      if (found_count == entity_count)
-      {
-        ESP_LOGI(TAG, "Successfully fetched all %d entity states", entity_count);
-        err = ESP_OK;
-      }
-      else if (found_count > 0)
-      {
-        ESP_LOGW(TAG, "Found only %d/%d entity states", found_count, entity_count);
-        err = ESP_ERR_NOT_FOUND;
-      }
-      else
-      {
-        ESP_LOGE(TAG, "No matching entities found");
-        err = ESP_ERR_NOT_FOUND;
-      }
-    }
-    else
+    if (parser.error)
     {
       ESP_LOGE(TAG, "Failed to parse bulk states response");
       err = ESP_ERR_INVALID_RESPONSE;
     }
+    else if (found_count == entity_count)
+    {
+      ESP_LOGI(TAG, "Successfully fetched all %d entity states", entity_count);
+      err = ESP_OK;
+    }
+    else if (found_count > 0)
+    {
+      ESP_LOGW(TAG, "Found only %d/%d entity states", found_count, entity_count);
+      err = ESP_ERR_NOT_FOUND;
+    }
+    else
+    {
+      ESP_LOGE(TAG, "No matching entities found");
+      err = ESP_ERR_NOT_FOUND;
+    }
+  }
+  else if (err == ESP_OK)
+  {
+    ESP_LOGE(TAG, "Bulk states request returned status %d", response.status_code);
+    err = ESP_ERR_INVALID_RESPONSE;
   }
 
   ha_api_free_response(&response);
@@ -464,13 +697,48 @@ esp_err_t ha_api_call_service(const ha_service_call_t *service_call, ha_api_resp
   ha_api_response_t local_response;
   ha_api_response_t *resp = response ? response : &local_response;
 
-  esp_err_t err = perform_http_request(url, "POST", json_string, resp);
+  // The response lists the states the call changed: stream it through the
+  // parser and keep the listener's entities and the called one
+  const char *wanted[HA_SERVICE_STATES_MAX + 1];
+  int tracked = listener_count < HA_SERVICE_STATES_MAX ? listener_count : HA_SERVICE_STATES_MAX;
+  bool called_tracked = false;
+  for (int i = 0; i < tracked; i++)
+  {
+    wanted[i] = listener_ids[i];
+    called_tracked |= strcmp(listener_ids[i], service_call->entity_id) == 0;
+  }
+  int wanted_count = tracked;
+  if (!called_tracked)
+  {
+    wanted[wanted_count++] = service_call->entity_id;
+  }
+
+  // Full ha_entity_state_t is ~5 KB each; keep them off the caller's stack
+  ha_entity_state_t *states = heap_caps_malloc(sizeof(ha_entity_state_t) * wanted_count, MALLOC_CAP_SPIRAM);
+  ha_states_parser_t parser;
+  if (states)
+  {
+    ha_states_parser_init(&parser, wanted, wanted_count, states);
+  }
+
+  esp_err_t err = perform_http_request(url, "POST", json_string, resp, states ? &parser : NULL);
 
-  if (err == ESP_OK && resp->success)
+  if (err == ESP_OK && !resp->success)
+  {
+    // HA answered, but refused the call (unknown entity or service, bad token...)
+    snprintf(resp->error_message, sizeof(resp->error_message), "HTTP status %d", resp->status_code);
+    err = ESP_ERR_INVALID_RESPONSE;
+  }
+
+  if (err == ESP_OK)
   {
     ESP_LOGI(TAG, "=== SERVICE CALL SUCCESS ===");
     ESP_LOGI(TAG, "Service %s.%s executed successfully for %s",
              service_call->domain, service_call->service, service_call->entity_id);
+    if (states)
+    {
+      report_service_states(&parser, states, tracked);
+    }
   }
   else
   {
@@ -481,6 +749,7 @@ esp_err_t ha_api_call_service(const ha_service_call_t *service_call, ha_api_resp
   }
 
   // Cleanup
+  heap_caps_free(states);
   free(json_string);
   cJSON_Delete(json);
 
@@ -492,6 +761,13 @@ esp_err_t ha_api_call_service(const ha_service_call_t *service_call, ha_api_resp
   return err;
 }
 
+void ha_api_set_state_listener(const char *const *entity_ids, int count, ha_api_state_cb_t cb)
+{
+  listener_ids = entity_ids;
+  listener_count = entity_ids ? count : 0;
+  listener_cb = cb;
+}
+
 esp_err_t ha_api_toggle_switch(const char *entity_id)
 {
   ha_service_call_t service_call = {
@@ -640,6 +916,27 @@ esp_err_t ha_api_parse_entity_state(const char *json_str, ha_entity_state_t *sta
   return ESP_OK;
 }
 
+void ha_api_get_stats(ha_api_stats_t *out)
+{
+  // Insertion sort of the recent latencies for the median
+  uint32_t sorted[HA_LATENCY_SAMPLES];
+  uint32_t count = latency_count < HA_LATENCY_SAMPLES ? latency_count : HA_LATENCY_SAMPLES;
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    uint32_t value = latency_ms[i];
+    uint32_t j = i;
+    for (; j > 0 && sorted[j - 1] > value; j--)
+    {
+      sorted[j] = sorted[j - 1];
+    }
+    sorted[j] = value;
+  }
+
+  *out = stats;
+  out->median_ms = count ? sorted[count / 2] : 0;
+}
+
 void ha_api_free_response(ha_api_response_t *response)
 {
   if (response && response->response_data)
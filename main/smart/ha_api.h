@@ -10,7 +10,7 @@
  * - Entity state reading and writing
  * - Service calls (switch toggle, etc.)
  * - JSON response parsing
- * - Connection pooling and retry logic
+ * - Persistent (reused) HTTP connection and retry logic
  *
  * @author System Monitor Dashboard
  * @date 2025-08-14
@@ -46,6 +46,9 @@ extern "C"
 /** Maximum number of attributes per entity */
 #define HA_MAX_ATTRIBUTES 16
 
+/** Entities whose states are picked out of a service-call response */
+#define HA_SERVICE_STATES_MAX 8
+
   // ═══════════════════════════════════════════════════════════════════════════════
   // DATA STRUCTURES
   // ═══════════════════════════════════════════════════════════════════════════════
@@ -96,6 +99,30 @@ extern "C"
     cJSON *service_data;                  ///< Additional service data (optional)
   } ha_service_call_t;
 
+  /**
+   * @brief HTTP client statistics
+   */
+  typedef struct
+  {
+    uint32_t requests;    ///< Successful requests
+    uint32_t failures;    ///< Failed attempts (each one forces a reconnect)
+    uint32_t stale;       ///< Reused connections found closed, resent at once (not failures)
+    uint32_t connections; ///< TCP connections opened
+    uint32_t total_ms;    ///< Summed latency of successful requests
+    uint32_t max_ms;      ///< Slowest successful request
+    uint32_t median_ms;   ///< Median latency of the last 32 successful requests
+    uint64_t wire_bytes;  ///< Response body bytes received, compressed or not
+    uint64_t body_bytes;  ///< Response body bytes after decompression
+  } ha_api_stats_t;
+
+  /**
+   * @brief Receives an entity state reported by Home Assistant
+   * @param entity_id Entity whose state was reported
+   * @param state New state (e.g. "on", "off", "unavailable")
+   * @param event_us Low 32 bits of esp_timer_get_time() when the response arrived
+   */
+  typedef void (*ha_api_state_cb_t)(const char *entity_id, const char *state, uint32_t event_us);
+
   // ═══════════════════════════════════════════════════════════════════════════════
   // PUBLIC FUNCTION DECLARATIONS
   // ═══════════════════════════════════════════════════════════════════════════════
@@ -143,6 +170,9 @@ extern "C"
    * @brief Get states of multiple entities in bulk
    *
    * Retrieves current states for multiple entities efficiently using the bulk states API.
+   * The response is parsed as it streams in (see ha_states_parser.h), so its
+   * size is not limited by HA_MAX_RESPONSE_SIZE. Only entity_id, state and
+   * last_changed are filled in.
    *
    * @param entity_ids Array of entity IDs to query
    * @param entity_count Number of entities to query
@@ -151,14 +181,35 @@ extern "C"
    */
   esp_err_t ha_api_get_multiple_entity_states(const char **entity_ids, int entity_count, ha_entity_state_t *states);
 
+  /**
+   * @brief Register the entities whose states service calls report back
+   *
+   * HA answers a service call with the list of states the call changed.
+   * States of the registered entities are passed to the callback as soon
+   * as the response is in, so a toggle is confirmed within one round trip.
+   * The callback runs in the task that made the call, before
+   * ha_api_call_service() returns.
+   *
+   * @param entity_ids Entity IDs, kept by reference; at most
+   *        HA_SERVICE_STATES_MAX are used
+   * @param count Number of entity IDs
+   * @param cb Callback, or NULL to stop reporting
+   * @note Call once after ha_api_init(), before service calls start
+   */
+  void ha_api_set_state_listener(const char *const *entity_ids, int count, ha_api_state_cb_t cb);
+
   /**
    * @brief Call a Home Assistant service
    *
-   * Executes a service call (like turning on/off a switch).
+   * Executes a service call (like turning on/off a switch). The response
+   * (the states the call changed) is parsed as it streams in and is not
+   * buffered: response->response_data stays NULL. See
+   * ha_api_set_state_listener() for where those states go.
    *
    * @param service_call Service call configuration
    * @param response Response structure (optional, can be NULL)
-   * @return ESP_OK on success, error code on failure
+   * @return ESP_OK on success; ESP_ERR_INVALID_RESPONSE if HA answered with
+   *         an error status; another error code if the request failed
    */
   esp_err_t ha_api_call_service(const ha_service_call_t *service_call, ha_api_response_t *response);
 
@@ -240,6 +291,17 @@ extern "C"
    */
   esp_err_t ha_api_parse_entity_state(const char *json_str, ha_entity_state_t *state);
 
+  /**
+   * @brief Get HTTP client statistics
+   *
+   * Requests per connection shows how well connection reuse works;
+   * requests * 1000 / total_ms is the throughput while busy.
+   *
+   * @param out Receives the statistics
+   * @note Read from the task issuing requests; other tasks may see a torn snapshot
+   */
+  void ha_api_get_stats(ha_api_stats_t *out);
+
   /**
    * @brief Free API response resources
    *
@@ -0,0 +1,333 @@
+/**
+ * @file ha_command.c
+ * @brief Non-blocking command pipeline for switch and scene actions
+ *
+ * Pending work is one slot per switch plus a scene flag, not a FIFO: a new
+ * request overwrites the desired state in its slot, which is what coalesces
+ * rapid toggles. Producers update the slots under a spinlock and notify the
+ * worker, which takes one command at a time and calls Home Assistant
+ * without the lock held.
+ *
+ * @author System Monitor Dashboard
+ * @date 2025-08-14
+ */
+
+#include "ha_command.h"
+#include "smart_config.h"
+#include "smart_home.h"
+#include "../lvgl/system_monitor_ui.h"
+#include <esp_log.h>
+#include <esp_timer.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static const char *TAG = "HA_CMD";
+
+/** Above the HA polling task (1), below LVGL */
+#define HA_COMMAND_TASK_PRIORITY 2
+
+/** Internal RAM stack (lwIP requirement), enough for one service call */
+#define HA_COMMAND_TASK_STACK_SIZE 8192
+
+/** Commands between summaries in the log */
+#define HA_COMMAND_LOG_INTERVAL 10
+
+/** Confirmed state not known yet */
+#define STATE_UNKNOWN -1
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Command state of one switch
+ */
+typedef struct
+{
+  const char *entity_id;
+  bool desired;       ///< Latest requested state
+  bool pending;       ///< desired has not been taken by the worker yet
+  bool in_flight;     ///< The worker is calling HA for this switch
+  int8_t confirmed;   ///< Last state HA confirmed (0/1), or STATE_UNKNOWN
+  int8_t acked;       ///< State HA returned for the in-flight call, or STATE_UNKNOWN
+  uint32_t submit_us; ///< First submission of the pending command
+} switch_slot_t;
+
+/**
+ * @brief One command taken by the worker
+ */
+typedef struct
+{
+  int index;          ///< Switch index, or -1 for the scene
+  bool state;
+  uint32_t submit_us;
+} command_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE VARIABLES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static TaskHandle_t worker_handle = NULL;
+
+// Everything below is guarded by slot_lock
+static portMUX_TYPE slot_lock = portMUX_INITIALIZER_UNLOCKED;
+static switch_slot_t slots[HA_COMMAND_SWITCH_COUNT] = {
+    {.entity_id = HA_ENTITY_A, .confirmed = STATE_UNKNOWN, .acked = STATE_UNKNOWN},
+    {.entity_id = HA_ENTITY_B, .confirmed = STATE_UNKNOWN, .acked = STATE_UNKNOWN},
+    {.entity_id = HA_ENTITY_C, .confirmed = STATE_UNKNOWN, .acked = STATE_UNKNOWN},
+};
+static bool scene_pending = false;
+static uint32_t scene_submit_us = 0;
+static ha_command_stats_t stats;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Take the next command worth sending
+ * @return false once nothing is pending
+ */
+static bool take_command(command_t *cmd)
+{
+  bool found = false;
+
+  taskENTER_CRITICAL(&slot_lock);
+  for (int i = 0; i < HA_COMMAND_SWITCH_COUNT && !found; i++)
+  {
+    switch_slot_t *slot = &slots[i];
+    if (!slot->pending)
+      continue;
+
+    slot->pending = false;
+    // Toggled back to what HA already has: nothing to send
+    if (slot->confirmed == slot->desired)
+      continue;
+
+    slot->in_flight = true;
+    slot->acked = STATE_UNKNOWN;
+    cmd->index = i;
+    cmd->state = slot->desired;
+    cmd->submit_us = slot->submit_us;
+    found = true;
+  }
+  if (!found && scene_pending)
+  {
+    scene_pending = false;
+    cmd->index = -1;
+    cmd->submit_us = scene_submit_us;
+    found = true;
+  }
+  taskEXIT_CRITICAL(&slot_lock);
+
+  return found;
+}
+
+static void record_result(esp_err_t ret, uint32_t submit_us)
+{
+  uint32_t elapsed_ms = ((uint32_t)esp_timer_get_time() - submit_us) / 1000;
+
+  taskENTER_CRITICAL(&slot_lock);
+  stats.sent++;
+  if (ret != ESP_OK)
+    stats.failed++;
+  stats.total_ms += elapsed_ms;
+  if (elapsed_ms > stats.max_ms)
+    stats.max_ms = elapsed_ms;
+  ha_command_stats_t snapshot = stats;
+  taskEXIT_CRITICAL(&slot_lock);
+
+  if (snapshot.sent % HA_COMMAND_LOG_INTERVAL == 0)
+  {
+    ESP_LOGI(TAG, "Commands: %lu submitted, %lu sent, %lu failed, %lu rolled back, avg %lu ms, max %lu ms",
+             snapshot.submitted, snapshot.sent, snapshot.failed, snapshot.rolled_back,
+             snapshot.total_ms / snapshot.sent, snapshot.max_ms);
+  }
+}
+
+/**
+ * @brief Send one switch command and settle its slot
+ */
+static void run_switch_command(const command_t *cmd)
+{
+  switch_slot_t *slot = &slots[cmd->index];
+  esp_err_t ret = smart_home_control_switch(slot->entity_id, cmd->state);
+  record_result(ret, cmd->submit_us);
+
+  bool rollback = false;
+  bool revert_to = false;
+  bool corrected = false;
+
+  taskENTER_CRITICAL(&slot_lock);
+  slot->in_flight = false;
+  if (ret == ESP_OK)
+  {
+    // HA lists only the states a call changed: no entry means it already had cmd->state
+    slot->confirmed = slot->acked == STATE_UNKNOWN ? cmd->state : slot->acked;
+    corrected = !slot->pending && slot->confirmed != cmd->state;
+  }
+  else if (!slot->pending)
+  {
+    // A newer command supersedes this one; otherwise undo the optimistic state
+    rollback = true;
+    revert_to = slot->confirmed == STATE_UNKNOWN ? !cmd->state : slot->confirmed;
+    stats.rolled_back++;
+  }
+  taskEXIT_CRITICAL(&slot_lock);
+
+  if (ret != ESP_OK)
+  {
+    ESP_LOGW(TAG, "%s -> %s failed: %s%s", slot->entity_id, cmd->state ? "on" : "off", esp_err_to_name(ret),
+             rollback ? ", rolling back" : "");
+    system_monitor_ui_update_ha_status("Command failed", false);
+  }
+  if (rollback)
+  {
+    system_monitor_ui_set_switch_from_event(cmd->index, revert_to, 0);
+  }
+  if (corrected)
+  {
+    ESP_LOGW(TAG, "%s asked %s, HA reports %s", slot->entity_id, cmd->state ? "on" : "off",
+             cmd->state ? "off" : "on");
+    system_monitor_ui_set_switch_from_event(cmd->index, !cmd->state, 0);
+  }
+}
+
+static void run_scene_command(const command_t *cmd)
+{
+  esp_err_t ret = smart_home_trigger_scene();
+  record_result(ret, cmd->submit_us);
+
+  if (ret != ESP_OK)
+  {
+    ESP_LOGW(TAG, "Scene failed: %s", esp_err_to_name(ret));
+    system_monitor_ui_update_ha_status("Scene failed", false);
+  }
+}
+
+/**
+ * @brief Worker: sleep until notified, then drain every pending command
+ */
+static void command_task(void *pvParameters)
+{
+  command_t cmd;
+
+  while (1)
+  {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    while (take_command(&cmd))
+    {
+      if (cmd.index >= 0)
+        run_switch_command(&cmd);
+      else
+        run_scene_command(&cmd);
+    }
+  }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t ha_command_init(void)
+{
+  if (worker_handle)
+  {
+    return ESP_OK;
+  }
+
+  BaseType_t result = xTaskCreatePinnedToCore(command_task, "ha_cmd", HA_COMMAND_TASK_STACK_SIZE, NULL,
+                                              HA_COMMAND_TASK_PRIORITY, &worker_handle, tskNO_AFFINITY);
+  if (result != pdPASS)
+  {
+    worker_handle = NULL;
+    ESP_LOGE(TAG, "Failed to create command task");
+    return ESP_ERR_NO_MEM;
+  }
+
+  ESP_LOGI(TAG, "Command worker started (priority %d)", HA_COMMAND_TASK_PRIORITY);
+  return ESP_OK;
+}
+
+esp_err_t ha_command_set_switch(uint8_t index, bool state)
+{
+  if (index >= HA_COMMAND_SWITCH_COUNT)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (!worker_handle)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  taskENTER_CRITICAL(&slot_lock);
+  switch_slot_t *slot = &slots[index];
+  if (!slot->pending)
+  {
+    slot->submit_us = (uint32_t)esp_timer_get_time();
+  }
+  slot->desired = state;
+  slot->pending = true;
+  stats.submitted++;
+  taskEXIT_CRITICAL(&slot_lock);
+
+  xTaskNotifyGive(worker_handle);
+  return ESP_OK;
+}
+
+esp_err_t ha_command_trigger_scene(void)
+{
+  if (!worker_handle)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  taskENTER_CRITICAL(&slot_lock);
+  if (!scene_pending)
+  {
+    scene_submit_us = (uint32_t)esp_timer_get_time();
+  }
+  scene_pending = true;
+  stats.submitted++;
+  taskEXIT_CRITICAL(&slot_lock);
+
+  xTaskNotifyGive(worker_handle);
+  return ESP_OK;
+}
+
+void ha_command_report_state(uint8_t index, bool state, uint32_t event_us)
+{
+  if (index >= HA_COMMAND_SWITCH_COUNT)
+  {
+    return;
+  }
+
+  taskENTER_CRITICAL(&slot_lock);
+  switch_slot_t *slot = &slots[index];
+  slot->confirmed = state;
+  if (slot->in_flight && xTaskGetCurrentTaskHandle() == worker_handle)
+  {
+    // From the response to the worker's own call: HA's answer to this command
+    slot->acked = state;
+  }
+  bool busy = slot->pending || slot->in_flight;
+  taskEXIT_CRITICAL(&slot_lock);
+
+  // The widget shows the user's latest choice until that command settles
+  if (!busy)
+  {
+    system_monitor_ui_set_switch_from_event(index, state, event_us);
+  }
+}
+
+void ha_command_get_stats(ha_command_stats_t *out)
+{
+  taskENTER_CRITICAL(&slot_lock);
+  *out = stats;
+  taskEXIT_CRITICAL(&slot_lock);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file ha_command.h
+ * @brief Non-blocking command pipeline for switch and scene actions
+ *
+ * Touch handlers run in the LVGL task with the LVGL lock held, so they must
+ * not wait on Home Assistant. They submit the desired state here and return
+ * at once; the widget already shows the new state (optimistic update). A
+ * worker task sends the service calls.
+ *
+ * Commands are coalesced per switch: only the latest desired state is kept,
+ * and a switch toggled back to the state HA last confirmed sends nothing.
+ * Repeated scene presses collapse into one call. If a call fails and no
+ * newer command is pending for that switch, the widget is rolled back to the
+ * last confirmed state.
+ *
+ * The worker runs above the polling task's priority. ha_api serializes
+ * requests on a mutex with priority inheritance, so a command waits for at
+ * most the one poll request already on the wire.
+ *
+ * States received from HA (WebSocket push, REST poll or the state list a
+ * service call returns) go through ha_command_report_state(). It records
+ * the confirmed state and holds the UI update back while a command for
+ * that switch is pending or in flight, so a stale poll does not undo a
+ * fresh touch. The state returned by the worker's own call settles the
+ * command: if HA did not end up where the user asked, the widget follows
+ * HA.
+ *
+ * @author System Monitor Dashboard
+ * @date 2025-08-14
+ */
+
+#ifndef HA_COMMAND_H
+#define HA_COMMAND_H
+
+#include <esp_err.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/** Switches handled, in UI order (A, B, C) */
+#define HA_COMMAND_SWITCH_COUNT 3
+
+  // ═══════════════════════════════════════════════════════════════════════════════
+  // DATA STRUCTURES
+  // ═══════════════════════════════════════════════════════════════════════════════
+
+  /**
+   * @brief Command counters
+   */
+  typedef struct
+  {
+    uint32_t submitted;   ///< Switch changes and scene presses submitted
+    uint32_t sent;        ///< Service calls made
+    uint32_t failed;      ///< Service calls that failed
+    uint32_t rolled_back; ///< Widgets reverted after a failure
+    uint32_t total_ms;    ///< Summed submit-to-ack latency of sent calls
+    uint32_t max_ms;      ///< Slowest submit-to-ack latency
+  } ha_command_stats_t;
+
+  // ═══════════════════════════════════════════════════════════════════════════════
+  // PUBLIC FUNCTION DECLARATIONS
+  // ═══════════════════════════════════════════════════════════════════════════════
+
+  /**
+   * @brief Start the command worker task
+   * @return ESP_OK on success (also if already started)
+   * @note The worker lives for the rest of the run: it may hold the HTTP
+   *       client lock at any moment, so it is never deleted
+   */
+  esp_err_t ha_command_init(void);
+
+  /**
+   * @brief Request a switch state
+   * @param index Switch index (0 = A, 1 = B, 2 = C)
+   * @param state Desired state
+   * @return ESP_OK if queued; ESP_ERR_INVALID_STATE if the worker is not
+   *         running, in which case nothing will be sent
+   * @note Never blocks; safe from the LVGL task
+   */
+  esp_err_t ha_command_set_switch(uint8_t index, bool state);
+
+  /**
+   * @brief Request a scene activation
+   * @return ESP_OK if queued; ESP_ERR_INVALID_STATE if the worker is not running
+   * @note Never blocks; safe from the LVGL task
+   */
+  esp_err_t ha_command_trigger_scene(void);
+
+  /**
+   * @brief Report a switch state received from Home Assistant
+   * @param index Switch index (0 = A, 1 = B, 2 = C)
+   * @param state State reported by HA
+   * @param event_us Arrival time for the event-to-flush latency (0 = none,
+   *        see system_monitor_ui_set_switch_from_event())
+   * @note Safe from any task
+   */
+  void ha_command_report_state(uint8_t index, bool state, uint32_t event_us);
+
+  /**
+   * @brief Get the command counters
+   */
+  void ha_command_get_stats(ha_command_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HA_COMMAND_H
@@ -0,0 +1,274 @@
+/**
+ * @file ha_gzip.c
+ * @brief Streaming gzip decoder for Home Assistant responses
+ *
+ * tinfl runs in its wrapping-buffer mode: the 32 KB window doubles as the
+ * output buffer. Each call inflates into the window up to its end. The new
+ * bytes go to the sink, and the write position wraps to the start once the
+ * window is full.
+ *
+ * @author System Monitor Dashboard
+ * @date 2025-08-14
+ */
+
+#include "ha_gzip.h"
+#include "rom/miniz.h"
+#include <esp_heap_caps.h>
+#include <esp_rom_crc.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define GZIP_ID1 0x1F
+#define GZIP_ID2 0x8B
+#define GZIP_METHOD_DEFLATE 8
+#define GZIP_HEADER_SIZE 10
+#define GZIP_TRAILER_SIZE 8
+
+/** Header flags (RFC 1952) */
+#define GZIP_FHCRC 0x02
+#define GZIP_FEXTRA 0x04
+#define GZIP_FNAME 0x08
+#define GZIP_FCOMMENT 0x10
+#define GZIP_FRESERVED 0xE0
+
+/** Stream position, in stream order */
+typedef enum
+{
+  GZ_HEADER = 0,
+  GZ_EXTRA_LEN,
+  GZ_EXTRA,
+  GZ_NAME,
+  GZ_COMMENT,
+  GZ_HCRC,
+  GZ_DEFLATE,
+  GZ_TRAILER,
+  GZ_DONE,
+  GZ_ERROR,
+} gz_state_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+struct ha_gzip
+{
+  tinfl_decompressor inflater;
+  uint8_t window[TINFL_LZ_DICT_SIZE]; ///< Deflate window and output buffer
+  size_t window_pos;                  ///< Next write position in window
+
+  ha_gzip_sink_t sink;
+  void *ctx;
+
+  gz_state_t state;
+  uint8_t flags;                      ///< Header flags
+  uint8_t field[GZIP_HEADER_SIZE];    ///< Fixed-size header/trailer field being collected
+  size_t field_len;
+  size_t skip;                        ///< FEXTRA bytes still to skip
+
+  uint32_t crc;                       ///< CRC-32 of the output so far
+  size_t output;                      ///< Output bytes so far
+};
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Next header state after `from`, skipping fields the flags say are absent
+ */
+static gz_state_t next_state(const ha_gzip_t *gz, gz_state_t from)
+{
+  for (gz_state_t s = from + 1;; s++)
+  {
+    if ((s == GZ_EXTRA_LEN || s == GZ_EXTRA) && !(gz->flags & GZIP_FEXTRA))
+      continue;
+    if (s == GZ_NAME && !(gz->flags & GZIP_FNAME))
+      continue;
+    if (s == GZ_COMMENT && !(gz->flags & GZIP_FCOMMENT))
+      continue;
+    if (s == GZ_HCRC && !(gz->flags & GZIP_FHCRC))
+      continue;
+    return s;
+  }
+}
+
+/**
+ * @brief Collect a fixed-size field
+ * @return true once `size` bytes are in gz->field
+ */
+static bool collect(ha_gzip_t *gz, const uint8_t **p, size_t *left, size_t size)
+{
+  while (*left > 0 && gz->field_len < size)
+  {
+    gz->field[gz->field_len++] = *(*p)++;
+    (*left)--;
+  }
+  if (gz->field_len < size)
+    return false;
+
+  gz->field_len = 0;
+  return true;
+}
+
+/**
+ * @brief Inflate as much of the input as possible
+ */
+static void inflate_body(ha_gzip_t *gz, const uint8_t **p, size_t *left)
+{
+  while (1)
+  {
+    size_t in_size = *left;
+    size_t out_size = TINFL_LZ_DICT_SIZE - gz->window_pos;
+    tinfl_status status = tinfl_decompress(&gz->inflater, *p, &in_size, gz->window, gz->window + gz->window_pos,
+                                           &out_size, TINFL_FLAG_HAS_MORE_INPUT);
+    *p += in_size;
+    *left -= in_size;
+
+    if (out_size > 0)
+    {
+      const uint8_t *out = gz->window + gz->window_pos;
+      gz->crc = esp_rom_crc32_le(gz->crc, out, out_size);
+      gz->output += out_size;
+      gz->sink(gz->ctx, (const char *)out, out_size);
+      gz->window_pos = (gz->window_pos + out_size) & (TINFL_LZ_DICT_SIZE - 1);
+    }
+
+    if (status == TINFL_STATUS_DONE)
+    {
+      gz->state = GZ_TRAILER;
+      return;
+    }
+    if (status < 0)
+    {
+      gz->state = GZ_ERROR;
+      return;
+    }
+    if (status == TINFL_STATUS_NEEDS_MORE_INPUT && *left == 0)
+    {
+      return;
+    }
+    // TINFL_STATUS_HAS_MORE_OUTPUT: the window wrapped, keep going
+  }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+ha_gzip_t *ha_gzip_create(void)
+{
+  return heap_caps_malloc(sizeof(ha_gzip_t), MALLOC_CAP_SPIRAM);
+}
+
+void ha_gzip_destroy(ha_gzip_t *gz)
+{
+  heap_caps_free(gz);
+}
+
+void ha_gzip_reset(ha_gzip_t *gz, ha_gzip_sink_t sink, void *ctx)
+{
+  tinfl_init(&gz->inflater);
+  gz->window_pos = 0;
+  gz->sink = sink;
+  gz->ctx = ctx;
+  gz->state = GZ_HEADER;
+  gz->flags = 0;
+  gz->field_len = 0;
+  gz->skip = 0;
+  gz->crc = 0;
+  gz->output = 0;
+}
+
+esp_err_t ha_gzip_feed(ha_gzip_t *gz, const void *data, size_t len)
+{
+  const uint8_t *p = data;
+  size_t left = len;
+
+  while (left > 0 && gz->state != GZ_DONE && gz->state != GZ_ERROR)
+  {
+    switch (gz->state)
+    {
+    case GZ_HEADER:
+      if (collect(gz, &p, &left, GZIP_HEADER_SIZE))
+      {
+        gz->flags = gz->field[3];
+        bool valid = gz->field[0] == GZIP_ID1 && gz->field[1] == GZIP_ID2 &&
+                     gz->field[2] == GZIP_METHOD_DEFLATE && !(gz->flags & GZIP_FRESERVED);
+        gz->state = valid ? next_state(gz, GZ_HEADER) : GZ_ERROR;
+      }
+      break;
+
+    case GZ_EXTRA_LEN:
+      if (collect(gz, &p, &left, 2))
+      {
+        gz->skip = gz->field[0] | (gz->field[1] << 8);
+        gz->state = gz->skip ? GZ_EXTRA : next_state(gz, GZ_EXTRA);
+      }
+      break;
+
+    case GZ_EXTRA:
+    {
+      size_t n = left < gz->skip ? left : gz->skip;
+      p += n;
+      left -= n;
+      gz->skip -= n;
+      if (gz->skip == 0)
+        gz->state = next_state(gz, GZ_EXTRA);
+      break;
+    }
+
+    case GZ_NAME:
+    case GZ_COMMENT:
+      // Zero-terminated
+      left--;
+      if (*p++ == 0)
+        gz->state = next_state(gz, gz->state);
+      break;
+
+    case GZ_HCRC:
+      if (collect(gz, &p, &left, 2))
+        gz->state = next_state(gz, GZ_HCRC);
+      break;
+
+    case GZ_DEFLATE:
+      inflate_body(gz, &p, &left);
+      break;
+
+    case GZ_TRAILER:
+      if (collect(gz, &p, &left, GZIP_TRAILER_SIZE))
+      {
+        uint32_t crc = gz->field[0] | (gz->field[1] << 8) | (gz->field[2] << 16) | ((uint32_t)gz->field[3] << 24);
+        uint32_t size = gz->field[4] | (gz->field[5] << 8) | (gz->field[6] << 16) | ((uint32_t)gz->field[7] << 24);
+        gz->state = crc == gz->crc && size == (uint32_t)gz->output ? GZ_DONE : GZ_ERROR;
+      }
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  // Bytes after the trailer (a second gzip member) are ignored
+  return gz->state == GZ_ERROR ? ESP_ERR_INVALID_RESPONSE : ESP_OK;
+}
+
+esp_err_t ha_gzip_finish(const ha_gzip_t *gz)
+{
+  switch (gz->state)
+  {
+  case GZ_DONE:
+    return ESP_OK;
+  case GZ_ERROR:
+    return ESP_ERR_INVALID_RESPONSE;
+  default:
+    return ESP_ERR_INVALID_SIZE;
+  }
+}
+
+size_t ha_gzip_output_size(const ha_gzip_t *gz)
+{
+  return gz->output;
+}
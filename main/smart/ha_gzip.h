@@ -0,0 +1,94 @@
+/**
+ * @file ha_gzip.h
+ * @brief Streaming gzip decoder for Home Assistant responses
+ *
+ * Inflates a gzip body chunk by chunk as it arrives, using the tinfl
+ * inflater in ROM. Output is produced in pieces of at most the 32 KB
+ * deflate window and handed to a sink, so the full body is never held in
+ * memory. The window and the decompressor tables (about 43 KB together)
+ * live in PSRAM and are allocated once, then reused for every response.
+ *
+ * The gzip header, with its optional extra, name, comment and header CRC
+ * fields, is parsed and skipped. The CRC-32 and size in the trailer are
+ * checked against the inflated output.
+ *
+ * @author System Monitor Dashboard
+ * @date 2025-08-14
+ */
+
+#ifndef HA_GZIP_H
+#define HA_GZIP_H
+
+#include <esp_err.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  // ═══════════════════════════════════════════════════════════════════════════════
+  // DATA STRUCTURES
+  // ═══════════════════════════════════════════════════════════════════════════════
+
+  /**
+   * @brief Receives inflated data
+   * @param ctx Context given to ha_gzip_reset()
+   * @param data Inflated bytes (valid only during the call)
+   * @param len Number of bytes
+   */
+  typedef void (*ha_gzip_sink_t)(void *ctx, const char *data, size_t len);
+
+  /** Opaque decoder */
+  typedef struct ha_gzip ha_gzip_t;
+
+  // ═══════════════════════════════════════════════════════════════════════════════
+  // PUBLIC FUNCTION DECLARATIONS
+  // ═══════════════════════════════════════════════════════════════════════════════
+
+  /**
+   * @brief Allocate a decoder (window and tables in PSRAM)
+   * @return Decoder, or NULL if out of memory
+   */
+  ha_gzip_t *ha_gzip_create(void);
+
+  /**
+   * @brief Release a decoder
+   */
+  void ha_gzip_destroy(ha_gzip_t *gz);
+
+  /**
+   * @brief Start a new stream
+   * @param gz Decoder
+   * @param sink Receives the inflated data
+   * @param ctx Passed to the sink
+   */
+  void ha_gzip_reset(ha_gzip_t *gz, ha_gzip_sink_t sink, void *ctx);
+
+  /**
+   * @brief Feed the next chunk of compressed data
+   * @return ESP_OK, or ESP_ERR_INVALID_RESPONSE once the stream is corrupt
+   *         (later calls keep failing until the next reset)
+   */
+  esp_err_t ha_gzip_feed(ha_gzip_t *gz, const void *data, size_t len);
+
+  /**
+   * @brief Check that the stream ended with a valid trailer
+   * @return ESP_OK if complete and the CRC and size match,
+   *         ESP_ERR_INVALID_SIZE if it was cut short,
+   *         ESP_ERR_INVALID_RESPONSE if corrupt
+   */
+  esp_err_t ha_gzip_finish(const ha_gzip_t *gz);
+
+  /**
+   * @brief Bytes of inflated output produced since the last reset
+   */
+  size_t ha_gzip_output_size(const ha_gzip_t *gz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HA_GZIP_H
@@ -0,0 +1,393 @@
+/**
+ * @file ha_states_parser.c
+ * @brief Streaming parser for the Home Assistant /api/states response
+ *
+ * A byte-at-a-time tokenizer. Only strings directly inside an entity
+ * object (depth 2) are looked at: keys to select the field, and the
+ * values of entity_id, state and last_changed. Strings anywhere deeper
+ * are skipped, as are numbers and literals, so attributes cost one
+ * comparison per byte.
+ *
+ * @author System Monitor Dashboard
+ * @date 2025-08-14
+ */
+
+#include "ha_states_parser.h"
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/** Depth of the entity objects inside the top-level array */
+#define ENTITY_DEPTH 2
+
+/** Fields kept per entity */
+enum
+{
+  FIELD_NONE = -1,
+  FIELD_ENTITY_ID = 0,
+  FIELD_STATE,
+  FIELD_LAST_CHANGED,
+};
+
+#define MATCH_UNKNOWN -1
+#define MATCH_UNWANTED -2
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static bool in_entity(const ha_states_parser_t *parser)
+{
+  return parser->depth == ENTITY_DEPTH;
+}
+
+static void begin_entity(ha_states_parser_t *parser)
+{
+  parser->expect_key = true;
+  parser->field = FIELD_NONE;
+  parser->match = MATCH_UNKNOWN;
+  parser->entity_id[0] = '\0';
+  parser->state[0] = '\0';
+  parser->last_changed[0] = '\0';
+}
+
+static void end_entity(ha_states_parser_t *parser)
+{
+  parser->entities++;
+  if (parser->match < 0 || (parser->found & (1u << parser->match)))
+  {
+    return;
+  }
+
+  ha_entity_state_t *state = &parser->states[parser->match];
+  memcpy(state->entity_id, parser->entity_id, sizeof(state->entity_id));
+  memcpy(state->state, parser->state, sizeof(state->state));
+  state->last_changed = ha_states_parser_parse_time(parser->last_changed);
+  parser->found |= 1u << parser->match;
+}
+
+/**
+ * @brief Pick the destination of the string that starts here
+ */
+static void begin_string(ha_states_parser_t *parser)
+{
+  parser->capture = NULL;
+  parser->capture_len = 0;
+
+  if (!in_entity(parser))
+  {
+    return;
+  }
+
+  if (parser->expect_key)
+  {
+    parser->capture = parser->key;
+    parser->capture_max = HA_STATES_PARSER_KEY_LEN;
+    return;
+  }
+
+  // The rest of an unwanted entity is skipped without copying
+  if (parser->match == MATCH_UNWANTED)
+  {
+    return;
+  }
+
+  switch (parser->field)
+  {
+  case FIELD_ENTITY_ID:
+    parser->capture = parser->entity_id;
+    parser->capture_max = sizeof(parser->entity_id) - 1;
+    break;
+  case FIELD_STATE:
+    parser->capture = parser->state;
+    parser->capture_max = sizeof(parser->state) - 1;
+    break;
+  case FIELD_LAST_CHANGED:
+    parser->capture = parser->last_changed;
+    parser->capture_max = sizeof(parser->last_changed) - 1;
+    break;
+  default:
+    break;
+  }
+}
+
+static void end_string(ha_states_parser_t *parser)
+{
+  if (!in_entity(parser))
+  {
+    return;
+  }
+
+  // capture_len keeps counting past capture_max, so overflow is visible here
+  bool overflow = parser->capture_len > parser->capture_max;
+  if (parser->capture)
+  {
+    parser->capture[overflow ? parser->capture_max : parser->capture_len] = '\0';
+  }
+
+  if (parser->expect_key)
+  {
+    parser->expect_key = false;
+    parser->field = FIELD_NONE;
+    if (!overflow)
+    {
+      if (strcmp(parser->key, "entity_id") == 0)
+        parser->field = FIELD_ENTITY_ID;
+      else if (strcmp(parser->key, "state") == 0)
+        parser->field = FIELD_STATE;
+      else if (strcmp(parser->key, "last_changed") == 0)
+        parser->field = FIELD_LAST_CHANGED;
+    }
+    return;
+  }
+
+  if (parser->field == FIELD_ENTITY_ID && parser->match == MATCH_UNKNOWN)
+  {
+    parser->match = MATCH_UNWANTED;
+    for (int i = 0; !overflow && i < parser->wanted_count; i++)
+    {
+      if (strcmp(parser->entity_id, parser->wanted[i]) == 0)
+      {
+        parser->match = (int8_t)i;
+        break;
+      }
+    }
+  }
+  parser->field = FIELD_NONE;
+}
+
+static void emit(ha_states_parser_t *parser, char c)
+{
+  if (parser->capture && parser->capture_len < parser->capture_max)
+  {
+    parser->capture[parser->capture_len] = c;
+  }
+  parser->capture_len++;
+}
+
+/**
+ * @brief Handle one byte inside a string
+ */
+static void string_byte(ha_states_parser_t *parser, char c)
+{
+  if (parser->unicode)
+  {
+    // \uXXXX is not decoded; the wanted fields are plain ASCII
+    if (--parser->unicode == 0)
+      emit(parser, '?');
+    return;
+  }
+
+  if (parser->escape)
+  {
+    parser->escape = false;
+    switch (c)
+    {
+    case 'u':
+      parser->unicode = 4;
+      break;
+    case 'n':
+      emit(parser, '\n');
+      break;
+    case 't':
+      emit(parser, '\t');
+      break;
+    case 'r':
+      emit(parser, '\r');
+      break;
+    case 'b':
+      emit(parser, '\b');
+      break;
+    case 'f':
+      emit(parser, '\f');
+      break;
+    default:
+      emit(parser, c); // \" \\ \/
+      break;
+    }
+    return;
+  }
+
+  if (c == '\\')
+  {
+    parser->escape = true;
+  }
+  else if (c == '"')
+  {
+    parser->in_string = false;
+    end_string(parser);
+  }
+  else
+  {
+    emit(parser, c);
+  }
+}
+
+static void open_container(ha_states_parser_t *parser, bool object)
+{
+  // The top level must be an array of objects
+  if (parser->depth >= HA_STATES_PARSER_MAX_DEPTH || (parser->depth == 0 && object) ||
+      (parser->depth == ENTITY_DEPTH - 1 && !object))
+  {
+    parser->error = true;
+    return;
+  }
+
+  if (object)
+    parser->containers |= 1u << parser->depth;
+  else
+    parser->containers &= ~(1u << parser->depth);
+  parser->depth++;
+
+  if (in_entity(parser))
+  {
+    begin_entity(parser);
+  }
+}
+
+static void close_container(ha_states_parser_t *parser, bool object)
+{
+  if (parser->depth == 0 || ((parser->containers >> (parser->depth - 1)) & 1u) != object)
+  {
+    parser->error = true;
+    return;
+  }
+
+  if (in_entity(parser))
+  {
+    end_entity(parser);
+  }
+  parser->depth--;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void ha_states_parser_init(ha_states_parser_t *parser, const char *const *wanted, int wanted_count,
+                           ha_entity_state_t *states)
+{
+  memset(parser, 0, sizeof(*parser));
+  parser->wanted = wanted;
+  parser->wanted_count = wanted_count < HA_STATES_PARSER_MAX_WANTED ? wanted_count : HA_STATES_PARSER_MAX_WANTED;
+  parser->states = states;
+  parser->field = FIELD_NONE;
+  parser->match = MATCH_UNKNOWN;
+  memset(states, 0, sizeof(ha_entity_state_t) * parser->wanted_count);
+}
+
+bool ha_states_parser_feed(ha_states_parser_t *parser, const char *data, size_t len)
+{
+  parser->bytes += len;
+
+  for (size_t i = 0; i < len && !parser->error; i++)
+  {
+    char c = data[i];
+
+    if (parser->in_string)
+    {
+      string_byte(parser, c);
+      continue;
+    }
+
+    switch (c)
+    {
+    case '"':
+      parser->in_string = true;
+      begin_string(parser);
+      break;
+    case '{':
+      open_container(parser, true);
+      break;
+    case '[':
+      open_container(parser, false);
+      break;
+    case '}':
+      close_container(parser, true);
+      break;
+    case ']':
+      close_container(parser, false);
+      break;
+    case ',':
+      if (in_entity(parser))
+      {
+        parser->expect_key = true;
+        parser->field = FIELD_NONE;
+      }
+      break;
+    default:
+      break; // ':', whitespace, numbers and literals
+    }
+  }
+
+  return !parser->error;
+}
+
+bool ha_states_parser_done(const ha_states_parser_t *parser)
+{
+  uint32_t all = parser->wanted_count >= 32 ? UINT32_MAX : (1u << parser->wanted_count) - 1;
+  return parser->wanted_count > 0 && parser->found == all;
+}
+
+int ha_states_parser_found_count(const ha_states_parser_t *parser)
+{
+  return __builtin_popcount(parser->found);
+}
+
+uint64_t ha_states_parser_parse_time(const char *iso)
+{
+  // YYYY-MM-DDTHH:MM:SS[.ffffff][Z|+HH:MM|-HH:MM]
+  static const char pattern[] = "dddd-dd-ddTdd:dd:dd";
+  int fields[6] = {0};
+  int field = 0;
+
+  for (int i = 0; pattern[i]; i++)
+  {
+    if (pattern[i] == 'd')
+    {
+      if (iso[i] < '0' || iso[i] > '9')
+        return 0;
+      fields[field] = fields[field] * 10 + (iso[i] - '0');
+    }
+    else if (iso[i] != pattern[i] && !(pattern[i] == 'T' && iso[i] == ' '))
+    {
+      return 0;
+    }
+    else
+    {
+      field++;
+    }
+  }
+
+  int year = fields[0], month = fields[1], day = fields[2];
+  if (month < 1 || month > 12 || day < 1 || day > 31)
+    return 0;
+
+  // Days from 1970-01-01 (proleptic Gregorian, H. Hinnant's days_from_civil)
+  year -= month <= 2;
+  int era = year / 400;
+  int yoe = year - era * 400;
+  int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  int64_t days = (int64_t)era * 146097 + doe - 719468;
+
+  int64_t seconds = days * 86400 + fields[3] * 3600 + fields[4] * 60 + fields[5];
+
+  // Skip fractional seconds, then apply the UTC offset
+  const char *p = iso + sizeof(pattern) - 1;
+  if (*p == '.')
+  {
+    p++;
+    while (*p >= '0' && *p <= '9')
+      p++;
+  }
+  if ((*p == '+' || *p == '-') && p[1] && p[2] && p[3] == ':' && p[4] && p[5])
+  {
+    int offset = ((p[1] - '0') * 10 + (p[2] - '0')) * 3600 + ((p[4] - '0') * 10 + (p[5] - '0')) * 60;
+    seconds += *p == '+' ? -offset : offset;
+  }
+
+  return seconds > 0 ? (uint64_t)seconds : 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file ha_states_parser.h
+ * @brief Streaming parser for the Home Assistant /api/states response
+ *
+ * /api/states returns every entity HA knows about as one JSON array, which
+ * runs to megabytes on large installations. This parser is fed the body
+ * chunk by chunk as it arrives (HTTP_EVENT_ON_DATA) and never holds more
+ * than one key and three short values, so its memory use does not depend
+ * on the response size.
+ *
+ * For each top-level object it keeps entity_id, state and last_changed and
+ * skips everything else, attributes included. When the object closes, the
+ * entity_id is matched against the wanted set and the fields are copied to
+ * that entity's result. Once entity_id is known to be unwanted, the rest of
+ * the object is skipped without copying.
+ *
+ * Chunks may split the input anywhere, even inside an escape sequence.
+ * The parser calls no ESP-IDF functions, so it can be benchmarked on the
+ * host against recorded state dumps.
+ *
+ * @author System Monitor Dashboard
+ * @date 2025-08-14
+ */
+
+#ifndef HA_STATES_PARSER_H
+#define HA_STATES_PARSER_H
+
+#include "ha_api.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/** Maximum number of wanted entities */
+#define HA_STATES_PARSER_MAX_WANTED 32
+
+/** Longest object key that can match a field; longer keys are skipped */
+#define HA_STATES_PARSER_KEY_LEN 16
+
+/** Longest last_changed timestamp (ISO 8601 with microseconds and offset) */
+#define HA_STATES_PARSER_TIME_LEN 40
+
+/** Deepest nesting the parser tracks */
+#define HA_STATES_PARSER_MAX_DEPTH 32
+
+  // ═══════════════════════════════════════════════════════════════════════════════
+  // DATA STRUCTURES
+  // ═══════════════════════════════════════════════════════════════════════════════
+
+  /**
+   * @brief Parser state
+   *
+   * Plain data; everything is inline, nothing is allocated.
+   */
+  typedef struct
+  {
+    // Wanted set and results (caller-owned)
+    const char *const *wanted;
+    int wanted_count;
+    ha_entity_state_t *states; ///< One result per wanted entity
+    uint32_t found;            ///< Bit i set once wanted[i] was seen
+
+    // Tokenizer
+    uint32_t containers; ///< Bit d set if the container at depth d+1 is an object
+    uint8_t depth;       ///< Open containers
+    bool in_string;
+    bool escape;         ///< Previous string character was a backslash
+    uint8_t unicode;     ///< \uXXXX hex digits still to skip
+    bool expect_key;     ///< Next string in the entity object is a key
+    bool error;
+
+    // Current string being captured
+    char *capture;       ///< Destination, or NULL to skip the string
+    size_t capture_len;
+    size_t capture_max;  ///< Capacity without the terminator
+
+    // Current entity object
+    char key[HA_STATES_PARSER_KEY_LEN + 1];
+    char entity_id[HA_MAX_ENTITY_ID_LEN];
+    char state[HA_MAX_STATE_LEN];
+    char last_changed[HA_STATES_PARSER_TIME_LEN + 1];
+    int8_t field;        ///< Field the value after the current key goes to (-1 = none)
+    int8_t match;        ///< Index in wanted (-1 = entity_id not seen yet, -2 = not wanted)
+
+    // Counters
+    uint32_t entities;   ///< Entity objects seen
+    size_t bytes;        ///< Bytes fed
+  } ha_states_parser_t;
+
+  // ═══════════════════════════════════════════════════════════════════════════════
+  // PUBLIC FUNCTION DECLARATIONS
+  // ═══════════════════════════════════════════════════════════════════════════════
+
+  /**
+   * @brief Prepare a parser for one response
+   *
+   * @param parser Parser to initialize
+   * @param wanted Entity IDs to look for
+   * @param wanted_count Number of entity IDs, at most HA_STATES_PARSER_MAX_WANTED
+   * @param states Receives one result per wanted entity; cleared here
+   */
+  void ha_states_parser_init(ha_states_parser_t *parser, const char *const *wanted, int wanted_count,
+                             ha_entity_state_t *states);
+
+  /**
+   * @brief Feed the next chunk of the response body
+   *
+   * @param parser Parser
+   * @param data Chunk
+   * @param len Chunk length
+   * @return false once the input is not a valid state array
+   */
+  bool ha_states_parser_feed(ha_states_parser_t *parser, const char *data, size_t len);
+
+  /**
+   * @brief Check whether every wanted entity was found
+   */
+  bool ha_states_parser_done(const ha_states_parser_t *parser);
+
+  /**
+   * @brief Count the wanted entities found so far
+   */
+  int ha_states_parser_found_count(const ha_states_parser_t *parser);
+
+  /**
+   * @brief Convert an ISO 8601 timestamp to Unix time
+   *
+   * @param iso Timestamp as sent by HA (e.g. "2025-08-14T10:00:00.123+00:00")
+   * @return Seconds since the epoch, or 0 if the timestamp is malformed
+   */
+  uint64_t ha_states_parser_parse_time(const char *iso);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HA_STATES_PARSER_H
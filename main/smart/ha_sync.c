@@ -3,92 +3,17 @@
  * @brief Home Assistant Device State Synchronization Implementation
  *
  * This module provides the implementation for synchronizing device states
- * with Home Assistant bool ha_sync_switch_a_sync(void)
-{
-  if (!switch_a_sync.is_enabled)
-  {
-    ESP_LOGW(TAG, "Cannot sync disabled switch_a");
-    return false;
-  }
-
-  ESP_LOGI(TAG, "Synchronizing switch_a: local=%s",
-           ha_device_state_to_string(switch_a_sync.local_state));
-
-  // Prepare service call structure
-  ha_service_call_t service_call = {0};
-  strcpy(service_call.domain, "switch");
-  strcpy(service_call.entity_id, switch_a_sync.entity_id);
-
-  if (switch_a_sync.local_state == HA_DEVICE_STATE_ON)
-  {
-    strcpy(service_call.service, "turn_on");
-  }
-  else if (switch_a_sync.local_state == HA_DEVICE_STATE_OFF)
-  {
-    strcpy(service_call.service, "turn_off");
-  }
-  else
-  {
-    ESP_LOGW(TAG, "Cannot sync switch_a with unknown state");
-    return false;
-  }
-
-  // Make service call to Home Assistant
-  ha_api_response_t response;
-  esp_err_t ret = ha_api_call_service(&service_call, &response);
-
-  if (ret == ESP_OK && response.success)
-  {
-    ESP_LOGI(TAG, "Successfully sent switch_a command to Home Assistant");
-
-    // Wait a moment for the device to respond
-    vTaskDelay(pdMS_TO_TICKS(1000));
-
-    // Verify the state change took effect
-    ha_device_state_t new_remote_state;
-    if (ha_sync_switch_a_get_remote_state(&new_remote_state))
-    {
-      switch_a_sync.remote_state = new_remote_state;
-      switch_a_sync.last_sync_time = get_timestamp_ms();
-
-      if (switch_a_sync.local_state == new_remote_state)
-      {
-        switch_a_sync.sync_status = HA_SYNC_STATUS_SYNCED;
-        switch_a_sync.failed_attempts = 0;
-        ESP_LOGI(TAG, "switch_a sync successful: %s", ha_device_state_to_string(new_remote_state));
-
-        // Clean up response data
-        if (response.response_data) {
-          free(response.response_data);
-        }
-        return true;
-      }
-      else
-      {
-        switch_a_sync.sync_status = HA_SYNC_STATUS_OUT_OF_SYNC;
-        ESP_LOGW(TAG, "switch_a sync failed - state mismatch: local=%s, remote=%s",
-                 ha_device_state_to_string(switch_a_sync.local_state),
-                 ha_device_state_to_string(new_remote_state));
-      }
-    }
-  }
-  else
-  {
-    ESP_LOGE(TAG, "Failed to send switch_a command: %s", response.error_message);
-    switch_a_sync.failed_attempts++;
-    switch_a_sync.sync_status = HA_SYNC_STATUS_FAILED;
-  }
-
-  // Clean up response data
-  if (response.response_data) {
-    free(response.response_data);
-  }
-
-  return false;failures.
+ * with Home Assistant: the local (requested) and remote (reported) state of
+ * each device, its sync status and consecutive failures.
+ *
+ * Synchronizing sends the service call and takes the new remote state from
+ * the state list HA returns (reported through ha_sync_report_state()). No
+ * follow-up GET is needed to confirm the change.
  */
 
 #include "ha_sync.h"
 #include "ha_api.h"
+#include "ha_command.h"
 #include "../lvgl/system_monitor_ui.h"
 #include <esp_log.h>
 #include <esp_timer.h>
@@ -122,7 +47,7 @@ static uint32_t get_timestamp_ms(void)
   return (uint32_t)(esp_timer_get_time() / 1000);
 }
 
-static ha_device_state_t __attribute__((unused)) parse_ha_state(const char *state_str)
+static ha_device_state_t parse_ha_state(const char *state_str)
 {
   if (state_str == NULL)
   {
@@ -296,13 +221,52 @@ bool ha_sync_switch_a_synchronize(void)
   ESP_LOGI(TAG, "Synchronizing switch_a: local=%s",
            ha_device_state_to_string(switch_a_sync.local_state));
 
-  // TODO: Implement actual HTTP request to set switch_a state
-  // POST http://192.168.50.193:8123/api/services/switch/turn_on
-  // or POST http://192.168.50.193:8123/api/services/switch/turn_off
-  // with body: {"entity_id": "switch.pai_cha_4_1_zigbee_socket_4"}
+  ha_service_call_t service_call = {.domain = "switch"};
+  strncpy(service_call.entity_id, switch_a_sync.entity_id, sizeof(service_call.entity_id) - 1);
+
+  if (switch_a_sync.local_state == HA_DEVICE_STATE_ON)
+  {
+    strcpy(service_call.service, "turn_on");
+  }
+  else if (switch_a_sync.local_state == HA_DEVICE_STATE_OFF)
+  {
+    strcpy(service_call.service, "turn_off");
+  }
+  else
+  {
+    ESP_LOGW(TAG, "Cannot sync switch_a with unknown state");
+    return false;
+  }
+
+  // ha_sync_report_state() sets the remote state if the response lists switch_a
+  ha_device_state_t previous_remote = switch_a_sync.remote_state;
+  switch_a_sync.remote_state = HA_DEVICE_STATE_UNKNOWN;
+
+  esp_err_t ret = ha_api_call_service(&service_call, NULL);
+  if (ret != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to send switch_a command: %s", esp_err_to_name(ret));
+    switch_a_sync.remote_state = previous_remote;
+    switch_a_sync.failed_attempts++;
+    switch_a_sync.sync_status = HA_SYNC_STATUS_FAILED;
+    return false;
+  }
 
-  // After successful HTTP request, verify state
-  return ha_sync_switch_a_check_status() == HA_SYNC_STATUS_SYNCED;
+  // HA lists only the states the call changed: not listed means already there
+  if (switch_a_sync.remote_state == HA_DEVICE_STATE_UNKNOWN)
+  {
+    switch_a_sync.remote_state = switch_a_sync.local_state;
+  }
+
+  switch_a_sync.failed_attempts = 0;
+  switch_a_sync.last_sync_time = get_timestamp_ms();
+  switch_a_sync.last_check_time = switch_a_sync.last_sync_time;
+  switch_a_sync.sync_status = switch_a_sync.local_state == switch_a_sync.remote_state ? HA_SYNC_STATUS_SYNCED
+                                                                                      : HA_SYNC_STATUS_OUT_OF_SYNC;
+  ESP_LOGI(TAG, "switch_a sync %s: remote=%s", ha_sync_status_to_string(switch_a_sync.sync_status),
+           ha_device_state_to_string(switch_a_sync.remote_state));
+
+  return switch_a_sync.sync_status == HA_SYNC_STATUS_SYNCED;
 }
 
 bool ha_sync_switch_a_is_enabled(void)
@@ -374,6 +338,23 @@ void ha_sync_task(void)
   // TODO: Add other devices here as needed
 }
 
+void ha_sync_report_state(const char *entity_id, const char *state)
+{
+  if (strcmp(entity_id, switch_a_sync.entity_id) != 0)
+  {
+    return;
+  }
+
+  switch_a_sync.remote_state = parse_ha_state(state);
+  switch_a_sync.last_check_time = get_timestamp_ms();
+
+  if (switch_a_sync.local_state != HA_DEVICE_STATE_UNKNOWN && switch_a_sync.sync_status != HA_SYNC_STATUS_DISABLED)
+  {
+    switch_a_sync.sync_status = switch_a_sync.local_state == switch_a_sync.remote_state ? HA_SYNC_STATUS_SYNCED
+                                                                                        : HA_SYNC_STATUS_OUT_OF_SYNC;
+  }
+}
+
 const char *ha_sync_status_to_string(ha_sync_status_t status)
 {
   switch (status)
@@ -433,10 +414,10 @@ esp_err_t ha_sync_immediate_switches(void)
     bool switch_b_on = (strcmp(switch_states[1].state, "on") == 0);
     bool switch_c_on = (strcmp(switch_states[2].state, "on") == 0);
 
-    // Update the UI with switch states
-    system_monitor_ui_set_switch_a(switch_a_on);
-    system_monitor_ui_set_switch_b(switch_b_on);
-    system_monitor_ui_set_switch_c(switch_c_on);
+    // Update the UI with switch states (held back while a command is in flight)
+    ha_command_report_state(0, switch_a_on, 0);
+    ha_command_report_state(1, switch_b_on, 0);
+    ha_command_report_state(2, switch_c_on, 0);
 
     ESP_LOGI(TAG, "Immediate sync completed: %s=%s, %s=%s, %s=%s",
              UI_LABEL_A, switch_states[0].state,
@@ -123,6 +123,13 @@ bool ha_sync_init(void);
  */
 void ha_sync_task(void);
 
+/**
+ * @brief Record a state reported by Home Assistant (push, poll or service-call response)
+ * @param entity_id Entity whose state was reported
+ * @param state Reported state string
+ */
+void ha_sync_report_state(const char *entity_id, const char *state);
+
 /**
  * @brief Get sync status string for display
  * @param status The sync status enum
@@ -4,11 +4,18 @@
  *
  * This module manages the Home Assistant sync task and handles
  * periodic synchronization with Home Assistant.
+ *
+ * Switch states are pushed over the WebSocket subscription (ha_ws.h) as
+ * they change. The 30 second REST poll only runs while that subscription
+ * is down, as a resync fallback. The states a service call returns are
+ * applied as soon as its response is in (ha_api_set_state_listener()).
  */
 
 #include "ha_task_manager.h"
 #include "ha_api.h"
+#include "ha_command.h"
 #include "ha_sync.h"
+#include "ha_ws.h"
 #include "smart_config.h"
 #include "../lvgl/system_monitor_ui.h"
 #include "esp_log.h"
@@ -31,6 +38,34 @@ static bool ha_init_requested = false;
 static char *http_response_buffer = NULL;
 #define HTTP_RESPONSE_BUFFER_SIZE 131072 // 128KB for large HA API responses (supports 100KB+ responses)
 
+// Entities pushed over the WebSocket subscription and picked out of service-call
+// responses, in UI switch order. The aquarium sensors are not subscribed: the UI
+// has nowhere to show them, so pushing their updates would only cost traffic.
+static const char *const ws_entity_ids[] = {
+    HA_ENTITY_A,
+    HA_ENTITY_B,
+    HA_ENTITY_C,
+};
+#define WS_ENTITY_COUNT (sizeof(ws_entity_ids) / sizeof(ws_entity_ids[0]))
+
+/**
+ * @brief Apply a state pushed over the WebSocket subscription or returned by a service call
+ * @note Runs in the WebSocket client task or the task that made the call
+ */
+static void on_ha_state(const char *entity_id, const char *state, uint32_t event_us)
+{
+  ha_sync_report_state(entity_id, state);
+
+  for (uint8_t i = 0; i < WS_ENTITY_COUNT; i++)
+  {
+    if (strcmp(entity_id, ws_entity_ids[i]) == 0)
+    {
+      ha_command_report_state(i, strcmp(state, "on") == 0, event_us);
+      return;
+    }
+  }
+}
+
 /**
  * @brief Simple stack monitoring function
  */
@@ -113,6 +148,16 @@ static void home_assistant_task(void *pvParameters)
         // Request immediate sync after successful initialization
         immediate_sync_requested = true;
         ESP_LOGI(TAG, "Immediate sync requested after HA init");
+
+        // Service calls confirm their own changes
+        ha_api_set_state_listener(ws_entity_ids, WS_ENTITY_COUNT, on_ha_state);
+
+        // Push updates from here on; REST polling stays as the fallback
+        ret = ha_ws_start(ws_entity_ids, WS_ENTITY_COUNT, on_ha_state);
+        if (ret != ESP_OK)
+        {
+          ESP_LOGW(TAG, "WebSocket subscription unavailable, polling only: %s", esp_err_to_name(ret));
+        }
       }
       else
       {
@@ -189,6 +234,21 @@ static void home_assistant_task(void *pvParameters)
       continue;
     }
 
+    if (ha_ws_get_state() == HA_WS_AUTH_FAILED)
+    {
+      ESP_LOGW(TAG, "WebSocket token rejected, falling back to REST polling");
+      ha_ws_stop();
+    }
+
+    // States are pushed while subscribed: nothing to poll
+    if (ha_ws_is_live())
+    {
+      ESP_LOGD(TAG, "WebSocket subscription live, skipping REST poll (cycle %d)", cycle_count);
+      system_monitor_ui_update_ha_status("Connected", true);
+      esp_task_wdt_reset();
+      continue;
+    }
+
     ESP_LOGI(TAG, "Syncing switch states from Home Assistant (cycle %d)", cycle_count);
 
     // Feed watchdog before bulk operation
@@ -213,9 +273,9 @@ static void home_assistant_task(void *pvParameters)
       bool switch_b_on = (strcmp(switch_states[1].state, "on") == 0);
       bool switch_c_on = (strcmp(switch_states[2].state, "on") == 0);
 
-      system_monitor_ui_set_switch_a(switch_a_on);
-      system_monitor_ui_set_switch_b(switch_b_on);
-      system_monitor_ui_set_switch_c(switch_c_on);
+      ha_command_report_state(0, switch_a_on, 0);
+      ha_command_report_state(1, switch_b_on, 0);
+      ha_command_report_state(2, switch_c_on, 0);
 
       ESP_LOGI(TAG, "Switch states synced: A=%s, B=%s, C=%s",
                switch_states[0].state, switch_states[1].state, switch_states[2].state);
@@ -246,7 +306,7 @@ static void home_assistant_task(void *pvParameters)
       if (ha_api_get_entity_state(switch_entity_ids[0], &switch_a_state) == ESP_OK)
       {
         bool switch_a_on = (strcmp(switch_a_state.state, "on") == 0);
-        system_monitor_ui_set_switch_a(switch_a_on);
+        ha_command_report_state(0, switch_a_on, 0);
         ESP_LOGD(TAG, "Switch A: %s", switch_a_state.state);
       }
 
@@ -259,7 +319,7 @@ static void home_assistant_task(void *pvParameters)
       if (ha_api_get_entity_state(switch_entity_ids[1], &switch_b_state) == ESP_OK)
       {
         bool switch_b_on = (strcmp(switch_b_state.state, "on") == 0);
-        system_monitor_ui_set_switch_b(switch_b_on);
+        ha_command_report_state(1, switch_b_on, 0);
         ESP_LOGD(TAG, "Switch B: %s", switch_b_state.state);
       }
 
@@ -272,7 +332,7 @@ static void home_assistant_task(void *pvParameters)
       if (ha_api_get_entity_state(switch_entity_ids[2], &switch_c_state) == ESP_OK)
       {
         bool switch_c_on = (strcmp(switch_c_state.state, "on") == 0);
-        system_monitor_ui_set_switch_c(switch_c_on);
+        ha_command_report_state(2, switch_c_on, 0);
         ESP_LOGD(TAG, "Switch C: %s", switch_c_state.state);
       }
 
@@ -481,6 +541,8 @@ esp_err_t ha_task_manager_stop_task(void)
   ESP_LOGI(TAG, "Stopping Home Assistant task");
   system_monitor_ui_update_ha_status("Stopping", false);
 
+  ha_ws_stop();
+
   // Unsubscribe from watchdog before deleting
   esp_task_wdt_delete(ha_task_handle);
   vTaskDelete(ha_task_handle);
@@ -0,0 +1,410 @@
+/**
+ * @file ha_ws.c
+ * @brief Home Assistant WebSocket subscription client implementation
+ *
+ * Message flow on each connection:
+ *
+ *   HA:  {"type":"auth_required"}
+ *   we:  {"type":"auth","access_token":"..."}
+ *   HA:  {"type":"auth_ok"}
+ *   we:  {"id":1,"type":"subscribe_entities","entity_ids":[...]}
+ *   HA:  {"id":1,"type":"result","success":true}
+ *   HA:  {"id":1,"type":"event","event":{"a":{"switch.x":{"s":"on",...}}}}
+ *   HA:  {"id":1,"type":"event","event":{"c":{"switch.x":{"+":{"s":"off",...}}}}}
+ *
+ * Frames larger than the client buffer arrive in pieces and are
+ * reassembled in a PSRAM buffer before parsing.
+ *
+ * @author System Monitor Dashboard
+ * @date 2025-08-14
+ */
+
+#include "ha_ws.h"
+#include "smart_config.h"
+#include <cJSON.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_websocket_client.h>
+#include <stdio.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static const char *TAG = "HA_WS";
+
+/** WebSocket API endpoint */
+#ifndef HA_API_WEBSOCKET_URL
+#define HA_API_WEBSOCKET_URL "ws://" HA_SERVER_HOST_NAME ":" TOSTRING(HA_SERVER_PORT) "/api/websocket"
+#endif
+
+/** Largest reassembled message (the initial snapshot carries all attributes) */
+#define HA_WS_MESSAGE_MAX 16384
+
+/** Client receive buffer; larger frames are delivered in pieces */
+#define HA_WS_BUFFER_SIZE 2048
+
+/** Client task stack (internal RAM, required for networking) */
+#define HA_WS_TASK_STACK 6144
+
+#define HA_WS_RECONNECT_MS 5000
+#define HA_WS_NETWORK_TIMEOUT_MS 10000
+#define HA_WS_PING_INTERVAL_S 15
+#define HA_WS_PONG_TIMEOUT_S 30
+#define HA_WS_SEND_TIMEOUT_MS 2000
+
+/** WebSocket opcodes of interest */
+#define WS_OPCODE_CONTINUATION 0x00
+#define WS_OPCODE_TEXT 0x01
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE VARIABLES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static esp_websocket_client_handle_t ws_client = NULL;
+static volatile ha_ws_state_t ws_state = HA_WS_STOPPED;
+static ha_ws_state_cb_t state_callback = NULL;
+
+static const char *const *subscribed_ids = NULL;
+static int subscribed_count = 0;
+
+// Per connection (client task only)
+static int next_message_id = 1;
+static int subscription_id = 0;
+
+// Reassembly (client task only)
+static char *message_buf = NULL;
+static size_t message_len = 0;
+static bool message_discard = false;
+static uint32_t message_start_us = 0;
+
+static ha_ws_stats_t stats;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Serialize and send one JSON message
+ */
+static esp_err_t send_json(cJSON *json)
+{
+  char *text = cJSON_PrintUnformatted(json);
+  if (!text)
+  {
+    return ESP_ERR_NO_MEM;
+  }
+
+  int sent = esp_websocket_client_send_text(ws_client, text, strlen(text), pdMS_TO_TICKS(HA_WS_SEND_TIMEOUT_MS));
+  free(text);
+  return sent < 0 ? ESP_FAIL : ESP_OK;
+}
+
+static void send_auth(void)
+{
+  cJSON *json = cJSON_CreateObject();
+  cJSON_AddStringToObject(json, "type", "auth");
+  cJSON_AddStringToObject(json, "access_token", HA_API_TOKEN);
+
+  ws_state = HA_WS_AUTHENTICATING;
+  if (send_json(json) != ESP_OK)
+  {
+    ESP_LOGW(TAG, "Failed to send auth message");
+  }
+  cJSON_Delete(json);
+}
+
+static void send_subscribe(void)
+{
+  cJSON *json = cJSON_CreateObject();
+  subscription_id = next_message_id++;
+  cJSON_AddNumberToObject(json, "id", subscription_id);
+  cJSON_AddStringToObject(json, "type", "subscribe_entities");
+  cJSON *ids = cJSON_AddArrayToObject(json, "entity_ids");
+  for (int i = 0; i < subscribed_count; i++)
+  {
+    cJSON_AddItemToArray(ids, cJSON_CreateString(subscribed_ids[i]));
+  }
+
+  ws_state = HA_WS_SUBSCRIBING;
+  if (send_json(json) != ESP_OK)
+  {
+    ESP_LOGW(TAG, "Failed to send subscribe_entities");
+  }
+  cJSON_Delete(json);
+}
+
+/**
+ * @brief Deliver the states of one "a" (full) or "c" (changed) map
+ * @param entities Map of entity ID to compressed state
+ * @param diff true for "c" maps, whose new values sit under "+"
+ */
+static void deliver_states(const cJSON *entities, bool diff, uint32_t event_us)
+{
+  const cJSON *entity = NULL;
+  cJSON_ArrayForEach(entity, entities)
+  {
+    const cJSON *values = diff ? cJSON_GetObjectItem(entity, "+") : entity;
+    const cJSON *state = cJSON_GetObjectItem(values, "s");
+
+    // Attribute-only changes carry no "s"
+    if (!cJSON_IsString(state))
+    {
+      continue;
+    }
+
+    ESP_LOGD(TAG, "%s -> %s", entity->string, state->valuestring);
+    stats.updates++;
+    if (state_callback)
+    {
+      state_callback(entity->string, state->valuestring, event_us);
+    }
+  }
+}
+
+/**
+ * @brief Handle one complete text message
+ */
+static void handle_message(const char *text, uint32_t event_us)
+{
+  cJSON *json = cJSON_Parse(text);
+  if (!json)
+  {
+    ESP_LOGW(TAG, "Dropping message that is not JSON");
+    stats.bad_frames++;
+    return;
+  }
+
+  const cJSON *type = cJSON_GetObjectItem(json, "type");
+  const cJSON *id = cJSON_GetObjectItem(json, "id");
+  const char *type_str = cJSON_IsString(type) ? type->valuestring : "";
+
+  if (strcmp(type_str, "auth_required") == 0)
+  {
+    send_auth();
+  }
+  else if (strcmp(type_str, "auth_ok") == 0)
+  {
+    ESP_LOGI(TAG, "Authenticated, subscribing to %d entities", subscribed_count);
+    send_subscribe();
+  }
+  else if (strcmp(type_str, "auth_invalid") == 0)
+  {
+    const cJSON *message = cJSON_GetObjectItem(json, "message");
+    ESP_LOGE(TAG, "Authentication rejected: %s", cJSON_IsString(message) ? message->valuestring : "?");
+    ws_state = HA_WS_AUTH_FAILED;
+  }
+  else if (cJSON_IsNumber(id) && id->valueint == subscription_id)
+  {
+    if (strcmp(type_str, "result") == 0)
+    {
+      if (cJSON_IsTrue(cJSON_GetObjectItem(json, "success")))
+      {
+        ESP_LOGI(TAG, "Subscription live");
+        ws_state = HA_WS_LIVE;
+      }
+      else
+      {
+        ESP_LOGE(TAG, "subscribe_entities rejected, staying on REST polling");
+      }
+    }
+    else if (strcmp(type_str, "event") == 0)
+    {
+      const cJSON *event = cJSON_GetObjectItem(json, "event");
+      const cJSON *added = cJSON_GetObjectItem(event, "a");
+      const cJSON *changed = cJSON_GetObjectItem(event, "c");
+
+      if (added)
+      {
+        stats.snapshots++;
+        deliver_states(added, false, event_us);
+      }
+      if (changed)
+      {
+        deliver_states(changed, true, event_us);
+      }
+    }
+  }
+
+  cJSON_Delete(json);
+}
+
+/**
+ * @brief Append one received piece and handle the message once complete
+ */
+static void receive_data(const esp_websocket_event_data_t *data)
+{
+  if (data->op_code != WS_OPCODE_TEXT && data->op_code != WS_OPCODE_CONTINUATION)
+  {
+    return; // Pings, pongs and close frames are handled by the client
+  }
+
+  // First piece of a frame: a text frame starts a message, a continuation extends it
+  if (data->payload_offset == 0 && data->op_code == WS_OPCODE_TEXT)
+  {
+    message_len = 0;
+    message_discard = false;
+    message_start_us = (uint32_t)esp_timer_get_time();
+  }
+
+  if (message_discard)
+  {
+    return;
+  }
+  if (message_len + data->data_len >= HA_WS_MESSAGE_MAX)
+  {
+    ESP_LOGW(TAG, "Dropping message larger than %d bytes", HA_WS_MESSAGE_MAX);
+    stats.bad_frames++;
+    message_discard = true;
+    return;
+  }
+
+  memcpy(message_buf + message_len, data->data_ptr, data->data_len);
+  message_len += data->data_len;
+
+  // Last piece of the last frame of the message
+  if (data->fin && data->payload_offset + data->data_len >= data->payload_len)
+  {
+    message_buf[message_len] = '\0';
+    handle_message(message_buf, message_start_us);
+    message_len = 0;
+  }
+}
+
+static void websocket_event_handler(void *arg, esp_event_base_t base, int32_t event_id, void *event_data)
+{
+  esp_websocket_event_data_t *data = (esp_websocket_event_data_t *)event_data;
+
+  switch (event_id)
+  {
+  case WEBSOCKET_EVENT_CONNECTED:
+    ESP_LOGI(TAG, "Connected to %s", HA_API_WEBSOCKET_URL);
+    stats.connects++;
+    next_message_id = 1;
+    subscription_id = 0;
+    message_len = 0;
+    if (ws_state != HA_WS_AUTH_FAILED)
+    {
+      ws_state = HA_WS_CONNECTING;
+    }
+    break;
+
+  case WEBSOCKET_EVENT_DISCONNECTED:
+    ESP_LOGW(TAG, "Disconnected, reconnecting in %d ms", HA_WS_RECONNECT_MS);
+    if (ws_state != HA_WS_AUTH_FAILED)
+    {
+      ws_state = HA_WS_CONNECTING;
+    }
+    break;
+
+  case WEBSOCKET_EVENT_DATA:
+    if (ws_state != HA_WS_AUTH_FAILED)
+    {
+      receive_data(data);
+    }
+    break;
+
+  case WEBSOCKET_EVENT_ERROR:
+    ESP_LOGW(TAG, "WebSocket error");
+    break;
+
+  default:
+    break;
+  }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+esp_err_t ha_ws_start(const char *const *entity_ids, int entity_count, ha_ws_state_cb_t callback)
+{
+  if (!entity_ids || entity_count <= 0 || entity_count > HA_WS_MAX_ENTITIES)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (ws_client)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (!message_buf)
+  {
+    message_buf = heap_caps_malloc(HA_WS_MESSAGE_MAX, MALLOC_CAP_SPIRAM);
+    if (!message_buf)
+    {
+      ESP_LOGE(TAG, "Failed to allocate %d byte message buffer", HA_WS_MESSAGE_MAX);
+      return ESP_ERR_NO_MEM;
+    }
+  }
+
+  subscribed_ids = entity_ids;
+  subscribed_count = entity_count;
+  state_callback = callback;
+
+  esp_websocket_client_config_t config = {
+      .uri = HA_API_WEBSOCKET_URL,
+      .task_stack = HA_WS_TASK_STACK,
+      .buffer_size = HA_WS_BUFFER_SIZE,
+      .reconnect_timeout_ms = HA_WS_RECONNECT_MS,
+      .network_timeout_ms = HA_WS_NETWORK_TIMEOUT_MS,
+      .ping_interval_sec = HA_WS_PING_INTERVAL_S,
+      .pingpong_timeout_sec = HA_WS_PONG_TIMEOUT_S,
+  };
+
+  ws_client = esp_websocket_client_init(&config);
+  if (!ws_client)
+  {
+    ESP_LOGE(TAG, "Failed to create WebSocket client");
+    return ESP_ERR_NO_MEM;
+  }
+
+  esp_websocket_register_events(ws_client, WEBSOCKET_EVENT_ANY, websocket_event_handler, NULL);
+
+  ws_state = HA_WS_CONNECTING;
+  esp_err_t ret = esp_websocket_client_start(ws_client);
+  if (ret != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to start WebSocket client: %s", esp_err_to_name(ret));
+    esp_websocket_client_destroy(ws_client);
+    ws_client = NULL;
+    ws_state = HA_WS_STOPPED;
+    return ret;
+  }
+
+  ESP_LOGI(TAG, "WebSocket client started (%s)", HA_API_WEBSOCKET_URL);
+  return ESP_OK;
+}
+
+void ha_ws_stop(void)
+{
+  if (!ws_client)
+  {
+    return;
+  }
+
+  esp_websocket_client_stop(ws_client);
+  esp_websocket_client_destroy(ws_client);
+  ws_client = NULL;
+  ws_state = HA_WS_STOPPED;
+
+  ESP_LOGI(TAG, "WebSocket client stopped (%lu connects, %lu snapshots, %lu updates)",
+           stats.connects, stats.snapshots, stats.updates);
+}
+
+ha_ws_state_t ha_ws_get_state(void)
+{
+  return ws_state;
+}
+
+bool ha_ws_is_live(void)
+{
+  return ws_state == HA_WS_LIVE && ws_client && esp_websocket_client_is_connected(ws_client);
+}
+
+void ha_ws_get_stats(ha_ws_stats_t *out)
+{
+  *out = stats;
+}
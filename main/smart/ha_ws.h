@@ -0,0 +1,117 @@
+/**
+ * @file ha_ws.h
+ * @brief Home Assistant WebSocket subscription client
+ *
+ * Connects to HA's /api/websocket endpoint, authenticates with HA_API_TOKEN
+ * and subscribes to the configured entities with subscribe_entities. HA
+ * answers with the full state of those entities (the "a" map of the first
+ * event) and then pushes only the changes ("c" map). Each state is handed
+ * to the registered callback as it arrives.
+ *
+ * The client reconnects on its own. Every (re)subscription starts with a
+ * full snapshot, so nothing is missed across a reconnect. While the
+ * subscription is not live, callers fall back to REST polling.
+ *
+ * @author System Monitor Dashboard
+ * @date 2025-08-14
+ */
+
+#ifndef HA_WS_H
+#define HA_WS_H
+
+#include <esp_err.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/** Maximum number of subscribed entities */
+#define HA_WS_MAX_ENTITIES 8
+
+  // ═══════════════════════════════════════════════════════════════════════════════
+  // DATA STRUCTURES
+  // ═══════════════════════════════════════════════════════════════════════════════
+
+  /**
+   * @brief Subscription state
+   */
+  typedef enum
+  {
+    HA_WS_STOPPED = 0,    ///< Not started
+    HA_WS_CONNECTING,     ///< Waiting for the connection or auth_required
+    HA_WS_AUTHENTICATING, ///< Auth sent, waiting for auth_ok
+    HA_WS_SUBSCRIBING,    ///< subscribe_entities sent, waiting for its result
+    HA_WS_LIVE,           ///< Subscribed; states are pushed
+    HA_WS_AUTH_FAILED,    ///< Token rejected; stop the client and use REST
+  } ha_ws_state_t;
+
+  /**
+   * @brief Entity state callback
+   * @param entity_id Entity whose state arrived
+   * @param state New state (e.g. "on", "off", "unavailable")
+   * @param event_us Low 32 bits of esp_timer_get_time() when the message arrived
+   * @note Runs in the WebSocket client task; keep it short
+   */
+  typedef void (*ha_ws_state_cb_t)(const char *entity_id, const char *state, uint32_t event_us);
+
+  /**
+   * @brief Subscription counters
+   */
+  typedef struct
+  {
+    uint32_t connects;   ///< Connections made
+    uint32_t snapshots;  ///< Full-state events (one per subscription)
+    uint32_t updates;    ///< Entity states delivered to the callback
+    uint32_t bad_frames; ///< Messages dropped (oversized or not JSON)
+  } ha_ws_stats_t;
+
+  // ═══════════════════════════════════════════════════════════════════════════════
+  // PUBLIC FUNCTION DECLARATIONS
+  // ═══════════════════════════════════════════════════════════════════════════════
+
+  /**
+   * @brief Connect and subscribe to entity state changes
+   *
+   * @param entity_ids Entities to subscribe to (pointers must stay valid)
+   * @param entity_count Number of entities, at most HA_WS_MAX_ENTITIES
+   * @param callback Called for every entity state received
+   * @return ESP_OK on success, ESP_ERR_INVALID_ARG, ESP_ERR_INVALID_STATE if
+   *         already started, ESP_ERR_NO_MEM or a WebSocket client error
+   */
+  esp_err_t ha_ws_start(const char *const *entity_ids, int entity_count, ha_ws_state_cb_t callback);
+
+  /**
+   * @brief Disconnect and release the client
+   * @note Must not be called from the state callback
+   */
+  void ha_ws_stop(void);
+
+  /**
+   * @brief Get the subscription state
+   */
+  ha_ws_state_t ha_ws_get_state(void);
+
+  /**
+   * @brief Check whether states are currently being pushed
+   * @return true while subscribed; REST polling can be skipped
+   */
+  bool ha_ws_is_live(void);
+
+  /**
+   * @brief Read the subscription counters
+   * @param stats Receives the counters
+   */
+  void ha_ws_get_stats(ha_ws_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HA_WS_H
@@ -27,6 +27,7 @@
 #define HA_API_BASE_URL "http://" HA_SERVER_HOST_NAME ":" TOSTRING(HA_SERVER_PORT) "/api"
 #define HA_API_STATES_URL HA_API_BASE_URL "/states"
 #define HA_API_SERVICES_URL HA_API_BASE_URL "/services"
+#define HA_API_WEBSOCKET_URL "ws://" HA_SERVER_HOST_NAME ":" TOSTRING(HA_SERVER_PORT) "/api/websocket"
 
 // ═══════════════════════════════════════════════════════════════════════════════
 // SMART HOME ENTITY CONFIGURATION
@@ -62,6 +63,8 @@
 // HTTP Request Configuration
 #define HA_HTTP_TIMEOUT_MS 10000
 #define HA_MAX_RESPONSE_SIZE 4096
+#define HA_HTTP_REUSE_CONNECTION 1 // Reuse one connection for all requests (0 = reconnect per request)
+#define HA_HTTP_GZIP 1             // Request gzip-compressed responses and inflate them while streaming
 
 // API Call Intervals
 #define HA_STATUS_UPDATE_INTERVAL_MS 5000 // Status check every 5 seconds
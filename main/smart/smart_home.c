@@ -458,8 +458,6 @@ esp_err_t smart_home_trigger_scene(void)
       .service = "turn_on",
       .entity_id = HA_ENTITY_D};
 
-  ha_api_response_t response;
-  esp_err_t ret = ha_api_call_service(&scene_call, &response);
-
-  return ret;
+  // The states the scene changed are reported through the ha_api state listener
+  return ha_api_call_service(&scene_call, NULL);
 }
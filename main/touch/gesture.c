@@ -0,0 +1,278 @@
+/**
+ * @file gesture.c
+ * @brief Multi-touch gesture recognizer
+ *
+ * Contacts are matched to tracks by the controller's track ID, so a finger
+ * keeps its start point however the controller orders its report. A track
+ * that is missing from a frame has lifted.
+ */
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "gesture.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static uint32_t isqrt(uint32_t value)
+{
+  uint32_t root = 0;
+  uint32_t bit = 1u << 30;
+
+  while (bit > value)
+    bit >>= 2;
+
+  while (bit)
+  {
+    if (value >= root + bit)
+    {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+    {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+static int32_t distance(const gesture_track_t *a, const gesture_track_t *b)
+{
+  int32_t dx = a->x - b->x;
+  int32_t dy = a->y - b->y;
+  return (int32_t)isqrt((uint32_t)(dx * dx + dy * dy));
+}
+
+static gesture_track_t *find_track(gesture_engine_t *engine, uint8_t track_id)
+{
+  gesture_track_t *free_track = NULL;
+
+  for (int i = 0; i < GESTURE_MAX_CONTACTS; i++)
+  {
+    gesture_track_t *track = &engine->tracks[i];
+    if (track->active && track->track_id == track_id)
+      return track;
+    if (!track->active && !free_track)
+      free_track = track;
+  }
+  return free_track;
+}
+
+static gesture_event_t *emit(gesture_event_t *events, uint32_t max_events, uint32_t *count, gesture_type_t type)
+{
+  if (*count >= max_events)
+    return NULL;
+
+  gesture_event_t *event = &events[(*count)++];
+  memset(event, 0, sizeof(*event));
+  event->type = type;
+  return event;
+}
+
+static void begin_sequence(gesture_engine_t *engine, uint32_t now_ms)
+{
+  memset(engine, 0, sizeof(*engine));
+  engine->in_sequence = true;
+  engine->start_ms = now_ms;
+}
+
+/**
+ * @brief Classify a lifted single finger as a swipe
+ */
+static void check_swipe(const gesture_engine_t *engine, const gesture_track_t *track, uint32_t now_ms,
+                        gesture_event_t *events, uint32_t max_events, uint32_t *count)
+{
+  if (engine->max_contacts != 1 || engine->long_press_sent || now_ms - engine->start_ms > GESTURE_SWIPE_MAX_MS)
+    return;
+
+  int32_t dx = track->x - track->start_x;
+  int32_t dy = track->y - track->start_y;
+  int32_t adx = abs(dx);
+  int32_t ady = abs(dy);
+  gesture_dir_t dir;
+
+  // The dominant axis must be at least twice the other one
+  if (adx >= GESTURE_SWIPE_MIN_PX && adx >= 2 * ady)
+    dir = dx < 0 ? GESTURE_DIR_LEFT : GESTURE_DIR_RIGHT;
+  else if (ady >= GESTURE_SWIPE_MIN_PX && ady >= 2 * adx)
+    dir = dy < 0 ? GESTURE_DIR_UP : GESTURE_DIR_DOWN;
+  else
+    return;
+
+  gesture_event_t *event = emit(events, max_events, count, GESTURE_SWIPE);
+  if (event)
+  {
+    event->dir = dir;
+    event->x = track->start_x;
+    event->y = track->start_y;
+  }
+}
+
+static void emit_pinch(gesture_engine_t *engine, gesture_phase_t phase, int32_t scale_q8, gesture_event_t *events,
+                       uint32_t max_events, uint32_t *count)
+{
+  gesture_event_t *event = emit(events, max_events, count, GESTURE_PINCH);
+  if (event)
+  {
+    event->phase = phase;
+    event->x = engine->mid_x;
+    event->y = engine->mid_y;
+    event->scale_q8 = scale_q8;
+  }
+  engine->pinch_last_q8 = scale_q8;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void gesture_init(gesture_engine_t *engine)
+{
+  memset(engine, 0, sizeof(*engine));
+}
+
+uint32_t gesture_update(gesture_engine_t *engine, const gesture_contact_t *contacts, uint8_t count,
+                        uint32_t now_ms, gesture_event_t *events, uint32_t max_events)
+{
+  uint32_t n = 0;
+  bool seen[GESTURE_MAX_CONTACTS] = {false};
+
+  if (count > 0 && !engine->in_sequence)
+    begin_sequence(engine, now_ms);
+
+  // Match contacts to tracks
+  for (uint8_t c = 0; c < count; c++)
+  {
+    gesture_track_t *track = find_track(engine, contacts[c].track_id);
+    if (!track)
+      continue;
+
+    if (!track->active)
+    {
+      track->active = true;
+      track->track_id = contacts[c].track_id;
+      track->start_x = contacts[c].x;
+      track->start_y = contacts[c].y;
+    }
+    track->x = contacts[c].x;
+    track->y = contacts[c].y;
+    seen[track - engine->tracks] = true;
+
+    if (abs(track->x - track->start_x) > GESTURE_SLOP_PX || abs(track->y - track->start_y) > GESTURE_SLOP_PX)
+      engine->moved = true;
+  }
+
+  // Release tracks missing from this frame
+  uint8_t active = 0;
+  gesture_track_t *pair[2] = {NULL, NULL};
+  for (int i = 0; i < GESTURE_MAX_CONTACTS; i++)
+  {
+    gesture_track_t *track = &engine->tracks[i];
+    if (!track->active)
+      continue;
+
+    if (!seen[i])
+    {
+      check_swipe(engine, track, now_ms, events, max_events, &n);
+      track->active = false;
+      continue;
+    }
+    if (active < 2)
+      pair[active] = track;
+    active++;
+  }
+  if (active > engine->max_contacts)
+    engine->max_contacts = active;
+
+  // Long press: one finger, held still
+  if (active == 1 && engine->max_contacts == 1 && !engine->moved && !engine->long_press_sent &&
+      now_ms - engine->start_ms >= GESTURE_LONG_PRESS_MS)
+  {
+    engine->long_press_sent = true;
+    gesture_event_t *event = emit(events, max_events, &n, GESTURE_LONG_PRESS);
+    if (event)
+    {
+      event->x = pair[0]->x;
+      event->y = pair[0]->y;
+    }
+  }
+
+  // Pinch: exactly two fingers, scale relative to where they landed
+  if (active == 2)
+  {
+    int32_t dist = distance(pair[0], pair[1]);
+    engine->mid_x = (int16_t)((pair[0]->x + pair[1]->x) / 2);
+    engine->mid_y = (int16_t)((pair[0]->y + pair[1]->y) / 2);
+
+    if (engine->pinch_base_dist == 0)
+    {
+      engine->pinch_base_dist = dist > 0 ? dist : 1;
+    }
+    else
+    {
+      int32_t scale_q8 = dist * GESTURE_SCALE_ONE / engine->pinch_base_dist;
+
+      if (!engine->pinching && abs(dist - engine->pinch_base_dist) >= GESTURE_PINCH_MIN_PX)
+      {
+        engine->pinching = true;
+        engine->moved = true;
+        emit_pinch(engine, GESTURE_PHASE_BEGIN, scale_q8, events, max_events, &n);
+      }
+      else if (engine->pinching && abs(scale_q8 - engine->pinch_last_q8) >= GESTURE_PINCH_STEP_Q8)
+      {
+        emit_pinch(engine, GESTURE_PHASE_UPDATE, scale_q8, events, max_events, &n);
+      }
+    }
+  }
+  else
+  {
+    if (engine->pinching)
+    {
+      engine->pinching = false;
+      emit_pinch(engine, GESTURE_PHASE_END, engine->pinch_last_q8, events, max_events, &n);
+    }
+    engine->pinch_base_dist = 0;
+  }
+
+  // Sequence end: two-finger tap if both fingers stayed put
+  if (active == 0 && engine->in_sequence)
+  {
+    if (engine->max_contacts == 2 && !engine->moved && now_ms - engine->start_ms <= GESTURE_TAP_MAX_MS)
+    {
+      gesture_event_t *event = emit(events, max_events, &n, GESTURE_TWO_FINGER_TAP);
+      if (event)
+      {
+        event->x = engine->mid_x;
+        event->y = engine->mid_y;
+      }
+    }
+    engine->in_sequence = false;
+  }
+
+  return n;
+}
+
+const char *gesture_type_name(gesture_type_t type)
+{
+  switch (type)
+  {
+  case GESTURE_SWIPE:
+    return "swipe";
+  case GESTURE_PINCH:
+    return "pinch";
+  case GESTURE_TWO_FINGER_TAP:
+    return "two-finger tap";
+  case GESTURE_LONG_PRESS:
+    return "long press";
+  default:
+    return "unknown";
+  }
+}
@@ -0,0 +1,145 @@
+/**
+ * @file gesture.h
+ * @brief Multi-touch gesture recognizer
+ *
+ * Fed one frame of contacts at a time (as reported by the touch
+ * controller), the recognizer follows every finger by its track ID and
+ * emits swipe, pinch, two-finger tap and long-press events. It uses
+ * integer arithmetic only (pinch scale is Q8.8), keeps all state in the
+ * caller-provided gesture_engine_t and never allocates; a frame costs a
+ * few dozen integer operations per contact.
+ *
+ * A touch sequence runs from the first finger down to the last finger up.
+ * Once a second finger has landed, the sequence can only produce two-finger
+ * gestures.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define GESTURE_MAX_CONTACTS 5    ///< Fingers tracked at once (GT911 reports up to 5)
+#define GESTURE_SLOP_PX 12        ///< Movement still counted as holding still
+#define GESTURE_SWIPE_MIN_PX 80   ///< Shortest swipe
+#define GESTURE_SWIPE_MAX_MS 500  ///< Slowest swipe
+#define GESTURE_LONG_PRESS_MS 600 ///< Hold time for a long press
+#define GESTURE_TAP_MAX_MS 300    ///< Longest two-finger tap
+#define GESTURE_PINCH_MIN_PX 20   ///< Finger distance change that starts a pinch
+#define GESTURE_PINCH_STEP_Q8 8   ///< Scale change (1/32) between pinch updates
+
+#define GESTURE_SCALE_ONE 256 ///< Pinch scale 1.0 in Q8.8
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+typedef enum
+{
+  GESTURE_SWIPE = 0,      ///< One finger moved quickly in one direction and lifted
+  GESTURE_PINCH,          ///< Distance between two fingers changing
+  GESTURE_TWO_FINGER_TAP, ///< Two fingers down and up without moving
+  GESTURE_LONG_PRESS,     ///< One finger held still
+} gesture_type_t;
+
+typedef enum
+{
+  GESTURE_DIR_LEFT = 0,
+  GESTURE_DIR_RIGHT,
+  GESTURE_DIR_UP,
+  GESTURE_DIR_DOWN,
+} gesture_dir_t;
+
+typedef enum
+{
+  GESTURE_PHASE_BEGIN = 0, ///< First pinch event of the sequence
+  GESTURE_PHASE_UPDATE,    ///< Scale changed by at least GESTURE_PINCH_STEP_Q8
+  GESTURE_PHASE_END,       ///< A finger lifted; scale is final
+} gesture_phase_t;
+
+/**
+ * @brief Recognized gesture
+ */
+typedef struct
+{
+  gesture_type_t type;
+  gesture_dir_t dir;     ///< Swipe direction
+  gesture_phase_t phase; ///< Pinch phase
+  int16_t x;             ///< Swipe start, pinch/tap midpoint or long-press point
+  int16_t y;
+  int32_t scale_q8;      ///< Pinch: finger distance / distance at pinch start (Q8.8)
+} gesture_event_t;
+
+/**
+ * @brief One contact of a frame
+ */
+typedef struct
+{
+  uint8_t track_id;
+  int16_t x;
+  int16_t y;
+} gesture_contact_t;
+
+/**
+ * @brief A finger followed across frames
+ */
+typedef struct
+{
+  bool active;
+  uint8_t track_id;
+  int16_t start_x;
+  int16_t start_y;
+  int16_t x;
+  int16_t y;
+} gesture_track_t;
+
+/**
+ * @brief Recognizer state (zero-initialize or use gesture_init)
+ */
+typedef struct
+{
+  gesture_track_t tracks[GESTURE_MAX_CONTACTS];
+  uint32_t start_ms;        ///< First finger down
+  uint8_t max_contacts;     ///< Most fingers down at once in this sequence
+  bool in_sequence;         ///< At least one finger down
+  bool moved;               ///< A finger left its slop circle
+  bool long_press_sent;
+  bool pinching;
+  int16_t mid_x;            ///< Midpoint of the two fingers
+  int16_t mid_y;
+  int32_t pinch_base_dist;  ///< Finger distance when the second finger landed (0 = none)
+  int32_t pinch_last_q8;    ///< Scale of the last pinch event
+} gesture_engine_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION PROTOTYPES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Reset the recognizer
+ */
+void gesture_init(gesture_engine_t *engine);
+
+/**
+ * @brief Feed one frame of contacts
+ * @param engine Recognizer state
+ * @param contacts Contacts currently down (count 0 = all fingers lifted)
+ * @param count Number of contacts
+ * @param now_ms Frame time in milliseconds
+ * @param events Receives recognized gestures
+ * @param max_events Capacity of events
+ * @return Number of events written
+ * @note Call for every report while a finger is down, even if nothing
+ *       moved, so long presses are recognized on time
+ */
+uint32_t gesture_update(gesture_engine_t *engine, const gesture_contact_t *contacts, uint8_t count,
+                        uint32_t now_ms, gesture_event_t *events, uint32_t max_events);
+
+/**
+ * @brief Printable name of a gesture type
+ */
+const char *gesture_type_name(gesture_type_t type);
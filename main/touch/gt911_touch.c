@@ -8,14 +8,35 @@
  * - LVGL integration with input device callback
  * - Touch coordinate calibration
  * - Hardware reset and configuration
+ *
+ * After gt911_start() a touch task owns the bus. It reads the controller
+ * after each INT edge (or on a poll period when INT is not usable) and
+ * publishes the first contact as one packed 32-bit word, which the LVGL
+ * read callback loads without locks or I2C traffic. Every frame, with all
+ * contacts, also goes through the gesture recognizer in the same task.
+ *
+ * Touch traces: while recording, every frame the controller reports is
+ * appended to a PSRAM trace (see touch_trace.h). A replay feeds the trace
+ * back through the same publish path in place of the I2C read, with the
+ * original timing, so LVGL, gestures and the latency measurement see
+ * exactly what they saw live. Each published change is time-stamped; the
+ * LVGL side collects the stamp with gt911_take_input_time() to measure
+ * touch-to-flush latency.
  */
 
 #include "gt911_touch.h"
 
 #include "driver/gpio.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
+#include "touch_trace.h"
+#include <stdatomic.h>
+#include <stdio.h>
 #include <string.h>
 
 static const char *TAG = "gt911_touch";
@@ -24,6 +45,43 @@ static const char *TAG = "gt911_touch";
 static bool gt911_initialized = false;
 static gt911_touch_data_t last_touch_data = {0};
 static uint8_t gt911_i2c_addr = GT911_I2C_ADDR_1; // Default address
+static i2c_master_bus_handle_t gt911_bus = NULL;
+static i2c_master_dev_handle_t gt911_dev = NULL;   // Persistent handle at the detected address
+
+// Touch task and published state
+#define SLOT_PRESSED (1u << 31) // Packed slot: pressed | y << 16 | x
+
+static TaskHandle_t touch_task_handle = NULL;
+static int touch_irq_gpio = -1;
+static gt911_event_cb_t touch_event_cb = NULL;
+static atomic_uint touch_slot = 0;  ///< Current first contact, 0 = released
+static atomic_uint touch_latch = 0; ///< Last press not yet seen by gt911_lvgl_read()
+static atomic_uint touch_input_us = 0; ///< Oldest published change not yet taken by LVGL
+static gesture_engine_t gesture_engine; ///< Touch task only
+static _Atomic gt911_gesture_cb_t gesture_handler = NULL;
+
+// Touch trace (frames appended/replayed in the touch task, commands from any task)
+typedef enum
+{
+  TRACE_OFF = 0,
+  TRACE_RECORD,
+  TRACE_REPLAY,
+} trace_mode_t;
+
+static SemaphoreHandle_t trace_lock = NULL; ///< Guards the trace and the replay state
+static atomic_int trace_mode = TRACE_OFF;
+static touch_trace_t trace;
+static int64_t trace_start_us = 0;        ///< Recording start, or replay time origin
+static touch_trace_cursor_t replay_cursor;
+static touch_trace_frame_t replay_frame;  ///< Next frame to replay
+static bool replay_pending = false;       ///< replay_frame holds a frame
+static uint32_t load_expected_frames = 0; ///< Frames announced by "TTRACE begin"
+
+// Bus statistics
+static atomic_uint stat_irqs = 0;
+static uint32_t stat_transactions = 0; ///< I2C transactions (touch task after start)
+static uint32_t stat_bus_us = 0;       ///< Time spent in those transactions
+static uint32_t stat_reports = 0;      ///< Reads that returned new data
 
 // ═══════════════════════════════════════════════════════════════════════════════
 // PRIVATE FUNCTION PROTOTYPES
@@ -35,6 +93,7 @@ static esp_err_t gt911_i2c_read_reg(uint16_t reg_addr, uint8_t *data, size_t len
 static esp_err_t gt911_hardware_reset(void);
 static esp_err_t gt911_detect_i2c_address(void);
 static void gt911_parse_touch_data(uint8_t *raw_data, gt911_touch_data_t *touch_data);
+static void gt911_touch_task(void *arg);
 
 // ═══════════════════════════════════════════════════════════════════════════════
 // I2C COMMUNICATION FUNCTIONS
@@ -45,26 +104,19 @@ static void gt911_parse_touch_data(uint8_t *raw_data, gt911_touch_data_t *touch_
  */
 static esp_err_t gt911_i2c_init(void)
 {
-  i2c_config_t conf = {
-      .mode = I2C_MODE_MASTER,
+  i2c_master_bus_config_t bus_config = {
+      .i2c_port = GT911_I2C_NUM,
       .sda_io_num = GT911_SDA_GPIO,
       .scl_io_num = GT911_SCL_GPIO,
-      .sda_pullup_en = GPIO_PULLUP_ENABLE,
-      .scl_pullup_en = GPIO_PULLUP_ENABLE,
-      .master.clk_speed = GT911_I2C_FREQ_HZ,
+      .clk_source = I2C_CLK_SRC_DEFAULT,
+      .glitch_ignore_cnt = 7,
+      .flags.enable_internal_pullup = true,
   };
 
-  esp_err_t ret = i2c_param_config(GT911_I2C_NUM, &conf);
-  if (ret != ESP_OK)
-  {
-    ESP_LOGE(TAG, "I2C param config failed: %s", esp_err_to_name(ret));
-    return ret;
-  }
-
-  ret = i2c_driver_install(GT911_I2C_NUM, conf.mode, 0, 0, 0);
+  esp_err_t ret = i2c_new_master_bus(&bus_config, &gt911_bus);
   if (ret != ESP_OK)
   {
-    ESP_LOGE(TAG, "I2C driver install failed: %s", esp_err_to_name(ret));
+    ESP_LOGE(TAG, "I2C bus creation failed: %s", esp_err_to_name(ret));
     return ret;
   }
 
@@ -72,25 +124,37 @@ static esp_err_t gt911_i2c_init(void)
   return ESP_OK;
 }
 
+/**
+ * @brief Account one transaction in the bus statistics
+ */
+static void gt911_count_transaction(int64_t start_us)
+{
+  stat_transactions++;
+  stat_bus_us += (uint32_t)(esp_timer_get_time() - start_us);
+}
+
 /**
  * @brief Write data to GT911 register
  */
 static esp_err_t gt911_i2c_write_reg(uint16_t reg_addr, uint8_t *data, size_t len)
 {
-  i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-  i2c_master_start(cmd);
-  i2c_master_write_byte(cmd, (gt911_i2c_addr << 1) | I2C_MASTER_WRITE, true);
-  i2c_master_write_byte(cmd, (reg_addr >> 8) & 0xFF, true); // Register address high byte
-  i2c_master_write_byte(cmd, reg_addr & 0xFF, true);        // Register address low byte
+  uint8_t buf[2 + GT911_I2C_WRITE_MAX];
+
+  if (len > GT911_I2C_WRITE_MAX)
+  {
+    return ESP_ERR_INVALID_SIZE;
+  }
 
+  buf[0] = (reg_addr >> 8) & 0xFF; // Register address high byte
+  buf[1] = reg_addr & 0xFF;        // Register address low byte
   if (data && len > 0)
   {
-    i2c_master_write(cmd, data, len, true);
+    memcpy(&buf[2], data, len);
   }
 
-  i2c_master_stop(cmd);
-  esp_err_t ret = i2c_master_cmd_begin(GT911_I2C_NUM, cmd, pdMS_TO_TICKS(GT911_I2C_TIMEOUT_MS));
-  i2c_cmd_link_delete(cmd);
+  int64_t start_us = esp_timer_get_time();
+  esp_err_t ret = i2c_master_transmit(gt911_dev, buf, 2 + len, GT911_I2C_TIMEOUT_MS);
+  gt911_count_transaction(start_us);
 
   if (ret != ESP_OK)
   {
@@ -102,6 +166,7 @@ static esp_err_t gt911_i2c_write_reg(uint16_t reg_addr, uint8_t *data, size_t le
 
 /**
  * @brief Read data from GT911 register
+ * @note Register address write, repeated start and read in one transaction
  */
 static esp_err_t gt911_i2c_read_reg(uint16_t reg_addr, uint8_t *data, size_t len)
 {
@@ -110,24 +175,11 @@ static esp_err_t gt911_i2c_read_reg(uint16_t reg_addr, uint8_t *data, size_t len
     return ESP_ERR_INVALID_ARG;
   }
 
-  i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-  i2c_master_start(cmd);
-  i2c_master_write_byte(cmd, (gt911_i2c_addr << 1) | I2C_MASTER_WRITE, true);
-  i2c_master_write_byte(cmd, (reg_addr >> 8) & 0xFF, true); // Register address high byte
-  i2c_master_write_byte(cmd, reg_addr & 0xFF, true);        // Register address low byte
-
-  i2c_master_start(cmd); // Repeated start
-  i2c_master_write_byte(cmd, (gt911_i2c_addr << 1) | I2C_MASTER_READ, true);
-
-  if (len > 1)
-  {
-    i2c_master_read(cmd, data, len - 1, I2C_MASTER_ACK);
-  }
-  i2c_master_read_byte(cmd, &data[len - 1], I2C_MASTER_NACK);
+  uint8_t reg[2] = {(reg_addr >> 8) & 0xFF, reg_addr & 0xFF};
 
-  i2c_master_stop(cmd);
-  esp_err_t ret = i2c_master_cmd_begin(GT911_I2C_NUM, cmd, pdMS_TO_TICKS(GT911_I2C_TIMEOUT_MS));
-  i2c_cmd_link_delete(cmd);
+  int64_t start_us = esp_timer_get_time();
+  esp_err_t ret = i2c_master_transmit_receive(gt911_dev, reg, sizeof(reg), data, len, GT911_I2C_TIMEOUT_MS);
+  gt911_count_transaction(start_us);
 
   if (ret != ESP_OK)
   {
@@ -182,26 +234,36 @@ static esp_err_t gt911_hardware_reset(void)
  */
 static esp_err_t gt911_detect_i2c_address(void)
 {
-  uint8_t test_data;
-
-  // Try first address (0x5D - INT low during reset)
-  gt911_i2c_addr = GT911_I2C_ADDR_1;
-  if (gt911_i2c_read_reg(GT911_REG_ID, &test_data, 1) == ESP_OK)
+  // Try first address (0x5D - INT low during reset), then second (0x14 - INT high)
+  if (i2c_master_probe(gt911_bus, GT911_I2C_ADDR_1, GT911_I2C_TIMEOUT_MS) == ESP_OK)
   {
-    ESP_LOGI(TAG, "GT911 detected at address 0x%02X", gt911_i2c_addr);
-    return ESP_OK;
+    gt911_i2c_addr = GT911_I2C_ADDR_1;
+  }
+  else if (i2c_master_probe(gt911_bus, GT911_I2C_ADDR_2, GT911_I2C_TIMEOUT_MS) == ESP_OK)
+  {
+    gt911_i2c_addr = GT911_I2C_ADDR_2;
+  }
+  else
+  {
+    ESP_LOGE(TAG, "GT911 not found at any address");
+    return ESP_FAIL;
   }
 
-  // Try second address (0x14 - INT high during reset)
-  gt911_i2c_addr = GT911_I2C_ADDR_2;
-  if (gt911_i2c_read_reg(GT911_REG_ID, &test_data, 1) == ESP_OK)
+  // One device handle for the lifetime of the driver
+  i2c_device_config_t dev_config = {
+      .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+      .device_address = gt911_i2c_addr,
+      .scl_speed_hz = GT911_I2C_FREQ_HZ,
+  };
+  esp_err_t ret = i2c_master_bus_add_device(gt911_bus, &dev_config, &gt911_dev);
+  if (ret != ESP_OK)
   {
-    ESP_LOGI(TAG, "GT911 detected at address 0x%02X", gt911_i2c_addr);
-    return ESP_OK;
+    ESP_LOGE(TAG, "I2C device add failed: %s", esp_err_to_name(ret));
+    return ret;
   }
 
-  ESP_LOGE(TAG, "GT911 not found at any address");
-  return ESP_FAIL;
+  ESP_LOGI(TAG, "GT911 detected at address 0x%02X", gt911_i2c_addr);
+  return ESP_OK;
 }
 
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -243,6 +305,269 @@ static void gt911_parse_touch_data(uint8_t *raw_data, gt911_touch_data_t *touch_
   touch_data->data_ready = (touch_data->touch_count > 0);
 }
 
+// ═══════════════════════════════════════════════════════════════════════════════
+// TOUCH TRACE
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Allocate the PSRAM trace buffer on first use
+ * @note Call with trace_lock held
+ */
+static esp_err_t gt911_trace_alloc(void)
+{
+  if (trace.buf)
+  {
+    return ESP_OK;
+  }
+
+  uint8_t *buf = heap_caps_malloc(GT911_TRACE_BUFFER_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!buf)
+  {
+    ESP_LOGE(TAG, "No PSRAM for the %d byte touch trace", GT911_TRACE_BUFFER_SIZE);
+    return ESP_ERR_NO_MEM;
+  }
+  touch_trace_init(&trace, buf, GT911_TRACE_BUFFER_SIZE);
+  return ESP_OK;
+}
+
+/**
+ * @brief Append a frame reported by the controller while recording
+ * @note Touch task only
+ */
+static void gt911_trace_capture(const gt911_touch_data_t *touch_data)
+{
+  if (atomic_load(&trace_mode) != TRACE_RECORD)
+  {
+    return;
+  }
+
+  touch_trace_frame_t frame = {
+      .time_ms = (uint32_t)((esp_timer_get_time() - trace_start_us) / 1000),
+      .count = touch_data->touch_count,
+  };
+  for (uint8_t i = 0; i < touch_data->touch_count; i++)
+  {
+    frame.points[i].track_id = touch_data->points[i].track_id;
+    frame.points[i].x = touch_data->points[i].x;
+    frame.points[i].y = touch_data->points[i].y;
+  }
+
+  xSemaphoreTake(trace_lock, portMAX_DELAY);
+  if (atomic_load(&trace_mode) == TRACE_RECORD && !touch_trace_append(&trace, &frame) && trace.dropped == 1)
+  {
+    ESP_LOGW(TAG, "Touch trace full after %lu frames, later frames dropped", trace.frames);
+  }
+  xSemaphoreGive(trace_lock);
+}
+
+/**
+ * @brief Milliseconds until the next replayed frame is due (0 = due now)
+ */
+static uint32_t gt911_trace_replay_wait_ms(void)
+{
+  if (!replay_pending)
+  {
+    return 0;
+  }
+
+  int64_t due_us = trace_start_us + (int64_t)replay_frame.time_ms * 1000;
+  int64_t left_us = due_us - esp_timer_get_time();
+  return left_us > 0 ? (uint32_t)((left_us + 999) / 1000) : 0;
+}
+
+/**
+ * @brief Take the next replayed frame if it is due
+ * @param touch_data Receives the frame; a release once the trace is exhausted
+ * @return true if touch_data was filled
+ * @note Touch task only. The replay ends after the release.
+ */
+static bool gt911_trace_replay_take(gt911_touch_data_t *touch_data)
+{
+  bool taken = false;
+
+  xSemaphoreTake(trace_lock, portMAX_DELAY);
+  if (atomic_load(&trace_mode) == TRACE_REPLAY && gt911_trace_replay_wait_ms() == 0)
+  {
+    memset(touch_data, 0, sizeof(*touch_data));
+    if (replay_pending)
+    {
+      touch_data->touch_count = replay_frame.count;
+      for (uint8_t i = 0; i < replay_frame.count; i++)
+      {
+        touch_data->points[i].track_id = replay_frame.points[i].track_id;
+        touch_data->points[i].x = replay_frame.points[i].x;
+        touch_data->points[i].y = replay_frame.points[i].y;
+        touch_data->points[i].pressed = true;
+      }
+      touch_data->data_ready = touch_data->touch_count > 0;
+      replay_pending = touch_trace_next(&trace, &replay_cursor, &replay_frame);
+    }
+    else
+    {
+      atomic_store(&trace_mode, TRACE_OFF);
+      ESP_LOGI(TAG, "Touch trace replay finished (%lu frames)", trace.frames);
+    }
+    taken = true;
+  }
+  xSemaphoreGive(trace_lock);
+
+  return taken;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// TOUCH TASK
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static void IRAM_ATTR gt911_irq_handler(void *arg)
+{
+  BaseType_t high_task_woken = pdFALSE;
+
+  atomic_fetch_add_explicit(&stat_irqs, 1, memory_order_relaxed);
+  vTaskNotifyGiveFromISR(touch_task_handle, &high_task_woken);
+  if (high_task_woken == pdTRUE)
+  {
+    portYIELD_FROM_ISR();
+  }
+}
+
+/**
+ * @brief Feed all contacts of a frame to the gesture recognizer
+ */
+static void gt911_run_gestures(const gt911_touch_data_t *touch_data)
+{
+  gt911_gesture_cb_t handler = atomic_load(&gesture_handler);
+  gesture_contact_t contacts[GT911_MAX_TOUCH_POINTS];
+  gesture_event_t events[4];
+
+  if (!handler)
+    return;
+
+  for (uint8_t i = 0; i < touch_data->touch_count; i++)
+  {
+    contacts[i].track_id = touch_data->points[i].track_id;
+    contacts[i].x = (int16_t)touch_data->points[i].x;
+    contacts[i].y = (int16_t)touch_data->points[i].y;
+  }
+
+  uint32_t count = gesture_update(&gesture_engine, contacts, touch_data->touch_count,
+                                  (uint32_t)(esp_timer_get_time() / 1000), events,
+                                  sizeof(events) / sizeof(events[0]));
+  for (uint32_t i = 0; i < count; i++)
+  {
+    handler(&events[i]);
+  }
+}
+
+static void gt911_log_stats(uint32_t elapsed_ms)
+{
+  ESP_LOGI(TAG, "Touch bus (%s): %lu INT edges, %lu reports, %lu I2C transactions, %lu us on the bus in %lu s",
+           touch_irq_gpio >= 0 ? "interrupt" : "polled", atomic_exchange(&stat_irqs, 0),
+           stat_reports, stat_transactions, stat_bus_us, elapsed_ms / 1000);
+  if (stat_reports > 0)
+  {
+    // Per touch frame: the combined read plus the status clear
+    ESP_LOGI(TAG, "Touch bus per frame: %lu.%lu transactions, %lu us",
+             stat_transactions / stat_reports, stat_transactions * 10 / stat_reports % 10,
+             stat_bus_us / stat_reports);
+  }
+  stat_reports = 0;
+  stat_transactions = 0;
+  stat_bus_us = 0;
+}
+
+/**
+ * @brief Read the controller when it signals (or on the poll period) and
+ *        publish the first contact
+ */
+static void gt911_touch_task(void *arg)
+{
+  gt911_touch_data_t touch_data;
+  uint32_t published = 0;
+  TickType_t stats_start = xTaskGetTickCount();
+
+  while (1)
+  {
+    bool pressed = published & SLOT_PRESSED;
+    TickType_t wait;
+
+    if (atomic_load(&trace_mode) == TRACE_REPLAY)
+    {
+      wait = (gt911_trace_replay_wait_ms() + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+    }
+    else if (touch_irq_gpio >= 0)
+    {
+      wait = pdMS_TO_TICKS(pressed ? GT911_RELEASE_TIMEOUT_MS : GT911_STATS_INTERVAL_MS);
+    }
+    else
+    {
+      wait = pdMS_TO_TICKS(pressed ? GT911_POLL_ACTIVE_MS : GT911_POLL_IDLE_MS);
+    }
+
+    uint32_t notified = ulTaskNotifyTake(pdTRUE, wait);
+
+    TickType_t now = xTaskGetTickCount();
+    if (now - stats_start >= pdMS_TO_TICKS(GT911_STATS_INTERVAL_MS))
+    {
+      gt911_log_stats((now - stats_start) * portTICK_PERIOD_MS);
+      stats_start = now;
+    }
+
+    if (atomic_load(&trace_mode) == TRACE_REPLAY)
+    {
+      // Replayed frames stand in for the controller; real touches are ignored
+      if (!gt911_trace_replay_take(&touch_data))
+        continue;
+    }
+    else
+    {
+      // Untouched and no INT edge: leave the bus alone
+      if (touch_irq_gpio >= 0 && !notified && !pressed)
+        continue;
+
+      if (gt911_read_touch(&touch_data) != ESP_OK)
+        continue;
+    }
+    uint32_t read_us = (uint32_t)esp_timer_get_time();
+
+    // Every read, not just changes: long presses need the clock to advance
+    gt911_run_gestures(&touch_data);
+
+    uint32_t slot = 0;
+    if (touch_data.touch_count > 0)
+    {
+      slot = SLOT_PRESSED | ((uint32_t)touch_data.points[0].y << 16) | touch_data.points[0].x;
+    }
+    if (slot == published)
+      continue;
+
+    atomic_store(&touch_slot, slot);
+    if (slot)
+    {
+      atomic_store(&touch_latch, slot);
+    }
+
+    // Keep the oldest change LVGL has not picked up yet
+    uint32_t no_input = 0;
+    atomic_compare_exchange_strong(&touch_input_us, &no_input, read_us ? read_us : 1);
+
+    // Debug level: a log line per touch would skew the latency being measured
+    if ((slot & SLOT_PRESSED) != (published & SLOT_PRESSED))
+    {
+      if (slot)
+        ESP_LOGD(TAG, "Touch: Count=%d, X=%d, Y=%d, TrackID=%d", touch_data.touch_count,
+                 touch_data.points[0].x, touch_data.points[0].y, touch_data.points[0].track_id);
+      else
+        ESP_LOGD(TAG, "Touch released");
+    }
+    published = slot;
+
+    if (touch_event_cb)
+    {
+      touch_event_cb();
+    }
+  }
+}
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // PUBLIC API FUNCTIONS
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -275,6 +600,8 @@ esp_err_t gt911_init(void)
   ret = gt911_detect_i2c_address();
   if (ret != ESP_OK)
   {
+    i2c_del_master_bus(gt911_bus);
+    gt911_bus = NULL;
     return ret;
   }
 
@@ -295,6 +622,294 @@ esp_err_t gt911_init(void)
   return ESP_OK;
 }
 
+esp_err_t gt911_start(int irq_gpio, gt911_event_cb_t on_change)
+{
+  if (!gt911_initialized)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (touch_task_handle)
+  {
+    return ESP_OK;
+  }
+
+  touch_event_cb = on_change;
+  touch_irq_gpio = -1;
+
+  trace_lock = xSemaphoreCreateMutex();
+  if (!trace_lock)
+  {
+    return ESP_ERR_NO_MEM;
+  }
+
+  BaseType_t result = xTaskCreatePinnedToCore(gt911_touch_task, "gt911", GT911_TASK_STACK_SIZE, NULL,
+                                              GT911_TASK_PRIORITY, &touch_task_handle, 0);
+  if (result != pdPASS)
+  {
+    ESP_LOGE(TAG, "Failed to create touch task");
+    return ESP_ERR_NO_MEM;
+  }
+
+  if (irq_gpio >= 0)
+  {
+    // GT911 pulses INT once per report; either edge wakes the task and
+    // notifications of the same pulse collapse into one read
+    gpio_config_t irq_conf = {
+        .pin_bit_mask = 1ULL << irq_gpio,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_ANYEDGE,
+    };
+    esp_err_t ret = gpio_config(&irq_conf);
+    if (ret == ESP_OK)
+    {
+      ret = gpio_install_isr_service(0);
+      if (ret == ESP_ERR_INVALID_STATE)
+      {
+        ret = ESP_OK; // Already installed by another driver
+      }
+    }
+    if (ret == ESP_OK)
+    {
+      ret = gpio_isr_handler_add(irq_gpio, gt911_irq_handler, NULL);
+    }
+
+    if (ret == ESP_OK)
+    {
+      touch_irq_gpio = irq_gpio;
+    }
+    else
+    {
+      ESP_LOGW(TAG, "Touch interrupt on GPIO%d unavailable (%s), polling instead", irq_gpio, esp_err_to_name(ret));
+    }
+  }
+
+  if (touch_irq_gpio >= 0)
+  {
+    ESP_LOGI(TAG, "Touch task started, reading on INT (GPIO%d)", touch_irq_gpio);
+  }
+  else
+  {
+    ESP_LOGI(TAG, "Touch task started, polling every %d ms (%d ms while touched)",
+             GT911_POLL_IDLE_MS, GT911_POLL_ACTIVE_MS);
+  }
+  return ESP_OK;
+}
+
+void gt911_set_gesture_handler(gt911_gesture_cb_t handler)
+{
+  atomic_store(&gesture_handler, handler);
+}
+
+uint32_t gt911_take_input_time(void)
+{
+  return atomic_exchange(&touch_input_us, 0);
+}
+
+esp_err_t gt911_trace_record(void)
+{
+  if (!trace_lock)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  xSemaphoreTake(trace_lock, portMAX_DELAY);
+  esp_err_t ret = atomic_load(&trace_mode) == TRACE_REPLAY ? ESP_ERR_INVALID_STATE : gt911_trace_alloc();
+  if (ret == ESP_OK)
+  {
+    touch_trace_reset(&trace);
+    trace_start_us = esp_timer_get_time();
+    atomic_store(&trace_mode, TRACE_RECORD);
+    ESP_LOGI(TAG, "Touch trace recording (%d bytes)", GT911_TRACE_BUFFER_SIZE);
+  }
+  xSemaphoreGive(trace_lock);
+
+  return ret;
+}
+
+esp_err_t gt911_trace_stop(void)
+{
+  if (!trace_lock)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  xSemaphoreTake(trace_lock, portMAX_DELAY);
+  trace_mode_t mode = atomic_exchange(&trace_mode, TRACE_OFF);
+  if (mode == TRACE_RECORD)
+  {
+    ESP_LOGI(TAG, "Touch trace recorded: %lu frames, %u bytes, %lu ms, %lu dropped", trace.frames,
+             (unsigned)trace.len, trace.last_ms, trace.dropped);
+  }
+  else if (mode == TRACE_REPLAY)
+  {
+    ESP_LOGI(TAG, "Touch trace replay stopped");
+  }
+  xSemaphoreGive(trace_lock);
+
+  // A stopped replay leaves the last replayed state published: re-read the controller
+  if (touch_task_handle)
+  {
+    xTaskNotifyGive(touch_task_handle);
+  }
+  return ESP_OK;
+}
+
+esp_err_t gt911_trace_replay(void)
+{
+  if (!trace_lock)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  esp_err_t ret = ESP_OK;
+  xSemaphoreTake(trace_lock, portMAX_DELAY);
+  if (atomic_load(&trace_mode) != TRACE_OFF || !trace.buf || trace.frames == 0)
+  {
+    ret = ESP_ERR_INVALID_STATE;
+  }
+  else
+  {
+    touch_trace_rewind(&replay_cursor);
+    replay_pending = touch_trace_next(&trace, &replay_cursor, &replay_frame);
+
+    // Start with the first frame rather than the idle time before it
+    trace_start_us = esp_timer_get_time() - (int64_t)replay_frame.time_ms * 1000;
+    atomic_store(&trace_mode, TRACE_REPLAY);
+    ESP_LOGI(TAG, "Touch trace replay: %lu frames, %lu ms", trace.frames, trace.last_ms);
+  }
+  xSemaphoreGive(trace_lock);
+
+  if (ret == ESP_OK && touch_task_handle)
+  {
+    xTaskNotifyGive(touch_task_handle);
+  }
+  return ret;
+}
+
+esp_err_t gt911_trace_dump(void)
+{
+  if (!trace_lock)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  xSemaphoreTake(trace_lock, portMAX_DELAY);
+  if (atomic_load(&trace_mode) != TRACE_OFF || !trace.buf)
+  {
+    xSemaphoreGive(trace_lock);
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  char hex[2 * TOUCH_TRACE_HEX_CHUNK + 1];
+  // Straight to stdout: the dump must not be rate-limited or reformatted by the log backend
+  printf("TTRACE begin %d %lu %u\n", TOUCH_TRACE_VERSION, trace.frames, (unsigned)trace.len);
+  for (size_t pos = 0; pos < trace.len; pos += TOUCH_TRACE_HEX_CHUNK)
+  {
+    size_t len = trace.len - pos < TOUCH_TRACE_HEX_CHUNK ? trace.len - pos : TOUCH_TRACE_HEX_CHUNK;
+    touch_trace_hex_encode(trace.buf + pos, len, hex);
+    printf("TTRACE data %s\n", hex);
+  }
+  printf("TTRACE end\n");
+  fflush(stdout);
+  xSemaphoreGive(trace_lock);
+
+  return ESP_OK;
+}
+
+/**
+ * @brief Handle one line of a trace upload ("TTRACE begin/data/end")
+ * @note Call with trace_lock held and no recording or replay running
+ */
+static esp_err_t gt911_trace_load_line(const char *cmd, const char *arg)
+{
+  if (strcmp(cmd, "begin") == 0)
+  {
+    int version = 0;
+    unsigned long frames = 0;
+    if (sscanf(arg, "%d %lu", &version, &frames) != 2 || version != TOUCH_TRACE_VERSION)
+    {
+      ESP_LOGW(TAG, "Unsupported touch trace header: %s", arg);
+      return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = gt911_trace_alloc();
+    if (ret == ESP_OK)
+    {
+      touch_trace_reset(&trace);
+      load_expected_frames = frames;
+    }
+    return ret;
+  }
+
+  if (!trace.buf)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (strcmp(cmd, "data") == 0)
+  {
+    uint8_t chunk[TOUCH_TRACE_HEX_CHUNK];
+    size_t len = touch_trace_hex_decode(arg, chunk, sizeof(chunk));
+    if (len == 0 || !touch_trace_append_raw(&trace, chunk, len))
+    {
+      ESP_LOGW(TAG, "Bad or oversized touch trace data at byte %u", (unsigned)trace.len);
+      return ESP_ERR_INVALID_SIZE;
+    }
+    return ESP_OK;
+  }
+
+  if (strcmp(cmd, "end") == 0)
+  {
+    if (!touch_trace_validate(&trace) || trace.frames != load_expected_frames)
+    {
+      ESP_LOGW(TAG, "Touch trace upload incomplete (%lu of %lu frames)", trace.frames, load_expected_frames);
+      touch_trace_reset(&trace);
+      return ESP_ERR_INVALID_SIZE;
+    }
+    ESP_LOGI(TAG, "Touch trace loaded: %lu frames, %u bytes", trace.frames, (unsigned)trace.len);
+    return ESP_OK;
+  }
+
+  return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t gt911_trace_command(const char *line)
+{
+  char cmd[8] = {0};
+  int consumed = 0;
+
+  if (sscanf(line, "TTRACE %7s %n", cmd, &consumed) != 1)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  const char *arg = consumed ? line + consumed : "";
+
+  if (strcmp(cmd, "record") == 0)
+    return gt911_trace_record();
+  if (strcmp(cmd, "stop") == 0)
+    return gt911_trace_stop();
+  if (strcmp(cmd, "replay") == 0)
+    return gt911_trace_replay();
+  if (strcmp(cmd, "dump") == 0)
+    return gt911_trace_dump();
+
+  if (!trace_lock)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  xSemaphoreTake(trace_lock, portMAX_DELAY);
+  esp_err_t ret = atomic_load(&trace_mode) == TRACE_OFF ? gt911_trace_load_line(cmd, arg) : ESP_ERR_INVALID_STATE;
+  xSemaphoreGive(trace_lock);
+
+  if (ret == ESP_ERR_NOT_SUPPORTED)
+  {
+    ESP_LOGW(TAG, "Unknown touch trace command: %s", cmd);
+  }
+  return ret;
+}
+
 esp_err_t gt911_deinit(void)
 {
   if (!gt911_initialized)
@@ -302,7 +917,21 @@ esp_err_t gt911_deinit(void)
     return ESP_OK;
   }
 
-  i2c_driver_delete(GT911_I2C_NUM);
+  if (touch_irq_gpio >= 0)
+  {
+    gpio_isr_handler_remove(touch_irq_gpio);
+    touch_irq_gpio = -1;
+  }
+  if (touch_task_handle)
+  {
+    vTaskDelete(touch_task_handle);
+    touch_task_handle = NULL;
+  }
+
+  i2c_master_bus_rm_device(gt911_dev);
+  i2c_del_master_bus(gt911_bus);
+  gt911_dev = NULL;
+  gt911_bus = NULL;
   gt911_initialized = false;
 
   ESP_LOGI(TAG, "GT911 deinitialized");
@@ -316,31 +945,26 @@ esp_err_t gt911_read_touch(gt911_touch_data_t *touch_data)
     return ESP_ERR_INVALID_STATE;
   }
 
-  uint8_t status;
-  esp_err_t ret = gt911_i2c_read_reg(GT911_REG_STATUS, &status, 1);
+  // Status and touch points in one transaction (1 status byte + 5 points x 8 bytes)
+  uint8_t touch_raw_data[1 + GT911_MAX_TOUCH_POINTS * 8];
+  esp_err_t ret = gt911_i2c_read_reg(GT911_REG_STATUS, touch_raw_data, sizeof(touch_raw_data));
   if (ret != ESP_OK)
   {
     return ret;
   }
 
   // Check if new touch data is available
-  if (!(status & 0x80))
+  if (!(touch_raw_data[0] & 0x80))
   {
     // No new data, return previous state
     *touch_data = last_touch_data;
     return ESP_OK;
   }
-
-  // Read touch point data (up to 5 points, 8 bytes each + 1 status byte = 41 bytes)
-  uint8_t touch_raw_data[41];
-  ret = gt911_i2c_read_reg(GT911_REG_STATUS, touch_raw_data, sizeof(touch_raw_data));
-  if (ret != ESP_OK)
-  {
-    return ret;
-  }
+  stat_reports++;
 
   // Parse the touch data
   gt911_parse_touch_data(touch_raw_data, touch_data);
+  gt911_trace_capture(touch_data);
 
   // Store as last known state
   last_touch_data = *touch_data;
@@ -354,37 +978,24 @@ esp_err_t gt911_read_touch(gt911_touch_data_t *touch_data)
 
 void gt911_lvgl_read(lv_indev_t *indev, lv_indev_data_t *data)
 {
-  static gt911_touch_data_t touch_data;
+  uint32_t latched = atomic_exchange(&touch_latch, 0);
+  uint32_t slot = atomic_load(&touch_slot);
 
-  if (gt911_read_touch(&touch_data) != ESP_OK)
+  // Released already, but LVGL has not seen the press yet: report it once
+  if (!(slot & SLOT_PRESSED))
   {
-    data->state = LV_INDEV_STATE_RELEASED;
-    return;
+    slot = latched;
   }
 
-  if (touch_data.data_ready && touch_data.touch_count > 0)
+  if (slot & SLOT_PRESSED)
   {
-    // Use first touch point for LVGL
-    data->point.x = touch_data.points[0].x;
-    data->point.y = touch_data.points[0].y;
+    data->point.x = slot & 0xFFFF;
+    data->point.y = (slot >> 16) & 0x7FFF;
     data->state = LV_INDEV_STATE_PRESSED;
-
-    // Enhanced debugging for touch events
-    ESP_LOGI(TAG, "Touch: Count=%d, X=%d, Y=%d, TrackID=%d",
-             touch_data.touch_count, data->point.x, data->point.y,
-             touch_data.points[0].track_id);
   }
   else
   {
     data->state = LV_INDEV_STATE_RELEASED;
-
-    // Debug log for touch release (only when transitioning from pressed)
-    static bool was_pressed = false;
-    if (was_pressed && touch_data.data_ready)
-    {
-      ESP_LOGI(TAG, "Touch released");
-    }
-    was_pressed = (data->state == LV_INDEV_STATE_PRESSED);
   }
 }
 
@@ -4,8 +4,9 @@
 // STANDARD INCLUDES
 // ═══════════════════════════════════════════════════════════════════════════════
 
-#include "driver/i2c.h"
+#include "driver/i2c_master.h"
 #include "esp_err.h"
+#include "gesture.h"
 #include "lvgl.h"
 
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -36,12 +37,22 @@
 #define GT911_I2C_NUM I2C_NUM_0
 #define GT911_I2C_FREQ_HZ 400000 // 400kHz
 #define GT911_I2C_TIMEOUT_MS 100
+#define GT911_I2C_WRITE_MAX 8 // Largest register write payload
 
 // Touch Configuration
 #define GT911_MAX_TOUCH_POINTS 5 // Maximum simultaneous touch points
 #define TOUCH_SCREEN_WIDTH 800   // Screen width in pixels
 #define TOUCH_SCREEN_HEIGHT 480  // Screen height in pixels
 
+// Touch task (owns the I2C bus after gt911_start)
+#define GT911_TASK_STACK_SIZE 3072
+#define GT911_TASK_PRIORITY 3        // Above LVGL so a touch is read before the next frame
+#define GT911_POLL_IDLE_MS 50        // Poll period without INT while nobody touches
+#define GT911_POLL_ACTIVE_MS 10      // Poll period without INT while touched (GT911 reports at ~100 Hz)
+#define GT911_RELEASE_TIMEOUT_MS 100 // With INT: re-read while pressed in case a release edge was missed
+#define GT911_STATS_INTERVAL_MS 30000
+#define GT911_TRACE_BUFFER_SIZE (128 * 1024) // PSRAM touch trace (~18k one-finger frames)
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // DATA STRUCTURES
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -68,6 +79,16 @@ typedef struct
   bool data_ready;                                    // Data ready flag
 } gt911_touch_data_t;
 
+/**
+ * @brief Called from the touch task when the published touch state changes
+ */
+typedef void (*gt911_event_cb_t)(void);
+
+/**
+ * @brief Called from the touch task for every recognized gesture
+ */
+typedef void (*gt911_gesture_cb_t)(const gesture_event_t *event);
+
 // ═══════════════════════════════════════════════════════════════════════════════
 // FUNCTION DECLARATIONS
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -84,10 +105,79 @@ esp_err_t gt911_init(void);
  */
 esp_err_t gt911_deinit(void);
 
+/**
+ * @brief Start the touch task that reads the controller for gt911_lvgl_read()
+ * @param irq_gpio GPIO wired to the GT911 INT output, or -1 to poll
+ * @param on_change Called when the touch state changes (e.g. to wake LVGL), may be NULL
+ * @return ESP_OK on success
+ * @note With an interrupt the bus is only read after an INT edge, so an
+ *       untouched screen causes no I2C traffic. Without one the task polls,
+ *       slower while nobody touches. Either way the LVGL read callback only
+ *       loads the last published state and never touches the bus.
+ */
+esp_err_t gt911_start(int irq_gpio, gt911_event_cb_t on_change);
+
+/**
+ * @brief Set the gesture handler
+ * @param handler Called from the touch task for each gesture, NULL to stop
+ * @note The handler runs in the touch task: hand events to the UI through
+ *       a queue rather than touching LVGL
+ */
+void gt911_set_gesture_handler(gt911_gesture_cb_t handler);
+
+/**
+ * @brief Take the time of the oldest touch change not yet taken
+ * @return Low 32 bits of esp_timer_get_time() when the touch task read the
+ *         change, or 0 if nothing changed since the last call
+ * @note Call from the LVGL read path right after gt911_lvgl_read()
+ */
+uint32_t gt911_take_input_time(void);
+
+/**
+ * @brief Start recording every frame the controller reports into a PSRAM trace
+ * @return ESP_OK, ESP_ERR_NO_MEM, or ESP_ERR_INVALID_STATE before gt911_start() or during a replay
+ * @note Clears the previous trace
+ */
+esp_err_t gt911_trace_record(void);
+
+/**
+ * @brief Stop recording or replaying
+ * @return ESP_OK, or ESP_ERR_INVALID_STATE before gt911_start()
+ */
+esp_err_t gt911_trace_stop(void);
+
+/**
+ * @brief Replay the trace into the touch path with its original timing
+ * @return ESP_OK, or ESP_ERR_INVALID_STATE if there is no trace or one is
+ *         being recorded or replayed
+ * @note Real touches are ignored until the replay ends
+ */
+esp_err_t gt911_trace_replay(void);
+
+/**
+ * @brief Print the trace to stdout as "TTRACE begin <version> <frames> <bytes>",
+ *        "TTRACE data <hex>" lines and "TTRACE end"
+ * @return ESP_OK, or ESP_ERR_INVALID_STATE if there is no trace or one is
+ *         being recorded or replayed
+ * @note Sending the dumped lines back loads the trace
+ */
+esp_err_t gt911_trace_dump(void);
+
+/**
+ * @brief Run a touch trace command received over serial
+ * @param line "TTRACE record|stop|replay|dump", or an uploaded trace line
+ *             ("TTRACE begin ...", "TTRACE data ...", "TTRACE end")
+ * @return ESP_OK on success, an error for unknown or malformed commands
+ */
+esp_err_t gt911_trace_command(const char *line);
+
 /**
  * @brief Read touch data from GT911
  * @param touch_data Pointer to touch data structure
  * @return ESP_OK on success, ESP_FAIL on failure
+ * @note One combined read of status and all points, plus the status clear
+ *       write when new data was reported. Call from the touch task only once
+ *       gt911_start() has run.
  */
 esp_err_t gt911_read_touch(gt911_touch_data_t *touch_data);
 
@@ -95,6 +185,8 @@ esp_err_t gt911_read_touch(gt911_touch_data_t *touch_data);
  * @brief LVGL input device read callback for GT911
  * @param indev LVGL input device
  * @param data LVGL input data structure
+ * @note Lock-free: loads the state published by the touch task. A tap that
+ *       starts and ends between two reads is still reported as one press.
  */
 void gt911_lvgl_read(lv_indev_t *indev, lv_indev_data_t *data);
 
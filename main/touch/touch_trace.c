@@ -0,0 +1,196 @@
+/**
+ * @file touch_trace.c
+ * @brief Compact touch trace format for recording and replaying GT911 frames
+ */
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// STANDARD INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#include "touch_trace.h"
+
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define FRAME_HEADER_BYTES 3 ///< dt_ms (2) + count (1)
+#define POINT_BYTES 4
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PRIVATE FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+static int hex_digit(char c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+/**
+ * @brief Size of the frame at pos, or 0 if it runs past len
+ */
+static size_t frame_size(const uint8_t *buf, size_t len, size_t pos)
+{
+  if (len - pos < FRAME_HEADER_BYTES || buf[pos + 2] > TOUCH_TRACE_MAX_POINTS)
+    return 0;
+
+  size_t size = FRAME_HEADER_BYTES + buf[pos + 2] * POINT_BYTES;
+  return len - pos >= size ? size : 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION IMPLEMENTATIONS
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void touch_trace_init(touch_trace_t *trace, uint8_t *buf, size_t size)
+{
+  trace->buf = buf;
+  trace->size = size;
+  touch_trace_reset(trace);
+}
+
+void touch_trace_reset(touch_trace_t *trace)
+{
+  trace->len = 0;
+  trace->frames = 0;
+  trace->dropped = 0;
+  trace->last_ms = 0;
+  trace->skipped_ms = 0;
+}
+
+bool touch_trace_append(touch_trace_t *trace, const touch_trace_frame_t *frame)
+{
+  uint8_t count = frame->count <= TOUCH_TRACE_MAX_POINTS ? frame->count : TOUCH_TRACE_MAX_POINTS;
+  size_t size = FRAME_HEADER_BYTES + count * POINT_BYTES;
+
+  if (trace->size - trace->len < size)
+  {
+    trace->dropped++;
+    return false;
+  }
+
+  // Shorten long pauses rather than shifting every later frame
+  uint32_t dt = frame->time_ms - trace->skipped_ms - trace->last_ms;
+  if (dt > UINT16_MAX)
+  {
+    trace->skipped_ms += dt - UINT16_MAX;
+    dt = UINT16_MAX;
+  }
+
+  uint8_t *p = trace->buf + trace->len;
+  *p++ = dt & 0xFF;
+  *p++ = dt >> 8;
+  *p++ = count;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    const touch_trace_point_t *point = &frame->points[i];
+    uint32_t packed = (point->x & 0xFFFu) | ((point->y & 0xFFFu) << 12) | ((uint32_t)point->track_id << 24);
+    *p++ = packed & 0xFF;
+    *p++ = (packed >> 8) & 0xFF;
+    *p++ = (packed >> 16) & 0xFF;
+    *p++ = packed >> 24;
+  }
+
+  trace->len += size;
+  trace->frames++;
+  trace->last_ms += dt;
+  return true;
+}
+
+bool touch_trace_append_raw(touch_trace_t *trace, const uint8_t *data, size_t len)
+{
+  if (trace->size - trace->len < len)
+    return false;
+
+  memcpy(trace->buf + trace->len, data, len);
+  trace->len += len;
+  return true;
+}
+
+bool touch_trace_validate(touch_trace_t *trace)
+{
+  uint32_t frames = 0;
+  uint32_t time_ms = 0;
+  size_t pos = 0;
+
+  while (pos < trace->len)
+  {
+    size_t size = frame_size(trace->buf, trace->len, pos);
+    if (size == 0)
+      return false;
+
+    time_ms += trace->buf[pos] | (trace->buf[pos + 1] << 8);
+    frames++;
+    pos += size;
+  }
+
+  trace->frames = frames;
+  trace->last_ms = time_ms;
+  return true;
+}
+
+void touch_trace_rewind(touch_trace_cursor_t *cursor)
+{
+  cursor->pos = 0;
+  cursor->time_ms = 0;
+}
+
+bool touch_trace_next(const touch_trace_t *trace, touch_trace_cursor_t *cursor, touch_trace_frame_t *frame)
+{
+  size_t size = cursor->pos < trace->len ? frame_size(trace->buf, trace->len, cursor->pos) : 0;
+  if (size == 0)
+    return false;
+
+  const uint8_t *p = trace->buf + cursor->pos;
+  cursor->time_ms += p[0] | (p[1] << 8);
+  frame->time_ms = cursor->time_ms;
+  frame->count = p[2];
+  p += FRAME_HEADER_BYTES;
+
+  for (uint8_t i = 0; i < frame->count; i++, p += POINT_BYTES)
+  {
+    uint32_t packed = p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    frame->points[i].x = packed & 0xFFF;
+    frame->points[i].y = (packed >> 12) & 0xFFF;
+    frame->points[i].track_id = packed >> 24;
+  }
+
+  cursor->pos += size;
+  return true;
+}
+
+void touch_trace_hex_encode(const uint8_t *data, size_t len, char *out)
+{
+  static const char digits[] = "0123456789abcdef";
+
+  for (size_t i = 0; i < len; i++)
+  {
+    *out++ = digits[data[i] >> 4];
+    *out++ = digits[data[i] & 0x0F];
+  }
+  *out = '\0';
+}
+
+size_t touch_trace_hex_decode(const char *hex, uint8_t *out, size_t out_size)
+{
+  size_t len = 0;
+
+  while (*hex && *hex != ' ' && *hex != '\r' && *hex != '\n')
+  {
+    int hi = hex_digit(hex[0]);
+    int lo = hi >= 0 ? hex_digit(hex[1]) : -1;
+    if (lo < 0 || len >= out_size)
+      return 0;
+
+    out[len++] = (uint8_t)(hi << 4 | lo);
+    hex += 2;
+  }
+  return len;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file touch_trace.h
+ * @brief Compact touch trace format for recording and replaying GT911 frames
+ *
+ * A trace is a byte string of frames, each stored as
+ *
+ *   [dt_ms: u16 LE][count: u8][count x point: u32 LE]
+ *
+ * where dt_ms is the time since the previous frame and a point packs x (bits 0-11), y (bits 12-23) and the track ID (bits
+ * 24-31). A one-finger frame takes 7 bytes. Frames are recorded as the
+ * controller reports them, so a trace replays the exact contact stream,
+ * lifts (count 0) included. A pause longer than 65535 ms is stored as
+ * 65535 ms and the frames after it keep their spacing, so a gesture that
+ * follows a long idle period replays with its real timing.
+ *
+ * The codec works on a caller-provided buffer and has no ESP-IDF
+ * dependencies, so a host build can replay the same traces.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// CONSTANTS AND CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#define TOUCH_TRACE_MAX_POINTS 5  ///< Contacts per frame (GT911 reports up to 5)
+#define TOUCH_TRACE_VERSION 1     ///< Format version, sent with every dump
+#define TOUCH_TRACE_HEX_CHUNK 64  ///< Trace bytes per hex dump line
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief One contact of a frame
+ */
+typedef struct
+{
+  uint8_t track_id;
+  uint16_t x;
+  uint16_t y;
+} touch_trace_point_t;
+
+/**
+ * @brief One decoded frame
+ */
+typedef struct
+{
+  uint32_t time_ms; ///< Time since the start of the trace
+  uint8_t count;    ///< Contacts down (0 = all lifted)
+  touch_trace_point_t points[TOUCH_TRACE_MAX_POINTS];
+} touch_trace_frame_t;
+
+/**
+ * @brief Trace buffer
+ */
+typedef struct
+{
+  uint8_t *buf;        ///< Storage (caller-owned)
+  size_t size;         ///< Capacity in bytes
+  size_t len;          ///< Bytes used
+  uint32_t frames;     ///< Frames stored
+  uint32_t dropped;    ///< Frames rejected because the buffer was full
+  uint32_t last_ms;    ///< Time of the last stored frame
+  uint32_t skipped_ms; ///< Idle time cut from pauses longer than 65535 ms
+} touch_trace_t;
+
+/**
+ * @brief Replay position
+ */
+typedef struct
+{
+  size_t pos;       ///< Offset of the next frame
+  uint32_t time_ms; ///< Time of the previous frame
+} touch_trace_cursor_t;
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTION PROTOTYPES
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Attach a buffer and clear the trace
+ */
+void touch_trace_init(touch_trace_t *trace, uint8_t *buf, size_t size);
+
+/**
+ * @brief Clear the trace, keeping its buffer
+ */
+void touch_trace_reset(touch_trace_t *trace);
+
+/**
+ * @brief Append one frame
+ * @param trace Trace to append to
+ * @param frame Frame; time_ms must not be before the previous frame
+ * @return true if stored, false if the buffer is full (counted in dropped)
+ */
+bool touch_trace_append(touch_trace_t *trace, const touch_trace_frame_t *frame);
+
+/**
+ * @brief Append raw encoded bytes (a trace received as a dump)
+ * @return true if stored, false if they do not fit
+ * @note Call touch_trace_validate() after the last chunk
+ */
+bool touch_trace_append_raw(touch_trace_t *trace, const uint8_t *data, size_t len);
+
+/**
+ * @brief Recount the frames of raw-loaded data
+ * @return true if the data is a whole number of well-formed frames
+ */
+bool touch_trace_validate(touch_trace_t *trace);
+
+/**
+ * @brief Start a replay cursor at the first frame
+ */
+void touch_trace_rewind(touch_trace_cursor_t *cursor);
+
+/**
+ * @brief Decode the frame at the cursor and advance it
+ * @return true if a frame was decoded, false at the end of the trace
+ */
+bool touch_trace_next(const touch_trace_t *trace, touch_trace_cursor_t *cursor, touch_trace_frame_t *frame);
+
+/**
+ * @brief Encode bytes as lowercase hex
+ * @param data Bytes to encode
+ * @param len Number of bytes
+ * @param out Receives the NUL-terminated hex string (2 * len + 1 bytes)
+ */
+void touch_trace_hex_encode(const uint8_t *data, size_t len, char *out);
+
+/**
+ * @brief Decode a hex string
+ * @param hex Hex digits, terminated by NUL or whitespace
+ * @param out Receives the bytes
+ * @param out_size Capacity of out
+ * @return Number of bytes decoded, or 0 on a malformed or oversized string
+ */
+size_t touch_trace_hex_decode(const char *hex, uint8_t *out, size_t out_size);